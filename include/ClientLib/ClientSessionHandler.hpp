@@ -8,6 +8,8 @@
 #define TSOM_CLIENTLIB_CLIENTSESSIONHANDLER_HPP
 
 #include <ClientLib/Export.hpp>
+#include <CommonLib/BulkTransferReceiver.hpp>
+#include <CommonLib/Chunk.hpp>
 #include <CommonLib/EntityRegistry.hpp>
 #include <CommonLib/EnvironmentTransform.hpp>
 #include <CommonLib/SessionHandler.hpp>
@@ -29,6 +31,7 @@ namespace Nz
 
 namespace tsom
 {
+	class ChunkContentCache;
 	class ClientBlockLibrary;
 	class GravityController;
 	struct PlayerAnimationAssets;
@@ -48,6 +51,9 @@ namespace tsom
 			inline ScriptingContext& GetScriptingContext();
 
 			void HandlePacket(Packets::AuthResponse&& authResponse);
+			void HandlePacket(Packets::BulkCancel&& bulkCancel);
+			void HandlePacket(Packets::BulkCommit&& bulkCommit);
+			void HandlePacket(Packets::BulkFragment&& bulkFragment);
 			void HandlePacket(Packets::ChatMessage&& chatMessage);
 			void HandlePacket(Packets::ChunkCreate&& chunkCreate);
 			void HandlePacket(Packets::ChunkDestroy&& chunkDestroy);
@@ -72,6 +78,10 @@ namespace tsom
 
 			void LoadScripts(bool isReloading = false);
 
+			inline void SetChunkContentCache(ChunkContentCache* chunkContentCache);
+
+			void Update();
+
 			NazaraSignal(OnAuthResponse, const Packets::AuthResponse& /*authResponse*/);
 			NazaraSignal(OnChatMessage, const std::string& /*message*/);
 			NazaraSignal(OnControlledEntityChanged, entt::handle /*newEntity*/);
@@ -92,8 +102,10 @@ namespace tsom
 			};
 
 		private:
+			void CancelChunkLoad(const Chunk* chunk);
 			inline PlayerInfo* FetchPlayerInfo(PlayerIndex playerIndex);
 			inline const PlayerInfo* FetchPlayerInfo(PlayerIndex playerIndex) const;
+			void RequestChunkReset(Packets::Helper::ChunkId chunkId);
 			void SetupEntity(entt::handle entity, Packets::Helper::PlayerControlledData&& entityData);
 
 			struct EnvironmentData
@@ -110,6 +122,13 @@ namespace tsom
 				entt::handle entity;
 			};
 
+			struct PendingChunkLoad
+			{
+				Chunk* chunk;
+				Packets::Helper::ChunkId chunkId;
+				std::vector<Chunk::BlockUpdate> blockUpdates;
+			};
+
 			struct PlayerModel
 			{
 				std::shared_ptr<Nz::Model> model;
@@ -121,9 +140,13 @@ namespace tsom
 			std::vector<std::optional<EntityData>> m_entities; //< FIXME: Nz::SparseVector
 			std::vector<std::optional<EnvironmentData>> m_environments; //< FIXME: Nz::SparseVector
 			std::vector<std::optional<PlayerInfo>> m_players; //< FIXME: Nz::SparseVector
+			tsl::hopscotch_map<Nz::UInt64 /*loadId*/, PendingChunkLoad> m_pendingChunkLoads;
+			tsl::hopscotch_map<const Chunk*, Nz::UInt64 /*loadId*/> m_pendingChunkLoadByChunk;
 			Nz::ApplicationBase& m_app;
 			Nz::EnttWorld& m_world;
 			ClientBlockLibrary& m_blockLibrary;
+			BulkTransferReceiver m_bulkTransferReceiver;
+			ChunkContentCache* m_chunkContentCache;
 			Nz::UInt16 m_lastTickIndex;
 			Nz::UInt16 m_ownPlayerIndex;
 			Packets::Helper::EnvironmentId m_currentEnvironmentIndex;
@@ -24,6 +24,11 @@ namespace tsom
 		return m_scriptingContext;
 	}
 
+	inline void ClientSessionHandler::SetChunkContentCache(ChunkContentCache* chunkContentCache)
+	{
+		m_chunkContentCache = chunkContentCache;
+	}
+
 	inline auto ClientSessionHandler::FetchPlayerInfo(PlayerIndex playerIndex) -> PlayerInfo*
 	{
 		if (playerIndex >= m_players.size() || !m_players[playerIndex])
@@ -57,7 +57,8 @@ namespace tsom
 		m_lastTickIndex = tickIndex;
 
 		// If we lost a movement, build missing movements by interpolating
-		if (tickDifference >= 2 && !m_movementPoints.empty())
+		// (server doesn't send states of resting entities, a large gap means the entity didn't move in the meantime)
+		if (tickDifference >= 2 && tickDifference <= MaxPoint && !m_movementPoints.empty())
 		{
 			auto& referencePosition = m_movementPoints.back();
 
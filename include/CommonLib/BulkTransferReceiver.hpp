@@ -0,0 +1,57 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_BULKTRANSFERRECEIVER_HPP
+#define TSOM_COMMONLIB_BULKTRANSFERRECEIVER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <tsl/hopscotch_map.h>
+#include <optional>
+
+namespace tsom
+{
+	// Reassembles fragments sent by a BulkTransferSender, a transfer is only delivered once committed
+	class TSOM_COMMONLIB_API BulkTransferReceiver
+	{
+		public:
+			using TransferId = Nz::UInt32;
+
+			inline BulkTransferReceiver(std::size_t maxPendingBytes = Constants::BulkTransferMaxSize);
+			BulkTransferReceiver(const BulkTransferReceiver&) = delete;
+			BulkTransferReceiver(BulkTransferReceiver&&) = delete;
+			~BulkTransferReceiver() = default;
+
+			void Cancel(TransferId transferId);
+
+			std::optional<Nz::ByteArray> Commit(TransferId transferId);
+
+			inline std::size_t GetPendingBytes() const;
+			inline std::size_t GetPendingTransferCount() const;
+
+			bool HandleFragment(Packets::BulkFragment&& fragment);
+
+			BulkTransferReceiver& operator=(const BulkTransferReceiver&) = delete;
+			BulkTransferReceiver& operator=(BulkTransferReceiver&&) = delete;
+
+		private:
+			struct PendingTransfer
+			{
+				Nz::ByteArray payload;
+				std::size_t receivedBytes;
+			};
+
+			tsl::hopscotch_map<TransferId, PendingTransfer> m_pendingTransfers;
+			std::size_t m_maxPendingBytes;
+			std::size_t m_pendingBytes;
+	};
+}
+
+#include <CommonLib/BulkTransferReceiver.inl>
+
+#endif // TSOM_COMMONLIB_BULKTRANSFERRECEIVER_HPP
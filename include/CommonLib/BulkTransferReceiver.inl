@@ -0,0 +1,22 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline BulkTransferReceiver::BulkTransferReceiver(std::size_t maxPendingBytes) :
+	m_maxPendingBytes(maxPendingBytes),
+	m_pendingBytes(0)
+	{
+	}
+
+	inline std::size_t BulkTransferReceiver::GetPendingBytes() const
+	{
+		return m_pendingBytes;
+	}
+
+	inline std::size_t BulkTransferReceiver::GetPendingTransferCount() const
+	{
+		return m_pendingTransfers.size();
+	}
+}
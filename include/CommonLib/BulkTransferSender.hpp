@@ -0,0 +1,80 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_BULKTRANSFERSENDER_HPP
+#define TSOM_COMMONLIB_BULKTRANSFERSENDER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/CongestionController.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace tsom
+{
+	// Splits large packets into fragments sent a few at a time, so they don't delay small packets sent on other channels
+	class TSOM_COMMONLIB_API BulkTransferSender
+	{
+		public:
+			using SendFragmentCallback = Nz::FunctionRef<std::size_t(const Packets::BulkFragment& fragment, std::function<void(std::size_t packetSize)> acknowledgeCallback)>;
+			using TransferId = Nz::UInt32;
+
+			inline BulkTransferSender(std::shared_ptr<CongestionController> congestionController = nullptr, std::size_t fragmentSize = Constants::BulkFragmentMaxSize);
+			BulkTransferSender(const BulkTransferSender&) = delete;
+			BulkTransferSender(BulkTransferSender&&) = delete;
+			~BulkTransferSender() = default;
+
+			bool Cancel(TransferId transferId);
+
+			TransferId Enqueue(Nz::ByteArray payload);
+
+			std::size_t Flush(std::size_t byteBudget, const SendFragmentCallback& sendFragment);
+
+			inline std::size_t GetInFlightTransferCount() const;
+			inline std::size_t GetQueuedBytes() const;
+
+			inline bool HasQueuedData() const;
+
+			void PollCompletedTransfers(const Nz::FunctionRef<void(TransferId transferId)>& callback);
+
+			BulkTransferSender& operator=(const BulkTransferSender&) = delete;
+			BulkTransferSender& operator=(BulkTransferSender&&) = delete;
+
+			static std::size_t ComputeFragmentPacketSize(Nz::UInt32 transferId, Nz::UInt32 offset, Nz::UInt32 totalSize, std::size_t fragmentSize);
+
+		private:
+			struct InFlightTransfer
+			{
+				TransferId transferId;
+				std::shared_ptr<std::atomic_size_t> unacknowledgedFragments; //< decremented on the network thread
+			};
+
+			struct QueuedTransfer
+			{
+				TransferId transferId;
+				Nz::ByteArray payload;
+				std::size_t sentBytes;
+				std::shared_ptr<std::atomic_size_t> unacknowledgedFragments;
+			};
+
+			std::deque<QueuedTransfer> m_queuedTransfers;
+			std::shared_ptr<CongestionController> m_congestionController;
+			std::size_t m_fragmentSize;
+			std::size_t m_queuedBytes;
+			std::vector<InFlightTransfer> m_inFlightTransfers;
+			TransferId m_nextTransferId;
+	};
+}
+
+#include <CommonLib/BulkTransferSender.inl>
+
+#endif // TSOM_COMMONLIB_BULKTRANSFERSENDER_HPP
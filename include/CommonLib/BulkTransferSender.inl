@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+
+namespace tsom
+{
+	inline BulkTransferSender::BulkTransferSender(std::shared_ptr<CongestionController> congestionController, std::size_t fragmentSize) :
+	m_congestionController(std::move(congestionController)),
+	m_fragmentSize(fragmentSize),
+	m_queuedBytes(0),
+	m_nextTransferId(0)
+	{
+		assert(m_fragmentSize > 0 && m_fragmentSize <= Constants::BulkFragmentMaxSize);
+	}
+
+	inline std::size_t BulkTransferSender::GetInFlightTransferCount() const
+	{
+		return m_inFlightTransfers.size();
+	}
+
+	inline std::size_t BulkTransferSender::GetQueuedBytes() const
+	{
+		return m_queuedBytes;
+	}
+
+	inline bool BulkTransferSender::HasQueuedData() const
+	{
+		return !m_queuedTransfers.empty();
+	}
+}
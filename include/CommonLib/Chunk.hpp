@@ -9,7 +9,9 @@
 
 #include <CommonLib/Export.hpp>
 #include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
 #include <CommonLib/Direction.hpp>
+#include <CommonLib/Utility/AtomicSharedPtr.hpp>
 #include <Nazara/Core/Color.hpp>
 #include <Nazara/Math/Matrix4.hpp>
 #include <NazaraUtils/Bitset.hpp>
@@ -17,9 +19,12 @@
 #include <NazaraUtils/FunctionRef.hpp>
 #include <NazaraUtils/Signal.hpp>
 #include <NazaraUtils/SparsePtr.hpp>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <span>
 #include <vector>
 
 namespace Nz
@@ -40,6 +45,7 @@ namespace tsom
 	class TSOM_COMMONLIB_API Chunk : public std::enable_shared_from_this<Chunk>
 	{
 		public:
+			struct BlockUpdate;
 			struct VertexAttributes;
 
 			inline Chunk(const BlockLibrary& blockLibrary, ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float blockSize);
@@ -54,8 +60,11 @@ namespace tsom
 			virtual Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> ComputeVoxelCorners(const Nz::Vector3ui& indices) const = 0;
 
 			virtual void Deserialize(Nz::ByteStream& byteStream);
+			void DeserializeDelta(Nz::ByteStream& byteStream);
 
 			inline const Nz::Bitset<Nz::UInt64>& GetCollisionCellMask() const;
+			inline std::shared_ptr<const BorderSlice> GetBorderSlice(Direction direction) const;
+			inline unsigned int GetBorderSliceIndex(Direction direction, const Nz::Vector3ui& indices) const;
 			inline unsigned int GetBlockLocalIndex(const Nz::Vector3ui& indices) const;
 			inline Nz::Vector3ui GetBlockLocalIndices(unsigned int blockIndex) const;
 			inline BlockIndex GetBlockContent(unsigned int blockIndex) const;
@@ -66,10 +75,14 @@ namespace tsom
 			inline const ChunkContainer& GetContainer() const;
 			inline const BlockIndex* GetContent() const;
 			inline const ChunkIndices& GetIndices() const;
+			inline Nz::UInt64 GetRevision() const;
 			inline const Nz::Vector3ui& GetSize() const;
+			std::shared_ptr<const ChunkSnapshot> GetSnapshot() const;
 
 			inline bool HasContent() const;
 
+			inline bool IsOnBorder(Direction direction, const Nz::Vector3ui& indices) const;
+
 			inline void LockRead() const;
 			inline void LockWrite();
 
@@ -77,18 +90,27 @@ namespace tsom
 			template<typename F> void Reset(F&& func);
 
 			virtual void Serialize(Nz::ByteStream& byteStream) const;
+			void SerializeDelta(Nz::ByteStream& byteStream, const ChunkSnapshot& baseContent) const;
 
 			inline void UnlockRead() const;
 			inline void UnlockWrite();
 
 			void UpdateBlock(const Nz::Vector3ui& indices, BlockIndex cellType);
+			void UpdateBlocks(std::span<const BlockUpdate> updates);
 
 			Chunk& operator=(const Chunk&) = delete;
 			Chunk& operator=(Chunk&&) = delete;
 
 			NazaraSignal(OnBlockUpdated, Chunk* /*emitter*/, const Nz::Vector3ui& /*indices*/, BlockIndex /*newBlock*/);
+			NazaraSignal(OnBlocksUpdated, Chunk* /*emitter*/, const Nz::Bitset<Nz::UInt64>& /*updatedBlocks*/, const Nz::Vector3ui& /*minIndices*/, const Nz::Vector3ui& /*maxIndices*/);
 			NazaraSignal(OnReset, Chunk* /*emitter*/);
 
+			struct BlockUpdate
+			{
+				Nz::Vector3ui indices;
+				BlockIndex newBlock;
+			};
+
 			struct VertexAttributes
 			{
 				Nz::UInt32 firstIndex;
@@ -101,8 +123,17 @@ namespace tsom
 
 		protected:
 			void OnChunkReset();
+			std::shared_ptr<const ChunkSnapshot> PublishSnapshot() const;
+			void RebuildBorderSlices();
+
+			static inline unsigned int GetDirectionAxis(Direction direction);
 
 			mutable std::shared_mutex m_mutex;
+			mutable AtomicSharedPtr<const ChunkSnapshot> m_snapshot;
+			mutable std::atomic_bool m_hasSnapshotReaders;
+			std::atomic_bool m_isWriteLocked;
+			std::atomic_uint64_t m_revision;
+			Nz::EnumArray<Direction, AtomicSharedPtr<const BorderSlice>> m_borderSlices;
 			std::vector<BlockIndex> m_blocks;
 			std::vector<Nz::UInt16> m_blockTypeCount;
 			Nz::Bitset<Nz::UInt64> m_collisionCellMask;
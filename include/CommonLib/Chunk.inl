@@ -8,6 +8,9 @@
 namespace tsom
 {
 	inline Chunk::Chunk(const BlockLibrary& blockLibrary, ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float cellSize) :
+	m_hasSnapshotReaders(false),
+	m_isWriteLocked(false),
+	m_revision(0),
 	m_size(size),
 	m_indices(indices),
 	m_blockLibrary(blockLibrary),
@@ -22,6 +25,21 @@ namespace tsom
 		return m_collisionCellMask;
 	}
 
+	inline std::shared_ptr<const BorderSlice> Chunk::GetBorderSlice(Direction direction) const
+	{
+		return m_borderSlices[direction].Load();
+	}
+
+	inline unsigned int Chunk::GetBorderSliceIndex(Direction direction, const Nz::Vector3ui& indices) const
+	{
+		// Border slices are stored along the two other axes, in axis order
+		unsigned int axis = GetDirectionAxis(direction);
+		unsigned int uAxis = (axis + 1) % 3;
+		unsigned int vAxis = (axis + 2) % 3;
+
+		return m_size[uAxis] * indices[vAxis] + indices[uAxis];
+	}
+
 	inline unsigned int Chunk::GetBlockLocalIndex(const Nz::Vector3ui& indices) const
 	{
 		assert(indices.x < m_size.x);
@@ -84,6 +102,11 @@ namespace tsom
 		return m_indices;
 	}
 
+	inline Nz::UInt64 Chunk::GetRevision() const
+	{
+		return m_revision.load(std::memory_order_acquire);
+	}
+
 	inline const Nz::Vector3ui& Chunk::GetSize() const
 	{
 		return m_size;
@@ -94,6 +117,15 @@ namespace tsom
 		return !m_blocks.empty();
 	}
 
+	inline bool Chunk::IsOnBorder(Direction direction, const Nz::Vector3ui& indices) const
+	{
+		unsigned int axis = GetDirectionAxis(direction);
+		if (s_blockDirOffset[direction][axis] > 0)
+			return indices[axis] == m_size[axis] - 1;
+		else
+			return indices[axis] == 0;
+	}
+
 	inline void Chunk::Reset()
 	{
 		m_blocks.clear();
@@ -104,6 +136,10 @@ namespace tsom
 
 		m_blockTypeCount.resize(EmptyBlockIndex + 1);
 		m_blockTypeCount[EmptyBlockIndex] = m_blocks.size();
+
+		RebuildBorderSlices();
+
+		m_revision.fetch_add(1, std::memory_order_release);
 	}
 
 	template<typename F>
@@ -130,6 +166,13 @@ namespace tsom
 	inline void Chunk::LockWrite()
 	{
 		m_mutex.lock();
+		m_isWriteLocked.store(true, std::memory_order_release);
+	}
+
+	inline unsigned int Chunk::GetDirectionAxis(Direction direction)
+	{
+		const Nz::Vector3i& offset = s_blockDirOffset[direction];
+		return (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
 	}
 
 	inline void Chunk::UnlockRead() const
@@ -139,6 +182,11 @@ namespace tsom
 
 	inline void Chunk::UnlockWrite()
 	{
+		// Once a chunk has been read in the background, publish its new content while we still have exclusive access so readers never lock it
+		if (m_hasSnapshotReaders.load(std::memory_order_relaxed) && HasContent())
+			PublishSnapshot();
+
+		m_isWriteLocked.store(false, std::memory_order_release);
 		m_mutex.unlock();
 	}
 }
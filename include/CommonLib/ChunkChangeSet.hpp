@@ -0,0 +1,51 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKCHANGESET_HPP
+#define TSOM_COMMONLIB_CHUNKCHANGESET_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <NazaraUtils/Bitset.hpp>
+#include <vector>
+
+namespace tsom
+{
+	class Chunk;
+
+	// Tracks which blocks of a chunk changed since the last dispatch, only their final content is sent
+	class TSOM_COMMONLIB_API ChunkChangeSet
+	{
+		public:
+			ChunkChangeSet() = default;
+			ChunkChangeSet(const ChunkChangeSet&) = default;
+			ChunkChangeSet(ChunkChangeSet&&) noexcept = default;
+			~ChunkChangeSet() = default;
+
+			void BuildUpdates(const Chunk& chunk, std::vector<Packets::ChunkUpdate::BlockUpdate>& updates) const;
+
+			inline void Clear();
+
+			inline std::size_t GetChangedBlockCount() const;
+
+			inline bool IsEmpty() const;
+
+			inline void MarkBlock(unsigned int blockIndex);
+			inline void MarkBlocks(const Nz::Bitset<Nz::UInt64>& blockIndices);
+
+			ChunkChangeSet& operator=(const ChunkChangeSet&) = default;
+			ChunkChangeSet& operator=(ChunkChangeSet&&) noexcept = default;
+
+			static std::size_t EstimateResetSize(const ChunkSnapshot& snapshot, const CompressionProfile& profile, bool useFrame);
+
+		private:
+			Nz::Bitset<Nz::UInt64> m_changedBlocks;
+	};
+}
+
+#include <CommonLib/ChunkChangeSet.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKCHANGESET_HPP
@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline void ChunkChangeSet::Clear()
+	{
+		m_changedBlocks.Clear();
+	}
+
+	inline std::size_t ChunkChangeSet::GetChangedBlockCount() const
+	{
+		return m_changedBlocks.Count();
+	}
+
+	inline bool ChunkChangeSet::IsEmpty() const
+	{
+		return m_changedBlocks.TestNone();
+	}
+
+	inline void ChunkChangeSet::MarkBlock(unsigned int blockIndex)
+	{
+		m_changedBlocks.UnboundedSet(blockIndex);
+	}
+
+	inline void ChunkChangeSet::MarkBlocks(const Nz::Bitset<Nz::UInt64>& blockIndices)
+	{
+		m_changedBlocks |= blockIndices;
+	}
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKCONTENTCACHE_HPP
+#define TSOM_COMMONLIB_CHUNKCONTENTCACHE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <tsl/hopscotch_map.h>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace tsom
+{
+	// On-disk store of chunk contents, identified by their content hash (see ChunkSnapshot::ComputeContentHash)
+	// Entries are indexed in memory, file accesses happen on a worker thread and load results are retrieved with PollLoads
+	class TSOM_COMMONLIB_API ChunkContentCache
+	{
+		public:
+			using LoadId = Nz::UInt64;
+			using LoadCallback = Nz::FunctionRef<void(LoadId loadId, std::optional<std::vector<BlockIndex>>&& content)>;
+
+			ChunkContentCache(std::filesystem::path cacheDirectory, std::size_t maxEntryCount = DefaultMaxEntryCount);
+			ChunkContentCache(const ChunkContentCache&) = delete;
+			ChunkContentCache(ChunkContentCache&&) = delete;
+			~ChunkContentCache();
+
+			bool Contains(Nz::UInt64 contentHash) const;
+
+			inline const std::filesystem::path& GetDirectory() const;
+			std::size_t GetEntryCount() const;
+			inline std::size_t GetMaxEntryCount() const;
+
+			void PollLoads(const LoadCallback& callback);
+
+			std::optional<LoadId> RequestLoad(Nz::UInt64 contentHash, const Nz::Vector3ui& size);
+
+			void Store(const Nz::Vector3ui& size, std::vector<BlockIndex> content);
+
+			void WaitForPendingOperations();
+
+			ChunkContentCache& operator=(const ChunkContentCache&) = delete;
+			ChunkContentCache& operator=(ChunkContentCache&&) = delete;
+
+			static constexpr std::size_t DefaultMaxEntryCount = 16 * 1024;
+
+		private:
+			using EntryList = std::list<Nz::UInt64>; //< least recently used first
+
+			struct LoadRequest
+			{
+				LoadId loadId;
+				Nz::UInt64 contentHash;
+				Nz::Vector3ui size;
+			};
+
+			struct StoreRequest
+			{
+				Nz::Vector3ui size;
+				std::vector<BlockIndex> content;
+			};
+
+			struct LoadResult
+			{
+				LoadId loadId;
+				std::optional<std::vector<BlockIndex>> content;
+			};
+
+			using Operation = std::variant<LoadRequest, StoreRequest>;
+
+			void BuildIndex();
+			void EvictEntries();
+			std::filesystem::path GetEntryPath(Nz::UInt64 contentHash) const;
+			std::optional<std::vector<BlockIndex>> LoadEntry(const LoadRequest& request);
+			void PushOperation(Operation&& operation);
+			void RemoveEntry(Nz::UInt64 contentHash);
+			void StoreEntry(const StoreRequest& request);
+			void WorkerThread();
+
+			std::condition_variable m_idleCondition;
+			std::condition_variable m_operationCondition;
+			std::deque<Operation> m_operations;
+			std::filesystem::path m_cacheDirectory;
+			std::mutex m_operationMutex;
+			std::mutex m_resultMutex;
+			mutable std::mutex m_indexMutex;
+			std::size_t m_maxEntryCount;
+			std::thread m_thread;
+			std::vector<LoadResult> m_loadResults;
+			tsl::hopscotch_map<Nz::UInt64, EntryList::iterator> m_entryByHash;
+			EntryList m_entries;
+			LoadId m_nextLoadId;
+			bool m_isProcessing;
+			bool m_running;
+	};
+}
+
+#include <CommonLib/ChunkContentCache.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKCONTENTCACHE_HPP
@@ -0,0 +1,16 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline const std::filesystem::path& ChunkContentCache::GetDirectory() const
+	{
+		return m_cacheDirectory;
+	}
+
+	inline std::size_t ChunkContentCache::GetMaxEntryCount() const
+	{
+		return m_maxEntryCount;
+	}
+}
@@ -34,6 +34,8 @@ namespace tsom
 			ChunkEntities(ChunkEntities&&) = delete;
 			~ChunkEntities();
 
+			inline std::size_t GetPendingJobCount() const;
+
 			void SetParentEntity(entt::handle entity);
 
 			void Update();
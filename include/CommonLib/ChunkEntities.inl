@@ -4,6 +4,11 @@
 
 namespace tsom
 {
+	inline std::size_t ChunkEntities::GetPendingJobCount() const
+	{
+		return m_updateJobs.size();
+	}
+
 	inline void ChunkEntities::UpdateChunkEntity(const ChunkIndices& chunkIndices, DirectionMask neighborMask)
 	{
 		assert(m_chunkEntities.contains(chunkIndices));
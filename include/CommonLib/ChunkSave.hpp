@@ -0,0 +1,53 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKSAVE_HPP
+#define TSOM_COMMONLIB_CHUNKSAVE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+
+namespace Nz
+{
+	class ByteStream;
+}
+
+namespace tsom
+{
+	class Chunk;
+
+	enum class ChunkSaveFormat : Nz::UInt8
+	{
+		Full  = 0, //< whole chunk content
+		Delta = 1  //< blocks differing from the generated chunk
+	};
+
+	// Generator parameters delta chunks were saved against, they can only be loaded back if the generator reproduces the same chunks
+	struct PlanetSaveHeader
+	{
+		Nz::UInt32 generatorVersion;
+		Nz::UInt32 seed;
+		Nz::Vector3ui chunkCount;
+
+		inline bool operator==(const PlanetSaveHeader& header) const;
+	};
+
+	// Above this ratio of changed blocks, storing the whole chunk is smaller than storing its delta
+	constexpr float ChunkDeltaMaxDensity = 0.25f;
+
+	// regenerateChunk returns false when the chunk can't be generated as it was when the delta was saved, the delta is refused in this case
+	TSOM_COMMONLIB_API ChunkSaveFormat LoadChunk(Nz::ByteStream& byteStream, Chunk& chunk, const Nz::FunctionRef<bool(Chunk& chunk)>& regenerateChunk);
+	TSOM_COMMONLIB_API PlanetSaveHeader LoadPlanetSaveHeader(Nz::ByteStream& byteStream);
+	TSOM_COMMONLIB_API ChunkSaveFormat SaveChunk(Nz::ByteStream& byteStream, const Chunk& chunk, const Chunk& generatedChunk, float maxDeltaDensity = ChunkDeltaMaxDensity);
+	TSOM_COMMONLIB_API void SaveFullChunk(Nz::ByteStream& byteStream, const Chunk& chunk);
+	TSOM_COMMONLIB_API void SavePlanetSaveHeader(Nz::ByteStream& byteStream, const PlanetSaveHeader& header);
+}
+
+#include <CommonLib/ChunkSave.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKSAVE_HPP
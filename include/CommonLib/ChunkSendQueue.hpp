@@ -0,0 +1,95 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKSENDQUEUE_HPP
+#define TSOM_COMMONLIB_CHUNKSENDQUEUE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <limits>
+#include <vector>
+
+namespace tsom
+{
+	class ChunkSnapshot;
+
+	enum class ChunkVisibilityHint
+	{
+		Buried,  //< chunk is full of blocks, it's unlikely to be visible
+		Empty,   //< chunk has no block, there's nothing to display
+		Surface  //< chunk has both empty and non-empty blocks
+	};
+
+	// Priority queue of chunks waiting to be sent to a client, lower scores (close, in front of the viewer, visible) are sent first
+	class TSOM_COMMONLIB_API ChunkSendQueue
+	{
+		public:
+			ChunkSendQueue() = default;
+			ChunkSendQueue(const ChunkSendQueue&) = delete;
+			ChunkSendQueue(ChunkSendQueue&&) = delete;
+			~ChunkSendQueue() = default;
+
+			inline void Clear();
+
+			inline bool Contains(std::size_t chunkIndex) const;
+
+			void Erase(std::size_t chunkIndex);
+
+			inline std::size_t GetPendingCount() const;
+			inline std::size_t GetTop() const;
+
+			inline bool IsEmpty() const;
+
+			std::size_t Pop();
+			void Push(std::size_t chunkIndex, const Nz::Vector3f& chunkCenter, ChunkVisibilityHint visibilityHint);
+
+			void Update(const Nz::Vector3f& viewerPosition, const Nz::Vector3f& viewerDirection);
+
+			ChunkSendQueue& operator=(const ChunkSendQueue&) = delete;
+			ChunkSendQueue& operator=(ChunkSendQueue&&) = delete;
+
+			static ChunkVisibilityHint ComputeVisibilityHint(const ChunkSnapshot& snapshot);
+
+			static constexpr double AgingRate = 2.0; //< how much a chunk waiting for one more tick is favored (in distance units)
+			static constexpr float BehindPenalty = 1.f; //< chunks right behind the viewer are considered (1 + BehindPenalty) times farther
+			static constexpr float BuriedPenalty = 3.f;
+			static constexpr float EmptyPenalty = 1.5f;
+			static constexpr float RescoreDirectionThreshold = 0.96f; //< cosine of the view angle change (~15°) triggering a rescore
+			static constexpr float RescoreDistance = 8.f;
+
+		private:
+			double ComputeScore(const Nz::Vector3f& chunkCenter, ChunkVisibilityHint visibilityHint, Nz::UInt64 enqueueTick) const;
+			void Rescore();
+			void SiftDown(std::size_t heapIndex);
+			void SiftUp(std::size_t heapIndex);
+			inline void SwapEntries(std::size_t heapIndexA, std::size_t heapIndexB);
+
+			static constexpr std::size_t InvalidHeapIndex = std::numeric_limits<std::size_t>::max();
+
+			struct Entry
+			{
+				std::size_t chunkIndex;
+				double score;
+				ChunkVisibilityHint visibilityHint;
+				Nz::UInt64 enqueueTick;
+				Nz::Vector3f chunkCenter;
+			};
+
+			std::vector<Entry> m_heap;
+			std::vector<std::size_t> m_heapIndices; //< indexed by chunk index
+			Nz::UInt64 m_currentTick = 0;
+			Nz::Vector3f m_scoredViewerDirection = Nz::Vector3f::Zero();
+			Nz::Vector3f m_scoredViewerPosition = Nz::Vector3f::Zero();
+			Nz::Vector3f m_viewerDirection = Nz::Vector3f::Zero();
+			Nz::Vector3f m_viewerPosition = Nz::Vector3f::Zero();
+			bool m_hasViewer = false;
+	};
+}
+
+#include <CommonLib/ChunkSendQueue.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKSENDQUEUE_HPP
@@ -0,0 +1,43 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+#include <utility>
+
+namespace tsom
+{
+	inline void ChunkSendQueue::Clear()
+	{
+		m_heap.clear();
+		m_heapIndices.clear();
+	}
+
+	inline bool ChunkSendQueue::Contains(std::size_t chunkIndex) const
+	{
+		return chunkIndex < m_heapIndices.size() && m_heapIndices[chunkIndex] != InvalidHeapIndex;
+	}
+
+	inline std::size_t ChunkSendQueue::GetPendingCount() const
+	{
+		return m_heap.size();
+	}
+
+	inline std::size_t ChunkSendQueue::GetTop() const
+	{
+		assert(!m_heap.empty());
+		return m_heap.front().chunkIndex;
+	}
+
+	inline bool ChunkSendQueue::IsEmpty() const
+	{
+		return m_heap.empty();
+	}
+
+	inline void ChunkSendQueue::SwapEntries(std::size_t heapIndexA, std::size_t heapIndexB)
+	{
+		std::swap(m_heap[heapIndexA], m_heap[heapIndexB]);
+		m_heapIndices[m_heap[heapIndexA].chunkIndex] = heapIndexA;
+		m_heapIndices[m_heap[heapIndexB].chunkIndex] = heapIndexB;
+	}
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKSNAPSHOT_HPP
+#define TSOM_COMMONLIB_CHUNKSNAPSHOT_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/Direction.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/Bitset.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace tsom
+{
+	// Blocks of a chunk face, along the two other axes (see Chunk::GetBorderSliceIndex)
+	// Border slices are immutable once published and shared between the chunk and its snapshots
+	using BorderSlice = std::vector<BlockIndex>;
+
+	// Immutable copy of a chunk content at a given revision, can be read from any thread without locking the chunk
+	class TSOM_COMMONLIB_API ChunkSnapshot
+	{
+		public:
+			inline ChunkSnapshot(Nz::UInt64 revision, const Nz::Vector3ui& size, std::vector<BlockIndex> blocks, std::vector<Nz::UInt16> blockTypeCount, Nz::Bitset<Nz::UInt64> collisionCellMask, Nz::EnumArray<Direction, std::shared_ptr<const BorderSlice>> borderSlices);
+			ChunkSnapshot(const ChunkSnapshot&) = delete;
+			ChunkSnapshot(ChunkSnapshot&&) = delete;
+			~ChunkSnapshot() = default;
+
+			inline BlockIndex GetBlockContent(unsigned int blockIndex) const;
+			inline BlockIndex GetBlockContent(const Nz::Vector3ui& indices) const;
+			inline std::size_t GetBlockCount() const;
+			inline unsigned int GetBlockLocalIndex(const Nz::Vector3ui& indices) const;
+			inline const std::vector<Nz::UInt16>& GetBlockTypeCount() const;
+			inline const BorderSlice& GetBorderSlice(Direction direction) const;
+			inline const Nz::Bitset<Nz::UInt64>& GetCollisionCellMask() const;
+			std::optional<std::span<const Nz::UInt8>> GetCompressedContent(const CompressionProfile& profile, bool useFrame) const;
+			inline const BlockIndex* GetContent() const;
+			Nz::UInt64 GetContentHash() const;
+			inline Nz::UInt64 GetRevision() const;
+			inline const Nz::Vector3ui& GetSize() const;
+
+			inline bool HasContent() const;
+
+			ChunkSnapshot& operator=(const ChunkSnapshot&) = delete;
+			ChunkSnapshot& operator=(ChunkSnapshot&&) = delete;
+
+			static Nz::UInt64 ComputeContentHash(const Nz::Vector3ui& size, const BlockIndex* blocks);
+
+		private:
+			struct CompressedContent
+			{
+				CompressionCodec codec;
+				int acceleration;
+				int level;
+				Nz::UInt32 dictionaryId;
+				bool isFrame;
+				std::vector<Nz::UInt8> data;
+			};
+
+			Nz::EnumArray<Direction, std::shared_ptr<const BorderSlice>> m_borderSlices;
+			std::vector<BlockIndex> m_blocks;
+			std::vector<Nz::UInt16> m_blockTypeCount;
+			Nz::Bitset<Nz::UInt64> m_collisionCellMask;
+			mutable std::mutex m_compressedContentMutex;
+			mutable std::vector<std::unique_ptr<CompressedContent>> m_compressedContents;
+			mutable std::once_flag m_contentHashFlag;
+			mutable Nz::UInt64 m_contentHash;
+			Nz::UInt64 m_revision;
+			Nz::Vector3ui m_size;
+	};
+}
+
+#include <CommonLib/ChunkSnapshot.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKSNAPSHOT_HPP
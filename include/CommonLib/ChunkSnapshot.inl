@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+
+namespace tsom
+{
+	inline ChunkSnapshot::ChunkSnapshot(Nz::UInt64 revision, const Nz::Vector3ui& size, std::vector<BlockIndex> blocks, std::vector<Nz::UInt16> blockTypeCount, Nz::Bitset<Nz::UInt64> collisionCellMask, Nz::EnumArray<Direction, std::shared_ptr<const BorderSlice>> borderSlices) :
+	m_borderSlices(std::move(borderSlices)),
+	m_blocks(std::move(blocks)),
+	m_blockTypeCount(std::move(blockTypeCount)),
+	m_collisionCellMask(std::move(collisionCellMask)),
+	m_contentHash(0),
+	m_revision(revision),
+	m_size(size)
+	{
+	}
+
+	inline BlockIndex ChunkSnapshot::GetBlockContent(unsigned int blockIndex) const
+	{
+		assert(!m_blocks.empty());
+		return m_blocks[blockIndex];
+	}
+
+	inline BlockIndex ChunkSnapshot::GetBlockContent(const Nz::Vector3ui& indices) const
+	{
+		return GetBlockContent(GetBlockLocalIndex(indices));
+	}
+
+	inline std::size_t ChunkSnapshot::GetBlockCount() const
+	{
+		return m_blocks.size();
+	}
+
+	inline unsigned int ChunkSnapshot::GetBlockLocalIndex(const Nz::Vector3ui& indices) const
+	{
+		assert(indices.x < m_size.x);
+		assert(indices.y < m_size.y);
+		assert(indices.z < m_size.z);
+
+		return m_size.x * (m_size.y * indices.z + indices.y) + indices.x;
+	}
+
+	inline const std::vector<Nz::UInt16>& ChunkSnapshot::GetBlockTypeCount() const
+	{
+		return m_blockTypeCount;
+	}
+
+	inline const BorderSlice& ChunkSnapshot::GetBorderSlice(Direction direction) const
+	{
+		assert(m_borderSlices[direction]);
+		return *m_borderSlices[direction];
+	}
+
+	inline const Nz::Bitset<Nz::UInt64>& ChunkSnapshot::GetCollisionCellMask() const
+	{
+		return m_collisionCellMask;
+	}
+
+	inline const BlockIndex* ChunkSnapshot::GetContent() const
+	{
+		assert(!m_blocks.empty());
+		return m_blocks.data();
+	}
+
+	inline Nz::UInt64 ChunkSnapshot::GetRevision() const
+	{
+		return m_revision;
+	}
+
+	inline const Nz::Vector3ui& ChunkSnapshot::GetSize() const
+	{
+		return m_size;
+	}
+
+	inline bool ChunkSnapshot::HasContent() const
+	{
+		return !m_blocks.empty();
+	}
+}
@@ -8,6 +8,7 @@
 #define TSOM_COMMONLIB_COMPONENTS_SCRIPTEDENTITYCOMPONENT_HPP
 
 #include <CommonLib/Export.hpp>
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
 #include <sol/table.hpp>
 
 namespace tsom
@@ -16,6 +17,8 @@ namespace tsom
 	{
 		sol::table classMetatable;
 		sol::table entityTable;
+		ScriptCpuStats cpuStats;
+		ScriptCpuStats* classCpuStats = nullptr;
 	};
 }
 
@@ -0,0 +1,69 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CONGESTIONCONTROLLER_HPP
+#define TSOM_COMMONLIB_CONGESTIONCONTROLLER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <atomic>
+#include <optional>
+
+namespace tsom
+{
+	// Controls how many bytes of bulk data can be in flight (sent but not yet acknowledged) for a peer
+	class TSOM_COMMONLIB_API CongestionController
+	{
+		public:
+			CongestionController();
+			CongestionController(const CongestionController&) = delete;
+			CongestionController(CongestionController&&) = delete;
+			~CongestionController() = default;
+
+			inline bool CanSend(std::size_t byteCount);
+
+			inline Nz::UInt64 GetBandwidthEstimate() const;
+			inline std::size_t GetInFlightBytes() const;
+			inline Nz::Time GetMinRoundTripTime() const;
+			inline std::size_t GetWindowSize() const;
+
+			inline void OnAcknowledged(std::size_t byteCount);
+			inline void OnSent(std::size_t byteCount);
+
+			void Update(Nz::Time now, const NetworkReactor::PeerInfo& peerInfo);
+
+			CongestionController& operator=(const CongestionController&) = delete;
+			CongestionController& operator=(CongestionController&&) = delete;
+
+			static constexpr std::size_t InitialWindowSize = 64 * 1024;
+			static constexpr std::size_t MinWindowSize = 16 * 1024;
+			static constexpr std::size_t MaxWindowSize = 16 * 1024 * 1024;
+			static constexpr std::size_t WindowGrowthStep = 16 * 1024; //< window growth per window acknowledged, after slow start
+			static constexpr float MaxLossRatio = 0.02f;
+			static constexpr Nz::Time MinRoundTripTimeLifetime = Nz::Time::Seconds(10);
+			static constexpr Nz::Time QueueingDelayTolerance = Nz::Time::Milliseconds(30);
+
+		private:
+			std::atomic_size_t m_acknowledgedBytes;
+			std::atomic_size_t m_inFlightBytes;
+			std::optional<Nz::Time> m_lastUpdate;
+			std::size_t m_windowSize;
+			Nz::Time m_lastDecrease;
+			Nz::Time m_minRoundTripTime;
+			Nz::Time m_minRoundTripTimeExpiration;
+			Nz::Time m_periodMinRoundTripTime;
+			Nz::UInt32 m_lastTotalPacketLost;
+			Nz::UInt32 m_lastTotalPacketSent;
+			Nz::UInt64 m_bandwidthEstimate;
+			bool m_isSlowStart;
+			bool m_isWindowLimited;
+	};
+}
+
+#include <CommonLib/CongestionController.inl>
+
+#endif // TSOM_COMMONLIB_CONGESTIONCONTROLLER_HPP
@@ -0,0 +1,51 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline bool CongestionController::CanSend(std::size_t byteCount)
+	{
+		// Always allow one packet in flight, even if it's bigger than the window
+		std::size_t inFlightBytes = m_inFlightBytes.load(std::memory_order_relaxed);
+		if (inFlightBytes == 0 || inFlightBytes + byteCount <= m_windowSize)
+			return true;
+
+		m_isWindowLimited = true;
+		return false;
+	}
+
+	inline Nz::UInt64 CongestionController::GetBandwidthEstimate() const
+	{
+		return m_bandwidthEstimate;
+	}
+
+	inline std::size_t CongestionController::GetInFlightBytes() const
+	{
+		return m_inFlightBytes.load(std::memory_order_relaxed);
+	}
+
+	inline Nz::Time CongestionController::GetMinRoundTripTime() const
+	{
+		return m_minRoundTripTime;
+	}
+
+	inline std::size_t CongestionController::GetWindowSize() const
+	{
+		return m_windowSize;
+	}
+
+	/*
+	* Acknowledgments are received on the network thread
+	*/
+	inline void CongestionController::OnAcknowledged(std::size_t byteCount)
+	{
+		m_acknowledgedBytes.fetch_add(byteCount, std::memory_order_relaxed);
+		m_inFlightBytes.fetch_sub(byteCount, std::memory_order_relaxed);
+	}
+
+	inline void CongestionController::OnSent(std::size_t byteCount)
+	{
+		m_inFlightBytes.fetch_add(byteCount, std::memory_order_relaxed);
+	}
+}
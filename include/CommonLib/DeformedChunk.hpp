@@ -7,11 +7,13 @@
 #ifndef TSOM_COMMONLIB_DEFORMEDCHUNK_HPP
 #define TSOM_COMMONLIB_DEFORMEDCHUNK_HPP
 
+#include <CommonLib/Export.hpp>
 #include <CommonLib/Chunk.hpp>
+#include <vector>
 
 namespace tsom
 {
-	class DeformedChunk : public Chunk
+	class TSOM_COMMONLIB_API DeformedChunk : public Chunk
 	{
 		public:
 			inline DeformedChunk(const BlockLibrary& blockLibrary, ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float cellSize, const Nz::Vector3f& deformationCenter, float deformationRadius);
@@ -20,6 +22,7 @@ namespace tsom
 			~DeformedChunk() = default;
 
 			std::shared_ptr<Nz::Collider3D> BuildCollider() const override;
+			void BuildCollisionMesh(std::vector<Nz::Vector3f>& positions, std::vector<Nz::UInt32>& indices) const;
 
 			std::optional<Nz::Vector3ui> ComputeCoordinates(const Nz::Vector3f& position) const override;
 			Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> ComputeVoxelCorners(const Nz::Vector3ui& indices) const override;
@@ -32,6 +35,8 @@ namespace tsom
 			DeformedChunk& operator=(DeformedChunk&&) = delete;
 
 		private:
+			bool IsUndeformed(const Nz::Vector3f& position) const;
+
 			Nz::Vector3f m_deformationCenter;
 			float m_deformationRadius;
 	};
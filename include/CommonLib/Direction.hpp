@@ -80,6 +80,15 @@ namespace tsom
 		Nz::Vector3i {  0,  0,  1 }, //< Up
 	};
 
+	constexpr Nz::EnumArray<Direction, Direction> s_dirOpposite = {
+		Direction::Front, //< Back
+		Direction::Up,    //< Down
+		Direction::Back,  //< Front
+		Direction::Right, //< Left
+		Direction::Left,  //< Right
+		Direction::Down,  //< Up
+	};
+
 	constexpr Nz::EnumArray<Direction, Nz::Vector3i> s_chunkDirOffset = {
 		Nz::Vector3i {  0,  0,  1 }, //< Back
 		Nz::Vector3i {  0, -1,  0 }, //< Down
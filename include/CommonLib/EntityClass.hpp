@@ -9,6 +9,7 @@
 
 #include <CommonLib/Export.hpp>
 #include <CommonLib/EntityProperties.hpp>
+#include <Nazara/Core/Time.hpp>
 #include <entt/fwd.hpp>
 #include <tsl/hopscotch_map.h>
 #include <functional>
@@ -57,6 +58,7 @@ namespace tsom
 				EntityProperty defaultValue;
 				bool isArray;
 				bool isNetworked;
+				Nz::Time sendInterval = Nz::Time::Zero(); //< minimum time between two network updates, zero to send changes every tick
 			};
 
 			struct RemoteProcedureCall
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_ENTITYPROPERTYTRACKER_HPP
+#define TSOM_COMMONLIB_ENTITYPROPERTYTRACKER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <NazaraUtils/Bitset.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <entt/entt.hpp>
+#include <tsl/hopscotch_map.h>
+#include <tsl/hopscotch_set.h>
+#include <vector>
+
+namespace tsom
+{
+	// Collects networked property changes during a tick so only the latest values are sent, at most once per tick (or per send interval)
+	class TSOM_COMMONLIB_API EntityPropertyTracker
+	{
+		public:
+			using FlushCallback = Nz::FunctionRef<void(entt::entity entity, const Nz::Bitset<Nz::UInt64>& properties)>;
+
+			EntityPropertyTracker() = default;
+			EntityPropertyTracker(const EntityPropertyTracker&) = delete;
+			EntityPropertyTracker(EntityPropertyTracker&&) = delete;
+			~EntityPropertyTracker() = default;
+
+			void Flush(Nz::Time currentTime, const FlushCallback& callback);
+
+			void Forget(entt::entity entity);
+
+			inline bool HasPendingUpdates() const;
+
+			void MarkDirty(entt::entity entity, Nz::UInt32 propertyIndex, Nz::Time sendInterval);
+
+			EntityPropertyTracker& operator=(const EntityPropertyTracker&) = delete;
+			EntityPropertyTracker& operator=(EntityPropertyTracker&&) = delete;
+
+		private:
+			struct PropertyTiming
+			{
+				Nz::Time nextSendTime = Nz::Time::Zero();
+				Nz::Time sendInterval = Nz::Time::Zero();
+			};
+
+			struct EntityData
+			{
+				Nz::Bitset<Nz::UInt64> dirtyProperties;
+				std::vector<PropertyTiming> propertyTimings; //< only filled for entities with rate-limited properties
+			};
+
+			tsl::hopscotch_map<entt::entity, EntityData> m_entities;
+			tsl::hopscotch_set<entt::entity> m_dirtyEntities;
+			Nz::Bitset<Nz::UInt64> m_sendMask;
+	};
+}
+
+#include <CommonLib/EntityPropertyTracker.inl>
+
+#endif // TSOM_COMMONLIB_ENTITYPROPERTYTRACKER_HPP
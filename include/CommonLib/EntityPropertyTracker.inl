@@ -0,0 +1,11 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline bool EntityPropertyTracker::HasPendingUpdates() const
+	{
+		return !m_dirtyEntities.empty();
+	}
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_ENTITYSTATETRACKER_HPP
+#define TSOM_COMMONLIB_ENTITYSTATETRACKER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <vector>
+
+namespace tsom
+{
+	// Keeps track of the last entity states sent to a session to skip updates of entities which didn't move since
+	class TSOM_COMMONLIB_API EntityStateTracker
+	{
+		public:
+			using EntityId = Packets::Helper::EntityId;
+			using EntityState = Packets::Helper::EntityState;
+
+			inline EntityStateTracker(Nz::UInt16 heartbeatInterval = DefaultHeartbeatInterval);
+			EntityStateTracker(const EntityStateTracker&) = delete;
+			EntityStateTracker(EntityStateTracker&&) = delete;
+			~EntityStateTracker() = default;
+
+			inline Nz::UInt16 GetHeartbeatInterval() const;
+
+			inline void Invalidate(EntityId entityId);
+
+			void Reset(EntityId entityId, Nz::UInt16 tickIndex, const EntityState& state);
+
+			bool ShouldSend(EntityId entityId, Nz::UInt16 tickIndex, const EntityState& state, bool isSleeping);
+
+			EntityStateTracker& operator=(const EntityStateTracker&) = delete;
+			EntityStateTracker& operator=(EntityStateTracker&&) = delete;
+
+			static constexpr Nz::UInt16 DefaultHeartbeatInterval = 60; //< states are sent at least once per second (at 60Hz) to cover for unreliable packet loss
+			static constexpr float PositionEpsilon = 0.001f;
+			static constexpr float RotationEpsilon = 1e-6f; //< 1 - |dot(q1, q2)|, about 0.15 degree
+
+		private:
+			struct SentState
+			{
+				EntityState state;
+				Nz::UInt16 tickIndex;
+				bool isSleeping; //< resting state was sent since the entity fell asleep
+				bool isValid;
+			};
+
+			std::vector<SentState> m_sentStates;
+			Nz::UInt16 m_heartbeatInterval;
+	};
+}
+
+#include <CommonLib/EntityStateTracker.inl>
+
+#endif // TSOM_COMMONLIB_ENTITYSTATETRACKER_HPP
@@ -0,0 +1,22 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline EntityStateTracker::EntityStateTracker(Nz::UInt16 heartbeatInterval) :
+	m_heartbeatInterval(heartbeatInterval)
+	{
+	}
+
+	inline Nz::UInt16 EntityStateTracker::GetHeartbeatInterval() const
+	{
+		return m_heartbeatInterval;
+	}
+
+	inline void EntityStateTracker::Invalidate(EntityId entityId)
+	{
+		if (entityId < m_sentStates.size())
+			m_sentStates[entityId].isValid = false;
+	}
+}
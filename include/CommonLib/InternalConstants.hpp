@@ -14,13 +14,24 @@
 
 namespace tsom::Constants
 {
+	// Compression constants
+	constexpr Nz::UInt32 ChunkCompressionDictionaryId = 1; //< bump when retraining the dictionary, frames referencing another id are rejected
+	constexpr std::string_view ChunkCompressionDictionaryPath = "data/chunks_v1.tsdict";
+
 	// Network constants
-	constexpr Nz::UInt32 NetworkChannelCount = 3;
+	constexpr std::size_t BulkFragmentMaxSize = 1024; //< fits in a single ENet datagram
+	constexpr std::size_t BulkTransferMaxSize = 16 * 1024 * 1024;
+	constexpr Nz::UInt32 NetworkChannelCount = 4;
+	constexpr Nz::UInt32 ProtocolBatchedPropertyUpdateVersion = BuildVersion(0, 6, 0);
+	constexpr Nz::UInt32 ProtocolBulkTransferVersion = BuildVersion(0, 6, 0);
+	constexpr Nz::UInt32 ProtocolChunkCacheVersion = BuildVersion(0, 6, 0);
+	constexpr Nz::UInt32 ProtocolChunkUpdateRunsVersion = BuildVersion(0, 6, 0);
+	constexpr Nz::UInt32 ProtocolCompressionFrameVersion = BuildVersion(0, 6, 0);
 	constexpr Nz::UInt32 ProtocolRequiredClientVersion = BuildVersion(0, 5, 0);
 	constexpr Nz::Time TickDuration = Nz::Time::TickDuration(60);
 
 	// Serialization constants
-	constexpr Nz::UInt32 ChunkBinaryVersion = 1;
+	constexpr Nz::UInt32 ChunkBinaryVersion = 2;
 }
 
 #endif // TSOM_COMMONLIB_INTERNALCONSTANTS_HPP
@@ -12,6 +12,7 @@
 #include <concurrentqueue.h>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <thread>
 #include <variant>
 #include <vector>
@@ -25,13 +26,15 @@ namespace tsom
 		Normal  // Disconnect
 	};
 
+	class MetricsRegistry;
+
 	class TSOM_COMMONLIB_API NetworkReactor
 	{
 		public:
 			struct PeerInfo;
 			using PeerInfoCallback = std::function<void(PeerInfo& peerInfo)>;
 
-			NetworkReactor(std::size_t idOffset, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient);
+			NetworkReactor(std::size_t idOffset, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient); //< port 0 binds an ephemeral port on loopback only
 			NetworkReactor(const NetworkReactor&) = delete;
 			NetworkReactor(NetworkReactor&&) = delete;
 			~NetworkReactor();
@@ -39,7 +42,13 @@ namespace tsom
 			std::size_t ConnectTo(Nz::IpAddress address, Nz::UInt32 data = 0);
 			void DisconnectPeer(std::size_t peerId, Nz::UInt32 data = 0, DisconnectionType type = DisconnectionType::Normal);
 
+			void EnableFakePeers(); //< peers which aren't connected acknowledge packets right away and answer info queries, used to replay recorded sessions
+			void EnableMetrics(MetricsRegistry& metricsRegistry); //< counts sent packets on the SendData caller thread and received packets on the reactor thread
+
+			inline Nz::UInt16 GetBoundPort() const;
 			inline std::size_t GetIdOffset() const;
+			inline std::size_t GetIncomingQueueSize() const;
+			inline std::size_t GetOutgoingQueueSize() const;
 			inline Nz::NetProtocol GetProtocol() const;
 
 			template<typename ConnectCB, typename DisconnectCB, typename DataCB>
@@ -66,12 +75,16 @@ namespace tsom
 			static constexpr std::size_t InvalidPeerId = std::numeric_limits<std::size_t>::max();
 
 		private:
+			struct TrafficCounters;
+
 			void EnsureProperDisconnection(const moodycamel::ProducerToken& producterToken, moodycamel::ConsumerToken& token);
 			void HandleConnectionRequests(moodycamel::ConsumerToken& token);
 			void ReceivePackets(const moodycamel::ProducerToken& producterToken);
 			void SendPackets(const moodycamel::ProducerToken& producterToken, moodycamel::ConsumerToken& token);
 			void WorkerThread();
 
+			static void CountTraffic(const TrafficCounters* trafficCounters, bool outgoing, const Nz::ByteArray& payload);
+
 			struct ConnectionRequest
 			{
 				using Callback = std::function<void(std::size_t clientId)>;
@@ -136,15 +149,19 @@ namespace tsom
 				std::variant<DisconnectEvent, PacketEvent, QueryPeerInfo> data;
 			};
 
+			std::atomic<const TrafficCounters*> m_trafficCountersPtr;
+			std::atomic_bool m_fakePeersEnabled;
 			std::atomic_bool m_running;
 			std::size_t m_idOffset;
 			std::thread m_thread;
+			std::unique_ptr<TrafficCounters> m_trafficCounters;
 			std::vector<Nz::ENetPeer*> m_clients;
 			moodycamel::ConcurrentQueue<ConnectionRequest> m_connectionRequests;
 			moodycamel::ConcurrentQueue<IncomingEvent> m_incomingQueue;
 			moodycamel::ConcurrentQueue<OutgoingEvent> m_outgoingQueue;
 			Nz::ENetHost m_host;
 			Nz::NetProtocol m_protocol;
+			Nz::UInt16 m_boundPort;
 	};
 }
 
@@ -4,11 +4,26 @@
 
 namespace tsom
 {
+	inline Nz::UInt16 NetworkReactor::GetBoundPort() const
+	{
+		return m_boundPort;
+	}
+
 	inline std::size_t NetworkReactor::GetIdOffset() const
 	{
 		return m_idOffset;
 	}
 
+	inline std::size_t NetworkReactor::GetIncomingQueueSize() const
+	{
+		return m_incomingQueue.size_approx();
+	}
+
+	inline std::size_t NetworkReactor::GetOutgoingQueueSize() const
+	{
+		return m_outgoingQueue.size_approx();
+	}
+
 	inline Nz::NetProtocol NetworkReactor::GetProtocol() const
 	{
 		return m_protocol;
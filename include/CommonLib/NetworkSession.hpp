@@ -11,41 +11,56 @@
 #include <CommonLib/NetworkReactor.hpp>
 #include <CommonLib/SessionHandler.hpp>
 #include <CommonLib/Protocol/NetworkStringStore.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <Nazara/Core/ByteArray.hpp>
 #include <Nazara/Network/ENetPacket.hpp>
 #include <Nazara/Network/IpAddress.hpp>
-
-namespace Nz
-{
-	class ByteArray;
-}
+#include <functional>
+#include <vector>
 
 namespace tsom
 {
 	class TSOM_COMMONLIB_API NetworkSession
 	{
 		public:
+			struct BufferedPacket;
+
 			NetworkSession(NetworkReactor& reactor, std::size_t peerId, const Nz::IpAddress& remoteAddress);
 			NetworkSession(const NetworkSession&) = delete;
 			NetworkSession(NetworkSession&&) = delete;
 			~NetworkSession();
 
+			inline void BeginPacketBuffering();
+
 			void Disconnect(DisconnectionType type = DisconnectionType::Normal);
 
+			inline void EnableChunkContentCache(bool enable);
+
+			void FlushBufferedPackets();
+
+			inline const std::vector<BufferedPacket>& GetBufferedPackets() const;
+
+			inline const CompressionProfile& GetCompressionProfile() const;
 			inline std::size_t GetPeerId() const;
 			inline Nz::UInt32 GetProtocolVersion() const;
 			inline SessionHandler* GetSessionHandler();
 			inline NetworkStringStore& GetStringStore();
 			inline const NetworkStringStore& GetStringStore() const;
 
+			inline bool IsBufferingPackets() const;
+			inline bool IsChunkContentCacheEnabled() const;
 			inline bool IsConnected() const;
 
 			void HandlePacket(Nz::ByteArray&& byteArray);
 
 			void QueryInfo(NetworkReactor::PeerInfoCallback callback);
 
-			template<typename T> void SendPacket(const T& packet, std::function<void()> acknowledgeCallback = {});
+			template<typename T> std::size_t SendPacket(const T& packet, std::function<void()> acknowledgeCallback = {});
+			template<typename T> std::size_t SendPacket(const T& packet, std::function<void(std::size_t packetSize)> acknowledgeCallback);
+			template<typename T> Nz::ByteArray SerializePacket(const T& packet);
 
 			SessionHandler& SetHandler(std::unique_ptr<SessionHandler>&& sessionHandler);
+			inline void SetCompressionProfile(CompressionProfile compressionProfile);
 			inline void SetProtocolVersion(Nz::UInt32 protocolVersion);
 
 			template<typename T, typename... Args> T& SetupHandler(Args&&... args);
@@ -53,13 +68,27 @@ namespace tsom
 			NetworkSession& operator=(const NetworkSession&) = delete;
 			NetworkSession& operator=(NetworkSession&&) = delete;
 
+			struct BufferedPacket
+			{
+				Nz::ByteArray payload;
+				Nz::ENetPacketFlags flags;
+				Nz::UInt8 channel;
+				std::function<void()> acknowledgeCallback;
+			};
+
 		private:
+			void SendData(Nz::UInt8 channel, Nz::ENetPacketFlags flags, Nz::ByteArray&& payload, std::function<void()> acknowledgeCallback);
+
 			std::size_t m_peerId;
 			std::unique_ptr<SessionHandler> m_sessionHandler;
+			std::vector<BufferedPacket> m_bufferedPackets;
+			CompressionProfile m_compressionProfile;
 			Nz::IpAddress m_remoteAddress;
 			Nz::UInt32 m_protocolVersion;
 			NetworkReactor& m_reactor;
 			NetworkStringStore m_stringStore;
+			bool m_isBufferingPackets;
+			bool m_isChunkContentCacheEnabled;
 	};
 }
 
@@ -7,6 +7,26 @@
 
 namespace tsom
 {
+	inline void NetworkSession::BeginPacketBuffering()
+	{
+		m_isBufferingPackets = true;
+	}
+
+	inline void NetworkSession::EnableChunkContentCache(bool enable)
+	{
+		m_isChunkContentCacheEnabled = enable;
+	}
+
+	inline auto NetworkSession::GetBufferedPackets() const -> const std::vector<BufferedPacket>&
+	{
+		return m_bufferedPackets;
+	}
+
+	inline const CompressionProfile& NetworkSession::GetCompressionProfile() const
+	{
+		return m_compressionProfile;
+	}
+
 	inline std::size_t NetworkSession::GetPeerId() const
 	{
 		return m_peerId;
@@ -32,28 +52,54 @@ namespace tsom
 		return m_stringStore;
 	}
 
+	inline bool NetworkSession::IsBufferingPackets() const
+	{
+		return m_isBufferingPackets;
+	}
+
+	inline bool NetworkSession::IsChunkContentCacheEnabled() const
+	{
+		return m_isChunkContentCacheEnabled;
+	}
+
 	inline bool NetworkSession::IsConnected() const
 	{
 		return m_peerId != NetworkReactor::InvalidPeerId;
 	}
 
 	template<typename T>
-	void NetworkSession::SendPacket(const T& packet, std::function<void()> acknowledgeCallback)
+	std::size_t NetworkSession::SendPacket(const T& packet, std::function<void()> acknowledgeCallback)
 	{
-		static_assert(PacketCount < 0xFF);
+		const SessionHandler::SendAttributes& sendAttributes = m_sessionHandler->GetPacketAttributes<T>();
+
+		Nz::ByteArray byteArray = SerializePacket(packet);
+		std::size_t packetSize = byteArray.GetSize();
+
+		SendData(sendAttributes.channel, sendAttributes.flags, std::move(byteArray), std::move(acknowledgeCallback));
 
+		return packetSize;
+	}
+
+	template<typename T>
+	std::size_t NetworkSession::SendPacket(const T& packet, std::function<void(std::size_t packetSize)> acknowledgeCallback)
+	{
 		const SessionHandler::SendAttributes& sendAttributes = m_sessionHandler->GetPacketAttributes<T>();
 
-		Nz::ByteArray byteArray;
-		Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
-		byteStream << Nz::UInt8(PacketIndex<T>);
+		Nz::ByteArray byteArray = SerializePacket(packet);
+		std::size_t packetSize = byteArray.GetSize();
 
-		PacketSerializer serializer(byteStream, true, m_protocolVersion);
-		Packets::Serialize(serializer, const_cast<T&>(packet));
+		std::function<void()> callback;
+		if (acknowledgeCallback)
+			callback = [acknowledgeCallback = std::move(acknowledgeCallback), packetSize] { acknowledgeCallback(packetSize); };
 
-		byteStream.FlushBits();
+		SendData(sendAttributes.channel, sendAttributes.flags, std::move(byteArray), std::move(callback));
 
-		m_reactor.SendData(m_peerId, sendAttributes.channel, sendAttributes.flags, std::move(byteArray), std::move(acknowledgeCallback));
+		return packetSize;
+	}
+
+	inline void NetworkSession::SetCompressionProfile(CompressionProfile compressionProfile)
+	{
+		m_compressionProfile = std::move(compressionProfile);
 	}
 
 	inline void NetworkSession::SetProtocolVersion(Nz::UInt32 protocolVersion)
@@ -62,6 +108,24 @@ namespace tsom
 		m_protocolVersion = protocolVersion;
 	}
 
+	template<typename T>
+	Nz::ByteArray NetworkSession::SerializePacket(const T& packet)
+	{
+		static_assert(PacketCount < 0xFF);
+
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+		byteStream << Nz::UInt8(PacketIndex<T>);
+
+		PacketSerializer serializer(byteStream, true, m_protocolVersion);
+		serializer.SetCompressionProfile(&m_compressionProfile);
+		Packets::Serialize(serializer, const_cast<T&>(packet));
+
+		byteStream.FlushBits();
+
+		return byteArray;
+	}
+
 	template<typename T, typename ...Args>
 	T& NetworkSession::SetupHandler(Args&&... args)
 	{
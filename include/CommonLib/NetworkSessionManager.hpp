@@ -18,6 +18,8 @@
 
 namespace tsom
 {
+	class SessionRecorder;
+
 	class TSOM_COMMONLIB_API NetworkSessionManager
 	{
 		public:
@@ -26,11 +28,20 @@ namespace tsom
 			NetworkSessionManager(NetworkSessionManager&&) = delete;
 			~NetworkSessionManager() = default;
 
+			inline NetworkReactor& GetReactor();
+			inline const NetworkReactor& GetReactor() const;
+
+			// Called by Poll for reactor events, can also be called directly to replay recorded sessions
+			void HandleConnection(std::size_t peerIndex, const Nz::IpAddress& remoteAddress);
+			void HandleDisconnection(std::size_t peerIndex, bool timeout);
+			void HandlePacket(std::size_t peerIndex, Nz::ByteArray&& packet);
+
 			void Poll();
 
 			inline void SendData(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::ByteArray&& payload);
 
 			template<typename T, typename... Args> void SetDefaultHandler(Args&&... args);
+			inline void SetRecorder(SessionRecorder* recorder);
 
 			NetworkSessionManager& operator=(const NetworkSessionManager&) = delete;
 			NetworkSessionManager& operator=(NetworkSessionManager&&) = delete;
@@ -43,6 +54,7 @@ namespace tsom
 			std::vector<std::optional<NetworkSession>> m_sessions; //< TODO: Nz::SparseVector
 			HandlerFactory m_handlerFactory;
 			NetworkReactor m_reactor;
+			SessionRecorder* m_recorder;
 	};
 }
 
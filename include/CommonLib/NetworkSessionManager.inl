@@ -9,10 +9,21 @@ namespace tsom
 	inline NetworkSessionManager::NetworkSessionManager(Nz::UInt16 port, Nz::NetProtocol protocol, std::size_t maxSessions) :
 	m_sessions(maxSessions),
 	m_handlerFactory(nullptr),
-	m_reactor(0, protocol, port, maxSessions)
+	m_reactor(0, protocol, port, maxSessions),
+	m_recorder(nullptr)
 	{
 	}
 
+	inline NetworkReactor& NetworkSessionManager::GetReactor()
+	{
+		return m_reactor;
+	}
+
+	inline const NetworkReactor& NetworkSessionManager::GetReactor() const
+	{
+		return m_reactor;
+	}
+
 	void NetworkSessionManager::SendData(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::ByteArray&& payload)
 	{
 		m_reactor.SendData(peerId, channelId, flags, std::move(payload));
@@ -25,4 +36,9 @@ namespace tsom
 
 		m_handlerFactory = [=](NetworkSession* session) mutable -> std::unique_ptr<SessionHandler> { return std::make_unique<T>(std::forward<Args>(args)..., session); };
 	}
+
+	inline void NetworkSessionManager::SetRecorder(SessionRecorder* recorder)
+	{
+		m_recorder = recorder;
+	}
 }
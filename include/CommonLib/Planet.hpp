@@ -11,6 +11,7 @@
 #include <CommonLib/ChunkContainer.hpp>
 #include <CommonLib/Direction.hpp>
 #include <CommonLib/GravityController.hpp>
+#include <CommonLib/PlanetHeightmapCache.hpp>
 #include <NazaraUtils/FunctionRef.hpp>
 #include <tsl/hopscotch_map.h>
 #include <memory>
@@ -23,6 +24,8 @@ namespace Nz
 
 namespace tsom
 {
+	class CompressionDictionary;
+
 	class TSOM_COMMONLIB_API Planet : public ChunkContainer, public GravityController
 	{
 		public:
@@ -49,6 +52,8 @@ namespace tsom
 			inline std::size_t GetChunkCount() const override;
 			inline float GetCornerRadius() const;
 			inline float GetGravity() const;
+			inline PlanetHeightmapCache& GetHeightmapCache();
+			inline const PlanetHeightmapCache& GetHeightmapCache() const;
 
 			void RemoveChunk(const ChunkIndices& indices) override;
 
@@ -57,7 +62,12 @@ namespace tsom
 			Planet& operator=(const Planet&) = delete;
 			Planet& operator=(Planet&&) = delete;
 
+			static std::shared_ptr<CompressionDictionary> TrainChunkDictionary(const BlockLibrary& blockLibrary, Nz::UInt32 dictionaryId);
+
+			// Must be bumped whenever GenerateChunk output changes, as delta saves are stored against it
+			static constexpr Nz::UInt32 GeneratorVersion = 1;
 			static constexpr unsigned int ChunkSize = 32;
+			static constexpr std::size_t DefaultHeightmapCacheCapacity = 1024;
 
 		protected:
 			struct ChunkData
@@ -65,10 +75,12 @@ namespace tsom
 				std::shared_ptr<Chunk> chunk;
 
 				NazaraSlot(Chunk, OnBlockUpdated, onUpdated);
+				NazaraSlot(Chunk, OnBlocksUpdated, onBlocksUpdated);
 				NazaraSlot(Chunk, OnReset, onReset);
 			};
 
 			tsl::hopscotch_map<ChunkIndices, ChunkData> m_chunks;
+			PlanetHeightmapCache m_heightmapCache;
 			float m_cornerRadius;
 			float m_gravity;
 	};
@@ -42,6 +42,16 @@ namespace tsom
 		return m_gravity;
 	}
 
+	inline PlanetHeightmapCache& Planet::GetHeightmapCache()
+	{
+		return m_heightmapCache;
+	}
+
+	inline const PlanetHeightmapCache& Planet::GetHeightmapCache() const
+	{
+		return m_heightmapCache;
+	}
+
 	inline void Planet::UpdateCornerRadius(float cornerRadius)
 	{
 		m_cornerRadius = cornerRadius;
@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_PLANETHEIGHTMAPCACHE_HPP
+#define TSOM_COMMONLIB_PLANETHEIGHTMAPCACHE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Direction.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <tsl/hopscotch_map.h>
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace tsom
+{
+	// Thread-safe LRU cache of planet face terrain depths, every chunk of a column shares the same tile
+	class TSOM_COMMONLIB_API PlanetHeightmapCache
+	{
+		public:
+			static constexpr unsigned int TileSize = 32;
+
+			struct TileKey
+			{
+				Direction face;
+				Nz::UInt32 seed;
+				Nz::Vector2i origin;
+				int maxHeight;
+
+				inline bool operator==(const TileKey& key) const;
+				inline bool operator!=(const TileKey& key) const;
+			};
+
+			using Tile = std::array<int, TileSize * TileSize>;
+
+			inline explicit PlanetHeightmapCache(std::size_t capacity);
+			PlanetHeightmapCache(const PlanetHeightmapCache&) = delete;
+			PlanetHeightmapCache(PlanetHeightmapCache&&) = delete;
+			~PlanetHeightmapCache() = default;
+
+			void Clear();
+
+			inline std::size_t GetCapacity() const;
+			std::shared_ptr<const Tile> GetTile(const TileKey& key, const Nz::FunctionRef<void(Tile& tile)>& generator);
+			std::size_t GetTileCount() const;
+
+			void UpdateCapacity(std::size_t capacity);
+
+			PlanetHeightmapCache& operator=(const PlanetHeightmapCache&) = delete;
+			PlanetHeightmapCache& operator=(PlanetHeightmapCache&&) = delete;
+
+		private:
+			void EvictTiles();
+
+			struct TileKeyHasher
+			{
+				inline std::size_t operator()(const TileKey& key) const;
+			};
+
+			struct TileEntry
+			{
+				std::list<TileKey>::iterator lruIt;
+				std::once_flag generated;
+				Tile tile;
+			};
+
+			tsl::hopscotch_map<TileKey, std::shared_ptr<TileEntry>, TileKeyHasher> m_tiles;
+			std::list<TileKey> m_lruList; //< most recently used first
+			std::size_t m_capacity;
+			mutable std::mutex m_mutex;
+	};
+}
+
+#include <CommonLib/PlanetHeightmapCache.inl>
+
+#endif // TSOM_COMMONLIB_PLANETHEIGHTMAPCACHE_HPP
@@ -0,0 +1,38 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <NazaraUtils/Algorithm.hpp>
+
+namespace tsom
+{
+	inline PlanetHeightmapCache::PlanetHeightmapCache(std::size_t capacity) :
+	m_capacity(capacity)
+	{
+	}
+
+	inline std::size_t PlanetHeightmapCache::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	inline bool PlanetHeightmapCache::TileKey::operator==(const TileKey& key) const
+	{
+		return face == key.face && seed == key.seed && origin == key.origin && maxHeight == key.maxHeight;
+	}
+
+	inline bool PlanetHeightmapCache::TileKey::operator!=(const TileKey& key) const
+	{
+		return !operator==(key);
+	}
+
+	inline std::size_t PlanetHeightmapCache::TileKeyHasher::operator()(const TileKey& key) const
+	{
+		std::size_t seed = std::hash<Nz::UInt32>{}(key.seed);
+		Nz::HashCombine(seed, key.face);
+		Nz::HashCombine(seed, key.origin.x);
+		Nz::HashCombine(seed, key.origin.y);
+		Nz::HashCombine(seed, key.maxHeight);
+		return seed;
+	}
+}
@@ -8,6 +8,7 @@
 #define TSOM_COMMONLIB_PROTOCOL_COMPRESSEDINTEGER_HPP
 
 #include <Nazara/Core/Algorithm.hpp>
+#include <cstddef>
 #include <type_traits>
 
 namespace tsom
@@ -43,6 +44,8 @@ namespace tsom
 			explicit CompressedUnsigned(T value = 0);
 			~CompressedUnsigned() = default;
 
+			std::size_t GetEncodedSize() const;
+
 			operator T() const;
 
 			CompressedUnsigned& operator=(T value);
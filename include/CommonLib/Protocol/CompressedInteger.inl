@@ -62,6 +62,21 @@ namespace tsom
 	{
 	}
 
+	template<typename T>
+	std::size_t CompressedUnsigned<T>::GetEncodedSize() const
+	{
+		// One byte per started group of 7 bits, see Nz::Serialize below
+		T integerValue = m_value >> 7;
+		std::size_t size = 1;
+		while (integerValue != 0)
+		{
+			integerValue >>= 7;
+			size++;
+		}
+
+		return size;
+	}
+
 	template<typename T>
 	CompressedUnsigned<T>::operator T() const
 	{
@@ -44,7 +44,13 @@ TSOM_NETWORK_PACKET(PlayerJoin)
 TSOM_NETWORK_PACKET(PlayerNameUpdate)
 TSOM_NETWORK_PACKET(SendChatMessage)
 TSOM_NETWORK_PACKET(UpdateRootEnvironment)
-TSOM_NETWORK_PACKET_LAST(UpdatePlayerInputs)
+TSOM_NETWORK_PACKET(UpdatePlayerInputs)
+
+// Added in 0.6.0, kept last to preserve opcodes of 0.5.0 clients
+TSOM_NETWORK_PACKET(BulkCancel)
+TSOM_NETWORK_PACKET(BulkCommit)
+TSOM_NETWORK_PACKET(BulkFragment)
+TSOM_NETWORK_PACKET_LAST(ChunkResetRequest)
 
 #undef TSOM_NETWORK_PACKET
 #undef TSOM_NETWORK_PACKET_LAST
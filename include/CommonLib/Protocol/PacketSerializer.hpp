@@ -28,6 +28,7 @@ namespace tsom
 
 			inline BinaryCompressor& GetBinaryCompressor();
 			inline Nz::ByteStream& GetByteStream();
+			inline const CompressionProfile* GetCompressionProfile() const;
 			inline Nz::UInt32 GetProtocolVersion() const;
 
 			inline void Read(void* ptr, std::size_t size);
@@ -35,6 +36,7 @@ namespace tsom
 			inline bool IsWriting() const;
 
 			inline void SetBinaryCompressor(BinaryCompressor& binaryCompressor);
+			inline void SetCompressionProfile(const CompressionProfile* compressionProfile);
 
 			inline void Write(const void* ptr, std::size_t size);
 
@@ -63,6 +65,7 @@ namespace tsom
 			Nz::ByteStream& m_stream;
 			Nz::UInt32 m_protocolVersion;
 			BinaryCompressor* m_binaryCompressor;
+			const CompressionProfile* m_compressionProfile;
 			bool m_isWriting;
 	};
 }
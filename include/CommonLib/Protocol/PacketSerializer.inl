@@ -48,6 +48,7 @@ namespace tsom
 	m_stream(packetStream),
 	m_protocolVersion(protocolVersion),
 	m_binaryCompressor(&binaryCompressor),
+	m_compressionProfile(nullptr),
 	m_isWriting(isWriting)
 	{
 	}
@@ -62,6 +63,11 @@ namespace tsom
 		return m_stream;
 	}
 
+	inline const CompressionProfile* PacketSerializer::GetCompressionProfile() const
+	{
+		return m_compressionProfile;
+	}
+
 	inline Nz::UInt32 PacketSerializer::GetProtocolVersion() const
 	{
 		return m_protocolVersion;
@@ -83,6 +89,11 @@ namespace tsom
 		m_binaryCompressor = &binaryCompressor;
 	}
 
+	inline void PacketSerializer::SetCompressionProfile(const CompressionProfile* compressionProfile)
+	{
+		m_compressionProfile = compressionProfile;
+	}
+
 	inline void PacketSerializer::Write(const void* ptr, std::size_t size)
 	{
 		if (m_stream.Write(ptr, size) != size)
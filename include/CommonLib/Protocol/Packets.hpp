@@ -9,6 +9,7 @@
 
 #include <CommonLib/Export.hpp>
 #include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
 #include <CommonLib/EntityProperties.hpp>
 #include <CommonLib/EnvironmentTransform.hpp>
 #include <CommonLib/GameConstants.hpp>
@@ -22,6 +23,8 @@
 #include <Nazara/Math/Vector3.hpp>
 #include <NazaraUtils/Result.hpp>
 #include <NazaraUtils/TypeList.hpp>
+#include <span>
+#include <vector>
 
 namespace tsom
 {
@@ -102,6 +105,12 @@ namespace tsom
 			};
 
 			std::variant<AuthenticatedPlayerData, AnonymousPlayerData> token;
+
+			// Only sent since protocol 0.6.0 (older clients only know about raw LZ4)
+			CompressionCapabilities compressionCapabilities;
+
+			// Only sent since protocol 0.6.0, clients keeping a chunk content cache are only sent the hash of chunk contents
+			bool hasChunkContentCache = false;
 		};
 
 		struct AuthResponse
@@ -112,6 +121,25 @@ namespace tsom
 			PlayerIndex ownPlayerIndex;
 		};
 
+		// Bulk transfers are sent as fragments on a dedicated channel, the commit (sent on the ordered gameplay channel) delivers the reassembled packet
+		struct BulkCancel
+		{
+			CompressedUnsigned<Nz::UInt32> transferId;
+		};
+
+		struct BulkCommit
+		{
+			CompressedUnsigned<Nz::UInt32> transferId;
+		};
+
+		struct BulkFragment
+		{
+			CompressedUnsigned<Nz::UInt32> transferId;
+			CompressedUnsigned<Nz::UInt32> offset;
+			CompressedUnsigned<Nz::UInt32> totalSize;
+			std::vector<Nz::UInt8> data;
+		};
+
 		struct ChatMessage
 		{
 			std::optional<PlayerIndex> playerIndex;
@@ -130,6 +158,9 @@ namespace tsom
 			CompressedUnsigned<Nz::UInt32> chunkSizeY;
 			CompressedUnsigned<Nz::UInt32> chunkSizeZ;
 			float cellSize;
+
+			// Since 0.6.0, the server only sends the content hash of chunks, the client either loads it from its cache or requests a reset
+			std::optional<Nz::UInt64> contentHash;
 		};
 
 		struct ChunkDestroy
@@ -145,10 +176,23 @@ namespace tsom
 			Helper::ChunkId chunkId;
 			Helper::EntityId entityId;
 			std::vector<BlockIndex> content;
+			std::shared_ptr<const ChunkSnapshot> snapshot; //< when set, content is written from the snapshot which caches its compressed forms
+		};
+
+		struct ChunkResetRequest
+		{
+			Helper::ChunkId chunkId;
 		};
 
 		struct ChunkUpdate
 		{
+			struct BlockRun
+			{
+				std::size_t firstUpdate;
+				std::size_t length;
+				bool isUniform;
+			};
+
 			struct BlockUpdate
 			{
 				Helper::VoxelLocation voxelLoc;
@@ -232,10 +276,15 @@ namespace tsom
 
 		struct EntityPropertyUpdate
 		{
+			struct PropertyUpdate
+			{
+				CompressedUnsigned<Nz::UInt32> propertyIndex;
+				EntityProperty propertyValue;
+			};
+
 			Nz::UInt16 tickIndex;
 			Helper::EntityId entity;
-			CompressedUnsigned<Nz::UInt32> propertyIndex;
-			EntityProperty propertyValue;
+			std::vector<PropertyUpdate> properties;
 		};
 
 		struct EnvironmentCreate
@@ -332,12 +381,19 @@ namespace tsom
 			PlayerInputs inputs;
 		};
 
+		TSOM_COMMONLIB_API void BuildChunkUpdateRuns(std::span<const ChunkUpdate::BlockUpdate> updates, std::vector<ChunkUpdate::BlockRun>& runs);
+		TSOM_COMMONLIB_API std::size_t ComputeChunkUpdateSize(std::span<const ChunkUpdate::BlockUpdate> updates, Nz::UInt32 protocolVersion);
+
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, AuthRequest& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, AuthResponse& data);
+		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, BulkCancel& data);
+		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, BulkCommit& data);
+		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, BulkFragment& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, ChatMessage& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, ChunkCreate& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, ChunkDestroy& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, ChunkReset& data);
+		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, ChunkResetRequest& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, ChunkUpdate& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, DebugDrawLineList& data);
 		TSOM_COMMONLIB_API void Serialize(PacketSerializer& serializer, EntitiesCreation& data);
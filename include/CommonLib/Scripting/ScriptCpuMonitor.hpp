@@ -0,0 +1,113 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_SCRIPTING_SCRIPTCPUMONITOR_HPP
+#define TSOM_COMMONLIB_SCRIPTING_SCRIPTCPUMONITOR_HPP
+
+#include <CommonLib/Export.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tsom
+{
+	struct ScriptCpuStats
+	{
+		Nz::Time maxCallTime = Nz::Time::Zero();
+		Nz::Time totalTime = Nz::Time::Zero();
+		Nz::UInt64 abortCount = 0;
+		Nz::UInt64 callCount = 0;
+		Nz::UInt64 instructionCount = 0;
+	};
+
+	// Accounts time and instructions spent in script callbacks through a Lua count hook, and aborts calls exceeding their budget
+	class TSOM_COMMONLIB_API ScriptCpuMonitor
+	{
+		public:
+			struct Budget;
+			using ClassStats = std::map<std::string, ScriptCpuStats, std::less<>>;
+
+			ScriptCpuMonitor(lua_State* L);
+			ScriptCpuMonitor(const ScriptCpuMonitor&) = delete;
+			ScriptCpuMonitor(ScriptCpuMonitor&&) = delete;
+			~ScriptCpuMonitor();
+
+			template<typename... Args> sol::protected_function_result Call(const sol::protected_function& function, ScriptCpuStats* classStats, ScriptCpuStats* entityStats, Args&&... args);
+
+			inline const Budget& GetBudget() const;
+			inline const ClassStats& GetClassStats() const;
+			inline Nz::Time GetLastTickTime() const;
+			ScriptCpuStats& GetOrCreateClassStats(std::string_view className);
+			inline Nz::Time GetTickTime() const;
+
+			inline bool IsCallInProgress() const;
+
+			void ResetStats();
+			inline void ResetTickTime();
+
+			inline void UpdateBudget(const Budget& budget);
+
+			ScriptCpuMonitor& operator=(const ScriptCpuMonitor&) = delete;
+			ScriptCpuMonitor& operator=(ScriptCpuMonitor&&) = delete;
+
+			static ScriptCpuMonitor& Retrieve(lua_State* L);
+
+			static constexpr int HookInstructionInterval = 1000;
+
+			struct Budget
+			{
+				Nz::Time callTime = Nz::Time::Zero(); //< zero means unlimited
+				Nz::Time tickTime = Nz::Time::Zero(); //< zero means unlimited
+				Nz::UInt64 callInstructions = 0; //< zero means unlimited
+			};
+
+		private:
+			void BeginCall(lua_State* L, ScriptCpuStats* classStats, ScriptCpuStats* entityStats);
+			void EndCall(lua_State* L);
+			void SetHookInterval(lua_State* L, int instructionInterval);
+
+			static void HookCallback(lua_State* L, lua_Debug* ar);
+
+			enum class AbortReason
+			{
+				None,
+				CallInstructions,
+				CallTime,
+				TickTime
+			};
+
+			struct CallFrame
+			{
+				ScriptCpuStats* classStats;
+				ScriptCpuStats* entityStats;
+				AbortReason abortReason;
+				AbortReason deadlineReason;
+				Nz::Time childTime;
+				Nz::Time deadline;
+				Nz::Time startTime;
+				Nz::UInt64 childInstructionCount;
+				Nz::UInt64 instructionLimit;
+				Nz::UInt64 startInstructionCount;
+			};
+
+			std::vector<CallFrame> m_callFrames;
+			lua_State* m_state;
+			Budget m_budget;
+			ClassStats m_classStats;
+			Nz::Time m_lastTickTime;
+			Nz::Time m_tickTime;
+			Nz::UInt64 m_instructionCount;
+			int m_hookInterval;
+	};
+}
+
+#include <CommonLib/Scripting/ScriptCpuMonitor.inl>
+
+#endif // TSOM_COMMONLIB_SCRIPTING_SCRIPTCPUMONITOR_HPP
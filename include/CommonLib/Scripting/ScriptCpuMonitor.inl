@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <NazaraUtils/CallOnExit.hpp>
+#include <utility>
+
+namespace tsom
+{
+	template<typename... Args>
+	sol::protected_function_result ScriptCpuMonitor::Call(const sol::protected_function& function, ScriptCpuStats* classStats, ScriptCpuStats* entityStats, Args&&... args)
+	{
+		lua_State* L = function.lua_state();
+
+		BeginCall(L, classStats, entityStats);
+		NAZARA_DEFER({ EndCall(L); });
+
+		return function(std::forward<Args>(args)...);
+	}
+
+	inline auto ScriptCpuMonitor::GetBudget() const -> const Budget&
+	{
+		return m_budget;
+	}
+
+	inline auto ScriptCpuMonitor::GetClassStats() const -> const ClassStats&
+	{
+		return m_classStats;
+	}
+
+	inline Nz::Time ScriptCpuMonitor::GetLastTickTime() const
+	{
+		return m_lastTickTime;
+	}
+
+	inline Nz::Time ScriptCpuMonitor::GetTickTime() const
+	{
+		return m_tickTime;
+	}
+
+	inline bool ScriptCpuMonitor::IsCallInProgress() const
+	{
+		return !m_callFrames.empty();
+	}
+
+	inline void ScriptCpuMonitor::ResetTickTime()
+	{
+		m_lastTickTime = std::exchange(m_tickTime, Nz::Time::Zero());
+	}
+
+	inline void ScriptCpuMonitor::UpdateBudget(const Budget& budget)
+	{
+		m_budget = budget;
+	}
+}
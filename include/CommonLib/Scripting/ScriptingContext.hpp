@@ -8,6 +8,7 @@
 #define TSOM_COMMONLIB_SCRIPTING_SCRIPTINGCONTEXT_HPP
 
 #include <CommonLib/Export.hpp>
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
 #include <NazaraUtils/Result.hpp>
 #include <sol/sol.hpp>
 #include <memory>
@@ -34,6 +35,9 @@ namespace tsom
 
 			Nz::Result<sol::object, std::string> Execute(std::string_view str, const std::string& origin);
 
+			inline ScriptCpuMonitor& GetCpuMonitor();
+			inline const ScriptCpuMonitor& GetCpuMonitor() const;
+
 			void LoadDirectory(std::string_view directoryPath);
 			Nz::Result<sol::object, std::string> LoadFile(const std::string& filePath);
 
@@ -47,6 +51,7 @@ namespace tsom
 
 		private:
 			sol::state m_state;
+			ScriptCpuMonitor m_cpuMonitor;
 			std::vector<std::unique_ptr<ScriptingLibrary>> m_libraries;
 			PrintCallback m_printCallback;
 			Nz::ApplicationBase& m_app;
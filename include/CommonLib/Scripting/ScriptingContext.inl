@@ -4,6 +4,16 @@
 
 namespace tsom
 {
+	inline ScriptCpuMonitor& ScriptingContext::GetCpuMonitor()
+	{
+		return m_cpuMonitor;
+	}
+
+	inline const ScriptCpuMonitor& ScriptingContext::GetCpuMonitor() const
+	{
+		return m_cpuMonitor;
+	}
+
 	template<typename T, typename... Args>
 	T& ScriptingContext::RegisterLibrary(Args&&... args)
 	{
@@ -10,9 +10,27 @@
 #include <CommonLib/Export.hpp>
 #include <CommonLib/EntityProperties.hpp>
 #include <sol/forward.hpp>
+#include <memory>
+#include <string>
 
 namespace tsom
 {
+	class EntityClass;
+
+	// Property index resolved once when building the class, to skip the name lookup on each access from scripts
+	struct EntityPropertyHandle
+	{
+		// Shared by the handles of a class builder, set once the class is registered
+		struct ClassBinding
+		{
+			std::weak_ptr<const EntityClass> entityClass; //< weak to avoid keeping the class (and its script references) alive from scripts
+		};
+
+		std::shared_ptr<const ClassBinding> classBinding; //< compared to the entity class, so a handle can't be used on another class
+		std::string name;
+		Nz::UInt32 index;
+	};
+
 	TSOM_COMMONLIB_API EntityProperty TranslatePropertyFromLua(sol::object value, EntityPropertyType expectedType, bool isArray);
 	TSOM_COMMONLIB_API sol::object TranslatePropertyToLua(sol::state_view& lua, const EntityProperty& property);
 }
@@ -15,6 +15,7 @@
 namespace tsom
 {
 	class EntityRegistry;
+	class ScriptCpuMonitor;
 
 	class TSOM_COMMONLIB_API SharedEntityScriptingLibrary : public ScriptingLibrary
 	{
@@ -45,6 +46,8 @@ namespace tsom
 			};
 
 		protected:
+			inline ScriptCpuMonitor& GetCpuMonitor();
+
 			virtual void FillConstants(sol::state& state, sol::table constants);
 			virtual void FillEntityMetatable(sol::state& state, sol::table entityMetatable);
 
@@ -63,6 +66,7 @@ namespace tsom
 			void RegisterPhysics(sol::state& state);
 
 			EntityRegistry& m_entityRegistry;
+			ScriptCpuMonitor* m_cpuMonitor;
 			sol::table m_entityMetatable;
 	};
 }
@@ -2,11 +2,20 @@
 // This file is part of the "This Space Of Mine" project
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <cassert>
+
 namespace tsom
 {
 	inline SharedEntityScriptingLibrary::SharedEntityScriptingLibrary(EntityRegistry& entityRegistry) :
-	m_entityRegistry(entityRegistry)
+	m_entityRegistry(entityRegistry),
+	m_cpuMonitor(nullptr)
+	{
+	}
+
+	inline ScriptCpuMonitor& SharedEntityScriptingLibrary::GetCpuMonitor()
 	{
+		assert(m_cpuMonitor);
+		return *m_cpuMonitor;
 	}
 
 	template<typename T>
@@ -34,6 +34,7 @@ namespace tsom
 			SessionHandler(SessionHandler&&) = delete;
 			virtual ~SessionHandler();
 
+			const CompressionProfile& GetCompressionProfile() const;
 			template<typename T> const SendAttributes& GetPacketAttributes();
 			Nz::UInt32 GetProtocolVersion() const;
 			inline NetworkSession* GetSession() const;
@@ -30,6 +30,7 @@ namespace tsom
 						PacketType deserializedPacket;
 
 						PacketSerializer serializer(packet, false, sessionHandler.GetProtocolVersion());
+						serializer.SetCompressionProfile(&sessionHandler.GetCompressionProfile());
 						try
 						{
 							Nz::ErrorFlags errFlags(Nz::ErrorMode::Silent | Nz::ErrorMode::ThrowException);
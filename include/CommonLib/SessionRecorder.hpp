@@ -0,0 +1,76 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_SESSIONRECORDER_HPP
+#define TSOM_COMMONLIB_SESSIONRECORDER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <filesystem>
+#include <string>
+
+namespace tsom
+{
+	enum class SessionRecordType : Nz::UInt8
+	{
+		Connection,
+		Disconnection,
+		Frame,
+		Packet
+	};
+
+	// Records incoming session events (connections, disconnections and packets) frame by frame to a binary file, see SessionReplay
+	class TSOM_COMMONLIB_API SessionRecorder
+	{
+		public:
+			struct Header;
+
+			SessionRecorder(const std::filesystem::path& filePath, const Header& header);
+			SessionRecorder(const SessionRecorder&) = delete;
+			SessionRecorder(SessionRecorder&&) = delete;
+			~SessionRecorder();
+
+			void BeginFrame(Nz::Time elapsedTime, Nz::UInt16 tickIndex);
+
+			void Flush();
+
+			inline const std::filesystem::path& GetFilePath() const;
+
+			void RecordConnection(std::size_t peerIndex);
+			void RecordDisconnection(std::size_t peerIndex, bool timeout);
+			void RecordPacket(std::size_t peerIndex, const Nz::ByteArray& payload);
+
+			SessionRecorder& operator=(const SessionRecorder&) = delete;
+			SessionRecorder& operator=(SessionRecorder&&) = delete;
+
+			struct Header
+			{
+				std::string saveDirectory;
+				Nz::UInt32 seed = 0;
+			};
+
+			static constexpr std::size_t DisconnectionRecordSize = sizeof(Nz::UInt8) + sizeof(Nz::UInt16) + sizeof(Nz::UInt8); //< type, peer index and timeout flag
+			static constexpr Nz::UInt32 FileMagic = 0x43455254; //< "TREC"
+			static constexpr Nz::UInt32 FileVersion = 1;
+			static constexpr std::size_t FlushThreshold = 64 * 1024;
+			static constexpr std::size_t FrameRecordSize = sizeof(Nz::UInt8) + 2 * sizeof(Nz::UInt64) + sizeof(Nz::UInt16); //< type, timestamp, elapsed time and tick index
+			static constexpr std::size_t PacketRecordHeaderSize = sizeof(Nz::UInt8) + sizeof(Nz::UInt16) + sizeof(Nz::UInt32); //< type, peer index and payload size, followed by the payload
+
+		private:
+			std::filesystem::path m_filePath;
+			Nz::ByteArray m_buffer;
+			Nz::ByteStream m_stream;
+			Nz::File m_file;
+			Nz::Time m_startTime;
+	};
+}
+
+#include <CommonLib/SessionRecorder.inl>
+
+#endif // TSOM_COMMONLIB_SESSIONRECORDER_HPP
@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_SESSIONREPLAY_HPP
+#define TSOM_COMMONLIB_SESSIONREPLAY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/SessionRecorder.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <filesystem>
+#include <vector>
+
+namespace tsom
+{
+	class NetworkSessionManager;
+
+	// Loads a SessionRecorder file and feeds its events back to a session manager, frame by frame
+	class TSOM_COMMONLIB_API SessionReplay
+	{
+		public:
+			struct Event;
+			struct Frame;
+
+			SessionReplay(const std::filesystem::path& filePath);
+			SessionReplay(const SessionReplay&) = delete;
+			SessionReplay(SessionReplay&&) noexcept = default;
+			~SessionReplay() = default;
+
+			inline const Frame& GetFrame(std::size_t frameIndex) const;
+			inline std::size_t GetFrameCount() const;
+			inline const SessionRecorder::Header& GetHeader() const;
+
+			void InjectFrame(std::size_t frameIndex, NetworkSessionManager& sessionManager) const;
+
+			SessionReplay& operator=(const SessionReplay&) = delete;
+			SessionReplay& operator=(SessionReplay&&) noexcept = default;
+
+			struct Event
+			{
+				Nz::ByteArray payload;
+				std::size_t peerIndex;
+				SessionRecordType type;
+				bool timeout = false;
+			};
+
+			struct Frame
+			{
+				std::vector<Event> events;
+				Nz::Time elapsedTime = Nz::Time::Zero();
+				Nz::Time timestamp = Nz::Time::Zero();
+				Nz::UInt16 tickIndex = 0;
+			};
+
+		private:
+			std::vector<Frame> m_frames;
+			SessionRecorder::Header m_header;
+	};
+}
+
+#include <CommonLib/SessionReplay.inl>
+
+#endif // TSOM_COMMONLIB_SESSIONREPLAY_HPP
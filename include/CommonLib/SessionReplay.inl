@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+
+namespace tsom
+{
+	inline auto SessionReplay::GetFrame(std::size_t frameIndex) const -> const Frame&
+	{
+		assert(frameIndex < m_frames.size());
+		return m_frames[frameIndex];
+	}
+
+	inline std::size_t SessionReplay::GetFrameCount() const
+	{
+		return m_frames.size();
+	}
+
+	inline const SessionRecorder::Header& SessionReplay::GetHeader() const
+	{
+		return m_header;
+	}
+}
@@ -60,6 +60,7 @@ namespace tsom
 				std::shared_ptr<FlatChunk> chunk;
 
 				NazaraSlot(FlatChunk, OnBlockUpdated, onUpdated);
+				NazaraSlot(FlatChunk, OnBlocksUpdated, onBlocksUpdated);
 				NazaraSlot(FlatChunk, OnReset, onReset);
 			};
 
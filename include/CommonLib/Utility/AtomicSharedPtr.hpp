@@ -0,0 +1,45 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_ATOMICSHAREDPTR_HPP
+#define TSOM_COMMONLIB_UTILITY_ATOMICSHAREDPTR_HPP
+
+#include <atomic>
+#include <memory>
+#include <version>
+
+namespace tsom
+{
+	// Shared pointer which can be loaded and replaced concurrently from any thread
+	// (std::atomic<std::shared_ptr> isn't available on every standard library we build with)
+	template<typename T>
+	class AtomicSharedPtr
+	{
+		public:
+			AtomicSharedPtr() = default;
+			AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+			AtomicSharedPtr(AtomicSharedPtr&&) = delete;
+			~AtomicSharedPtr() = default;
+
+			std::shared_ptr<T> Load() const;
+
+			void Store(std::shared_ptr<T> ptr);
+
+			AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+			AtomicSharedPtr& operator=(AtomicSharedPtr&&) = delete;
+
+		private:
+#ifdef __cpp_lib_atomic_shared_ptr
+			std::atomic<std::shared_ptr<T>> m_ptr;
+#else
+			std::shared_ptr<T> m_ptr;
+#endif
+	};
+}
+
+#include <CommonLib/Utility/AtomicSharedPtr.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_ATOMICSHAREDPTR_HPP
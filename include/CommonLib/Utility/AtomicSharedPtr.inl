@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	template<typename T>
+	std::shared_ptr<T> AtomicSharedPtr<T>::Load() const
+	{
+#ifdef __cpp_lib_atomic_shared_ptr
+		return m_ptr.load(std::memory_order_acquire);
+#else
+		return std::atomic_load_explicit(&m_ptr, std::memory_order_acquire);
+#endif
+	}
+
+	template<typename T>
+	void AtomicSharedPtr<T>::Store(std::shared_ptr<T> ptr)
+	{
+#ifdef __cpp_lib_atomic_shared_ptr
+		m_ptr.store(std::move(ptr), std::memory_order_release);
+#else
+		std::atomic_store_explicit(&m_ptr, std::move(ptr), std::memory_order_release);
+#endif
+	}
+}
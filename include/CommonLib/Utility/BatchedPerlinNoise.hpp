@@ -0,0 +1,60 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_BATCHEDPERLINNOISE_HPP
+#define TSOM_COMMONLIB_UTILITY_BATCHEDPERLINNOISE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <array>
+#include <span>
+
+namespace tsom
+{
+	// Perlin noise evaluating many samples per call (using SIMD when available), every implementation gives bit-identical outputs,
+	// matching siv::PerlinNoise as long as the latter isn't compiled with floating-point contraction (FMA)
+	class TSOM_COMMONLIB_API BatchedPerlinNoise
+	{
+		public:
+			enum class Implementation
+			{
+				Scalar,
+				SSE2,
+				AVX2
+			};
+
+			using Permutation = std::array<Nz::UInt8, 256>;
+
+			BatchedPerlinNoise();
+			explicit BatchedPerlinNoise(Nz::UInt32 seed);
+			inline explicit BatchedPerlinNoise(const Permutation& permutation);
+			BatchedPerlinNoise(const BatchedPerlinNoise&) = default;
+			BatchedPerlinNoise(BatchedPerlinNoise&&) noexcept = default;
+			~BatchedPerlinNoise() = default;
+
+			inline const Permutation& GetPermutation() const;
+
+			void NormalizedOctave2D_01(std::span<const double> x, std::span<const double> y, std::span<double> output, Nz::Int32 octaves, double persistence = 0.5) const;
+			void NormalizedOctave2D_01(Implementation implementation, std::span<const double> x, std::span<const double> y, std::span<double> output, Nz::Int32 octaves, double persistence = 0.5) const;
+
+			void Reseed(Nz::UInt32 seed);
+
+			BatchedPerlinNoise& operator=(const BatchedPerlinNoise&) = default;
+			BatchedPerlinNoise& operator=(BatchedPerlinNoise&&) noexcept = default;
+
+			static Implementation GetBestImplementation();
+			static bool IsSupported(Implementation implementation);
+
+			// 2D noise is 3D noise sampled at this depth (same as siv::PerlinNoise)
+			static constexpr double DefaultZ = 0.34567;
+
+		private:
+			Permutation m_permutation;
+	};
+}
+
+#include <CommonLib/Utility/BatchedPerlinNoise.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_BATCHEDPERLINNOISE_HPP
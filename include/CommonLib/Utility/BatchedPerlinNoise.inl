@@ -0,0 +1,16 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline BatchedPerlinNoise::BatchedPerlinNoise(const Permutation& permutation) :
+	m_permutation(permutation)
+	{
+	}
+
+	inline auto BatchedPerlinNoise::GetPermutation() const -> const Permutation&
+	{
+		return m_permutation;
+	}
+}
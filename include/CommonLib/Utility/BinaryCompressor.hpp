@@ -8,15 +8,44 @@
 #define TSOM_COMMONLIB_UTILITY_BINARYCOMPRESSOR_HPP
 
 #include <CommonLib/Export.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
 #include <NazaraUtils/MovablePtr.hpp>
+#include <memory>
 #include <optional>
 #include <span>
+#include <string_view>
 #include <vector>
 
 typedef union LZ4_stream_u LZ4_stream_t;
+typedef union LZ4_streamHC_u LZ4_streamHC_t;
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
 
 namespace tsom
 {
+	enum class CompressionCodec : Nz::UInt8
+	{
+		LZ4   = 0,
+		LZ4HC = 1, //< slower compression for data compressed once and decompressed many times, LZ4 decompression speed
+		Zstd  = 2, //< only available when built with zstd support
+
+		Max = Zstd
+	};
+
+	struct CompressionCapabilities
+	{
+		Nz::UInt8 codecMask = 0;
+		std::vector<Nz::UInt32> dictionaries;
+	};
+
+	struct CompressionProfile
+	{
+		CompressionCodec codec = CompressionCodec::LZ4;
+		int acceleration = 1; //< LZ4 only, trades ratio for speed
+		int level = 0; //< LZ4HC and zstd only (0 = default)
+		std::shared_ptr<const CompressionDictionary> dictionary;
+	};
+
 	class TSOM_COMMONLIB_API BinaryCompressor
 	{
 		public:
@@ -26,16 +55,30 @@ namespace tsom
 			~BinaryCompressor();
 
 			std::optional<std::span<Nz::UInt8>> Compress(const void* data, std::size_t size);
+			std::optional<std::span<Nz::UInt8>> CompressFrame(const CompressionProfile& profile, const void* data, std::size_t size);
+
 			std::optional<std::size_t> Decompress(const void* compressedData, std::size_t compressedSize, void* output, std::size_t maxOutputSize);
+			std::optional<std::size_t> DecompressFrame(const void* frameData, std::size_t frameSize, void* output, std::size_t maxOutputSize, const CompressionDictionary* dictionary);
 
 			BinaryCompressor& operator=(const BinaryCompressor&) = delete;
 			BinaryCompressor& operator=(BinaryCompressor&&) noexcept = default;
 
+			static CompressionCapabilities GetLocalCapabilities();
 			static BinaryCompressor& GetThreadCompressor();
+			static bool IsCodecSupported(CompressionCodec codec);
+			static CompressionProfile NegotiateProfile(const CompressionProfile& profile, const CompressionCapabilities& peerCapabilities);
+			static std::optional<CompressionCodec> ParseCodec(std::string_view codecName);
 
 		private:
+			std::optional<std::size_t> CompressLZ4(const CompressionProfile& profile, const char* src, int srcSize, char* dst, int dstCapacity);
+			std::optional<std::size_t> CompressLZ4HC(const CompressionProfile& profile, const char* src, int srcSize, char* dst, int dstCapacity);
+			std::optional<std::size_t> CompressZstd(const CompressionProfile& profile, const void* src, std::size_t srcSize, void* dst, std::size_t dstCapacity);
+
 			std::vector<Nz::UInt8> m_compressedData;
 			Nz::MovablePtr<LZ4_stream_t> m_state;
+			Nz::MovablePtr<LZ4_streamHC_t> m_stateHC;
+			Nz::MovablePtr<ZSTD_CCtx> m_zstdCompressionContext;
+			Nz::MovablePtr<ZSTD_DCtx> m_zstdDecompressionContext;
 	};
 }
 
@@ -0,0 +1,50 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_COMPRESSIONDICTIONARY_HPP
+#define TSOM_COMMONLIB_UTILITY_COMPRESSIONDICTIONARY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tsom
+{
+	// Content used to prime the compression window of small payloads, identified by a versioned id checked during the handshake
+	class TSOM_COMMONLIB_API CompressionDictionary
+	{
+		public:
+			CompressionDictionary(Nz::UInt32 id, std::vector<Nz::UInt8> content);
+			CompressionDictionary(const CompressionDictionary&) = delete;
+			CompressionDictionary(CompressionDictionary&&) = delete;
+			~CompressionDictionary() = default;
+
+			inline const std::vector<Nz::UInt8>& GetContent() const;
+			inline Nz::UInt32 GetId() const;
+
+			bool SaveToFile(const std::filesystem::path& filePath) const;
+
+			CompressionDictionary& operator=(const CompressionDictionary&) = delete;
+			CompressionDictionary& operator=(CompressionDictionary&&) = delete;
+
+			static std::shared_ptr<CompressionDictionary> LoadFromFile(const std::filesystem::path& filePath);
+			static std::shared_ptr<CompressionDictionary> Train(Nz::UInt32 id, std::span<const std::span<const Nz::UInt8>> samples, std::size_t maxSize = MaxSize);
+
+			static constexpr Nz::UInt32 FileMagic = 0x44435354; //< "TSCD"
+			static constexpr std::size_t MaxSize = 64 * 1024; //< LZ4 only uses the last 64KiB of a dictionary
+
+		private:
+			std::vector<Nz::UInt8> m_content;
+			Nz::UInt32 m_id;
+	};
+}
+
+#include <CommonLib/Utility/CompressionDictionary.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_COMPRESSIONDICTIONARY_HPP
@@ -0,0 +1,16 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline const std::vector<Nz::UInt8>& CompressionDictionary::GetContent() const
+	{
+		return m_content;
+	}
+
+	inline Nz::UInt32 CompressionDictionary::GetId() const
+	{
+		return m_id;
+	}
+}
@@ -0,0 +1,145 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_METRICSREGISTRY_HPP
+#define TSOM_COMMONLIB_UTILITY_METRICSREGISTRY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace tsom
+{
+	// Thread-safe counters, gauges and histograms, exported in the Prometheus text exposition format
+	class TSOM_COMMONLIB_API MetricsRegistry
+	{
+		public:
+			class Counter;
+			class Gauge;
+			class Histogram;
+			using Labels = std::vector<std::pair<std::string, std::string>>;
+
+			MetricsRegistry() = default;
+			MetricsRegistry(const MetricsRegistry&) = delete;
+			MetricsRegistry(MetricsRegistry&&) = delete;
+			~MetricsRegistry() = default;
+
+			// Returned references stay valid for the registry lifetime, metrics are identified by their name and labels
+			Counter& GetCounter(std::string_view name, std::string_view help, Labels labels = {});
+			Gauge& GetGauge(std::string_view name, std::string_view help, Labels labels = {});
+			Histogram& GetHistogram(std::string_view name, std::string_view help, std::vector<double> bucketBounds, Labels labels = {});
+
+			std::string ToPrometheusText() const;
+
+			bool WriteToFile(const std::filesystem::path& filePath) const;
+
+			MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+			MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+			static std::vector<double> ExponentialBuckets(double start, double factor, std::size_t count);
+			static std::vector<double> LinearBuckets(double start, double width, std::size_t count);
+
+		private:
+			enum class MetricType
+			{
+				Counter,
+				Gauge,
+				Histogram
+			};
+
+			using Metric = std::variant<std::unique_ptr<Counter>, std::unique_ptr<Gauge>, std::unique_ptr<Histogram>>;
+
+			struct Family
+			{
+				std::string help;
+				std::vector<std::pair<Labels, Metric>> metrics;
+				MetricType type;
+			};
+
+			template<typename T, typename F> T& GetMetric(MetricType type, std::string_view name, std::string_view help, Labels&& labels, F&& factory);
+
+			mutable std::mutex m_mutex;
+			std::map<std::string, Family, std::less<>> m_families;
+	};
+
+	class MetricsRegistry::Counter
+	{
+		public:
+			Counter() = default;
+			Counter(const Counter&) = delete;
+			Counter(Counter&&) = delete;
+			~Counter() = default;
+
+			inline double GetValue() const;
+
+			inline void Increment(double value = 1.0);
+
+			Counter& operator=(const Counter&) = delete;
+			Counter& operator=(Counter&&) = delete;
+
+		private:
+			std::atomic<double> m_value = 0.0;
+	};
+
+	class MetricsRegistry::Gauge
+	{
+		public:
+			Gauge() = default;
+			Gauge(const Gauge&) = delete;
+			Gauge(Gauge&&) = delete;
+			~Gauge() = default;
+
+			inline double GetValue() const;
+
+			inline void Increment(double value = 1.0);
+
+			inline void Set(double value);
+
+			Gauge& operator=(const Gauge&) = delete;
+			Gauge& operator=(Gauge&&) = delete;
+
+		private:
+			std::atomic<double> m_value = 0.0;
+	};
+
+	class TSOM_COMMONLIB_API MetricsRegistry::Histogram
+	{
+		public:
+			explicit Histogram(std::vector<double> bucketBounds);
+			Histogram(const Histogram&) = delete;
+			Histogram(Histogram&&) = delete;
+			~Histogram() = default;
+
+			inline const std::vector<double>& GetBucketBounds() const;
+			std::vector<Nz::UInt64> GetCumulativeCounts() const; //< one entry per bucket plus the +Inf bucket
+			inline Nz::UInt64 GetCount() const;
+			inline double GetSum() const;
+
+			void Observe(double value);
+
+			Histogram& operator=(const Histogram&) = delete;
+			Histogram& operator=(Histogram&&) = delete;
+
+		private:
+			std::unique_ptr<std::atomic<Nz::UInt64>[]> m_bucketCounts;
+			std::vector<double> m_bucketBounds;
+			std::atomic<Nz::UInt64> m_count = 0;
+			std::atomic<double> m_sum = 0.0;
+	};
+}
+
+#include <CommonLib/Utility/MetricsRegistry.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_METRICSREGISTRY_HPP
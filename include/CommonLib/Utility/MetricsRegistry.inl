@@ -0,0 +1,48 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline double MetricsRegistry::Counter::GetValue() const
+	{
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+	inline void MetricsRegistry::Counter::Increment(double value)
+	{
+		m_value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+
+	inline double MetricsRegistry::Gauge::GetValue() const
+	{
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+	inline void MetricsRegistry::Gauge::Increment(double value)
+	{
+		m_value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	inline void MetricsRegistry::Gauge::Set(double value)
+	{
+		m_value.store(value, std::memory_order_relaxed);
+	}
+
+
+	inline const std::vector<double>& MetricsRegistry::Histogram::GetBucketBounds() const
+	{
+		return m_bucketBounds;
+	}
+
+	inline Nz::UInt64 MetricsRegistry::Histogram::GetCount() const
+	{
+		return m_count.load(std::memory_order_relaxed);
+	}
+
+	inline double MetricsRegistry::Histogram::GetSum() const
+	{
+		return m_sum.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_TICKPROFILER_HPP
+#define TSOM_COMMONLIB_UTILITY_TICKPROFILER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace tsom
+{
+	// Records timing zones in per-thread ring buffers, which can be dumped to the Chrome trace event format (chrome://tracing, Perfetto)
+	class TSOM_COMMONLIB_API TickProfiler
+	{
+		public:
+			class Zone;
+			struct Event;
+			struct ThreadEvents;
+
+			TickProfiler() = delete;
+			~TickProfiler() = delete;
+
+			static void Clear();
+			static std::vector<ThreadEvents> CollectEvents();
+
+			static void Enable(bool enable = true);
+
+			static bool IsEnabled();
+
+			static void RecordEvent(const char* name, Nz::Time beginTime, Nz::Time endTime);
+
+			static void SetThreadName(std::string threadName);
+
+			static std::string ToChromeTrace();
+
+			static bool WriteChromeTrace(const std::filesystem::path& filePath);
+
+			static constexpr std::size_t ThreadEventCapacity = 16 * 1024;
+
+			struct Event
+			{
+				const char* name; //< must be a string literal (or outlive the profiler)
+				Nz::Time beginTime;
+				Nz::Time endTime;
+			};
+
+			struct ThreadEvents
+			{
+				std::string threadName;
+				std::vector<Event> events; //< oldest first
+				unsigned int threadId;
+			};
+	};
+
+	// Records the time spent between its construction and destruction, does nothing if the profiler isn't enabled
+	class TickProfiler::Zone
+	{
+		public:
+			inline explicit Zone(const char* name);
+			Zone(const Zone&) = delete;
+			Zone(Zone&&) = delete;
+			inline ~Zone();
+
+			Zone& operator=(const Zone&) = delete;
+			Zone& operator=(Zone&&) = delete;
+
+		private:
+			const char* m_name;
+			Nz::Time m_beginTime;
+	};
+}
+
+#include <CommonLib/Utility/TickProfiler.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_TICKPROFILER_HPP
@@ -0,0 +1,21 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Nazara/Core/Clock.hpp>
+
+namespace tsom
+{
+	inline TickProfiler::Zone::Zone(const char* name) :
+	m_name((TickProfiler::IsEnabled()) ? name : nullptr)
+	{
+		if (m_name)
+			m_beginTime = Nz::GetElapsedNanoseconds();
+	}
+
+	inline TickProfiler::Zone::~Zone()
+	{
+		if (m_name)
+			TickProfiler::RecordEvent(m_name, m_beginTime, Nz::GetElapsedNanoseconds());
+	}
+}
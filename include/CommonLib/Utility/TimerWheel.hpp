@@ -0,0 +1,100 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_TIMERWHEEL_HPP
+#define TSOM_COMMONLIB_UTILITY_TIMERWHEEL_HPP
+
+#include <CommonLib/Export.hpp>
+#include <entt/entt.hpp>
+#include <tsl/hopscotch_map.h>
+#include <array>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace tsom
+{
+	// Hierarchical timing wheel (four levels of 64 slots), advancing a tick costs O(1) regardless of the number of pending timers
+	// Timers expiring on the same tick are triggered in the order they were scheduled
+	class TSOM_COMMONLIB_API TimerWheel
+	{
+		public:
+			using Callback = std::function<void()>;
+			using TimerId = Nz::UInt64;
+
+			TimerWheel();
+			TimerWheel(const TimerWheel&) = delete;
+			TimerWheel(TimerWheel&&) = delete;
+			~TimerWheel() = default;
+
+			TimerId AddRepeatingTimer(Nz::UInt64 intervalTicks, Callback callback, entt::entity owner = entt::null);
+			TimerId AddTimer(Nz::UInt64 delayTicks, Callback callback, entt::entity owner = entt::null);
+
+			void Advance();
+
+			bool CancelTimer(TimerId timerId);
+			std::size_t CancelTimers(entt::entity owner);
+
+			inline Nz::UInt64 GetCurrentTick() const;
+			inline std::size_t GetTimerCount() const;
+			entt::entity GetTimerOwner(TimerId timerId) const;
+
+			bool IsTimerActive(TimerId timerId) const;
+
+			TimerWheel& operator=(const TimerWheel&) = delete;
+			TimerWheel& operator=(TimerWheel&&) = delete;
+
+			static constexpr TimerId InvalidTimer = 0;
+
+		private:
+			static constexpr Nz::UInt32 InvalidIndex = std::numeric_limits<Nz::UInt32>::max();
+			static constexpr unsigned int LevelBits = 6;
+			static constexpr unsigned int LevelCount = 4;
+			static constexpr Nz::UInt32 SlotCount = 1u << LevelBits;
+			static constexpr Nz::UInt64 MaxRange = Nz::UInt64(1) << (LevelBits * LevelCount);
+
+			struct Timer
+			{
+				Callback callback;
+				entt::entity owner = entt::null;
+				Nz::UInt64 expiration = 0;
+				Nz::UInt64 interval = 0; //< zero for one-shot timers
+				Nz::UInt64 sequence = 0;
+				Nz::UInt32 generation = 1;
+				Nz::UInt32 bucket = InvalidIndex;
+				Nz::UInt32 prev = InvalidIndex;
+				Nz::UInt32 next = InvalidIndex;
+				Nz::UInt32 ownerPrev = InvalidIndex;
+				Nz::UInt32 ownerNext = InvalidIndex;
+				bool isActive = false;
+			};
+
+			TimerId AllocateTimer(Nz::UInt64 delayTicks, Nz::UInt64 intervalTicks, Callback&& callback, entt::entity owner);
+			void Cascade(unsigned int level);
+			Nz::UInt32 DetachBucket(Nz::UInt32 bucketIndex);
+			void FreeTimer(Nz::UInt32 timerIndex);
+			void InsertTimer(Nz::UInt32 timerIndex);
+			const Timer* RetrieveTimer(TimerId timerId) const;
+			void UnlinkFromBucket(Timer& timer);
+
+			static inline TimerId BuildTimerId(Nz::UInt32 timerIndex, Nz::UInt32 generation);
+			static inline Nz::UInt32 GetTimerGeneration(TimerId timerId);
+			static inline Nz::UInt32 GetTimerIndex(TimerId timerId);
+
+			std::array<Nz::UInt32, LevelCount * SlotCount> m_buckets;
+			std::vector<Nz::UInt32> m_freeTimers;
+			std::vector<Timer> m_timers;
+			std::vector<TimerId> m_expiredTimers;
+			tsl::hopscotch_map<entt::entity, Nz::UInt32> m_ownerTimers; //< first timer of each owner
+			Nz::UInt64 m_currentTick;
+			Nz::UInt64 m_nextSequence;
+			std::size_t m_activeTimerCount;
+	};
+}
+
+#include <CommonLib/Utility/TimerWheel.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_TIMERWHEEL_HPP
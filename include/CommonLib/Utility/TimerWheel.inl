@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline Nz::UInt64 TimerWheel::GetCurrentTick() const
+	{
+		return m_currentTick;
+	}
+
+	inline std::size_t TimerWheel::GetTimerCount() const
+	{
+		return m_activeTimerCount;
+	}
+
+	inline auto TimerWheel::BuildTimerId(Nz::UInt32 timerIndex, Nz::UInt32 generation) -> TimerId
+	{
+		return (Nz::UInt64(generation) << 32) | timerIndex;
+	}
+
+	inline Nz::UInt32 TimerWheel::GetTimerGeneration(TimerId timerId)
+	{
+		return Nz::UInt32(timerId >> 32);
+	}
+
+	inline Nz::UInt32 TimerWheel::GetTimerIndex(TimerId timerId)
+	{
+		return Nz::UInt32(timerId & 0xFFFFFFFF);
+	}
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_SERVERLIB_METRICSEXPORTERAPPCOMPONENT_HPP
+#define TSOM_SERVERLIB_METRICSEXPORTERAPPCOMPONENT_HPP
+
+#include <ServerLib/Export.hpp>
+#include <CommonLib/Utility/MetricsRegistry.hpp>
+#include <Nazara/Core/ApplicationComponent.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <Nazara/Network/TcpClient.hpp>
+#include <Nazara/Network/TcpServer.hpp>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tsom
+{
+	// Periodically writes a metrics registry (which must outlive the application) to a Prometheus text file, and optionally serves it over HTTP on localhost
+	class TSOM_SERVERLIB_API MetricsExporterAppComponent : public Nz::ApplicationComponent
+	{
+		public:
+			struct Config;
+
+			MetricsExporterAppComponent(Nz::ApplicationBase& app, MetricsRegistry& registry, Config config);
+			MetricsExporterAppComponent(const MetricsExporterAppComponent&) = delete;
+			MetricsExporterAppComponent(MetricsExporterAppComponent&&) = delete;
+			~MetricsExporterAppComponent() = default;
+
+			inline MetricsRegistry& GetRegistry();
+
+			void Update(Nz::Time elapsedTime) override;
+
+			MetricsExporterAppComponent& operator=(const MetricsExporterAppComponent&) = delete;
+			MetricsExporterAppComponent& operator=(MetricsExporterAppComponent&&) = delete;
+
+			struct Config
+			{
+				std::filesystem::path exportPath;
+				Nz::Time exportInterval = Nz::Time::Seconds(15);
+				Nz::UInt16 httpPort = 0; //< 0 to disable the HTTP endpoint
+			};
+
+		private:
+			struct HttpClient
+			{
+				Nz::TcpClient socket;
+				Nz::MillisecondClock connectionClock;
+				std::string request;
+			};
+
+			void ExportToFile();
+			void PollHttpClients();
+
+			std::optional<Nz::TcpServer> m_httpServer;
+			std::filesystem::path m_exportPath;
+			std::vector<std::unique_ptr<HttpClient>> m_httpClients;
+			Nz::MillisecondClock m_exportClock;
+			Nz::Time m_exportInterval;
+			MetricsRegistry& m_registry;
+	};
+}
+
+#include <ServerLib/MetricsExporterAppComponent.inl>
+
+#endif // TSOM_SERVERLIB_METRICSEXPORTERAPPCOMPONENT_HPP
@@ -8,10 +8,15 @@
 #define TSOM_SERVERLIB_SERVERCONSTANTS_HPP
 
 #include <Nazara/Core/Time.hpp>
+#include <cstddef>
 
 namespace tsom::Constants
 {
+	constexpr std::size_t MetricsHttpMaxRequestSize = 8 * 1024;
+	constexpr Nz::Time MetricsHttpRequestTimeout = Nz::Time::Second();
+	constexpr Nz::Time MetricsUpdateInterval = Nz::Time::Second();
 	constexpr Nz::Time PlayerTokenRefreshWindow = Nz::Time::Seconds(15);
+	constexpr Nz::Time TickProfileDumpMinInterval = Nz::Time::Seconds(10);
 }
 
 #endif // TSOM_SERVERLIB_SERVERCONSTANTS_HPP
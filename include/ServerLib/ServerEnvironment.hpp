@@ -9,6 +9,7 @@
 
 #include <ServerLib/Export.hpp>
 #include <CommonLib/EnvironmentTransform.hpp>
+#include <CommonLib/Utility/TimerWheel.hpp>
 #include <ServerLib/ServerInstance.hpp>
 #include <Nazara/Core/EnttWorld.hpp>
 #include <Nazara/Core/Node.hpp>
@@ -49,6 +50,10 @@ namespace tsom
 
 			inline bool GetEnvironmentTransformation(ServerEnvironment& targetEnv, EnvironmentTransform* transform) const;
 			virtual const GravityController* GetGravityController() const = 0;
+			inline ServerInstance& GetServerInstance();
+			inline const ServerInstance& GetServerInstance() const;
+			inline TimerWheel& GetTimerWheel();
+			inline const TimerWheel& GetTimerWheel() const;
 			inline ServerEnvironmentType GetType() const;
 			inline Nz::EnttWorld& GetWorld();
 			inline const Nz::EnttWorld& GetWorld() const;
@@ -72,6 +77,12 @@ namespace tsom
 			Nz::Bitset<Nz::UInt64> m_registeredPlayers;
 			ServerEnvironmentType m_type;
 			ServerInstance& m_serverInstance;
+
+		private:
+			void OnScriptedEntityDestroy(entt::registry& registry, entt::entity entity);
+
+			entt::scoped_connection m_scriptedEntityDestroyConnection;
+			TimerWheel m_timerWheel;
 	};
 }
 
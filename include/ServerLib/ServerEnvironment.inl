@@ -37,6 +37,26 @@ namespace tsom
 		return true;
 	}
 
+	inline ServerInstance& ServerEnvironment::GetServerInstance()
+	{
+		return m_serverInstance;
+	}
+
+	inline const ServerInstance& ServerEnvironment::GetServerInstance() const
+	{
+		return m_serverInstance;
+	}
+
+	inline TimerWheel& ServerEnvironment::GetTimerWheel()
+	{
+		return m_timerWheel;
+	}
+
+	inline const TimerWheel& ServerEnvironment::GetTimerWheel() const
+	{
+		return m_timerWheel;
+	}
+
 	inline ServerEnvironmentType ServerEnvironment::GetType() const
 	{
 		return m_type;
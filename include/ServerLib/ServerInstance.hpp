@@ -12,13 +12,18 @@
 #include <CommonLib/EntityRegistry.hpp>
 #include <CommonLib/NetworkSessionManager.hpp>
 #include <CommonLib/Scripting/ScriptingContext.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <CommonLib/Utility/MetricsRegistry.hpp>
 #include <ServerLib/ServerPlayer.hpp>
 #include <Nazara/Core/Clock.hpp>
 #include <NazaraUtils/Bitset.hpp>
 #include <NazaraUtils/MemoryPool.hpp>
 #include <NazaraUtils/PathUtils.hpp>
 #include <array>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -32,6 +37,7 @@ namespace tsom
 {
 	class ServerPlanetEnvironment;
 	class ServerShipEnvironment;
+	class SessionRecorder;
 
 	class TSOM_SERVERLIB_API ServerInstance
 	{
@@ -54,22 +60,30 @@ namespace tsom
 			ServerPlayer* CreateAuthenticatedPlayer(NetworkSession* session, const Nz::Uuid& uuid, std::string nickname, PlayerPermissionFlags permissions);
 			void DestroyPlayer(PlayerIndex playerIndex);
 
+			std::optional<std::filesystem::path> DumpTickProfile(std::string_view reason);
+
 			inline ServerPlayer* FindPlayerByNickname(std::string_view nickname);
 			inline const ServerPlayer* FindPlayerByNickname(std::string_view nickname) const;
 			inline ServerPlayer* FindPlayerByUuid(const Nz::Uuid& uuid);
 			inline const ServerPlayer* FindPlayerByUuid(const Nz::Uuid& uuid) const;
 
+			template<typename F> void ForEachEnvironment(F&& functor);
+			template<typename F> void ForEachEnvironment(F&& functor) const;
 			template<typename F> void ForEachPlayer(F&& functor);
 			template<typename F> void ForEachPlayer(F&& functor) const;
 
 			inline Nz::ApplicationBase& GetApplication();
 			inline const BlockLibrary& GetBlockLibrary() const;
+			inline const CompressionProfile& GetChunkCompressionProfile() const;
 			inline const std::array<std::uint8_t, 32>& GetConnectionTokenEncryptionKey() const;
 			inline const Spawnpoint& GetDefaultSpawnpoint() const;
 			inline EntityRegistry& GetEntityRegistry();
 			inline const EntityRegistry& GetEntityRegistry() const;
 			inline ServerPlayer* GetPlayer(PlayerIndex playerIndex);
 			inline const ServerPlayer* GetPlayer(PlayerIndex playerIndex) const;
+			inline ScriptingContext& GetScriptingContext();
+			inline const ScriptingContext& GetScriptingContext() const;
+			inline const CompressionProfile& GetShipCompressionProfile() const;
 			inline Nz::Time GetTickDuration() const;
 
 			std::unique_ptr<Nz::EnttWorld> RegisterEnvironment(ServerEnvironment* environment);
@@ -86,7 +100,15 @@ namespace tsom
 			struct Config
 			{
 				std::array<std::uint8_t, 32> connectionTokenEncryptionKey;
+				std::filesystem::path profileDirectory = Nz::Utf8Path("profiles");
+				MetricsRegistry* metricsRegistry = nullptr;
+				ScriptCpuMonitor::Budget scriptBudget;
+				SessionRecorder* sessionRecorder = nullptr;
+				CompressionProfile chunkCompression = { CompressionCodec::LZ4 };  //< compressed for every player, keep it fast
+				CompressionProfile shipCompression = { CompressionCodec::LZ4HC }; //< compressed once on save
 				Nz::Time saveInterval = Nz::Time::Seconds(30);
+				bool dumpProfileOnTickOverrun = false;
+				bool parallelDispatch = true;
 				bool pauseWhenEmpty = true;
 			};
 
@@ -102,6 +124,7 @@ namespace tsom
 			void OnNetworkTick();
 			void OnSave();
 			void OnTick(Nz::Time elapsedTime);
+			void UpdateMetrics();
 
 			struct PlayerRename
 			{
@@ -113,20 +136,33 @@ namespace tsom
 			std::vector<std::unique_ptr<NetworkSessionManager>> m_sessionManagers;
 			std::vector<PlayerRename> m_pendingPlayerRename;
 			std::vector<ServerEnvironment*> m_environments;
+			std::vector<ServerPlayer*> m_dispatchedPlayers;
 			std::vector<std::unique_ptr<Nz::EnttWorld>> m_envWorldPool;
+			std::filesystem::path m_profileDirectory;
 			Nz::Bitset<> m_disconnectedPlayers;
 			Nz::Bitset<> m_newPlayers;
 			Nz::MemoryPool<ServerPlayer> m_players;
+			Nz::MillisecondClock m_metricsClock;
+			Nz::MillisecondClock m_profileDumpClock;
 			Nz::MillisecondClock m_saveClock;
 			Nz::Time m_saveInterval;
 			Nz::Time m_tickAccumulator;
 			Nz::Time m_tickDuration;
 			Nz::UInt16 m_tickIndex;
 			Nz::ApplicationBase& m_application;
+			MetricsRegistry* m_metricsRegistry;
+			MetricsRegistry::Counter* m_tickOverrunCounter;
+			MetricsRegistry::Histogram* m_saveDurationHistogram;
+			MetricsRegistry::Histogram* m_tickDurationHistogram;
+			SessionRecorder* m_sessionRecorder;
+			CompressionProfile m_chunkCompressionProfile;
+			CompressionProfile m_shipCompressionProfile;
 			BlockLibrary m_blockLibrary;
 			ScriptingContext m_scriptingContext;
 			EntityRegistry m_entityRegistry;
 			Spawnpoint m_defaultSpawnpoint;
+			bool m_dumpProfileOnTickOverrun;
+			bool m_parallelDispatch;
 			bool m_pauseWhenEmpty;
 	};
 }
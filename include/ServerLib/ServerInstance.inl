@@ -7,7 +7,13 @@ namespace tsom
 	template<typename... Args>
 	NetworkSessionManager& ServerInstance::AddSessionManager(Args&& ...args)
 	{
-		return *m_sessionManagers.emplace_back(std::make_unique<NetworkSessionManager>(std::forward<Args>(args)...));
+		NetworkSessionManager& sessionManager = *m_sessionManagers.emplace_back(std::make_unique<NetworkSessionManager>(std::forward<Args>(args)...));
+		if (m_metricsRegistry)
+			sessionManager.GetReactor().EnableMetrics(*m_metricsRegistry);
+
+		sessionManager.SetRecorder(m_sessionRecorder);
+
+		return sessionManager;
 	}
 
 	inline ServerPlayer* ServerInstance::FindPlayerByNickname(std::string_view nickname)
@@ -54,6 +60,18 @@ namespace tsom
 		return nullptr;
 	}
 
+	template<typename F> void ServerInstance::ForEachEnvironment(F&& functor)
+	{
+		for (ServerEnvironment* environment : m_environments)
+			functor(*environment);
+	}
+
+	template<typename F> void ServerInstance::ForEachEnvironment(F&& functor) const
+	{
+		for (const ServerEnvironment* environment : m_environments)
+			functor(*environment);
+	}
+
 	template<typename F> void ServerInstance::ForEachPlayer(F&& functor)
 	{
 		for (ServerPlayer& serverPlayer : m_players)
@@ -76,6 +94,11 @@ namespace tsom
 		return m_blockLibrary;
 	}
 
+	inline const CompressionProfile& ServerInstance::GetChunkCompressionProfile() const
+	{
+		return m_chunkCompressionProfile;
+	}
+
 	inline const std::array<std::uint8_t, 32>& ServerInstance::GetConnectionTokenEncryptionKey() const
 	{
 		return m_connectionTokenEncryptionKey;
@@ -106,6 +129,21 @@ namespace tsom
 		return m_players.RetrieveFromIndex(playerIndex);
 	}
 
+	inline ScriptingContext& ServerInstance::GetScriptingContext()
+	{
+		return m_scriptingContext;
+	}
+
+	inline const ScriptingContext& ServerInstance::GetScriptingContext() const
+	{
+		return m_scriptingContext;
+	}
+
+	inline const CompressionProfile& ServerInstance::GetShipCompressionProfile() const
+	{
+		return m_shipCompressionProfile;
+	}
+
 	inline Nz::Time ServerInstance::GetTickDuration() const
 	{
 		return m_tickDuration;
@@ -11,13 +11,16 @@
 #include <CommonLib/Chunk.hpp>
 #include <ServerLib/ServerEnvironment.hpp>
 #include <entt/entt.hpp>
+#include <atomic>
 #include <filesystem>
 #include <memory>
+#include <optional>
 
 namespace tsom
 {
 	class ChunkEntities;
 	class Planet;
+	struct PlanetSaveHeader;
 
 	class TSOM_SERVERLIB_API ServerPlanetEnvironment final : public ServerEnvironment
 	{
@@ -41,10 +44,22 @@ namespace tsom
 
 		private:
 			void LoadFromDirectory();
+			std::optional<PlanetSaveHeader> LoadSaveHeader() const;
+			void SaveHeader();
+			void WaitForSave();
+
+			struct SaveJob
+			{
+				std::atomic_size_t deltaChunkCount = 0;
+				std::atomic_size_t remainingChunkCount = 0;
+			};
 
 			std::filesystem::path m_savePath;
+			std::shared_ptr<SaveJob> m_saveJob;
 			std::unordered_set<ChunkIndices /*chunkIndex*/> m_dirtyChunks;
 			entt::handle m_planetEntity;
+			Nz::UInt32 m_seed;
+			Nz::Vector3ui m_chunkCount;
 	};
 }
 
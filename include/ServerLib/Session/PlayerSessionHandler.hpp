@@ -20,6 +20,7 @@ namespace tsom
 			PlayerSessionHandler(NetworkSession* session, ServerPlayer* player);
 			~PlayerSessionHandler();
 
+			void HandlePacket(Packets::ChunkResetRequest&& chunkResetRequest);
 			void HandlePacket(Packets::ExitShipControl&& exitShipControl);
 			void HandlePacket(Packets::Interact&& interact);
 			void HandlePacket(Packets::MineBlock&& mineBlock);
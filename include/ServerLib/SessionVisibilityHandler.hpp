@@ -8,17 +8,24 @@
 #define TSOM_SERVERLIB_SESSIONVISIBILITYHANDLER_HPP
 
 #include <ServerLib/Export.hpp>
+#include <CommonLib/BulkTransferSender.hpp>
 #include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkChangeSet.hpp>
+#include <CommonLib/ChunkSendQueue.hpp>
+#include <CommonLib/CongestionController.hpp>
 #include <CommonLib/EntityProperties.hpp>
+#include <CommonLib/EntityStateTracker.hpp>
 #include <CommonLib/EnvironmentTransform.hpp>
 #include <CommonLib/PlayerInputs.hpp>
 #include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/Node.hpp>
 #include <NazaraUtils/Bitset.hpp>
 #include <entt/entt.hpp>
 #include <tsl/hopscotch_map.h>
 #include <tsl/hopscotch_set.h>
 #include <memory>
+#include <optional>
 
 namespace tsom
 {
@@ -47,16 +54,21 @@ namespace tsom
 
 			void Dispatch(Nz::UInt16 tickIndex);
 
+			inline const CongestionController& GetChunkStreamController() const;
 			inline bool GetChunkByNetworkId(Packets::Helper::ChunkId networkId, entt::handle* entityOwner, Chunk** chunk) const;
 			inline bool GetEntityByNetworkId(Packets::Helper::EntityId networkId, entt::handle* entity) const;
 			inline Packets::Helper::EnvironmentId GetEnvironmentId(ServerEnvironment* environment) const;
 
 			inline void MoveEnvironment(ServerEnvironment& environment, const EnvironmentTransform& transform);
 
+			void PrepareDispatch();
+
+			void RequestChunkReset(Packets::Helper::ChunkId chunkId);
+
 			inline void TriggerEntityRpc(entt::handle entity, Nz::UInt32 rpcIndex);
 
 			inline void UpdateControlledEntity(entt::handle entity, CharacterController* controller);
-			inline void UpdateEntityProperty(entt::handle entity, Nz::UInt32 propertyIndex);
+			inline void UpdateEntityProperties(entt::handle entity, const Nz::Bitset<Nz::UInt64>& properties);
 			void UpdateEntityEnvironment(ServerEnvironment& newEnvironment, entt::handle oldEntity, entt::handle newEntity);
 			inline void UpdateLastInputIndex(InputIndex inputIndex);
 			inline void UpdateRootEnvironment(ServerEnvironment& environment);
@@ -76,6 +88,7 @@ namespace tsom
 			};
 
 		private:
+			void CancelChunkTransfer(std::size_t chunkIndex);
 			void DispatchChunks(Nz::UInt16 tickIndex);
 			void DispatchChunkCreation(Nz::UInt16 tickIndex);
 			void DispatchChunkReset(Nz::UInt16 tickIndex);
@@ -83,7 +96,9 @@ namespace tsom
 			void DispatchEnvironments(Nz::UInt16 tickIndex);
 			void HandleEntityDestruction(entt::handle entity);
 
-			static constexpr std::size_t MaxConcurrentChunkUpdate = 3;
+			static constexpr std::size_t ChunkResetRequestsPerTick = 16;
+			static constexpr std::size_t ChunkTransferBudgetPerTick = 32 * 1024;
+			static constexpr Nz::Time PeerInfoPollInterval = Nz::Time::Milliseconds(100);
 			static constexpr std::size_t FreeChunkIdGrowRate = 128;
 			static constexpr std::size_t FreeEntityIdGrowRate = 512;
 			static constexpr std::size_t FreeNetworkIdGrowRate = 64;
@@ -95,17 +110,14 @@ namespace tsom
 			struct ChunkData
 			{
 				NazaraSlot(Chunk, OnBlockUpdated, onBlockUpdatedSlot);
+				NazaraSlot(Chunk, OnBlocksUpdated, onBlocksUpdatedSlot);
 				NazaraSlot(Chunk, OnReset, onResetSlot);
 
 				entt::handle entityOwner;
 				Chunk* chunk;
+				ChunkChangeSet changeSet;
 				Packets::ChunkUpdate chunkUpdatePacket;
-			};
-
-			struct ChunkWithPos
-			{
-				std::size_t chunkIndex;
-				Nz::Vector3f chunkCenter;
+				std::optional<BulkTransferSender::TransferId> transferId; //< chunk content being sent, updates are held until it's committed
 			};
 
 			struct EntityData
@@ -138,20 +150,29 @@ namespace tsom
 				inline std::size_t operator()(const entt::handle& handle) const;
 			};
 
+			struct Viewer
+			{
+				Nz::Vector3f direction;
+				Nz::Vector3f position;
+			};
+
 			using ChunkNetworkMap = tsl::hopscotch_map<ChunkIndices, ChunkId>;
 
 			tsl::hopscotch_map<entt::handle, EntityId, HandlerHasher> m_entityIndices;
 			tsl::hopscotch_map<entt::handle, CreateEntityData, HandlerHasher> m_createdEntities;
-			tsl::hopscotch_map<entt::handle, Nz::UInt32, HandlerHasher> m_propertyUpdatedEntities;
+			tsl::hopscotch_map<entt::handle, Nz::Bitset<Nz::UInt64>, HandlerHasher> m_propertyUpdatedEntities;
 			tsl::hopscotch_map<entt::handle, std::vector<Nz::UInt32>, HandlerHasher> m_triggeredEntitiesRpc;
 			tsl::hopscotch_map<entt::handle, ChunkNetworkMap, HandlerHasher> m_chunkNetworkMaps;
+			tsl::hopscotch_map<BulkTransferSender::TransferId, std::size_t> m_chunkTransfers;
 			tsl::hopscotch_map<const ServerEnvironment*, EnvironmentId> m_environmentIndices;
 			tsl::hopscotch_set<entt::handle, HandlerHasher> m_deletedEntities;
 			tsl::hopscotch_set<entt::handle, HandlerHasher> m_movingEntities;
-			std::shared_ptr<std::size_t> m_activeChunkUpdates;
+			std::shared_ptr<CongestionController> m_chunkStreamController;
+			BulkTransferSender m_chunkTransferSender;
+			ChunkSendQueue m_chunkResetQueue;
+			EntityStateTracker m_entityStateTracker;
 			std::vector<ServerEnvironment*> m_destroyedEnvironments;
 			std::vector<ChunkData> m_visibleChunks;
-			std::vector<ChunkWithPos> m_orderedChunkList;
 			std::vector<EntityData> m_visibleEntities;
 			std::vector<EnvironmentData> m_visibleEnvironments;
 			std::vector<EnvironmentTransformation> m_createdEnvironments;
@@ -160,13 +181,18 @@ namespace tsom
 			Nz::Bitset<Nz::UInt64> m_freeChunkIds;
 			Nz::Bitset<Nz::UInt64> m_freeEntityIds;
 			Nz::Bitset<Nz::UInt64> m_freeEnvironmentIds;
+			Nz::Bitset<Nz::UInt64> m_hashOnlyChunk;
 			Nz::Bitset<Nz::UInt64> m_newlyHiddenChunk;
 			Nz::Bitset<Nz::UInt64> m_newlyVisibleChunk;
+			Nz::Bitset<Nz::UInt64> m_newResetChunk;
+			Nz::Bitset<Nz::UInt64> m_requestedResetChunk;
 			Nz::Bitset<Nz::UInt64> m_resetChunk;
 			Nz::Bitset<Nz::UInt64> m_updatedChunk;
 			entt::handle m_controlledEntity;
 			EnvironmentId m_currentEnvironmentId;
 			InputIndex m_lastInputIndex;
+			std::optional<Viewer> m_viewer;
+			Nz::MillisecondClock m_peerInfoClock;
 			CharacterController* m_controlledCharacter;
 			NetworkSession* m_networkSession;
 			ServerEnvironment* m_nextRootEnvironment;
@@ -7,12 +7,18 @@
 namespace tsom
 {
 	inline SessionVisibilityHandler::SessionVisibilityHandler(NetworkSession* networkSession) :
+	m_chunkStreamController(std::make_shared<CongestionController>()),
+	m_chunkTransferSender(m_chunkStreamController),
 	m_currentEnvironmentId(Nz::MaxValue()),
 	m_lastInputIndex(0),
 	m_controlledCharacter(nullptr),
 	m_networkSession(networkSession)
 	{
-		m_activeChunkUpdates = std::make_shared<std::size_t>(0);
+	}
+
+	inline const CongestionController& SessionVisibilityHandler::GetChunkStreamController() const
+	{
+		return *m_chunkStreamController;
 	}
 
 	inline bool SessionVisibilityHandler::GetChunkByNetworkId(Packets::Helper::ChunkId networkId, entt::handle* entityOwner, Chunk** chunk) const
@@ -83,9 +89,9 @@ namespace tsom
 		m_movingEntities.erase(m_controlledEntity);
 	}
 
-	inline void SessionVisibilityHandler::UpdateEntityProperty(entt::handle entity, Nz::UInt32 propertyIndex)
+	inline void SessionVisibilityHandler::UpdateEntityProperties(entt::handle entity, const Nz::Bitset<Nz::UInt64>& properties)
 	{
-		m_propertyUpdatedEntities[entity] |= 1u << propertyIndex;
+		m_propertyUpdatedEntities[entity] |= properties;
 	}
 
 	inline void SessionVisibilityHandler::UpdateLastInputIndex(InputIndex inputIndex)
@@ -8,6 +8,7 @@
 #define TSOM_SERVERLIB_SYSTEMS_NETWORKEDENTITIESSYSTEM_HPP
 
 #include <ServerLib/Export.hpp>
+#include <CommonLib/EntityPropertyTracker.hpp>
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <ServerLib/SessionVisibilityHandler.hpp>
 #include <Nazara/Core/Time.hpp>
@@ -56,11 +57,13 @@ namespace tsom
 
 			tsl::hopscotch_map<entt::entity, EntityData> m_networkedEntities;
 			entt::observer m_networkedConstructObserver;
+			EntityPropertyTracker m_propertyTracker;
 			entt::scoped_connection m_disabledConstructConnection;
 			entt::scoped_connection m_networkedDestroyConnection;
 			entt::scoped_connection m_nodeDestroyConnection;
 			entt::registry& m_registry;
 			ServerEnvironment& m_environment;
+			Nz::Time m_currentTime;
 	};
 }
 
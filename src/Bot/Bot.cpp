@@ -0,0 +1,146 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Bot/Bot.hpp>
+#include <Bot/BotSessionHandler.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace tsom
+{
+	Bot::Bot(NetworkReactor& reactor, const Nz::IpAddress& serverAddress, std::string nickname, const Behavior& behavior, Nz::UInt32 seed) :
+	m_randomGenerator(seed),
+	m_nickname(std::move(nickname)),
+	m_behavior(behavior),
+	m_session(reactor, reactor.ConnectTo(serverAddress), serverAddress),
+	m_inputIndex(0),
+	m_tickCounter(0)
+	{
+		m_session.SetProtocolVersion(GameVersion);
+		m_sessionHandler = &m_session.SetupHandler<BotSessionHandler>(m_stats);
+
+		std::uniform_real_distribution<float> angleDis(-Nz::Pi<float>, Nz::Pi<float>);
+		m_yaw = angleDis(m_randomGenerator);
+
+		std::uniform_real_distribution<float> turnDis(-1.f, 1.f);
+		m_turnSpeed = turnDis(m_randomGenerator);
+	}
+
+	Bot::~Bot()
+	{
+		m_session.Disconnect();
+	}
+
+	void Bot::HandlePacket(Nz::ByteArray&& byteArray)
+	{
+		if (byteArray.GetSize() > 0)
+		{
+			Nz::UInt8 opcode = byteArray[0];
+			if (opcode < PacketCount)
+			{
+				m_stats.receivedBytes[opcode] += byteArray.GetSize();
+				m_stats.receivedPackets[opcode]++;
+			}
+		}
+
+		m_session.HandlePacket(std::move(byteArray));
+	}
+
+	bool Bot::IsAuthenticated() const
+	{
+		return m_sessionHandler->IsAuthenticated();
+	}
+
+	void Bot::OnConnected()
+	{
+		Packets::AuthRequest::AnonymousPlayerData anonymousPlayer;
+		anonymousPlayer.nickname = m_nickname;
+
+		Packets::AuthRequest request;
+		request.gameVersion = GameVersion;
+		request.token = std::move(anonymousPlayer);
+		request.compressionCapabilities = BinaryCompressor::GetLocalCapabilities();
+		request.hasChunkContentCache = false; //< always download chunk contents like a new player would
+
+		m_session.SendPacket(request);
+	}
+
+	void Bot::Tick()
+	{
+		if (!m_sessionHandler->IsAuthenticated())
+			return;
+
+		float tickDuration = Constants::TickDuration.AsSeconds<float>();
+
+		// Walk forward while slowly turning, stop and jump from time to time
+		m_tickCounter++;
+		m_yaw += Nz::RadianAnglef(m_turnSpeed * tickDuration);
+
+		PlayerInputs::Character characterInputs;
+		characterInputs.moveForward = (m_tickCounter % 600) < 480;
+		characterInputs.jump = (m_tickCounter % 300) == 0;
+		characterInputs.yaw = m_yaw;
+
+		Packets::UpdatePlayerInputs inputPacket;
+		inputPacket.inputs.index = m_inputIndex++;
+		inputPacket.inputs.data = characterInputs;
+
+		m_session.SendPacket(inputPacket);
+
+		// Blocks are picked at random in downloaded chunks, the server rejects invalid edits (mining air or placing in a filled block)
+		auto PickRandomBlock = [&](Packets::Helper::ChunkId* chunkId, Packets::Helper::VoxelLocation* voxelLoc)
+		{
+			Nz::Vector3ui chunkSize;
+			if (!m_sessionHandler->PickRandomChunk(m_randomGenerator, chunkId, &chunkSize))
+				return false;
+
+			voxelLoc->x = static_cast<Nz::UInt8>(std::uniform_int_distribution<unsigned int>(0, chunkSize.x - 1)(m_randomGenerator));
+			voxelLoc->y = static_cast<Nz::UInt8>(std::uniform_int_distribution<unsigned int>(0, chunkSize.y - 1)(m_randomGenerator));
+			voxelLoc->z = static_cast<Nz::UInt8>(std::uniform_int_distribution<unsigned int>(0, chunkSize.z - 1)(m_randomGenerator));
+			return true;
+		};
+
+		if (RollAction(m_behavior.mineRate))
+		{
+			Packets::MineBlock mineBlock;
+			if (PickRandomBlock(&mineBlock.chunkId, &mineBlock.voxelLoc))
+			{
+				m_session.SendPacket(mineBlock);
+				m_stats.minedBlockCount++;
+			}
+		}
+
+		if (RollAction(m_behavior.placeRate))
+		{
+			Packets::PlaceBlock placeBlock;
+			placeBlock.newContent = static_cast<Nz::UInt8>(m_behavior.placedBlock);
+			if (PickRandomBlock(&placeBlock.chunkId, &placeBlock.voxelLoc))
+			{
+				m_session.SendPacket(placeBlock);
+				m_stats.placedBlockCount++;
+			}
+		}
+
+		if (RollAction(m_behavior.chatRate))
+		{
+			Packets::SendChatMessage chatMessage;
+			chatMessage.message = fmt::format("beep boop #{}", m_stats.chatMessageCount);
+
+			m_session.SendPacket(chatMessage);
+			m_stats.chatMessageCount++;
+		}
+	}
+
+	bool Bot::RollAction(float ratePerSecond)
+	{
+		if (ratePerSecond <= 0.f)
+			return false;
+
+		std::bernoulli_distribution actionDis(std::min(ratePerSecond * Constants::TickDuration.AsSeconds<float>(), 1.f));
+		return actionDis(m_randomGenerator);
+	}
+}
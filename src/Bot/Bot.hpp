@@ -0,0 +1,75 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_BOT_BOT_HPP
+#define TSOM_BOT_BOT_HPP
+
+#include <Bot/BotStats.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/InputIndex.hpp>
+#include <CommonLib/NetworkSession.hpp>
+#include <Nazara/Math/Angle.hpp>
+#include <random>
+#include <string>
+
+namespace tsom
+{
+	class BotSessionHandler;
+
+	// Headless player, walking around and editing the world at configurable rates
+	class Bot
+	{
+		public:
+			struct Behavior;
+
+			Bot(NetworkReactor& reactor, const Nz::IpAddress& serverAddress, std::string nickname, const Behavior& behavior, Nz::UInt32 seed);
+			Bot(const Bot&) = delete;
+			Bot(Bot&&) = delete;
+			~Bot();
+
+			inline const std::string& GetNickname() const;
+			inline NetworkSession& GetSession();
+			inline BotStats& GetStats();
+			inline const BotStats& GetStats() const;
+
+			void HandlePacket(Nz::ByteArray&& byteArray);
+
+			bool IsAuthenticated() const;
+
+			void OnConnected();
+
+			void Tick();
+
+			Bot& operator=(const Bot&) = delete;
+			Bot& operator=(Bot&&) = delete;
+
+			struct Behavior
+			{
+				BlockIndex placedBlock;
+				float chatRate;
+				float mineRate;
+				float placeRate;
+			};
+
+		private:
+			bool RollAction(float ratePerSecond);
+
+			std::minstd_rand m_randomGenerator;
+			std::string m_nickname;
+			Behavior m_behavior;
+			BotStats m_stats;
+			BotSessionHandler* m_sessionHandler;
+			NetworkSession m_session;
+			InputIndex m_inputIndex;
+			Nz::RadianAnglef m_yaw;
+			Nz::UInt32 m_tickCounter;
+			float m_turnSpeed;
+	};
+}
+
+#include <Bot/Bot.inl>
+
+#endif // TSOM_BOT_BOT_HPP
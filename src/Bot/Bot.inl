@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline const std::string& Bot::GetNickname() const
+	{
+		return m_nickname;
+	}
+
+	inline NetworkSession& Bot::GetSession()
+	{
+		return m_session;
+	}
+
+	inline BotStats& Bot::GetStats()
+	{
+		return m_stats;
+	}
+
+	inline const BotStats& Bot::GetStats() const
+	{
+		return m_stats;
+	}
+}
@@ -0,0 +1,193 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Bot/BotAppComponent.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Utils.hpp>
+#include <Nazara/Core/ApplicationBase.hpp>
+#include <fmt/color.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+namespace tsom
+{
+	constexpr Nz::Time PeerInfoPollInterval = Nz::Time::Second();
+
+	BotAppComponent::BotAppComponent(Nz::ApplicationBase& app, const Nz::IpAddress& serverAddress, Config config) :
+	ApplicationComponent(app),
+	m_config(std::move(config)),
+	m_serverAddress(serverAddress),
+	m_elapsedTime(Nz::Time::Zero()),
+	m_nextPeerInfoPoll(PeerInfoPollInterval),
+	m_nextReport(m_config.reportInterval),
+	m_nextSpawn(Nz::Time::Zero()),
+	m_tickAccumulator(Nz::Time::Zero()),
+	m_nextBotIndex(0),
+	m_reactor(0, serverAddress.GetProtocol(), 0, m_config.botCount)
+	{
+		m_botByPeerId.resize(m_config.botCount, nullptr);
+	}
+
+	void BotAppComponent::Update(Nz::Time elapsedTime)
+	{
+		m_elapsedTime += elapsedTime;
+
+		auto ConnectionHandler = [&]([[maybe_unused]] bool outgoingConnection, std::size_t peerIndex, const Nz::IpAddress& /*remoteAddress*/, [[maybe_unused]] Nz::UInt32 data)
+		{
+			if (Bot* bot = m_botByPeerId[peerIndex])
+				bot->OnConnected();
+		};
+
+		auto DisconnectionHandler = [&](std::size_t peerIndex, [[maybe_unused]] Nz::UInt32 data, bool timeout)
+		{
+			Bot* bot = m_botByPeerId[peerIndex];
+			if (!bot)
+				return;
+
+			fmt::print(fg(fmt::color::red), "{0} has been disconnected{1}\n", bot->GetNickname(), (timeout) ? " (timeout)" : "");
+
+			m_botByPeerId[peerIndex] = nullptr;
+			auto it = std::find_if(m_bots.begin(), m_bots.end(), [&](const std::unique_ptr<Bot>& botPtr) { return botPtr.get() == bot; });
+			m_bots.erase(it);
+		};
+
+		auto PacketHandler = [&](std::size_t peerIndex, Nz::ByteArray&& packet)
+		{
+			if (Bot* bot = m_botByPeerId[peerIndex])
+				bot->HandlePacket(std::move(packet));
+		};
+
+		m_reactor.Poll(ConnectionHandler, DisconnectionHandler, PacketHandler);
+
+		// Spread connections over time, as players would
+		m_nextSpawn -= elapsedTime;
+		while (m_nextSpawn <= Nz::Time::Zero() && m_nextBotIndex < m_config.botCount)
+		{
+			SpawnBot();
+			m_nextSpawn += m_config.spawnInterval;
+		}
+
+		m_tickAccumulator += elapsedTime;
+		while (m_tickAccumulator >= Constants::TickDuration)
+		{
+			for (auto& bot : m_bots)
+				bot->Tick();
+
+			m_tickAccumulator -= Constants::TickDuration;
+		}
+
+		m_nextPeerInfoPoll -= elapsedTime;
+		if (m_nextPeerInfoPoll <= Nz::Time::Zero())
+		{
+			for (auto& bot : m_bots)
+			{
+				if (!bot->GetSession().IsConnected())
+					continue;
+
+				// Bot may have been disconnected by the time the answer is polled
+				std::size_t peerId = bot->GetSession().GetPeerId();
+				bot->GetSession().QueryInfo([this, peerId, botPtr = bot.get()](const NetworkReactor::PeerInfo& peerInfo)
+				{
+					if (m_botByPeerId[peerId] == botPtr)
+						botPtr->GetStats().ping = peerInfo.ping;
+				});
+			}
+
+			m_nextPeerInfoPoll += PeerInfoPollInterval;
+		}
+
+		m_nextReport -= elapsedTime;
+		if (m_nextReport <= Nz::Time::Zero())
+		{
+			PrintReport();
+			m_nextReport += m_config.reportInterval;
+		}
+
+		if (m_config.duration > Nz::Time::Zero() && m_elapsedTime >= m_config.duration)
+		{
+			PrintReport();
+			GetApp().Quit();
+			return;
+		}
+
+		Nz::Time nextTick = Constants::TickDuration - m_tickAccumulator;
+		if (nextTick > Nz::Time::Milliseconds(2))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	void BotAppComponent::PrintReport()
+	{
+		std::size_t authenticatedCount = std::count_if(m_bots.begin(), m_bots.end(), [](const std::unique_ptr<Bot>& bot) { return bot->IsAuthenticated(); });
+		double elapsedSeconds = m_elapsedTime.AsSeconds<double>();
+
+		fmt::print(fg(fmt::color::white), "--- {0:.1f}s: {1} bots ({2} authenticated) ---\n", elapsedSeconds, m_bots.size(), authenticatedCount);
+
+		std::array<Nz::UInt64, PacketCount> receivedBytes = {};
+		std::array<Nz::UInt64, PacketCount> receivedPackets = {};
+		for (auto& bot : m_bots)
+		{
+			BotStats& stats = bot->GetStats();
+			for (std::size_t i = 0; i < PacketCount; ++i)
+			{
+				receivedBytes[i] += stats.receivedBytes[i];
+				receivedPackets[i] += stats.receivedPackets[i];
+			}
+
+			if (m_config.perBotReport)
+			{
+				Nz::UInt64 totalBytes = std::accumulate(stats.receivedBytes.begin(), stats.receivedBytes.end(), Nz::UInt64(0));
+
+				double avgChunkDownloadTime = (stats.downloadedChunkCount > 0) ? stats.chunkDownloadTime.AsSeconds<double>() * 1000.0 / stats.downloadedChunkCount : 0.0;
+				double serverTickTime = (stats.serverTickCount > 0) ? stats.serverTickTime.AsSeconds<double>() * 1000.0 / stats.serverTickCount : 0.0;
+
+				fmt::print("{0}: rtt {1}ms, auth {2}ms, chunks {3}/{4} (avg {5:.1f}ms, max {6}ms), server tick {7:.2f}ms, received {8} ({9}), sent {10} mine, {11} place, {12} chat\n",
+					bot->GetNickname(),
+					stats.ping,
+					stats.authenticationTime.AsMilliseconds(),
+					stats.downloadedChunkCount,
+					stats.visibleChunkCount,
+					avgChunkDownloadTime,
+					stats.maxChunkDownloadTime.AsMilliseconds(),
+					serverTickTime,
+					ByteToString(totalBytes),
+					ByteToString(static_cast<Nz::UInt64>(totalBytes / std::max(elapsedSeconds, 1.0)), true),
+					stats.minedBlockCount,
+					stats.placedBlockCount,
+					stats.chatMessageCount);
+			}
+
+			// Server tick time is measured over each report interval, to see how it evolves with the load
+			stats.serverTickCount = 0;
+			stats.serverTickTime = Nz::Time::Zero();
+		}
+
+		if (m_bots.empty())
+			return;
+
+		std::array<std::size_t, PacketCount> packetOrder;
+		std::iota(packetOrder.begin(), packetOrder.end(), 0);
+		std::sort(packetOrder.begin(), packetOrder.end(), [&](std::size_t lhs, std::size_t rhs) { return receivedBytes[lhs] > receivedBytes[rhs]; });
+
+		fmt::print("received per packet type (average per bot):\n");
+		for (std::size_t packetIndex : packetOrder)
+		{
+			if (receivedPackets[packetIndex] == 0)
+				break;
+
+			fmt::print("  {0}: {1} packets, {2}\n", PacketNames[packetIndex], receivedPackets[packetIndex] / m_bots.size(), ByteToString(receivedBytes[packetIndex] / m_bots.size()));
+		}
+	}
+
+	void BotAppComponent::SpawnBot()
+	{
+		Nz::UInt32 botIndex = m_nextBotIndex++;
+
+		std::unique_ptr<Bot> bot = std::make_unique<Bot>(m_reactor, m_serverAddress, fmt::format("Bot{0}", botIndex), m_config.behavior, botIndex);
+		m_botByPeerId[bot->GetSession().GetPeerId()] = bot.get();
+
+		m_bots.push_back(std::move(bot));
+	}
+}
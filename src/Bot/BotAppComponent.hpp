@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_BOT_BOTAPPCOMPONENT_HPP
+#define TSOM_BOT_BOTAPPCOMPONENT_HPP
+
+#include <Bot/Bot.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <Nazara/Core/ApplicationComponent.hpp>
+#include <Nazara/Network/IpAddress.hpp>
+#include <memory>
+#include <vector>
+
+namespace tsom
+{
+	class BotAppComponent final : public Nz::ApplicationComponent
+	{
+		public:
+			struct Config;
+
+			BotAppComponent(Nz::ApplicationBase& app, const Nz::IpAddress& serverAddress, Config config);
+			BotAppComponent(const BotAppComponent&) = delete;
+			BotAppComponent(BotAppComponent&&) = delete;
+			~BotAppComponent() = default;
+
+			void Update(Nz::Time elapsedTime) override;
+
+			BotAppComponent& operator=(const BotAppComponent&) = delete;
+			BotAppComponent& operator=(BotAppComponent&&) = delete;
+
+			struct Config
+			{
+				Bot::Behavior behavior;
+				Nz::Time duration = Nz::Time::Zero();
+				Nz::Time reportInterval = Nz::Time::Seconds(10);
+				Nz::Time spawnInterval = Nz::Time::Milliseconds(100);
+				std::size_t botCount = 16;
+				bool perBotReport = true;
+			};
+
+		private:
+			void PrintReport();
+			void SpawnBot();
+
+			std::vector<std::unique_ptr<Bot>> m_bots;
+			std::vector<Bot*> m_botByPeerId;
+			Config m_config;
+			Nz::IpAddress m_serverAddress;
+			Nz::Time m_elapsedTime;
+			Nz::Time m_nextPeerInfoPoll;
+			Nz::Time m_nextReport;
+			Nz::Time m_nextSpawn;
+			Nz::Time m_tickAccumulator;
+			Nz::UInt32 m_nextBotIndex;
+			NetworkReactor m_reactor;
+	};
+}
+
+#include <Bot/BotAppComponent.inl>
+
+#endif // TSOM_BOT_BOTAPPCOMPONENT_HPP
@@ -0,0 +1,41 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Bot/BotConfigAppComponent.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <fmt/color.h>
+#include <fmt/format.h>
+
+namespace tsom
+{
+	BotConfigFile::BotConfigFile()
+	{
+		RegisterStringOption("Server.Address", "localhost");
+		RegisterIntegerOption("Server.Port", 1, 0xFFFF, 29536);
+		RegisterIntegerOption("Bot.Count", 1, 4095, 16);
+		RegisterFloatOption("Bot.SpawnRate", 0.1, 1000.0, 10.0);
+		RegisterIntegerOption("Bot.Duration", 0, 24 * 60 * 60, 0);
+		RegisterFloatOption("Bot.ChatRate", 0.0, 60.0, 0.05);
+		RegisterFloatOption("Bot.MineRate", 0.0, 60.0, 0.5);
+		RegisterFloatOption("Bot.PlaceRate", 0.0, 60.0, 0.5);
+		RegisterStringOption("Bot.PlacedBlock", "stone");
+		RegisterIntegerOption("Report.Interval", 1, 60 * 60, 10);
+		RegisterBoolOption("Report.PerBot", true);
+	}
+
+
+	BotConfigAppComponent::BotConfigAppComponent(Nz::ApplicationBase& app) :
+	ApplicationComponent(app)
+	{
+		std::filesystem::path configPath = Nz::Utf8Path("botconfig.lua");
+		std::filesystem::path defaultConfigPath = configPath;
+		defaultConfigPath.replace_extension(Nz::Utf8Path(".lua.default"));
+
+		if (!std::filesystem::is_regular_file(configPath) && std::filesystem::is_regular_file(defaultConfigPath))
+			configPath = std::move(defaultConfigPath);
+
+		if (!m_configFile.LoadFromFile(configPath))
+			fmt::print(fg(fmt::color::red), "failed to load bot config\n");
+	}
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_BOT_BOTCONFIGAPPCOMPONENT_HPP
+#define TSOM_BOT_BOTCONFIGAPPCOMPONENT_HPP
+
+#include <CommonLib/ConfigFile.hpp>
+#include <Nazara/Core/ApplicationComponent.hpp>
+
+namespace tsom
+{
+	class BotConfigFile : public ConfigFile
+	{
+		public:
+			BotConfigFile();
+	};
+
+	class BotConfigAppComponent final : public Nz::ApplicationComponent
+	{
+		public:
+			BotConfigAppComponent(Nz::ApplicationBase& app);
+			BotConfigAppComponent(const BotConfigAppComponent&) = delete;
+			BotConfigAppComponent(BotConfigAppComponent&&) = delete;
+			~BotConfigAppComponent() = default;
+
+			inline BotConfigFile& GetConfig();
+			inline const BotConfigFile& GetConfig() const;
+
+			BotConfigAppComponent& operator=(const BotConfigAppComponent&) = delete;
+			BotConfigAppComponent& operator=(BotConfigAppComponent&&) = delete;
+
+		private:
+			BotConfigFile m_configFile;
+	};
+}
+
+#include <Bot/BotConfigAppComponent.inl>
+
+#endif // TSOM_BOT_BOTCONFIGAPPCOMPONENT_HPP
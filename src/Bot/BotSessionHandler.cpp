@@ -0,0 +1,161 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Bot/BotSessionHandler.hpp>
+#include <CommonLib/NetworkSession.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <fmt/color.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
+
+namespace tsom
+{
+	constexpr SessionHandler::SendAttributeTable s_packetAttributes = SessionHandler::BuildAttributeTable({
+		{ PacketIndex<Packets::AuthRequest>,        { .channel = 0, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkResetRequest>,  { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::MineBlock>,          { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::PlaceBlock>,         { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::SendChatMessage>,    { .channel = 0, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::UpdatePlayerInputs>, { .channel = 1, .flags = Nz::ENetPacketFlag_Unreliable } }
+	});
+
+	BotSessionHandler::BotSessionHandler(NetworkSession* session, BotStats& stats) :
+	SessionHandler(session),
+	m_stats(stats),
+	m_connectionTime(Nz::GetElapsedNanoseconds()),
+	m_isAuthenticated(false)
+	{
+		SetupHandlerTable(this);
+		SetupAttributeTable(s_packetAttributes);
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::AuthResponse&& authResponse)
+	{
+		if (authResponse.authResult.IsErr())
+		{
+			fmt::print(fg(fmt::color::red), "bot {0} failed to authenticate: {1}\n", GetSession()->GetPeerId(), ToString(authResponse.authResult.GetError()));
+			return;
+		}
+
+		m_isAuthenticated = true;
+		m_stats.authenticationTime = Nz::GetElapsedNanoseconds() - m_connectionTime;
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::BulkCancel&& bulkCancel)
+	{
+		m_bulkTransferReceiver.Cancel(bulkCancel.transferId);
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::BulkCommit&& bulkCommit)
+	{
+		std::optional<Nz::ByteArray> payload = m_bulkTransferReceiver.Commit(bulkCommit.transferId);
+		if (!payload)
+			return;
+
+		SessionHandler::HandlePacket(std::move(*payload));
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::BulkFragment&& bulkFragment)
+	{
+		m_bulkTransferReceiver.HandleFragment(std::move(bulkFragment));
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::ChunkCreate&& chunkCreate)
+	{
+		ChunkData& chunkData = m_chunks[chunkCreate.chunkId];
+		chunkData.creationTime = Nz::GetElapsedNanoseconds();
+		chunkData.hasContent = false;
+		chunkData.size = Nz::Vector3ui(chunkCreate.chunkSizeX, chunkCreate.chunkSizeY, chunkCreate.chunkSizeZ);
+
+		m_stats.visibleChunkCount = m_chunks.size();
+
+		// Bots don't advertise a chunk cache and shouldn't receive hashes, download the content anyway if the server sent one
+		if (chunkCreate.contentHash)
+		{
+			Packets::ChunkResetRequest resetRequest;
+			resetRequest.chunkId = chunkCreate.chunkId;
+
+			GetSession()->SendPacket(resetRequest);
+		}
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::ChunkDestroy&& chunkDestroy)
+	{
+		auto it = m_chunks.find(chunkDestroy.chunkId);
+		if (it == m_chunks.end())
+			return;
+
+		if (it->second.hasContent)
+		{
+			auto chunkIt = std::find(m_downloadedChunks.begin(), m_downloadedChunks.end(), chunkDestroy.chunkId);
+			assert(chunkIt != m_downloadedChunks.end());
+
+			std::swap(*chunkIt, m_downloadedChunks.back());
+			m_downloadedChunks.pop_back();
+		}
+
+		m_chunks.erase(it);
+		m_stats.visibleChunkCount = m_chunks.size();
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::ChunkReset&& chunkReset)
+	{
+		auto it = m_chunks.find(chunkReset.chunkId);
+		if (it == m_chunks.end())
+			return;
+
+		ChunkData& chunkData = it.value();
+		if (chunkData.hasContent)
+			return; //< only the first reset is the chunk download
+
+		chunkData.hasContent = true;
+		m_downloadedChunks.push_back(chunkReset.chunkId);
+
+		Nz::Time downloadTime = Nz::GetElapsedNanoseconds() - chunkData.creationTime;
+		m_stats.chunkDownloadTime += downloadTime;
+		m_stats.maxChunkDownloadTime = std::max(m_stats.maxChunkDownloadTime, downloadTime);
+		m_stats.downloadedChunkCount++;
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::EntitiesStateUpdate&& stateUpdate)
+	{
+		// Server doesn't send its tick duration, measure how fast tick indices are progressing instead
+		Nz::Time now = Nz::GetElapsedNanoseconds();
+		if (m_lastTickIndex)
+		{
+			Nz::UInt16 tickDifference = static_cast<Nz::UInt16>(stateUpdate.tickIndex - *m_lastTickIndex);
+			if (tickDifference == 0 || tickDifference > 0x7FFF)
+				return; //< unreliable packet received out of order
+
+			m_stats.serverTickCount += tickDifference;
+			m_stats.serverTickTime += now - m_lastTickTime;
+		}
+
+		m_lastTickIndex = stateUpdate.tickIndex;
+		m_lastTickTime = now;
+	}
+
+	void BotSessionHandler::HandlePacket(Packets::NetworkStrings&& networkStrings)
+	{
+		GetSession()->GetStringStore().FillStore(networkStrings.startId, std::move(networkStrings.strings));
+	}
+
+	void BotSessionHandler::OnUnexpectedPacket(std::size_t /*packetIndex*/)
+	{
+		// Bots ignore packets they don't need
+	}
+
+	bool BotSessionHandler::PickRandomChunk(std::minstd_rand& randomGenerator, Packets::Helper::ChunkId* chunkId, Nz::Vector3ui* chunkSize) const
+	{
+		if (m_downloadedChunks.empty())
+			return false;
+
+		std::uniform_int_distribution<std::size_t> chunkDis(0, m_downloadedChunks.size() - 1);
+		*chunkId = m_downloadedChunks[chunkDis(randomGenerator)];
+		*chunkSize = m_chunks.at(*chunkId).size;
+
+		return true;
+	}
+}
@@ -0,0 +1,70 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_BOT_BOTSESSIONHANDLER_HPP
+#define TSOM_BOT_BOTSESSIONHANDLER_HPP
+
+#include <Bot/BotStats.hpp>
+#include <CommonLib/BulkTransferReceiver.hpp>
+#include <CommonLib/SessionHandler.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <tsl/hopscotch_map.h>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace tsom
+{
+	// Only handles what a headless client needs to keep up with the server, other packets are dropped
+	class BotSessionHandler : public SessionHandler
+	{
+		public:
+			BotSessionHandler(NetworkSession* session, BotStats& stats);
+			BotSessionHandler(const BotSessionHandler&) = delete;
+			BotSessionHandler(BotSessionHandler&&) = delete;
+			~BotSessionHandler() = default;
+
+			inline bool IsAuthenticated() const;
+
+			void HandlePacket(Packets::AuthResponse&& authResponse);
+			void HandlePacket(Packets::BulkCancel&& bulkCancel);
+			void HandlePacket(Packets::BulkCommit&& bulkCommit);
+			void HandlePacket(Packets::BulkFragment&& bulkFragment);
+			void HandlePacket(Packets::ChunkCreate&& chunkCreate);
+			void HandlePacket(Packets::ChunkDestroy&& chunkDestroy);
+			void HandlePacket(Packets::ChunkReset&& chunkReset);
+			void HandlePacket(Packets::EntitiesStateUpdate&& stateUpdate);
+			void HandlePacket(Packets::NetworkStrings&& networkStrings);
+
+			void OnUnexpectedPacket(std::size_t packetIndex) override;
+
+			bool PickRandomChunk(std::minstd_rand& randomGenerator, Packets::Helper::ChunkId* chunkId, Nz::Vector3ui* chunkSize) const;
+
+			BotSessionHandler& operator=(const BotSessionHandler&) = delete;
+			BotSessionHandler& operator=(BotSessionHandler&&) = delete;
+
+		private:
+			struct ChunkData
+			{
+				Nz::Vector3ui size;
+				Nz::Time creationTime;
+				bool hasContent = false;
+			};
+
+			std::optional<Nz::UInt16> m_lastTickIndex;
+			std::vector<Packets::Helper::ChunkId> m_downloadedChunks;
+			tsl::hopscotch_map<Packets::Helper::ChunkId, ChunkData> m_chunks;
+			BotStats& m_stats;
+			BulkTransferReceiver m_bulkTransferReceiver;
+			Nz::Time m_connectionTime;
+			Nz::Time m_lastTickTime;
+			bool m_isAuthenticated;
+	};
+}
+
+#include <Bot/BotSessionHandler.inl>
+
+#endif // TSOM_BOT_BOTSESSIONHANDLER_HPP
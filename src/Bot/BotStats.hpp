@@ -0,0 +1,36 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_BOT_BOTSTATS_HPP
+#define TSOM_BOT_BOTSTATS_HPP
+
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <array>
+
+namespace tsom
+{
+	struct BotStats
+	{
+		std::array<Nz::UInt64, PacketCount> receivedBytes = {};
+		std::array<Nz::UInt64, PacketCount> receivedPackets = {};
+		std::size_t chatMessageCount = 0;
+		std::size_t downloadedChunkCount = 0;
+		std::size_t minedBlockCount = 0;
+		std::size_t placedBlockCount = 0;
+		std::size_t visibleChunkCount = 0;
+		Nz::Time authenticationTime = Nz::Time::Zero();
+		Nz::Time chunkDownloadTime = Nz::Time::Zero();
+		Nz::Time maxChunkDownloadTime = Nz::Time::Zero();
+		Nz::UInt32 ping = 0;
+
+		// Measured from the tick indices of received state updates, reset on each report
+		Nz::UInt64 serverTickCount = 0;
+		Nz::Time serverTickTime = Nz::Time::Zero();
+	};
+}
+
+#endif // TSOM_BOT_BOTSTATS_HPP
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Bot/BotAppComponent.hpp>
+#include <Bot/BotConfigAppComponent.hpp>
+#include <CommonLib/BlockLibrary.hpp>
+#include <Nazara/Core/Application.hpp>
+#include <Nazara/Core/Core.hpp>
+#include <Nazara/Core/SignalHandlerAppComponent.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <Main/Main.hpp>
+#include <fmt/color.h>
+#include <string>
+
+int BotMain(int argc, char* argv[])
+{
+	Nz::Application<Nz::Core, Nz::Network> app(argc, argv);
+
+	app.AddComponent<Nz::SignalHandlerAppComponent>();
+	auto& configAppComponent = app.AddComponent<tsom::BotConfigAppComponent>();
+
+	auto& config = configAppComponent.GetConfig();
+
+	const std::string& serverHostname = config.GetStringValue("Server.Address");
+	Nz::UInt16 serverPort = config.GetIntegerValue<Nz::UInt16>("Server.Port");
+
+	Nz::ResolveError resolveError;
+	auto hostVec = Nz::IpAddress::ResolveHostname(Nz::NetProtocol::Any, serverHostname, std::to_string(serverPort), &resolveError);
+	if (hostVec.empty())
+	{
+		fmt::print(fg(fmt::color::red), "failed to resolve {}: {}\n", serverHostname, Nz::ErrorToString(resolveError));
+		return EXIT_FAILURE;
+	}
+
+	tsom::BlockLibrary blockLibrary;
+
+	const std::string& placedBlockName = config.GetStringValue("Bot.PlacedBlock");
+	tsom::BlockIndex placedBlock = blockLibrary.GetBlockIndex(placedBlockName);
+	if (placedBlock == tsom::InvalidBlockIndex)
+	{
+		fmt::print(fg(fmt::color::red), "unknown block {}\n", placedBlockName);
+		return EXIT_FAILURE;
+	}
+
+	tsom::BotAppComponent::Config botConfig;
+	botConfig.behavior.chatRate = config.GetFloatValue<float>("Bot.ChatRate");
+	botConfig.behavior.mineRate = config.GetFloatValue<float>("Bot.MineRate");
+	botConfig.behavior.placeRate = config.GetFloatValue<float>("Bot.PlaceRate");
+	botConfig.behavior.placedBlock = placedBlock;
+	botConfig.botCount = config.GetIntegerValue<std::size_t>("Bot.Count");
+	botConfig.duration = Nz::Time::Seconds(config.GetIntegerValue<long long>("Bot.Duration"));
+	botConfig.perBotReport = config.GetBoolValue("Report.PerBot");
+	botConfig.reportInterval = Nz::Time::Seconds(config.GetIntegerValue<long long>("Report.Interval"));
+	botConfig.spawnInterval = Nz::Time::Seconds(1.0 / config.GetFloatValue<double>("Bot.SpawnRate"));
+
+	fmt::print(fg(fmt::color::lime_green), "spawning {0} bots on {1}\n", botConfig.botCount, hostVec[0].address.ToString());
+
+	app.AddComponent<tsom::BotAppComponent>(hostVec[0].address, std::move(botConfig));
+
+	return app.Run();
+}
+
+TSOMMain(BotMain)
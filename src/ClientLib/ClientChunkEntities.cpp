@@ -221,9 +221,8 @@ namespace tsom
 			if (updateJob->cancelled)
 				return;
 
-			chunkPtr->LockRead();
+			// BuildCollider works on a chunk snapshot and doesn't require the chunk to be locked
 			updateJob->collider = chunkPtr->BuildCollider();
-			chunkPtr->UnlockRead();
 
 			updateJob->jobDone++;
 		});
@@ -15,6 +15,8 @@
 #include <ClientLib/Entities/ClientChunkClassLibrary.hpp>
 #include <ClientLib/Scripting/ClientEntityScriptingLibrary.hpp>
 #include <ClientLib/Scripting/ClientScriptingLibrary.hpp>
+#include <CommonLib/ChunkContentCache.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
 #include <CommonLib/GameConstants.hpp>
 #include <CommonLib/NetworkSession.hpp>
 #include <CommonLib/PhysicsConstants.hpp>
@@ -50,6 +52,7 @@ namespace tsom
 {
 	constexpr SessionHandler::SendAttributeTable s_packetAttributes = SessionHandler::BuildAttributeTable({
 		{ PacketIndex<Packets::AuthRequest>,        { .channel = 0, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkResetRequest>,  { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
 		{ PacketIndex<Packets::ExitShipControl>,    { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
 		{ PacketIndex<Packets::Interact>,           { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
 		{ PacketIndex<Packets::MineBlock>,          { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
@@ -63,6 +66,7 @@ namespace tsom
 	m_app(app),
 	m_world(world),
 	m_blockLibrary(blockLibrary),
+	m_chunkContentCache(nullptr),
 	m_ownPlayerIndex(InvalidPlayerIndex),
 	m_currentEnvironmentIndex(Nz::MaxValue()),
 	m_scriptingContext(app),
@@ -104,6 +108,31 @@ namespace tsom
 		OnAuthResponse(authResponse);
 	}
 
+	void ClientSessionHandler::HandlePacket(Packets::BulkCancel&& bulkCancel)
+	{
+		m_bulkTransferReceiver.Cancel(bulkCancel.transferId);
+	}
+
+	void ClientSessionHandler::HandlePacket(Packets::BulkCommit&& bulkCommit)
+	{
+		std::optional<Nz::ByteArray> payload = m_bulkTransferReceiver.Commit(bulkCommit.transferId);
+		if (!payload)
+		{
+			fmt::print(fg(fmt::color::red), "BulkCommit handler: unknown or incomplete transfer {}\n", Nz::UInt32(bulkCommit.transferId));
+			return;
+		}
+
+		// Handle the reassembled packet as if it was just received
+		SessionHandler::HandlePacket(std::move(*payload));
+	}
+
+	void ClientSessionHandler::HandlePacket(Packets::BulkFragment&& bulkFragment)
+	{
+		Nz::UInt32 transferId = bulkFragment.transferId;
+		if (!m_bulkTransferReceiver.HandleFragment(std::move(bulkFragment)))
+			fmt::print(fg(fmt::color::red), "BulkFragment handler: invalid fragment for transfer {}\n", transferId);
+	}
+
 	void ClientSessionHandler::HandlePacket(Packets::ChatMessage&& chatMessage)
 	{
 		if (chatMessage.playerIndex)
@@ -136,6 +165,23 @@ namespace tsom
 		auto& chunkNetworkMap = entity.get<ChunkNetworkMapComponent>();
 		chunkNetworkMap.chunkByNetworkIndex.emplace(chunkCreate.chunkId, chunk);
 		chunkNetworkMap.chunkNetworkIndices.emplace(chunk, chunkCreate.chunkId);
+
+		// Server only sent the content hash, load the chunk from the cache or ask for its content
+		if (chunkCreate.contentHash)
+		{
+			std::optional<Nz::UInt64> loadId;
+			if (m_chunkContentCache)
+				loadId = m_chunkContentCache->RequestLoad(*chunkCreate.contentHash, chunk->GetSize());
+
+			if (loadId)
+			{
+				// Content is applied once loaded by the cache worker (see Update)
+				m_pendingChunkLoads.emplace(*loadId, PendingChunkLoad{ .chunk = chunk, .chunkId = chunkCreate.chunkId });
+				m_pendingChunkLoadByChunk.emplace(chunk, *loadId);
+			}
+			else
+				RequestChunkReset(chunkCreate.chunkId);
+		}
 	}
 
 	void ClientSessionHandler::HandlePacket(Packets::ChunkDestroy&& chunkDestroy)
@@ -147,6 +193,16 @@ namespace tsom
 		auto it = chunkNetworkMap.chunkByNetworkIndex.find(chunkDestroy.chunkId);
 
 		Chunk* chunk = it->second;
+
+		// Keep the final content of the chunk, in case it becomes visible again
+		if (m_chunkContentCache && chunk->HasContent())
+		{
+			std::shared_ptr<const ChunkSnapshot> snapshot = chunk->GetSnapshot();
+			m_chunkContentCache->Store(snapshot->GetSize(), std::vector<BlockIndex>(snapshot->GetContent(), snapshot->GetContent() + snapshot->GetBlockCount()));
+		}
+
+		CancelChunkLoad(chunk);
+
 		chunk->GetContainer().RemoveChunk(chunk->GetIndices());
 
 		chunkNetworkMap.chunkNetworkIndices.erase(chunk);
@@ -173,6 +229,12 @@ namespace tsom
 				*blocks++ = blockContent;
 		});
 		chunk->UnlockWrite();
+
+		// Received content is more recent than the cached one
+		CancelChunkLoad(chunk);
+
+		if (m_chunkContentCache && chunkReset.content.size() == chunk->GetBlockCount())
+			m_chunkContentCache->Store(chunk->GetSize(), std::move(chunkReset.content));
 	}
 
 	void ClientSessionHandler::HandlePacket(Packets::ChunkUpdate&& chunkUpdate)
@@ -182,11 +244,27 @@ namespace tsom
 		auto& chunkNetworkMap = entity.get<ChunkNetworkMapComponent>();
 
 		Chunk* chunk = Nz::Retrieve(chunkNetworkMap.chunkByNetworkIndex, chunkUpdate.chunkId);
-		chunk->LockWrite();
 
+		std::vector<Chunk::BlockUpdate> blockUpdates;
+		blockUpdates.reserve(chunkUpdate.updates.size());
 		for (auto&& [blockPos, blockIndex] : chunkUpdate.updates)
-			chunk->UpdateBlock({ blockPos.x, blockPos.y, blockPos.z }, Nz::SafeCast<BlockIndex>(blockIndex));
+			blockUpdates.push_back({ { blockPos.x, blockPos.y, blockPos.z }, Nz::SafeCast<BlockIndex>(blockIndex) });
 
+		if (!chunk->HasContent())
+		{
+			// Cached content matches the chunk when it was created, apply the updates received since then once it's loaded
+			if (auto it = m_pendingChunkLoadByChunk.find(chunk); it != m_pendingChunkLoadByChunk.end())
+			{
+				std::vector<Chunk::BlockUpdate>& pendingUpdates = m_pendingChunkLoads[it->second].blockUpdates;
+				pendingUpdates.insert(pendingUpdates.end(), blockUpdates.begin(), blockUpdates.end());
+			}
+
+			// Otherwise chunk content was requested and not received yet, it will include those updates
+			return;
+		}
+
+		chunk->LockWrite();
+		chunk->UpdateBlocks(blockUpdates);
 		chunk->UnlockWrite();
 	}
 
@@ -387,7 +465,8 @@ namespace tsom
 		EntityData& entityData = *m_entities[propertyUpdate.entity];
 
 		auto& classInstance = entityData.entity.get<ClassInstanceComponent>();
-		classInstance.UpdateProperty(propertyUpdate.propertyIndex, std::move(propertyUpdate.propertyValue));
+		for (auto& property : propertyUpdate.properties)
+			classInstance.UpdateProperty(property.propertyIndex, std::move(property.propertyValue));
 	}
 
 	void ClientSessionHandler::HandlePacket(Packets::EnvironmentCreate&& envCreate)
@@ -549,6 +628,63 @@ namespace tsom
 		});
 	}
 
+	void ClientSessionHandler::Update()
+	{
+		if (m_chunkContentCache)
+		{
+			m_chunkContentCache->PollLoads([&](Nz::UInt64 loadId, std::optional<std::vector<BlockIndex>>&& content)
+			{
+				// Chunk may have been destroyed or reset since (or the load was requested by a previous session)
+				auto it = m_pendingChunkLoads.find(loadId);
+				if (it == m_pendingChunkLoads.end())
+					return;
+
+				PendingChunkLoad pendingLoad = std::move(it.value());
+				m_pendingChunkLoads.erase(it);
+				m_pendingChunkLoadByChunk.erase(pendingLoad.chunk);
+
+				if (!content)
+				{
+					RequestChunkReset(pendingLoad.chunkId);
+					return;
+				}
+
+				Chunk* chunk = pendingLoad.chunk;
+				chunk->LockWrite();
+				chunk->Reset([&](BlockIndex* blocks)
+				{
+					std::copy(content->begin(), content->end(), blocks);
+				});
+
+				if (!pendingLoad.blockUpdates.empty())
+					chunk->UpdateBlocks(pendingLoad.blockUpdates);
+
+				chunk->UnlockWrite();
+			});
+		}
+
+		// Called once per frame, the tick time budget applies to scripts run during a frame
+		m_scriptingContext.GetCpuMonitor().ResetTickTime();
+	}
+
+	void ClientSessionHandler::CancelChunkLoad(const Chunk* chunk)
+	{
+		auto it = m_pendingChunkLoadByChunk.find(chunk);
+		if (it == m_pendingChunkLoadByChunk.end())
+			return;
+
+		m_pendingChunkLoads.erase(it->second);
+		m_pendingChunkLoadByChunk.erase(it);
+	}
+
+	void ClientSessionHandler::RequestChunkReset(Packets::Helper::ChunkId chunkId)
+	{
+		Packets::ChunkResetRequest resetRequest;
+		resetRequest.chunkId = chunkId;
+
+		GetSession()->SendPacket(resetRequest);
+	}
+
 	void ClientSessionHandler::SetupEntity(entt::handle entity, Packets::Helper::PlayerControlledData&& entityData)
 	{
 		auto collider = std::make_shared<Nz::CapsuleCollider3D>(Constants::PlayerCapsuleHeight, Constants::PlayerColliderRadius);
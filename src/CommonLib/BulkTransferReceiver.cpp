@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/BulkTransferReceiver.hpp>
+#include <cstring>
+
+namespace tsom
+{
+	void BulkTransferReceiver::Cancel(TransferId transferId)
+	{
+		auto it = m_pendingTransfers.find(transferId);
+		if (it == m_pendingTransfers.end())
+			return;
+
+		m_pendingBytes -= it->second.payload.GetSize();
+		m_pendingTransfers.erase(it);
+	}
+
+	std::optional<Nz::ByteArray> BulkTransferReceiver::Commit(TransferId transferId)
+	{
+		auto it = m_pendingTransfers.find(transferId);
+		if (it == m_pendingTransfers.end())
+			return std::nullopt;
+
+		PendingTransfer& transfer = it.value();
+		if (transfer.receivedBytes != transfer.payload.GetSize())
+			return std::nullopt; //< commits are only sent once all fragments were acknowledged
+
+		Nz::ByteArray payload = std::move(transfer.payload);
+		m_pendingBytes -= payload.GetSize();
+		m_pendingTransfers.erase(it);
+
+		return payload;
+	}
+
+	bool BulkTransferReceiver::HandleFragment(Packets::BulkFragment&& fragment)
+	{
+		// Fragments are sent on a reliable channel, they're received in order
+		if (fragment.offset == 0)
+		{
+			if (m_pendingTransfers.contains(fragment.transferId))
+				return false;
+
+			if (fragment.totalSize > Constants::BulkTransferMaxSize || m_pendingBytes + fragment.totalSize > m_maxPendingBytes)
+				return false;
+
+			PendingTransfer transfer;
+			transfer.payload.Resize(fragment.totalSize);
+			transfer.receivedBytes = 0;
+
+			m_pendingBytes += fragment.totalSize;
+			m_pendingTransfers.emplace(fragment.transferId, std::move(transfer));
+		}
+
+		auto it = m_pendingTransfers.find(fragment.transferId);
+		if (it == m_pendingTransfers.end())
+			return false;
+
+		PendingTransfer& transfer = it.value();
+		if (fragment.totalSize != transfer.payload.GetSize() || fragment.offset != transfer.receivedBytes || transfer.receivedBytes + fragment.data.size() > transfer.payload.GetSize())
+			return false;
+
+		if (!fragment.data.empty())
+			std::memcpy(transfer.payload.GetBuffer() + transfer.receivedBytes, fragment.data.data(), fragment.data.size());
+
+		transfer.receivedBytes += fragment.data.size();
+
+		return true;
+	}
+}
@@ -0,0 +1,136 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/BulkTransferSender.hpp>
+#include <NazaraUtils/Algorithm.hpp>
+#include <algorithm>
+
+namespace tsom
+{
+	bool BulkTransferSender::Cancel(TransferId transferId)
+	{
+		// Returns true if the receiver got (or may have got) fragments of this transfer and has to be notified
+		if (auto it = std::find_if(m_queuedTransfers.begin(), m_queuedTransfers.end(), [&](const QueuedTransfer& transfer) { return transfer.transferId == transferId; }); it != m_queuedTransfers.end())
+		{
+			bool hasSentFragments = (it->sentBytes > 0);
+			m_queuedBytes -= it->payload.GetSize() - it->sentBytes;
+			m_queuedTransfers.erase(it);
+
+			return hasSentFragments;
+		}
+
+		if (auto it = std::find_if(m_inFlightTransfers.begin(), m_inFlightTransfers.end(), [&](const InFlightTransfer& transfer) { return transfer.transferId == transferId; }); it != m_inFlightTransfers.end())
+		{
+			m_inFlightTransfers.erase(it);
+			return true;
+		}
+
+		return false;
+	}
+
+	auto BulkTransferSender::Enqueue(Nz::ByteArray payload) -> TransferId
+	{
+		assert(payload.GetSize() <= Constants::BulkTransferMaxSize);
+
+		TransferId transferId = m_nextTransferId++;
+		m_queuedBytes += payload.GetSize();
+
+		m_queuedTransfers.push_back({
+			.transferId = transferId,
+			.payload = std::move(payload),
+			.sentBytes = 0,
+			.unacknowledgedFragments = std::make_shared<std::atomic_size_t>(0)
+		});
+
+		return transferId;
+	}
+
+	std::size_t BulkTransferSender::Flush(std::size_t byteBudget, const SendFragmentCallback& sendFragment)
+	{
+		std::size_t sentBytes = 0;
+		while (!m_queuedTransfers.empty())
+		{
+			QueuedTransfer& transfer = m_queuedTransfers.front();
+
+			std::size_t payloadSize = transfer.payload.GetSize();
+			std::size_t fragmentSize = std::min(m_fragmentSize, payloadSize - transfer.sentBytes);
+
+			Packets::BulkFragment fragment;
+			fragment.transferId = transfer.transferId;
+			fragment.offset = Nz::SafeCast<Nz::UInt32>(transfer.sentBytes);
+			fragment.totalSize = Nz::SafeCast<Nz::UInt32>(payloadSize);
+
+			// Budget and congestion window are counted in serialized packet bytes, as reported by the send callback
+			std::size_t expectedPacketSize = ComputeFragmentPacketSize(fragment.transferId, fragment.offset, fragment.totalSize, fragmentSize);
+			if (sentBytes + expectedPacketSize > byteBudget)
+				break;
+
+			if (m_congestionController && !m_congestionController->CanSend(expectedPacketSize))
+				break;
+
+			fragment.data.assign(transfer.payload.GetConstBuffer() + transfer.sentBytes, transfer.payload.GetConstBuffer() + transfer.sentBytes + fragmentSize);
+
+			// Count the fragment before sending it as it may be acknowledged right away by the network thread
+			transfer.unacknowledgedFragments->fetch_add(1, std::memory_order_relaxed);
+
+			std::size_t packetSize = sendFragment(fragment, [controller = m_congestionController, unacknowledgedFragments = transfer.unacknowledgedFragments](std::size_t packetSize)
+			{
+				if (controller)
+					controller->OnAcknowledged(packetSize);
+
+				unacknowledgedFragments->fetch_sub(1, std::memory_order_release);
+			});
+
+			if (m_congestionController)
+				m_congestionController->OnSent(packetSize);
+
+			sentBytes += packetSize;
+			transfer.sentBytes += fragmentSize;
+			m_queuedBytes -= fragmentSize;
+
+			if (transfer.sentBytes == payloadSize)
+			{
+				m_inFlightTransfers.push_back({
+					.transferId = transfer.transferId,
+					.unacknowledgedFragments = std::move(transfer.unacknowledgedFragments)
+				});
+
+				m_queuedTransfers.pop_front();
+			}
+		}
+
+		return sentBytes;
+	}
+
+	std::size_t BulkTransferSender::ComputeFragmentPacketSize(Nz::UInt32 transferId, Nz::UInt32 offset, Nz::UInt32 totalSize, std::size_t fragmentSize)
+	{
+		// Compressed integers use 7 bits per byte
+		auto CompressedSize = [](std::size_t value)
+		{
+			std::size_t size = 1;
+			while (value >>= 7)
+				size++;
+
+			return size;
+		};
+
+		constexpr std::size_t OpcodeSize = sizeof(Nz::UInt8);
+		return OpcodeSize + CompressedSize(transferId) + CompressedSize(offset) + CompressedSize(totalSize) + CompressedSize(fragmentSize) + fragmentSize;
+	}
+
+	void BulkTransferSender::PollCompletedTransfers(const Nz::FunctionRef<void(TransferId transferId)>& callback)
+	{
+		// Transfers are reported in the order they were sent
+		auto it = m_inFlightTransfers.begin();
+		for (; it != m_inFlightTransfers.end(); ++it)
+		{
+			if (it->unacknowledgedFragments->load(std::memory_order_acquire) != 0)
+				break;
+
+			callback(it->transferId);
+		}
+
+		m_inFlightTransfers.erase(m_inFlightTransfers.begin(), it);
+	}
+}
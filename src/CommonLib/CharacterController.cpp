@@ -7,6 +7,7 @@
 #include <CommonLib/GameConstants.hpp>
 #include <CommonLib/GravityController.hpp>
 #include <CommonLib/ShipController.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <Nazara/Physics3D/PhysWorld3D.hpp>
 #include <Nazara/Physics3D/RigidBody3D.hpp>
 #include <fmt/ostream.h>
@@ -28,6 +29,8 @@ namespace tsom
 
 	void CharacterController::PostSimulate(Nz::PhysCharacter3D& character, float elapsedTime)
 	{
+		TickProfiler::Zone profileZone("CharacterController::PostSimulate");
+
 		PlayerInputs::Character characterInputs;
 		if (std::holds_alternative<PlayerInputs::Character>(m_lastInputs.data))
 			characterInputs = std::get<PlayerInputs::Character>(m_lastInputs.data);
@@ -87,6 +90,8 @@ namespace tsom
 
 	void CharacterController::PreSimulate(Nz::PhysCharacter3D& character, float elapsedTime)
 	{
+		TickProfiler::Zone profileZone("CharacterController::PreSimulate");
+
 		UpdatePosition(character);
 
 		Nz::Vector3f velocity = character.GetLinearVelocity();
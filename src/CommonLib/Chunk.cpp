@@ -6,15 +6,46 @@
 #include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/ChunkContainer.hpp>
 #include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Protocol/CompressedInteger.hpp>
 #include <Nazara/Core/ByteStream.hpp>
 #include <Nazara/Core/VertexStruct.hpp>
 #include <NazaraUtils/CallOnExit.hpp>
 #include <NazaraUtils/EnumArray.hpp>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <limits>
 #include <numeric>
+#include <tuple>
 
 namespace tsom
 {
+	namespace
+	{
+		// Calls the callback with every block local index, the traversal axis being the fastest changing one
+		template<typename F>
+		void TraverseBlocks(const Nz::Vector3ui& size, unsigned int fastAxis, F&& callback)
+		{
+			unsigned int middleAxis = (fastAxis + 1) % 3;
+			unsigned int slowAxis = (fastAxis + 2) % 3;
+
+			Nz::Vector3ui strides(1, size.x, size.x * size.y);
+
+			for (unsigned int k = 0; k < size[slowAxis]; ++k)
+			{
+				for (unsigned int j = 0; j < size[middleAxis]; ++j)
+				{
+					unsigned int localIndex = k * strides[slowAxis] + j * strides[middleAxis];
+					for (unsigned int i = 0; i < size[fastAxis]; ++i)
+					{
+						callback(localIndex);
+						localIndex += strides[fastAxis];
+					}
+				}
+			}
+		}
+	}
+
 	Chunk::~Chunk() = default;
 
 	void Chunk::BuildMesh(std::vector<Nz::UInt32>& indices, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<VertexAttributes(Nz::UInt32)>& addVertices) const
@@ -101,75 +132,53 @@ namespace tsom
 			indices.push_back(vertexAttributes.firstIndex + 3);
 		};
 
-		// Find and lock all neighbor chunks to avoid discrepancies between chunks
-		Nz::EnumArray<Direction, const Chunk*> neighborChunks;
-		for (auto&& [dir, chunk] : neighborChunks.iter_kv())
+		// Copy our blocks along with our neighbors border slices in a padded grid, this way the meshing loop never has to look outside of it
+		// (missing neighbor blocks are marked as invalid)
+		Nz::Vector3ui paddedSize = m_size + Nz::Vector3ui(2);
+		auto GetPaddedIndex = [&](const Nz::Vector3ui& paddedIndices)
 		{
-			chunk = m_owner.GetChunk(m_indices + s_chunkDirOffset[dir]);
-			if (!chunk)
-				continue;
-
-			chunk->LockRead();
-		}
+			return paddedSize.x * (paddedSize.y * paddedIndices.z + paddedIndices.y) + paddedIndices.x;
+		};
 
-		NAZARA_DEFER(
+		std::vector<BlockIndex> paddedBlocks(paddedSize.x * paddedSize.y * paddedSize.z, InvalidBlockIndex);
+		for (unsigned int z = 0; z < m_size.z; ++z)
 		{
-			for (const Chunk* chunk : neighborChunks)
-			{
-				if (chunk)
-					chunk->UnlockRead();
-			}
-		});
+			for (unsigned int y = 0; y < m_size.y; ++y)
+				std::copy_n(&m_blocks[GetBlockLocalIndex({ 0, y, z })], m_size.x, &paddedBlocks[GetPaddedIndex({ 1, y + 1, z + 1 })]);
+		}
 
-		auto GetNeighborBlock = [&](Nz::Vector3ui indices, Direction direction) -> std::optional<BlockIndex>
+		Nz::EnumArray<Direction, int> paddedOffsets;
+		for (auto&& [direction, offset] : s_blockDirOffset.iter_kv())
 		{
-			ChunkIndices chunkIndices = m_indices;
-			std::swap(chunkIndices.y, chunkIndices.z);
+			paddedOffsets[direction] = offset.x + int(paddedSize.x) * (offset.y + int(paddedSize.y) * offset.z);
 
-			for (unsigned int axis : { 0, 1, 2 })
-			{
-				unsigned int& index = indices[axis];
-				int offset = s_blockDirOffset[direction][axis];
-				assert(offset >= -1 && offset <= 1);
+			const Chunk* neighborChunk = m_owner.GetChunk(m_indices + s_chunkDirOffset[direction]);
+			if (!neighborChunk || neighborChunk->GetSize() != m_size)
+				continue;
 
-				if (offset > 0)
-				{
-					index += offset;
-					if (index >= m_size[axis])
-					{
-						index -= m_size[axis];
-						chunkIndices[axis]++;
-					}
-				}
-				else if (offset < 0)
-				{
-					unsigned int posOffset = std::abs(offset);
-					if (posOffset > index)
-					{
-						index += m_size[axis];
-						chunkIndices[axis]--;
-					}
+			// Border slices are immutable, holding the neighbor one gives us a consistent view of its border without locking or copying the neighbor
+			std::shared_ptr<const BorderSlice> borderSlicePtr = neighborChunk->GetBorderSlice(s_dirOpposite[direction]);
+			if (!borderSlicePtr)
+				continue;
 
-					index -= posOffset;
-				}
-			}
+			const BorderSlice& borderSlice = *borderSlicePtr;
 
-			std::swap(chunkIndices.y, chunkIndices.z);
+			unsigned int axis = GetDirectionAxis(direction);
+			unsigned int uAxis = (axis + 1) % 3;
+			unsigned int vAxis = (axis + 2) % 3;
 
-			if (chunkIndices != m_indices)
+			Nz::Vector3ui paddedIndices;
+			paddedIndices[axis] = (offset[axis] > 0) ? m_size[axis] + 1 : 0;
+			for (unsigned int v = 0; v < m_size[vAxis]; ++v)
 			{
-				const Chunk* chunk = neighborChunks[direction];
-				if (!chunk)
-					return {};
-
-				if (!chunk->HasContent())
-					return {};
-
-				return chunk->GetBlockContent(indices);
+				paddedIndices[vAxis] = v + 1;
+				for (unsigned int u = 0; u < m_size[uAxis]; ++u)
+				{
+					paddedIndices[uAxis] = u + 1;
+					paddedBlocks[GetPaddedIndex(paddedIndices)] = borderSlice[m_size[uAxis] * v + u];
+				}
 			}
-			else
-				return GetBlockContent(indices);
-		};
+		}
 
 		for (unsigned int z = 0; z < m_size.z; ++z)
 		{
@@ -177,7 +186,9 @@ namespace tsom
 			{
 				for (unsigned int x = 0; x < m_size.x; ++x)
 				{
-					BlockIndex blockIndex = GetBlockContent({ x, y, z });
+					unsigned int paddedIndex = GetPaddedIndex({ x + 1, y + 1, z + 1 });
+
+					BlockIndex blockIndex = paddedBlocks[paddedIndex];
 					if (blockIndex == EmptyBlockIndex)
 						continue;
 
@@ -187,8 +198,12 @@ namespace tsom
 
 					Nz::Vector3f blockCenter = std::accumulate(corners.begin(), corners.end(), Nz::Vector3f::Zero()) / corners.size();
 
-					auto IsTransparent = [&](BlockIndex neighborBlockIndex)
+					auto IsNeighborTransparent = [&](Direction direction)
 					{
+						BlockIndex neighborBlockIndex = paddedBlocks[paddedIndex + paddedOffsets[direction]];
+						if (neighborBlockIndex == InvalidBlockIndex)
+							return true;
+
 						// don't render faces between blocks of the same type even if transparent
 						if (blockIndex == neighborBlockIndex)
 							return false;
@@ -198,7 +213,7 @@ namespace tsom
 					};
 
 					// Up
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, Direction::Up); !neighborOpt || IsTransparent(*neighborOpt))
+					if (IsNeighborTransparent(Direction::Up))
 					{
 						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::RightTopNear], corners[Nz::BoxCorner::LeftTopNear], corners[Nz::BoxCorner::RightBottomNear], corners[Nz::BoxCorner::LeftBottomNear] });
 						if (blockData.isDoubleSided)
@@ -206,7 +221,7 @@ namespace tsom
 					}
 
 					// Down
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, Direction::Down); !neighborOpt || IsTransparent(*neighborOpt))
+					if (IsNeighborTransparent(Direction::Down))
 					{
 						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::LeftTopFar], corners[Nz::BoxCorner::RightTopFar], corners[Nz::BoxCorner::LeftBottomFar], corners[Nz::BoxCorner::RightBottomFar] });
 						if (blockData.isDoubleSided)
@@ -214,7 +229,7 @@ namespace tsom
 					}
 
 					// Front
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, Direction::Front); !neighborOpt || IsTransparent(*neighborOpt))
+					if (IsNeighborTransparent(Direction::Front))
 					{
 						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::RightTopFar], corners[Nz::BoxCorner::RightTopNear], corners[Nz::BoxCorner::RightBottomFar], corners[Nz::BoxCorner::RightBottomNear] });
 						if (blockData.isDoubleSided)
@@ -222,7 +237,7 @@ namespace tsom
 					}
 
 					// Back
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, Direction::Back); !neighborOpt || IsTransparent(*neighborOpt))
+					if (IsNeighborTransparent(Direction::Back))
 					{
 						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::LeftTopNear], corners[Nz::BoxCorner::LeftTopFar], corners[Nz::BoxCorner::LeftBottomNear], corners[Nz::BoxCorner::LeftBottomFar] });
 						if (blockData.isDoubleSided)
@@ -230,7 +245,7 @@ namespace tsom
 					}
 
 					// Left
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, Direction::Left); !neighborOpt || IsTransparent(*neighborOpt))
+					if (IsNeighborTransparent(Direction::Left))
 					{
 						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::RightBottomNear], corners[Nz::BoxCorner::LeftBottomNear], corners[Nz::BoxCorner::RightBottomFar], corners[Nz::BoxCorner::LeftBottomFar] });
 						if (blockData.isDoubleSided)
@@ -238,7 +253,7 @@ namespace tsom
 					}
 
 					// Right
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, Direction::Right); !neighborOpt || IsTransparent(*neighborOpt))
+					if (IsNeighborTransparent(Direction::Right))
 					{
 						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::LeftTopNear], corners[Nz::BoxCorner::RightTopNear], corners[Nz::BoxCorner::LeftTopFar], corners[Nz::BoxCorner::RightTopFar] });
 						if (blockData.isDoubleSided)
@@ -254,7 +269,7 @@ namespace tsom
 		Nz::UInt32 chunkBinaryVersion;
 		byteStream >> chunkBinaryVersion;
 
-		if (chunkBinaryVersion != Constants::ChunkBinaryVersion)
+		if (chunkBinaryVersion == 0 || chunkBinaryVersion > Constants::ChunkBinaryVersion)
 			throw std::runtime_error("incompatible chunk version");
 
 		Nz::Vector3ui chunkSize;
@@ -283,7 +298,54 @@ namespace tsom
 		}
 
 		Reset();
-		if (blockTypeCount > 8)
+		if (chunkBinaryVersion >= 2)
+		{
+			// Runs of identical blocks, decoded straight into the block storage
+			Nz::UInt8 traversalAxis;
+			byteStream >> traversalAxis;
+
+			if (traversalAxis >= 3)
+				throw std::runtime_error("invalid chunk traversal axis");
+
+			std::size_t remainingBlocks = m_blocks.size();
+			auto ReadRun = [&]
+			{
+				CompressedUnsigned<Nz::UInt32> runLength;
+				CompressedUnsigned<Nz::UInt16> typeIndex;
+				byteStream >> runLength >> typeIndex;
+
+				if (runLength == 0 || runLength > remainingBlocks || typeIndex >= deserializationIndices.size())
+					throw std::runtime_error("invalid chunk block run");
+
+				remainingBlocks -= runLength;
+				return std::make_pair(Nz::UInt32(runLength), deserializationIndices[typeIndex]);
+			};
+
+			if (traversalAxis == 0)
+			{
+				// Storage order, runs are contiguous
+				auto blockIt = m_blocks.begin();
+				while (remainingBlocks > 0)
+				{
+					auto [runLength, blockIndex] = ReadRun();
+					blockIt = std::fill_n(blockIt, runLength, blockIndex);
+				}
+			}
+			else
+			{
+				Nz::UInt32 runLength = 0;
+				BlockIndex blockIndex = EmptyBlockIndex;
+				TraverseBlocks(m_size, traversalAxis, [&](unsigned int localIndex)
+				{
+					if (runLength == 0)
+						std::tie(runLength, blockIndex) = ReadRun();
+
+					m_blocks[localIndex] = blockIndex;
+					runLength--;
+				});
+			}
+		}
+		else if (blockTypeCount > 8)
 		{
 			for (BlockIndex& blockIndex : m_blocks)
 			{
@@ -307,41 +369,231 @@ namespace tsom
 		OnChunkReset();
 	}
 
+	void Chunk::DeserializeDelta(Nz::ByteStream& byteStream)
+	{
+		NazaraAssert(HasContent(), "delta must be applied on top of a reset chunk");
+
+		// Delta format didn't change between chunk binary versions
+		Nz::UInt32 chunkBinaryVersion;
+		byteStream >> chunkBinaryVersion;
+
+		if (chunkBinaryVersion == 0 || chunkBinaryVersion > Constants::ChunkBinaryVersion)
+			throw std::runtime_error("incompatible chunk version");
+
+		Nz::Vector3ui chunkSize;
+		byteStream >> chunkSize;
+
+		if (chunkSize != m_size)
+			throw std::runtime_error("incompatible chunk size");
+
+		std::vector<BlockIndex> deserializationIndices;
+
+		Nz::UInt16 blockTypeCount;
+		byteStream >> blockTypeCount;
+
+		deserializationIndices.reserve(blockTypeCount);
+
+		std::string blockName;
+		for (Nz::UInt16 i = 0; i < blockTypeCount; ++i)
+		{
+			byteStream >> blockName;
+
+			BlockIndex blockIndex = m_blockLibrary.GetBlockIndex(blockName);
+			if (blockIndex == InvalidBlockIndex)
+				throw std::runtime_error("unknown block " + blockName);
+
+			deserializationIndices.push_back(blockIndex);
+		}
+
+		Nz::UInt32 changeCount;
+		byteStream >> changeCount;
+
+		if (changeCount > m_blocks.size())
+			throw std::runtime_error("invalid chunk delta change count");
+
+		// Read all changes before touching the chunk so a corrupted delta doesn't leave it half-updated
+		std::vector<std::pair<Nz::UInt32, BlockIndex>> changes(changeCount);
+
+		bool wideBlockIndices = m_blocks.size() > std::numeric_limits<Nz::UInt16>::max() + 1;
+		bool wideTypeIndices = blockTypeCount > std::numeric_limits<Nz::UInt8>::max() + 1;
+		for (auto& [blockIndex, blockContent] : changes)
+		{
+			if (wideBlockIndices)
+				byteStream >> blockIndex;
+			else
+			{
+				Nz::UInt16 value;
+				byteStream >> value;
+
+				blockIndex = value;
+			}
+
+			Nz::UInt16 typeIndex;
+			if (wideTypeIndices)
+				byteStream >> typeIndex;
+			else
+			{
+				Nz::UInt8 value;
+				byteStream >> value;
+
+				typeIndex = value;
+			}
+
+			if (blockIndex >= m_blocks.size() || typeIndex >= deserializationIndices.size())
+				throw std::runtime_error("invalid chunk delta change");
+
+			blockContent = deserializationIndices[typeIndex];
+		}
+
+		Reset([&](BlockIndex* blocks)
+		{
+			for (const auto& [blockIndex, blockContent] : changes)
+				blocks[blockIndex] = blockContent;
+		});
+	}
+
+	std::shared_ptr<const ChunkSnapshot> Chunk::GetSnapshot() const
+	{
+		if (std::shared_ptr<const ChunkSnapshot> snapshot = m_snapshot.Load())
+		{
+			// A chunk being edited publishes its new content when unlocked, until then the published snapshot is its latest consistent state
+			if (snapshot->GetRevision() == GetRevision() || m_isWriteLocked.load(std::memory_order_acquire))
+				return snapshot;
+		}
+
+		// First read of this chunk (or chunk edited without being write-locked), from now on edits publish the snapshot in UnlockWrite
+		// Chunks which are never read in the background don't pay for the copy
+		m_hasSnapshotReaders.store(true, std::memory_order_relaxed);
+
+		LockRead();
+		NAZARA_DEFER({ UnlockRead(); });
+
+		return PublishSnapshot();
+	}
+
 	void Chunk::Serialize(Nz::ByteStream& byteStream) const
 	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = GetSnapshot();
+		const std::vector<Nz::UInt16>& blockTypeCount = snapshot->GetBlockTypeCount();
+
 		byteStream << Constants::ChunkBinaryVersion;
 		byteStream << m_size;
 
-		std::vector<BlockIndex> serializationIndices(m_blockTypeCount.size());
+		std::vector<BlockIndex> serializationIndices(blockTypeCount.size());
 		Nz::UInt16 nextUniqueIndex = 0;
 
-		for (BlockIndex i = 0; i < m_blockTypeCount.size(); ++i)
+		for (BlockIndex i = 0; i < blockTypeCount.size(); ++i)
 		{
-			if (m_blockTypeCount[i] == 0)
+			if (blockTypeCount[i] == 0)
 				continue;
 
 			serializationIndices[i] = nextUniqueIndex++;
 		}
 
 		byteStream << Nz::SafeCast<Nz::UInt16>(nextUniqueIndex);
-		for (BlockIndex i = 0; i < m_blockTypeCount.size(); ++i)
+		for (BlockIndex i = 0; i < blockTypeCount.size(); ++i)
 		{
-			if (m_blockTypeCount[i] == 0)
+			if (blockTypeCount[i] == 0)
 				continue;
 
 			byteStream << m_blockLibrary.GetBlockData(i).name;
 		}
 
-		// nextUniqueIndex is the number of bits required to store all the different block types used
-		if (nextUniqueIndex > 8)
+		// Store runs of identical blocks along the axis giving the fewest runs (terrain is mostly made of long horizontal runs)
+		std::array<std::size_t, 3> runCounts;
+		for (unsigned int axis = 0; axis < 3; ++axis)
 		{
-			for (BlockIndex blockIndex : m_blocks)
-				byteStream << static_cast<Nz::UInt16>(serializationIndices[blockIndex]);
+			std::size_t runCount = 0;
+			BlockIndex previousBlock = InvalidBlockIndex;
+			TraverseBlocks(m_size, axis, [&](unsigned int localIndex)
+			{
+				BlockIndex blockIndex = snapshot->GetBlockContent(localIndex);
+				if (blockIndex != previousBlock)
+				{
+					runCount++;
+					previousBlock = blockIndex;
+				}
+			});
+
+			runCounts[axis] = runCount;
 		}
-		else
+
+		Nz::UInt8 traversalAxis = Nz::SafeCast<Nz::UInt8>(std::distance(runCounts.begin(), std::min_element(runCounts.begin(), runCounts.end())));
+		byteStream << traversalAxis;
+
+		Nz::UInt32 runLength = 0;
+		BlockIndex runBlock = InvalidBlockIndex;
+		auto WriteRun = [&]
+		{
+			if (runLength > 0)
+				byteStream << CompressedUnsigned<Nz::UInt32>(runLength) << CompressedUnsigned<Nz::UInt16>(serializationIndices[runBlock]);
+		};
+
+		TraverseBlocks(m_size, traversalAxis, [&](unsigned int localIndex)
+		{
+			BlockIndex blockIndex = snapshot->GetBlockContent(localIndex);
+			if (blockIndex != runBlock)
+			{
+				WriteRun();
+
+				runBlock = blockIndex;
+				runLength = 0;
+			}
+
+			runLength++;
+		});
+
+		WriteRun();
+	}
+
+	void Chunk::SerializeDelta(Nz::ByteStream& byteStream, const ChunkSnapshot& baseContent) const
+	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = GetSnapshot();
+		NazaraAssert(baseContent.GetSize() == snapshot->GetSize(), "base content size mismatch");
+
+		std::size_t blockCount = snapshot->GetBlockCount();
+
+		// Only store block types appearing in the changes
+		std::vector<Nz::UInt32> changedBlocks;
+		std::vector<Nz::UInt16> serializationIndices(snapshot->GetBlockTypeCount().size(), std::numeric_limits<Nz::UInt16>::max());
+		std::vector<BlockIndex> usedBlockTypes;
+		for (std::size_t i = 0; i < blockCount; ++i)
 		{
-			for (BlockIndex blockIndex : m_blocks)
-				byteStream << static_cast<Nz::UInt8>(serializationIndices[blockIndex]);
+			BlockIndex blockContent = snapshot->GetBlockContent(i);
+			if (blockContent == baseContent.GetBlockContent(i))
+				continue;
+
+			changedBlocks.push_back(Nz::SafeCast<Nz::UInt32>(i));
+			if (serializationIndices[blockContent] == std::numeric_limits<Nz::UInt16>::max())
+			{
+				serializationIndices[blockContent] = Nz::SafeCast<Nz::UInt16>(usedBlockTypes.size());
+				usedBlockTypes.push_back(blockContent);
+			}
+		}
+
+		byteStream << Constants::ChunkBinaryVersion;
+		byteStream << m_size;
+
+		byteStream << Nz::SafeCast<Nz::UInt16>(usedBlockTypes.size());
+		for (BlockIndex blockType : usedBlockTypes)
+			byteStream << m_blockLibrary.GetBlockData(blockType).name;
+
+		byteStream << Nz::SafeCast<Nz::UInt32>(changedBlocks.size());
+
+		bool wideBlockIndices = blockCount > std::numeric_limits<Nz::UInt16>::max() + 1;
+		bool wideTypeIndices = usedBlockTypes.size() > std::numeric_limits<Nz::UInt8>::max() + 1;
+		for (Nz::UInt32 blockIndex : changedBlocks)
+		{
+			if (wideBlockIndices)
+				byteStream << blockIndex;
+			else
+				byteStream << static_cast<Nz::UInt16>(blockIndex);
+
+			Nz::UInt16 typeIndex = serializationIndices[snapshot->GetBlockContent(blockIndex)];
+			if (wideTypeIndices)
+				byteStream << typeIndex;
+			else
+				byteStream << static_cast<Nz::UInt8>(typeIndex);
 		}
 	}
 
@@ -362,9 +614,79 @@ namespace tsom
 
 		m_blockTypeCount[newBlock]++;
 
+		// Neighbors may be reading our border slices, replace them instead of editing them
+		for (auto&& [direction, borderSlice] : m_borderSlices.iter_kv())
+		{
+			if (!IsOnBorder(direction, indices))
+				continue;
+
+			std::shared_ptr<BorderSlice> newBorderSlice = std::make_shared<BorderSlice>(*borderSlice.Load());
+			(*newBorderSlice)[GetBorderSliceIndex(direction, indices)] = newBlock;
+
+			borderSlice.Store(std::move(newBorderSlice));
+		}
+
+		m_revision.fetch_add(1, std::memory_order_release);
+
 		OnBlockUpdated(this, indices, newBlock);
 	}
 
+	void Chunk::UpdateBlocks(std::span<const BlockUpdate> updates)
+	{
+		NazaraAssert(!m_blocks.empty(), "chunk has not been reset");
+
+		if (updates.empty())
+			return;
+
+		// Same as UpdateBlock but with a single revision bump and a single notification for the whole batch
+		Nz::Bitset<Nz::UInt64> updatedBlocks(m_blocks.size(), false);
+		Nz::EnumArray<Direction, std::shared_ptr<BorderSlice>> newBorderSlices;
+		Nz::Vector3ui minIndices = updates.front().indices;
+		Nz::Vector3ui maxIndices = updates.front().indices;
+
+		for (const BlockUpdate& update : updates)
+		{
+			const auto& blockData = m_blockLibrary.GetBlockData(update.newBlock);
+
+			unsigned int blockIndex = GetBlockLocalIndex(update.indices);
+			BlockIndex oldContent = m_blocks[blockIndex];
+			m_blocks[blockIndex] = update.newBlock;
+			m_collisionCellMask[blockIndex] = blockData.hasCollisions;
+
+			m_blockTypeCount[oldContent]--;
+			if (update.newBlock >= m_blockTypeCount.size())
+				m_blockTypeCount.resize(update.newBlock + 1);
+
+			m_blockTypeCount[update.newBlock]++;
+
+			for (auto&& [direction, newBorderSlice] : newBorderSlices.iter_kv())
+			{
+				if (!IsOnBorder(direction, update.indices))
+					continue;
+
+				// Border slices are copied once per batch
+				if (!newBorderSlice)
+					newBorderSlice = std::make_shared<BorderSlice>(*m_borderSlices[direction].Load());
+
+				(*newBorderSlice)[GetBorderSliceIndex(direction, update.indices)] = update.newBlock;
+			}
+
+			updatedBlocks[blockIndex] = true;
+			minIndices.Minimize(update.indices);
+			maxIndices.Maximize(update.indices);
+		}
+
+		for (auto&& [direction, newBorderSlice] : newBorderSlices.iter_kv())
+		{
+			if (newBorderSlice)
+				m_borderSlices[direction].Store(std::move(newBorderSlice));
+		}
+
+		m_revision.fetch_add(1, std::memory_order_release);
+
+		OnBlocksUpdated(this, updatedBlocks, minIndices, maxIndices);
+	}
+
 	void Chunk::OnChunkReset()
 	{
 		std::fill(m_blockTypeCount.begin(), m_blockTypeCount.end(), 0);
@@ -380,6 +702,55 @@ namespace tsom
 			m_blockTypeCount[blockContent]++;
 		}
 
+		RebuildBorderSlices();
+
+		m_revision.fetch_add(1, std::memory_order_release);
+
 		OnReset(this);
 	}
+
+	std::shared_ptr<const ChunkSnapshot> Chunk::PublishSnapshot() const
+	{
+		// Caller must hold the chunk lock (read or write)
+		Nz::UInt64 revision = GetRevision();
+
+		std::shared_ptr<const ChunkSnapshot> snapshot = m_snapshot.Load();
+		if (!snapshot || snapshot->GetRevision() != revision)
+		{
+			Nz::EnumArray<Direction, std::shared_ptr<const BorderSlice>> borderSlices;
+			for (auto&& [direction, borderSlice] : borderSlices.iter_kv())
+				borderSlice = m_borderSlices[direction].Load();
+
+			snapshot = std::make_shared<ChunkSnapshot>(revision, m_size, m_blocks, m_blockTypeCount, m_collisionCellMask, std::move(borderSlices));
+			m_snapshot.Store(snapshot);
+		}
+
+		return snapshot;
+	}
+
+	void Chunk::RebuildBorderSlices()
+	{
+		for (auto&& [direction, borderSlice] : m_borderSlices.iter_kv())
+		{
+			unsigned int axis = GetDirectionAxis(direction);
+			unsigned int uAxis = (axis + 1) % 3;
+			unsigned int vAxis = (axis + 2) % 3;
+
+			std::shared_ptr<BorderSlice> newBorderSlice = std::make_shared<BorderSlice>(m_size[uAxis] * m_size[vAxis]);
+
+			Nz::Vector3ui indices;
+			indices[axis] = (s_blockDirOffset[direction][axis] > 0) ? m_size[axis] - 1 : 0;
+			for (unsigned int v = 0; v < m_size[vAxis]; ++v)
+			{
+				indices[vAxis] = v;
+				for (unsigned int u = 0; u < m_size[uAxis]; ++u)
+				{
+					indices[uAxis] = u;
+					(*newBorderSlice)[GetBorderSliceIndex(direction, indices)] = m_blocks[GetBlockLocalIndex(indices)];
+				}
+			}
+
+			borderSlice.Store(std::move(newBorderSlice));
+		}
+	}
 }
@@ -0,0 +1,39 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkChangeSet.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <NazaraUtils/Algorithm.hpp>
+
+namespace tsom
+{
+	void ChunkChangeSet::BuildUpdates(const Chunk& chunk, std::vector<Packets::ChunkUpdate::BlockUpdate>& updates) const
+	{
+		// Blocks are iterated by local index so consecutive updates follow the X axis and can be sent as runs
+		updates.clear();
+		for (std::size_t blockIndex : m_changedBlocks.IterBits())
+		{
+			if (blockIndex >= chunk.GetBlockCount())
+				break;
+
+			Nz::Vector3ui indices = chunk.GetBlockLocalIndices(Nz::SafeCast<unsigned int>(blockIndex));
+			BlockIndex content = chunk.GetBlockContent(Nz::SafeCast<unsigned int>(blockIndex));
+
+			updates.push_back({
+				Packets::Helper::VoxelLocation{ Nz::SafeCast<Nz::UInt8>(indices.x), Nz::SafeCast<Nz::UInt8>(indices.y), Nz::SafeCast<Nz::UInt8>(indices.z) },
+				content
+			});
+		}
+	}
+
+	std::size_t ChunkChangeSet::EstimateResetSize(const ChunkSnapshot& snapshot, const CompressionProfile& profile, bool useFrame)
+	{
+		// Compressed content is cached by the snapshot and reused by the chunk reset packet, only the packet header is missing
+		if (std::optional<std::span<const Nz::UInt8>> compressedContent = snapshot.GetCompressedContent(profile, useFrame))
+			return compressedContent->size();
+
+		return snapshot.GetBlockCount() * sizeof(BlockIndex);
+	}
+}
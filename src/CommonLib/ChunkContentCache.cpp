@@ -0,0 +1,319 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkContentCache.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Core/ThreadExt.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <fmt/color.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+
+namespace tsom
+{
+	namespace
+	{
+		constexpr std::size_t EntryHeaderSize = 3 * sizeof(Nz::UInt32);
+	}
+
+	ChunkContentCache::ChunkContentCache(std::filesystem::path cacheDirectory, std::size_t maxEntryCount) :
+	m_cacheDirectory(std::move(cacheDirectory)),
+	m_maxEntryCount(maxEntryCount),
+	m_nextLoadId(0),
+	m_isProcessing(true), //< index is built by the worker
+	m_running(true)
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(m_cacheDirectory, ec);
+
+		m_thread = std::thread(&ChunkContentCache::WorkerThread, this);
+	}
+
+	ChunkContentCache::~ChunkContentCache()
+	{
+		{
+			std::lock_guard lock(m_operationMutex);
+			m_running = false;
+		}
+		m_operationCondition.notify_one();
+
+		m_thread.join();
+	}
+
+	bool ChunkContentCache::Contains(Nz::UInt64 contentHash) const
+	{
+		std::lock_guard lock(m_indexMutex);
+		return m_entryByHash.find(contentHash) != m_entryByHash.end();
+	}
+
+	std::size_t ChunkContentCache::GetEntryCount() const
+	{
+		std::lock_guard lock(m_indexMutex);
+		return m_entries.size();
+	}
+
+	void ChunkContentCache::PollLoads(const LoadCallback& callback)
+	{
+		std::vector<LoadResult> loadResults;
+		{
+			std::lock_guard lock(m_resultMutex);
+			loadResults = std::move(m_loadResults);
+			m_loadResults.clear();
+		}
+
+		for (LoadResult& loadResult : loadResults)
+			callback(loadResult.loadId, std::move(loadResult.content));
+	}
+
+	auto ChunkContentCache::RequestLoad(Nz::UInt64 contentHash, const Nz::Vector3ui& size) -> std::optional<LoadId>
+	{
+		{
+			std::lock_guard lock(m_indexMutex);
+
+			auto it = m_entryByHash.find(contentHash);
+			if (it == m_entryByHash.end())
+				return std::nullopt;
+
+			// Keep recently used entries when evicting
+			m_entries.splice(m_entries.end(), m_entries, it->second);
+		}
+
+		LoadId loadId = m_nextLoadId++;
+		PushOperation(LoadRequest{
+			.loadId = loadId,
+			.contentHash = contentHash,
+			.size = size
+		});
+
+		return loadId;
+	}
+
+	void ChunkContentCache::Store(const Nz::Vector3ui& size, std::vector<BlockIndex> content)
+	{
+		assert(content.size() == std::size_t(size.x) * size.y * size.z);
+
+		PushOperation(StoreRequest{
+			.size = size,
+			.content = std::move(content)
+		});
+	}
+
+	void ChunkContentCache::WaitForPendingOperations()
+	{
+		std::unique_lock lock(m_operationMutex);
+		m_idleCondition.wait(lock, [&] { return m_operations.empty() && !m_isProcessing; });
+	}
+
+	void ChunkContentCache::BuildIndex()
+	{
+		struct Entry
+		{
+			Nz::UInt64 contentHash;
+			std::filesystem::file_time_type lastUse;
+		};
+
+		std::vector<Entry> entries;
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(m_cacheDirectory, ec))
+		{
+			if (!entry.is_regular_file(ec) || entry.path().extension() != Nz::Utf8Path(".chunk"))
+				continue;
+
+			std::string entryName = Nz::PathToString(entry.path().stem());
+
+			Nz::UInt64 contentHash;
+			auto [ptr, parseError] = std::from_chars(entryName.data(), entryName.data() + entryName.size(), contentHash, 16);
+			if (parseError != std::errc{} || ptr != entryName.data() + entryName.size())
+				continue;
+
+			entries.push_back({ contentHash, entry.last_write_time(ec) });
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.lastUse < rhs.lastUse; });
+
+		{
+			std::lock_guard lock(m_indexMutex);
+			for (const Entry& entry : entries)
+				m_entryByHash.emplace(entry.contentHash, m_entries.insert(m_entries.end(), entry.contentHash));
+		}
+
+		EvictEntries();
+	}
+
+	void ChunkContentCache::EvictEntries()
+	{
+		// Only entries exceeding the max count are removed, which is at most one per store once the cache is full
+		std::vector<Nz::UInt64> evictedEntries;
+		{
+			std::lock_guard lock(m_indexMutex);
+			while (m_entries.size() > m_maxEntryCount)
+			{
+				Nz::UInt64 contentHash = m_entries.front();
+				m_entryByHash.erase(contentHash);
+				m_entries.pop_front();
+
+				evictedEntries.push_back(contentHash);
+			}
+		}
+
+		std::error_code ec;
+		for (Nz::UInt64 contentHash : evictedEntries)
+			std::filesystem::remove(GetEntryPath(contentHash), ec);
+	}
+
+	std::filesystem::path ChunkContentCache::GetEntryPath(Nz::UInt64 contentHash) const
+	{
+		return m_cacheDirectory / Nz::Utf8Path(fmt::format("{:016x}.chunk", contentHash));
+	}
+
+	std::optional<std::vector<BlockIndex>> ChunkContentCache::LoadEntry(const LoadRequest& request)
+	{
+		std::filesystem::path entryPath = GetEntryPath(request.contentHash);
+
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(entryPath, ec))
+		{
+			RemoveEntry(request.contentHash);
+			return std::nullopt;
+		}
+
+		std::optional<std::vector<Nz::UInt8>> entryData = Nz::File::ReadWhole(entryPath);
+		if (!entryData || entryData->size() < EntryHeaderSize)
+			return std::nullopt;
+
+		Nz::ByteStream byteStream(entryData->data(), entryData->size());
+
+		Nz::Vector3ui entrySize;
+		byteStream >> entrySize.x >> entrySize.y >> entrySize.z;
+		if (entrySize != request.size)
+			return std::nullopt;
+
+		std::vector<BlockIndex> content(std::size_t(entrySize.x) * entrySize.y * entrySize.z);
+
+		std::size_t contentSize = content.size() * sizeof(BlockIndex);
+		std::optional<std::size_t> decompressedSize = BinaryCompressor::GetThreadCompressor().Decompress(entryData->data() + EntryHeaderSize, entryData->size() - EntryHeaderSize, content.data(), contentSize);
+
+		// Don't trust the file system, a corrupted entry would desync the client
+		if (decompressedSize != contentSize || ChunkSnapshot::ComputeContentHash(entrySize, content.data()) != request.contentHash)
+		{
+			fmt::print(fg(fmt::color::yellow), "removing corrupted chunk cache entry {:016x}\n", request.contentHash);
+			std::filesystem::remove(entryPath, ec);
+			RemoveEntry(request.contentHash);
+
+			return std::nullopt;
+		}
+
+		// Keep the usage order between sessions
+		std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), ec);
+
+		return content;
+	}
+
+	void ChunkContentCache::PushOperation(Operation&& operation)
+	{
+		{
+			std::lock_guard lock(m_operationMutex);
+			m_operations.push_back(std::move(operation));
+		}
+		m_operationCondition.notify_one();
+	}
+
+	void ChunkContentCache::RemoveEntry(Nz::UInt64 contentHash)
+	{
+		std::lock_guard lock(m_indexMutex);
+
+		auto it = m_entryByHash.find(contentHash);
+		if (it == m_entryByHash.end())
+			return;
+
+		m_entries.erase(it->second);
+		m_entryByHash.erase(it);
+	}
+
+	void ChunkContentCache::StoreEntry(const StoreRequest& request)
+	{
+		Nz::UInt64 contentHash = ChunkSnapshot::ComputeContentHash(request.size, request.content.data());
+
+		{
+			std::lock_guard lock(m_indexMutex);
+			if (auto it = m_entryByHash.find(contentHash); it != m_entryByHash.end())
+			{
+				m_entries.splice(m_entries.end(), m_entries, it->second);
+				return;
+			}
+		}
+
+		std::optional<std::span<Nz::UInt8>> compressedContent = BinaryCompressor::GetThreadCompressor().Compress(request.content.data(), request.content.size() * sizeof(BlockIndex));
+		if (!compressedContent)
+			return;
+
+		Nz::ByteArray entryData;
+		Nz::ByteStream byteStream(&entryData, Nz::OpenMode::Write);
+		byteStream << request.size.x << request.size.y << request.size.z;
+		byteStream.Write(compressedContent->data(), compressedContent->size());
+
+		if (!Nz::File::WriteWhole(GetEntryPath(contentHash), entryData.GetConstBuffer(), entryData.GetSize()))
+		{
+			fmt::print(fg(fmt::color::red), "failed to store chunk cache entry {:016x}\n", contentHash);
+			return;
+		}
+
+		{
+			std::lock_guard lock(m_indexMutex);
+			m_entryByHash.emplace(contentHash, m_entries.insert(m_entries.end(), contentHash));
+		}
+
+		EvictEntries();
+	}
+
+	void ChunkContentCache::WorkerThread()
+	{
+		Nz::SetCurrentThreadName("ChunkContentCache");
+		TickProfiler::SetThreadName("ChunkContentCache");
+
+		BuildIndex();
+
+		std::unique_lock lock(m_operationMutex);
+		for (;;)
+		{
+			if (m_operations.empty())
+			{
+				m_isProcessing = false;
+				m_idleCondition.notify_all();
+
+				m_operationCondition.wait(lock, [&] { return !m_operations.empty() || !m_running; });
+
+				// Pending operations are processed before stopping, to keep chunks stored right before exiting
+				if (m_operations.empty())
+					break;
+			}
+
+			Operation operation = std::move(m_operations.front());
+			m_operations.pop_front();
+			m_isProcessing = true;
+
+			lock.unlock();
+
+			if (LoadRequest* loadRequest = std::get_if<LoadRequest>(&operation))
+			{
+				std::optional<std::vector<BlockIndex>> content = LoadEntry(*loadRequest);
+
+				std::lock_guard resultLock(m_resultMutex);
+				m_loadResults.push_back({ loadRequest->loadId, std::move(content) });
+			}
+			else
+				StoreEntry(std::get<StoreRequest>(operation));
+
+			lock.lock();
+		}
+	}
+}
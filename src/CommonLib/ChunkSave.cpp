@@ -0,0 +1,84 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkSave.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace tsom
+{
+	ChunkSaveFormat LoadChunk(Nz::ByteStream& byteStream, Chunk& chunk, const Nz::FunctionRef<bool(Chunk& chunk)>& regenerateChunk)
+	{
+		Nz::UInt8 saveFormat;
+		byteStream >> saveFormat;
+
+		switch (static_cast<ChunkSaveFormat>(saveFormat))
+		{
+			case ChunkSaveFormat::Full:
+				chunk.Deserialize(byteStream);
+				return ChunkSaveFormat::Full;
+
+			case ChunkSaveFormat::Delta:
+				if (!regenerateChunk(chunk))
+					throw std::runtime_error("delta chunk was saved against another generator");
+
+				chunk.DeserializeDelta(byteStream);
+				return ChunkSaveFormat::Delta;
+		}
+
+		throw std::runtime_error("unknown chunk save format " + std::to_string(saveFormat));
+	}
+
+	PlanetSaveHeader LoadPlanetSaveHeader(Nz::ByteStream& byteStream)
+	{
+		PlanetSaveHeader header;
+		byteStream >> header.generatorVersion;
+		byteStream >> header.seed;
+		byteStream >> header.chunkCount;
+
+		return header;
+	}
+
+	ChunkSaveFormat SaveChunk(Nz::ByteStream& byteStream, const Chunk& chunk, const Chunk& generatedChunk, float maxDeltaDensity)
+	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = chunk.GetSnapshot();
+		std::shared_ptr<const ChunkSnapshot> generatedSnapshot = generatedChunk.GetSnapshot();
+
+		std::size_t blockCount = snapshot->GetBlockCount();
+		std::size_t changeCount = 0;
+		for (std::size_t i = 0; i < blockCount; ++i)
+		{
+			if (snapshot->GetBlockContent(i) != generatedSnapshot->GetBlockContent(i))
+				changeCount++;
+		}
+
+		if (static_cast<float>(changeCount) > maxDeltaDensity * blockCount)
+		{
+			SaveFullChunk(byteStream, chunk);
+			return ChunkSaveFormat::Full;
+		}
+		else
+		{
+			byteStream << static_cast<Nz::UInt8>(ChunkSaveFormat::Delta);
+			chunk.SerializeDelta(byteStream, *generatedSnapshot);
+
+			return ChunkSaveFormat::Delta;
+		}
+	}
+
+	void SaveFullChunk(Nz::ByteStream& byteStream, const Chunk& chunk)
+	{
+		byteStream << static_cast<Nz::UInt8>(ChunkSaveFormat::Full);
+		chunk.Serialize(byteStream);
+	}
+
+	void SavePlanetSaveHeader(Nz::ByteStream& byteStream, const PlanetSaveHeader& header)
+	{
+		byteStream << header.generatorVersion;
+		byteStream << header.seed;
+		byteStream << header.chunkCount;
+	}
+}
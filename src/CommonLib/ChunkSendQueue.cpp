@@ -0,0 +1,183 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkSendQueue.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+
+namespace tsom
+{
+	void ChunkSendQueue::Erase(std::size_t chunkIndex)
+	{
+		if (!Contains(chunkIndex))
+			return;
+
+		std::size_t heapIndex = m_heapIndices[chunkIndex];
+		std::size_t lastIndex = m_heap.size() - 1;
+		if (heapIndex != lastIndex)
+			SwapEntries(heapIndex, lastIndex);
+
+		m_heap.pop_back();
+		m_heapIndices[chunkIndex] = InvalidHeapIndex;
+
+		if (heapIndex < m_heap.size())
+		{
+			SiftUp(heapIndex);
+			SiftDown(heapIndex);
+		}
+	}
+
+	std::size_t ChunkSendQueue::Pop()
+	{
+		std::size_t chunkIndex = GetTop();
+		Erase(chunkIndex);
+
+		return chunkIndex;
+	}
+
+	void ChunkSendQueue::Push(std::size_t chunkIndex, const Nz::Vector3f& chunkCenter, ChunkVisibilityHint visibilityHint)
+	{
+		if (chunkIndex >= m_heapIndices.size())
+			m_heapIndices.resize(chunkIndex + 1, InvalidHeapIndex);
+
+		if (std::size_t heapIndex = m_heapIndices[chunkIndex]; heapIndex != InvalidHeapIndex)
+		{
+			// Chunk is already queued, keep its waiting time but update its hint
+			Entry& entry = m_heap[heapIndex];
+			entry.chunkCenter = chunkCenter;
+			entry.visibilityHint = visibilityHint;
+			entry.score = ComputeScore(chunkCenter, visibilityHint, entry.enqueueTick);
+
+			SiftUp(heapIndex);
+			SiftDown(heapIndex);
+			return;
+		}
+
+		std::size_t heapIndex = m_heap.size();
+		m_heap.push_back({
+			.chunkIndex = chunkIndex,
+			.score = ComputeScore(chunkCenter, visibilityHint, m_currentTick),
+			.visibilityHint = visibilityHint,
+			.enqueueTick = m_currentTick,
+			.chunkCenter = chunkCenter
+		});
+		m_heapIndices[chunkIndex] = heapIndex;
+
+		SiftUp(heapIndex);
+	}
+
+	void ChunkSendQueue::Update(const Nz::Vector3f& viewerPosition, const Nz::Vector3f& viewerDirection)
+	{
+		m_currentTick++;
+		m_viewerPosition = viewerPosition;
+		m_viewerDirection = viewerDirection;
+
+		// Waiting time is accounted for by the enqueue tick so it doesn't change the order of queued entries,
+		// entries only have to be rescored when the viewer moved or turned significantly
+		if (!m_hasViewer || m_viewerPosition.SquaredDistance(m_scoredViewerPosition) > RescoreDistance * RescoreDistance || m_viewerDirection.DotProduct(m_scoredViewerDirection) < RescoreDirectionThreshold)
+		{
+			m_hasViewer = true;
+			Rescore();
+		}
+	}
+
+	ChunkVisibilityHint ChunkSendQueue::ComputeVisibilityHint(const ChunkSnapshot& snapshot)
+	{
+		const std::vector<Nz::UInt16>& blockTypeCount = snapshot.GetBlockTypeCount();
+
+		std::size_t emptyCount = (EmptyBlockIndex < blockTypeCount.size()) ? blockTypeCount[EmptyBlockIndex] : 0;
+		if (emptyCount == 0)
+			return ChunkVisibilityHint::Buried;
+		else if (emptyCount == snapshot.GetBlockCount())
+			return ChunkVisibilityHint::Empty;
+		else
+			return ChunkVisibilityHint::Surface;
+	}
+
+	double ChunkSendQueue::ComputeScore(const Nz::Vector3f& chunkCenter, ChunkVisibilityHint visibilityHint, Nz::UInt64 enqueueTick) const
+	{
+		float score = 0.f;
+		if (m_hasViewer)
+		{
+			Nz::Vector3f viewerToChunk = chunkCenter - m_viewerPosition;
+			float distance = viewerToChunk.GetLength();
+
+			// Chunks behind the viewer are considered farther than they are
+			float viewFactor = 1.f;
+			if (distance > 0.f)
+			{
+				float cosAngle = m_viewerDirection.DotProduct(viewerToChunk / distance);
+				viewFactor += BehindPenalty * (1.f - cosAngle) * 0.5f;
+			}
+
+			score = distance * viewFactor;
+		}
+
+		switch (visibilityHint)
+		{
+			case ChunkVisibilityHint::Buried:
+				score *= BuriedPenalty;
+				break;
+
+			case ChunkVisibilityHint::Empty:
+				score *= EmptyPenalty;
+				break;
+
+			case ChunkVisibilityHint::Surface:
+				break;
+		}
+
+		// Older entries get a lower score, this is equivalent to decreasing the score of every entry each tick
+		return score + AgingRate * enqueueTick;
+	}
+
+	void ChunkSendQueue::Rescore()
+	{
+		m_scoredViewerDirection = m_viewerDirection;
+		m_scoredViewerPosition = m_viewerPosition;
+
+		for (Entry& entry : m_heap)
+			entry.score = ComputeScore(entry.chunkCenter, entry.visibilityHint, entry.enqueueTick);
+
+		// Rebuild the heap bottom-up
+		for (std::size_t i = m_heap.size() / 2; i > 0; --i)
+			SiftDown(i - 1);
+	}
+
+	void ChunkSendQueue::SiftDown(std::size_t heapIndex)
+	{
+		std::size_t heapSize = m_heap.size();
+		for (;;)
+		{
+			std::size_t smallestIndex = heapIndex;
+
+			std::size_t leftIndex = heapIndex * 2 + 1;
+			if (leftIndex < heapSize && m_heap[leftIndex].score < m_heap[smallestIndex].score)
+				smallestIndex = leftIndex;
+
+			std::size_t rightIndex = leftIndex + 1;
+			if (rightIndex < heapSize && m_heap[rightIndex].score < m_heap[smallestIndex].score)
+				smallestIndex = rightIndex;
+
+			if (smallestIndex == heapIndex)
+				break;
+
+			SwapEntries(heapIndex, smallestIndex);
+			heapIndex = smallestIndex;
+		}
+	}
+
+	void ChunkSendQueue::SiftUp(std::size_t heapIndex)
+	{
+		while (heapIndex > 0)
+		{
+			std::size_t parentIndex = (heapIndex - 1) / 2;
+			if (m_heap[parentIndex].score <= m_heap[heapIndex].score)
+				break;
+
+			SwapEntries(heapIndex, parentIndex);
+			heapIndex = parentIndex;
+		}
+	}
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <NazaraUtils/Endianness.hpp>
+#include <sodium.h>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace tsom
+{
+	std::optional<std::span<const Nz::UInt8>> ChunkSnapshot::GetCompressedContent(const CompressionProfile& profile, bool useFrame) const
+	{
+		assert(HasContent());
+
+		// Every session seeing this revision gets the same bytes for the same negotiated profile, only compress them once
+		Nz::UInt32 dictionaryId = (profile.dictionary) ? profile.dictionary->GetId() : 0;
+
+		std::lock_guard lock(m_compressedContentMutex);
+		for (const auto& compressedContent : m_compressedContents)
+		{
+			if (compressedContent->isFrame != useFrame)
+				continue;
+
+			if (useFrame && (compressedContent->codec != profile.codec || compressedContent->acceleration != profile.acceleration || compressedContent->level != profile.level || compressedContent->dictionaryId != dictionaryId))
+				continue;
+
+			return compressedContent->data;
+		}
+
+		BinaryCompressor& binaryCompressor = BinaryCompressor::GetThreadCompressor();
+
+		std::optional<std::span<Nz::UInt8>> compressedData;
+		if (useFrame)
+			compressedData = binaryCompressor.CompressFrame(profile, m_blocks.data(), m_blocks.size() * sizeof(BlockIndex));
+		else
+			compressedData = binaryCompressor.Compress(m_blocks.data(), m_blocks.size() * sizeof(BlockIndex));
+
+		if (!compressedData)
+			return std::nullopt;
+
+		auto& compressedContent = m_compressedContents.emplace_back(std::make_unique<CompressedContent>());
+		compressedContent->codec = profile.codec;
+		compressedContent->acceleration = profile.acceleration;
+		compressedContent->level = profile.level;
+		compressedContent->dictionaryId = dictionaryId;
+		compressedContent->isFrame = useFrame;
+		compressedContent->data.assign(compressedData->begin(), compressedData->end());
+
+		return compressedContent->data;
+	}
+
+	Nz::UInt64 ChunkSnapshot::GetContentHash() const
+	{
+		assert(HasContent());
+
+		// Snapshots are shared between threads, only hash the content once
+		std::call_once(m_contentHashFlag, [&]
+		{
+			m_contentHash = ComputeContentHash(m_size, m_blocks.data());
+		});
+
+		return m_contentHash;
+	}
+
+	Nz::UInt64 ChunkSnapshot::ComputeContentHash(const Nz::Vector3ui& size, const BlockIndex* blocks)
+	{
+		// Content hash must be the same on every platform as it's used to identify chunk contents cached by clients
+		crypto_generichash_state state;
+		crypto_generichash_init(&state, nullptr, 0, crypto_generichash_BYTES_MIN);
+
+		std::array<Nz::UInt32, 3> sizeData = { Nz::HostToLittleEndian(size.x), Nz::HostToLittleEndian(size.y), Nz::HostToLittleEndian(size.z) };
+		crypto_generichash_update(&state, reinterpret_cast<const unsigned char*>(sizeData.data()), sizeData.size() * sizeof(Nz::UInt32));
+		crypto_generichash_update(&state, reinterpret_cast<const unsigned char*>(blocks), std::size_t(size.x) * size.y * size.z * sizeof(BlockIndex));
+
+		std::array<unsigned char, crypto_generichash_BYTES_MIN> hash;
+		crypto_generichash_final(&state, hash.data(), hash.size());
+
+		Nz::UInt64 contentHash;
+		std::memcpy(&contentHash, hash.data(), sizeof(contentHash));
+
+		return Nz::LittleEndianToHost(contentHash);
+	}
+}
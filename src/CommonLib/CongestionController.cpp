@@ -0,0 +1,97 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/CongestionController.hpp>
+#include <algorithm>
+
+namespace tsom
+{
+	CongestionController::CongestionController() :
+	m_acknowledgedBytes(0),
+	m_inFlightBytes(0),
+	m_windowSize(InitialWindowSize),
+	m_lastDecrease(Nz::Time::Zero()),
+	m_minRoundTripTime(Nz::Time::Zero()),
+	m_minRoundTripTimeExpiration(Nz::Time::Zero()),
+	m_periodMinRoundTripTime(Nz::Time::Zero()),
+	m_lastTotalPacketLost(0),
+	m_lastTotalPacketSent(0),
+	m_bandwidthEstimate(0),
+	m_isSlowStart(true),
+	m_isWindowLimited(false)
+	{
+	}
+
+	void CongestionController::Update(Nz::Time now, const NetworkReactor::PeerInfo& peerInfo)
+	{
+		Nz::Time roundTripTime = Nz::Time::Milliseconds(peerInfo.ping);
+
+		if (!m_lastUpdate)
+		{
+			m_lastUpdate = now;
+			m_lastTotalPacketLost = peerInfo.totalPacketLost;
+			m_lastTotalPacketSent = peerInfo.totalPacketSent;
+			m_minRoundTripTime = roundTripTime;
+			m_minRoundTripTimeExpiration = now + MinRoundTripTimeLifetime;
+			m_periodMinRoundTripTime = roundTripTime;
+			return;
+		}
+
+		Nz::Time elapsedTime = now - *m_lastUpdate;
+		if (elapsedTime <= Nz::Time::Zero())
+			return;
+
+		m_lastUpdate = now;
+
+		// Delivery rate, the estimate slowly decays to follow bandwidth drops
+		std::size_t acknowledgedBytes = m_acknowledgedBytes.exchange(0, std::memory_order_relaxed);
+		Nz::UInt64 deliveryRate = static_cast<Nz::UInt64>(acknowledgedBytes / elapsedTime.AsSeconds<double>());
+		m_bandwidthEstimate = std::max(deliveryRate, m_bandwidthEstimate - m_bandwidthEstimate / 8);
+
+		// Minimal RTT (without queueing delay), replaced by the minimal RTT of the last period so route changes are taken into account
+		m_minRoundTripTime = std::min(m_minRoundTripTime, roundTripTime);
+		m_periodMinRoundTripTime = std::min(m_periodMinRoundTripTime, roundTripTime);
+		if (now >= m_minRoundTripTimeExpiration)
+		{
+			m_minRoundTripTime = m_periodMinRoundTripTime;
+			m_minRoundTripTimeExpiration = now + MinRoundTripTimeLifetime;
+			m_periodMinRoundTripTime = roundTripTime;
+		}
+
+		Nz::UInt32 packetLost = peerInfo.totalPacketLost - m_lastTotalPacketLost;
+		Nz::UInt32 packetSent = peerInfo.totalPacketSent - m_lastTotalPacketSent;
+		m_lastTotalPacketLost = peerInfo.totalPacketLost;
+		m_lastTotalPacketSent = peerInfo.totalPacketSent;
+
+		float lossRatio = (packetSent > 0) ? float(packetLost) / packetSent : 0.f;
+
+		// Losses and growing queues (RTT increase) both mean we're sending more than the link can handle
+		bool isCongested = lossRatio > MaxLossRatio || roundTripTime > m_minRoundTripTime + std::max(m_minRoundTripTime / 2, QueueingDelayTolerance);
+		if (isCongested)
+		{
+			// Decrease at most once per RTT, as the previous decrease needs time to take effect
+			if (now - m_lastDecrease >= roundTripTime)
+			{
+				m_windowSize = std::max(m_windowSize * 7 / 10, MinWindowSize);
+				m_isSlowStart = false;
+				m_lastDecrease = now;
+			}
+		}
+		else if (m_isWindowLimited)
+		{
+			// Only grow the window if it's what is limiting us
+			if (m_isSlowStart)
+				m_windowSize += acknowledgedBytes;
+			else
+				m_windowSize += acknowledgedBytes * WindowGrowthStep / m_windowSize;
+
+			// Don't go too far beyond the bandwidth-delay product
+			std::size_t bandwidthDelayProduct = static_cast<std::size_t>(m_bandwidthEstimate * std::max(m_minRoundTripTime, Nz::Time::Milliseconds(1)).AsSeconds<double>());
+			m_windowSize = std::min(m_windowSize, std::max(bandwidthDelayProduct * 2, MinWindowSize));
+		}
+
+		m_windowSize = std::clamp(m_windowSize, MinWindowSize, MaxWindowSize);
+		m_isWindowLimited = false;
+	}
+}
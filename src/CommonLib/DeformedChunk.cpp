@@ -3,12 +3,15 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <CommonLib/DeformedChunk.hpp>
+#include <CommonLib/ChunkContainer.hpp>
 #include <CommonLib/Utility/SignedDistanceFunctions.hpp>
 #include <Nazara/Core/VertexStruct.hpp>
 #include <Nazara/Math/Ray.hpp>
 #include <Nazara/Physics3D/Collider3D.hpp>
 #include <fmt/format.h>
 #include <fmt/std.h>
+#include <algorithm>
+#include <limits>
 
 namespace tsom
 {
@@ -16,23 +19,220 @@ namespace tsom
 	{
 		std::vector<Nz::UInt32> indices;
 		std::vector<Nz::Vector3f> positions;
+		BuildCollisionMesh(positions, indices);
 
-		auto AddVertices = [&](Nz::UInt32 count)
+		if (indices.empty())
+			return nullptr;
+
+		return std::make_shared<Nz::MeshCollider3D>(&positions[0], positions.size(), indices.data(), indices.size());
+	}
+
+	void DeformedChunk::BuildCollisionMesh(std::vector<Nz::Vector3f>& positions, std::vector<Nz::UInt32>& indices) const
+	{
+		// Unlike BuildMesh, this only outputs the shell of colliding blocks: vertices are shared between faces
+		// and coplanar faces are merged as long as the deformation doesn't bend them
+		std::shared_ptr<const ChunkSnapshot> snapshot = GetSnapshot();
+		if (!snapshot->HasContent())
+			return;
+
+		constexpr Nz::UInt32 InvalidVertex = std::numeric_limits<Nz::UInt32>::max();
+
+		// Work on neighbor snapshots to get a consistent view without locking them
+		Nz::EnumArray<Direction, std::shared_ptr<const ChunkSnapshot>> neighborSnapshots;
+		for (auto&& [dir, neighborSnapshot] : neighborSnapshots.iter_kv())
 		{
-			VertexAttributes vertexAttributes;
+			if (const Chunk* chunk = m_owner.GetChunk(m_indices + s_chunkDirOffset[dir]))
+				neighborSnapshot = chunk->GetSnapshot();
+		}
 
-			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
-			positions.resize(positions.size() + count);
-			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&positions[vertexAttributes.firstIndex]);
+		const Nz::Bitset<Nz::UInt64>& collisionCellMask = snapshot->GetCollisionCellMask();
 
-			return vertexAttributes;
+		auto IsNeighborColliding = [&](const Nz::Vector3ui& blockIndices, Direction direction)
+		{
+			const ChunkSnapshot* chunk = snapshot.get();
+
+			Nz::Vector3i neighborIndices = Nz::Vector3i(blockIndices) + s_blockDirOffset[direction];
+			for (unsigned int axis : { 0, 1, 2 })
+			{
+				if (neighborIndices[axis] < 0)
+				{
+					neighborIndices[axis] += m_size[axis];
+					chunk = neighborSnapshots[direction].get();
+				}
+				else if (neighborIndices[axis] >= int(m_size[axis]))
+				{
+					neighborIndices[axis] -= m_size[axis];
+					chunk = neighborSnapshots[direction].get();
+				}
+			}
+
+			if (!chunk || !chunk->HasContent())
+				return false;
+
+			return chunk->GetCollisionCellMask().UnboundedTest(chunk->GetBlockLocalIndex(Nz::Vector3ui(neighborIndices)));
 		};
 
-		BuildMesh(indices, m_deformationCenter, AddVertices);
-		if (indices.empty())
-			return nullptr;
+		// Grid corners are shared by up to eight blocks, deform them only once
+		auto GetGridPosition = [&](const Nz::Vector3ui& gridIndices)
+		{
+			return Nz::Vector3f(gridIndices.x * m_blockSize, gridIndices.z * m_blockSize, gridIndices.y * m_blockSize);
+		};
 
-		return std::make_shared<Nz::MeshCollider3D>(&positions[0], positions.size(), indices.data(), indices.size());
+		Nz::Vector3ui gridSize = m_size + Nz::Vector3ui(1);
+		std::vector<Nz::UInt32> gridVertices(gridSize.x * gridSize.y * gridSize.z, InvalidVertex);
+
+		auto GetVertex = [&](const Nz::Vector3ui& gridIndices)
+		{
+			Nz::UInt32& vertexIndex = gridVertices[gridSize.x * (gridSize.y * gridIndices.z + gridIndices.y) + gridIndices.x];
+			if (vertexIndex == InvalidVertex)
+			{
+				vertexIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
+				positions.push_back(DeformPosition(GetGridPosition(gridIndices)));
+			}
+
+			return vertexIndex;
+		};
+
+		// Merged quads must not end in the middle of another face edge next to deformed geometry (T-junctions make bodies snag),
+		// so flat faces are only merged when every face touching them (in the same plane or across an edge) is flat too
+		auto IsSurroundingUndeformed = [&](const Nz::Vector3ui& gridIndices, unsigned int normalAxis, unsigned int uAxis, unsigned int vAxis)
+		{
+			for (int n = -1; n <= 1; ++n)
+			{
+				for (int v = -1; v <= 2; ++v)
+				{
+					for (int u = -1; u <= 2; ++u)
+					{
+						Nz::Vector3i cornerIndices(gridIndices);
+						cornerIndices[normalAxis] += n;
+						cornerIndices[uAxis] += u;
+						cornerIndices[vAxis] += v;
+
+						if (!IsUndeformed(Nz::Vector3f(cornerIndices.x * m_blockSize, cornerIndices.z * m_blockSize, cornerIndices.y * m_blockSize)))
+							return false;
+					}
+				}
+			}
+
+			return true;
+		};
+
+		enum class FaceType : Nz::UInt8
+		{
+			None,
+			Mergeable,
+			Single
+		};
+
+		std::vector<FaceType> faces;
+		for (auto&& [direction, offset] : s_blockDirOffset.iter_kv())
+		{
+			unsigned int normalAxis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+			unsigned int uAxis = (normalAxis + 1) % 3;
+			unsigned int vAxis = (normalAxis + 2) % 3;
+			bool positiveSide = offset[normalAxis] > 0;
+
+			// Faces must be counter-clockwise when seen from outside, which depends on the axis swizzling of GetGridPosition
+			Nz::Vector3ui uUnit = Nz::Vector3ui::Zero();
+			uUnit[uAxis] = 1;
+
+			Nz::Vector3ui vUnit = Nz::Vector3ui::Zero();
+			vUnit[vAxis] = 1;
+
+			Nz::Vector3ui normalUnit = Nz::Vector3ui::Zero();
+			normalUnit[normalAxis] = 1;
+
+			Nz::Vector3f faceNormal = Nz::Vector3f::CrossProduct(GetGridPosition(uUnit), GetGridPosition(vUnit));
+			Nz::Vector3f outsideNormal = GetGridPosition(normalUnit) * ((positiveSide) ? 1.f : -1.f);
+			bool reverseWinding = faceNormal.DotProduct(outsideNormal) < 0.f;
+
+			unsigned int uSize = m_size[uAxis];
+			unsigned int vSize = m_size[vAxis];
+			faces.resize(uSize * vSize);
+
+			for (unsigned int layer = 0; layer < m_size[normalAxis]; ++layer)
+			{
+				unsigned int gridLayer = layer + ((positiveSide) ? 1 : 0);
+
+				for (unsigned int v = 0; v < vSize; ++v)
+				{
+					for (unsigned int u = 0; u < uSize; ++u)
+					{
+						Nz::Vector3ui blockIndices;
+						blockIndices[normalAxis] = layer;
+						blockIndices[uAxis] = u;
+						blockIndices[vAxis] = v;
+
+						FaceType& face = faces[v * uSize + u];
+						if (!collisionCellMask.UnboundedTest(GetBlockLocalIndex(blockIndices)) || IsNeighborColliding(blockIndices, direction))
+						{
+							face = FaceType::None;
+							continue;
+						}
+
+						Nz::Vector3ui gridIndices = blockIndices;
+						gridIndices[normalAxis] = gridLayer;
+
+						face = (IsSurroundingUndeformed(gridIndices, normalAxis, uAxis, vAxis)) ? FaceType::Mergeable : FaceType::Single;
+					}
+				}
+
+				// Greedy merge of flat faces, faces next to deformed geometry are kept as is
+				for (unsigned int v = 0; v < vSize; ++v)
+				{
+					for (unsigned int u = 0; u < uSize;)
+					{
+						FaceType face = faces[v * uSize + u];
+						if (face == FaceType::None)
+						{
+							++u;
+							continue;
+						}
+
+						unsigned int width = 1;
+						unsigned int height = 1;
+						if (face == FaceType::Mergeable)
+						{
+							while (u + width < uSize && faces[v * uSize + u + width] == FaceType::Mergeable)
+								width++;
+
+							for (; v + height < vSize; ++height)
+							{
+								const FaceType* row = &faces[(v + height) * uSize + u];
+								if (!std::all_of(row, row + width, [](FaceType rowFace) { return rowFace == FaceType::Mergeable; }))
+									break;
+							}
+						}
+
+						for (unsigned int j = 0; j < height; ++j)
+							std::fill_n(&faces[(v + j) * uSize + u], width, FaceType::None);
+
+						Nz::Vector3ui gridIndices;
+						gridIndices[normalAxis] = gridLayer;
+						gridIndices[uAxis] = u;
+						gridIndices[vAxis] = v;
+
+						Nz::UInt32 firstCorner = GetVertex(gridIndices);
+						Nz::UInt32 uCorner = GetVertex(gridIndices + uUnit * width);
+						Nz::UInt32 vCorner = GetVertex(gridIndices + vUnit * height);
+						Nz::UInt32 oppositeCorner = GetVertex(gridIndices + uUnit * width + vUnit * height);
+
+						if (reverseWinding)
+							std::swap(uCorner, vCorner);
+
+						indices.push_back(firstCorner);
+						indices.push_back(uCorner);
+						indices.push_back(oppositeCorner);
+
+						indices.push_back(firstCorner);
+						indices.push_back(oppositeCorner);
+						indices.push_back(vCorner);
+
+						u += width;
+					}
+				}
+			}
+		}
 	}
 
 	std::optional<Nz::Vector3ui> DeformedChunk::ComputeCoordinates(const Nz::Vector3f& position) const
@@ -152,4 +352,22 @@ namespace tsom
 
 		return innerPos + normal * std::min(m_deformationRadius, distToCenter);
 	}
+
+	bool DeformedChunk::IsUndeformed(const Nz::Vector3f& position) const
+	{
+		// DeformPosition leaves a position untouched if it only gets clamped along its major axis (flat part of a face)
+		Nz::Vector3f offset = (position - m_deformationCenter).GetAbs();
+
+		float distToCenter = std::max({ offset.x, offset.y, offset.z });
+		float innerReductionSize = std::max(distToCenter - m_deformationRadius, 0.f);
+
+		unsigned int clampedAxisCount = 0;
+		for (unsigned int axis : { 0, 1, 2 })
+		{
+			if (offset[axis] > innerReductionSize)
+				clampedAxisCount++;
+		}
+
+		return clampedAxisCount <= 1;
+	}
 }
@@ -0,0 +1,83 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/EntityPropertyTracker.hpp>
+#include <cassert>
+
+namespace tsom
+{
+	void EntityPropertyTracker::Flush(Nz::Time currentTime, const FlushCallback& callback)
+	{
+		for (auto it = m_dirtyEntities.begin(); it != m_dirtyEntities.end();)
+		{
+			entt::entity entity = *it;
+
+			auto entityIt = m_entities.find(entity);
+			assert(entityIt != m_entities.end());
+			EntityData& entityData = entityIt.value();
+
+			m_sendMask.Clear();
+			for (std::size_t propertyIndex : entityData.dirtyProperties.IterBits())
+			{
+				if (propertyIndex < entityData.propertyTimings.size())
+				{
+					PropertyTiming& timing = entityData.propertyTimings[propertyIndex];
+					if (timing.sendInterval > Nz::Time::Zero())
+					{
+						// Rate-limited properties stay dirty until their interval elapsed, their latest value is sent then
+						if (currentTime < timing.nextSendTime)
+							continue;
+
+						timing.nextSendTime = currentTime + timing.sendInterval;
+					}
+				}
+
+				m_sendMask.UnboundedSet(propertyIndex);
+			}
+
+			if (m_sendMask.TestAny())
+			{
+				callback(entity, m_sendMask);
+
+				for (std::size_t propertyIndex : m_sendMask.IterBits())
+					entityData.dirtyProperties.Reset(propertyIndex);
+			}
+
+			if (entityData.dirtyProperties.TestNone())
+			{
+				// Timings have to be kept to rate-limit the next updates
+				if (entityData.propertyTimings.empty())
+					m_entities.erase(entityIt);
+
+				it = m_dirtyEntities.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void EntityPropertyTracker::Forget(entt::entity entity)
+	{
+		m_dirtyEntities.erase(entity);
+		m_entities.erase(entity);
+	}
+
+	void EntityPropertyTracker::MarkDirty(entt::entity entity, Nz::UInt32 propertyIndex, Nz::Time sendInterval)
+	{
+		EntityData& entityData = m_entities[entity];
+		entityData.dirtyProperties.UnboundedSet(propertyIndex);
+
+		if (sendInterval > Nz::Time::Zero())
+		{
+			if (propertyIndex >= entityData.propertyTimings.size())
+				entityData.propertyTimings.resize(propertyIndex + 1);
+
+			entityData.propertyTimings[propertyIndex].sendInterval = sendInterval;
+		}
+		else if (propertyIndex < entityData.propertyTimings.size())
+			entityData.propertyTimings[propertyIndex].sendInterval = Nz::Time::Zero(); //< class may have been reloaded
+
+		m_dirtyEntities.insert(entity);
+	}
+}
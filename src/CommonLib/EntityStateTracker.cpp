@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/EntityStateTracker.hpp>
+#include <cmath>
+
+namespace tsom
+{
+	void EntityStateTracker::Reset(EntityId entityId, Nz::UInt16 tickIndex, const EntityState& state)
+	{
+		if (entityId >= m_sentStates.size())
+			m_sentStates.resize(entityId + 1);
+
+		SentState& sentState = m_sentStates[entityId];
+		sentState.state = state;
+		sentState.tickIndex = tickIndex;
+		sentState.isSleeping = false;
+		sentState.isValid = true;
+	}
+
+	bool EntityStateTracker::ShouldSend(EntityId entityId, Nz::UInt16 tickIndex, const EntityState& state, bool isSleeping)
+	{
+		if (entityId >= m_sentStates.size() || !m_sentStates[entityId].isValid)
+		{
+			Reset(entityId, tickIndex, state);
+			m_sentStates[entityId].isSleeping = isSleeping;
+			return true;
+		}
+
+		SentState& sentState = m_sentStates[entityId];
+
+		bool shouldSend;
+		if (Nz::UInt16(tickIndex - sentState.tickIndex) >= m_heartbeatInterval)
+			shouldSend = true;
+		else if (isSleeping)
+			shouldSend = !sentState.isSleeping; //< send the resting state once, sleeping bodies don't move until woken up
+		else
+		{
+			// Compare to the last sent state (and not the previous one) so slow movements still get sent once they accumulate
+			shouldSend = sentState.state.position.SquaredDistance(state.position) > PositionEpsilon * PositionEpsilon ||
+			             1.f - std::abs(sentState.state.rotation.DotProduct(state.rotation)) > RotationEpsilon;
+		}
+
+		if (!shouldSend)
+			return false;
+
+		sentState.state = state;
+		sentState.tickIndex = tickIndex;
+		sentState.isSleeping = isSleeping;
+
+		return true;
+	}
+}
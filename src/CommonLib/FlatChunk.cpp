@@ -21,7 +21,11 @@ namespace tsom
 			childCollider.collider = std::make_shared<Nz::BoxCollider3D>(box.GetLengths() * m_blockSize);
 		};
 
-		BuildCollider(m_size, GetCollisionCellMask(), AddBox);
+		std::shared_ptr<const ChunkSnapshot> snapshot = GetSnapshot();
+		if (!snapshot->HasContent())
+			return nullptr;
+
+		BuildCollider(m_size, snapshot->GetCollisionCellMask(), AddBox);
 
 		if (childColliders.empty())
 			return nullptr;
@@ -4,13 +4,32 @@
 
 #include <CommonLib/NetworkReactor.hpp>
 #include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <CommonLib/Utility/MetricsRegistry.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <Nazara/Core/ThreadExt.hpp>
+#include <array>
 #include <cassert>
 #include <stdexcept>
+#include <string>
 
 namespace tsom
 {
+	struct NetworkReactor::TrafficCounters
+	{
+		struct PacketCounters
+		{
+			MetricsRegistry::Counter* bytes;
+			MetricsRegistry::Counter* packets;
+		};
+
+		std::array<PacketCounters, PacketCount> received;
+		std::array<PacketCounters, PacketCount> sent;
+	};
+
 	NetworkReactor::NetworkReactor(std::size_t idOffset, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient) :
+	m_trafficCountersPtr(nullptr),
+	m_fakePeersEnabled(false),
 	m_idOffset(idOffset),
 	m_protocol(protocol)
 	{
@@ -22,6 +41,8 @@ namespace tsom
 		else if (!m_host.Create((protocol == Nz::NetProtocol::IPv4) ? Nz::IpAddress::LoopbackIpV4 : Nz::IpAddress::LoopbackIpV6, maxClient, Constants::NetworkChannelCount))
 			throw std::runtime_error("failed to start reactor");
 
+		m_boundPort = m_host.GetBoundAddress().GetPort();
+
 		m_clients.resize(maxClient, nullptr);
 
 		m_running.store(true, std::memory_order_release);
@@ -73,6 +94,37 @@ namespace tsom
 		m_outgoingQueue.enqueue(std::move(outgoingData));
 	}
 
+	void NetworkReactor::EnableFakePeers()
+	{
+		m_fakePeersEnabled.store(true, std::memory_order_relaxed);
+	}
+
+	void NetworkReactor::EnableMetrics(MetricsRegistry& metricsRegistry)
+	{
+		assert(!m_trafficCounters);
+
+		auto trafficCounters = std::make_unique<TrafficCounters>();
+		for (std::size_t i = 0; i < PacketCount; ++i)
+		{
+			std::string packetName(PacketNames[i]);
+
+			auto BuildCounters = [&](std::string_view direction)
+			{
+				TrafficCounters::PacketCounters packetCounters;
+				packetCounters.bytes = &metricsRegistry.GetCounter("tsom_network_bytes_total", "Network bytes by packet type and direction", { { "direction", std::string(direction) }, { "packet", packetName } });
+				packetCounters.packets = &metricsRegistry.GetCounter("tsom_network_packets_total", "Network packets by packet type and direction", { { "direction", std::string(direction) }, { "packet", packetName } });
+
+				return packetCounters;
+			};
+
+			trafficCounters->received[i] = BuildCounters("received");
+			trafficCounters->sent[i] = BuildCounters("sent");
+		}
+
+		m_trafficCounters = std::move(trafficCounters);
+		m_trafficCountersPtr.store(m_trafficCounters.get(), std::memory_order_release);
+	}
+
 	void NetworkReactor::QueryInfo(std::size_t peerId, PeerInfoCallback callback)
 	{
 		assert(peerId >= m_idOffset);
@@ -90,6 +142,9 @@ namespace tsom
 	{
 		assert(peerId >= m_idOffset);
 
+		// Sent traffic is counted on the calling thread, before being queued (received traffic is counted on the reactor thread)
+		CountTraffic(m_trafficCountersPtr.load(std::memory_order_acquire), true, payload);
+
 		OutgoingEvent::PacketEvent packetEvent;
 		packetEvent.acknowledgeCallback = std::move(acknowledgeCallback);
 		packetEvent.channelId = channelId;
@@ -106,6 +161,7 @@ namespace tsom
 	void NetworkReactor::WorkerThread()
 	{
 		Nz::SetCurrentThreadName("NetworkReactor");
+		TickProfiler::SetThreadName("NetworkReactor");
 
 		moodycamel::ConsumerToken connectionToken(m_connectionRequests);
 		moodycamel::ConsumerToken outgoingToken(m_outgoingQueue);
@@ -203,6 +259,8 @@ namespace tsom
 		Nz::ENetEvent event;
 		if (m_host.Service(&event, 5) > 0)
 		{
+			TickProfiler::Zone profileZone("NetworkReactor::ReceivePackets");
+
 			do
 			{
 				switch (event.type)
@@ -251,6 +309,8 @@ namespace tsom
 						IncomingEvent::PacketEvent packetEvent;
 						packetEvent.data = std::move(event.packet->data);
 
+						CountTraffic(m_trafficCountersPtr.load(std::memory_order_acquire), false, packetEvent.data);
+
 						IncomingEvent newEvent;
 						newEvent.peerId = m_idOffset + peerId;
 						newEvent.data.emplace<IncomingEvent::PacketEvent>(std::move(packetEvent));
@@ -269,6 +329,8 @@ namespace tsom
 
 	void NetworkReactor::SendPackets(const moodycamel::ProducerToken& producterToken, moodycamel::ConsumerToken& token)
 	{
+		TickProfiler::Zone profileZone("NetworkReactor::SendPackets");
+
 		OutgoingEvent outEvent;
 		while (m_outgoingQueue.try_dequeue(token, outEvent))
 		{
@@ -322,6 +384,12 @@ namespace tsom
 
 						peer->Send(arg.channelId, std::move(packet));
 					}
+					else if (m_fakePeersEnabled.load(std::memory_order_relaxed))
+					{
+						// No peer exists when replaying a recording, acknowledge packets on the reactor thread like ENet does so reliable transfers keep going
+						if (arg.acknowledgeCallback)
+							arg.acknowledgeCallback();
+					}
 				}
 				else if constexpr (std::is_same_v<T, OutgoingEvent::QueryPeerInfo>)
 				{
@@ -340,6 +408,17 @@ namespace tsom
 						peerInfo.peerInfo.totalPacketReceived = peer->GetTotalPacketReceived();
 						peerInfo.peerInfo.totalPacketSent = peer->GetTotalPacketSent();
 
+						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+					}
+					else if (m_fakePeersEnabled.load(std::memory_order_relaxed))
+					{
+						IncomingEvent newEvent;
+						newEvent.peerId = m_idOffset + outEvent.peerId;
+
+						auto& peerInfo = newEvent.data.emplace<IncomingEvent::PeerInfoResponse>();
+						peerInfo.callback = std::move(arg.callback);
+						peerInfo.peerInfo = PeerInfo{}; //< fake peers have no latency nor packet loss
+
 						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
 					}
 				}
@@ -349,4 +428,19 @@ namespace tsom
 			}, outEvent.data);
 		}
 	}
+
+	void NetworkReactor::CountTraffic(const TrafficCounters* trafficCounters, bool outgoing, const Nz::ByteArray& payload)
+	{
+		if (!trafficCounters || payload.IsEmpty())
+			return;
+
+		// First byte is the packet opcode
+		Nz::UInt8 opcode = payload[0];
+		if (opcode >= PacketCount)
+			return;
+
+		const TrafficCounters::PacketCounters& packetCounters = (outgoing) ? trafficCounters->sent[opcode] : trafficCounters->received[opcode];
+		packetCounters.bytes->Increment(static_cast<double>(payload.GetSize()));
+		packetCounters.packets->Increment();
+	}
 }
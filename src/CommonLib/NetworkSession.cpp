@@ -12,7 +12,9 @@ namespace tsom
 	m_peerId(peerId),
 	m_remoteAddress(remoteAddress),
 	m_protocolVersion(0),
-	m_reactor(reactor)
+	m_reactor(reactor),
+	m_isBufferingPackets(false),
+	m_isChunkContentCacheEnabled(false)
 	{
 	}
 
@@ -22,10 +24,23 @@ namespace tsom
 	{
 		assert(m_peerId != NetworkReactor::InvalidPeerId);
 
+		// Don't drop packets sent before disconnection
+		FlushBufferedPackets();
+
 		m_reactor.DisconnectPeer(m_peerId, 0, type);
 		m_sessionHandler = nullptr;
 	}
 
+	void NetworkSession::FlushBufferedPackets()
+	{
+		m_isBufferingPackets = false;
+
+		for (BufferedPacket& packet : m_bufferedPackets)
+			m_reactor.SendData(m_peerId, packet.channel, packet.flags, std::move(packet.payload), std::move(packet.acknowledgeCallback));
+
+		m_bufferedPackets.clear();
+	}
+
 	void NetworkSession::HandlePacket(Nz::ByteArray&& byteArray)
 	{
 		if NAZARA_LIKELY(m_sessionHandler)
@@ -39,6 +54,23 @@ namespace tsom
 		m_reactor.QueryInfo(m_peerId, std::move(callback));
 	}
 
+	void NetworkSession::SendData(Nz::UInt8 channel, Nz::ENetPacketFlags flags, Nz::ByteArray&& payload, std::function<void()> acknowledgeCallback)
+	{
+		// Packets can be buffered while the session is accessed from another thread, to be handed to the reactor in order later
+		if (m_isBufferingPackets)
+		{
+			m_bufferedPackets.push_back({
+				.payload = std::move(payload),
+				.flags = flags,
+				.channel = channel,
+				.acknowledgeCallback = std::move(acknowledgeCallback)
+			});
+			return;
+		}
+
+		m_reactor.SendData(m_peerId, channel, flags, std::move(payload), std::move(acknowledgeCallback));
+	}
+
 	SessionHandler& NetworkSession::SetHandler(std::unique_ptr<SessionHandler>&& sessionHandler)
 	{
 		m_sessionHandler = std::move(sessionHandler);
@@ -4,6 +4,7 @@
 
 #include <CommonLib/NetworkSessionManager.hpp>
 #include <CommonLib/SessionHandler.hpp>
+#include <CommonLib/SessionRecorder.hpp>
 #include <NazaraUtils/Hash.hpp>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -11,35 +12,61 @@
 
 namespace tsom
 {
+	void NetworkSessionManager::HandleConnection(std::size_t peerIndex, const Nz::IpAddress& remoteAddress)
+	{
+		assert(!m_sessions[peerIndex].has_value());
+
+		if (m_recorder)
+			m_recorder->RecordConnection(peerIndex);
+
+		std::string addressStr = remoteAddress.ToString(false);
+
+		fmt::print("Peer connected (peerIndex: {}, hashed address: {:x})\n", peerIndex, Nz::FNV1a64(addressStr));
+		m_sessions[peerIndex].emplace(m_reactor, peerIndex, remoteAddress);
+		m_sessions[peerIndex]->SetHandler(m_handlerFactory(&m_sessions[peerIndex].value()));
+	}
+
+	void NetworkSessionManager::HandleDisconnection(std::size_t peerIndex, bool timeout)
+	{
+		assert(m_sessions[peerIndex].has_value());
+
+		if (m_recorder)
+			m_recorder->RecordDisconnection(peerIndex, timeout);
+
+		fmt::print("Peer {} (peerIndex: {})\n", (timeout) ? "timeout" : "disconnected", peerIndex);
+		m_sessions[peerIndex].reset();
+	}
+
+	void NetworkSessionManager::HandlePacket(std::size_t peerIndex, Nz::ByteArray&& packet)
+	{
+		assert(m_sessions[peerIndex].has_value());
+
+		if (m_recorder)
+			m_recorder->RecordPacket(peerIndex, packet);
+
+		m_sessions[peerIndex]->HandlePacket(std::move(packet));
+	}
+
 	void NetworkSessionManager::Poll()
 	{
 		auto ConnectionHandler = [&]([[maybe_unused]] bool outgoingConnection, std::size_t peerIndex, const Nz::IpAddress& remoteAddress, [[maybe_unused]] Nz::UInt32 data)
 		{
 			assert(!outgoingConnection);
-			assert(!m_sessions[peerIndex].has_value());
 			assert(data == 0);
 
-			std::string addressStr = remoteAddress.ToString(false);
-
-			fmt::print("Peer connected (peerIndex: {}, hashed address: {:x})\n", peerIndex, Nz::FNV1a64(addressStr));
-			m_sessions[peerIndex].emplace(m_reactor, peerIndex, remoteAddress);
-			m_sessions[peerIndex]->SetHandler(m_handlerFactory(&m_sessions[peerIndex].value()));
+			HandleConnection(peerIndex, remoteAddress);
 		};
 
 		auto DisconnectionHandler = [&](std::size_t peerIndex, [[maybe_unused]] Nz::UInt32 data, bool timeout)
 		{
-			assert(m_sessions[peerIndex].has_value());
 			assert(data == 0);
 
-			fmt::print("Peer {} (peerIndex: {})\n", (timeout) ? "timeout" : "disconnected", peerIndex);
-			m_sessions[peerIndex].reset();
+			HandleDisconnection(peerIndex, timeout);
 		};
 
 		auto PacketHandler = [&](std::size_t peerIndex, Nz::ByteArray&& packet)
 		{
-			assert(m_sessions[peerIndex].has_value());
-
-			m_sessions[peerIndex]->HandlePacket(std::move(packet));
+			HandlePacket(peerIndex, std::move(packet));
 		};
 
 		m_reactor.Poll(ConnectionHandler, DisconnectionHandler, PacketHandler);
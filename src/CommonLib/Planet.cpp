@@ -6,20 +6,52 @@
 #include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/DeformedChunk.hpp>
 #include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/Utility/BatchedPerlinNoise.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
 #include <CommonLib/Utility/SignedDistanceFunctions.hpp>
 #include <Nazara/Core/TaskScheduler.hpp>
 #include <Nazara/Core/VertexStruct.hpp>
 #include <Nazara/Math/Ray.hpp>
 #include <Nazara/Physics3D/Collider3D.hpp>
 #include <NazaraUtils/CallOnExit.hpp>
-#include <PerlinNoise.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
 #include <fmt/format.h>
+#include <array>
 #include <random>
+#include <vector>
 
 namespace tsom
 {
+	namespace
+	{
+		// Neighbor chunks touched by an update spanning the [minIndices, maxIndices] region
+		DirectionMask ComputeNeighborMask(const Chunk& chunk, const Nz::Vector3ui& minIndices, const Nz::Vector3ui& maxIndices)
+		{
+			DirectionMask neighborMask;
+			if (minIndices.x == 0)
+				neighborMask |= Direction::Left;
+			if (maxIndices.x == chunk.GetSize().x - 1)
+				neighborMask |= Direction::Right;
+
+			if (minIndices.y == 0)
+				neighborMask |= Direction::Front;
+			if (maxIndices.y == chunk.GetSize().y - 1)
+				neighborMask |= Direction::Back;
+
+			if (minIndices.z == 0)
+				neighborMask |= Direction::Down;
+			if (maxIndices.z == chunk.GetSize().z - 1)
+				neighborMask |= Direction::Up;
+
+			return neighborMask;
+		}
+	}
+
+	static_assert(PlanetHeightmapCache::TileSize == Planet::ChunkSize);
+
 	Planet::Planet(float tileSize, float cornerRadius, float gravity) :
 	ChunkContainer(tileSize),
+	m_heightmapCache(DefaultHeightmapCacheCapacity),
 	m_cornerRadius(cornerRadius),
 	m_gravity(gravity)
 	{
@@ -38,23 +70,12 @@ namespace tsom
 
 		chunkData.onUpdated.Connect(chunkData.chunk->OnBlockUpdated, [this](Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex /*newBlock*/)
 		{
-			DirectionMask neighborMask;
-			if (indices.x == 0)
-				neighborMask |= Direction::Left;
-			else if (indices.x == chunk->GetSize().x - 1)
-				neighborMask |= Direction::Right;
-
-			if (indices.y == 0)
-				neighborMask |= Direction::Front;
-			else if (indices.y == chunk->GetSize().y - 1)
-				neighborMask |= Direction::Back;
-
-			if (indices.z == 0)
-				neighborMask |= Direction::Down;
-			else if (indices.z == chunk->GetSize().z - 1)
-				neighborMask |= Direction::Up;
+			OnChunkUpdated(this, chunk, ComputeNeighborMask(*chunk, indices, indices));
+		});
 
-			OnChunkUpdated(this, chunk, neighborMask);
+		chunkData.onBlocksUpdated.Connect(chunkData.chunk->OnBlocksUpdated, [this](Chunk* chunk, const Nz::Bitset<Nz::UInt64>& /*updatedBlocks*/, const Nz::Vector3ui& minIndices, const Nz::Vector3ui& maxIndices)
+		{
+			OnChunkUpdated(this, chunk, ComputeNeighborMask(*chunk, minIndices, maxIndices));
 		});
 
 		auto it = m_chunks.insert_or_assign(indices, std::move(chunkData)).first;
@@ -176,10 +197,6 @@ namespace tsom
 		Nz::Vector3i maxHeight((Nz::Vector3i(chunkCount) + Nz::Vector3i(1)) / 2);
 		maxHeight *= int(Planet::ChunkSize);
 
-		Nz::EnumArray<Direction, siv::PerlinNoise> perlin;
-		for (auto&& [dir, noise] : perlin.iter_kv())
-			noise.reseed(seed + static_cast<unsigned int>(dir));
-
 		chunk.LockWrite();
 		NAZARA_DEFER({ chunk.UnlockWrite(); });
 
@@ -230,15 +247,55 @@ namespace tsom
 			constexpr double heightScale = 1.5f;
 			constexpr double scale = 0.02f;
 
+			// Terrain depth only depends on the face-space position of a column, every chunk of a column shares the same tile
+			auto GetTerrainDepths = [&](Direction face, int faceMaxHeight, const Nz::FunctionRef<Nz::Vector2i(unsigned int x, unsigned int y)>& getFacePosition)
+			{
+				PlanetHeightmapCache::TileKey tileKey;
+				tileKey.face = face;
+				tileKey.seed = seed;
+				tileKey.origin = getFacePosition(0, 0);
+				tileKey.maxHeight = faceMaxHeight;
+
+				return m_heightmapCache.GetTile(tileKey, [&](PlanetHeightmapCache::Tile& terrainDepths)
+				{
+					// Evaluate the noise of the whole tile at once
+					std::array<double, Planet::ChunkSize * Planet::ChunkSize> noiseX;
+					std::array<double, Planet::ChunkSize * Planet::ChunkSize> noiseY;
+					std::array<double, Planet::ChunkSize * Planet::ChunkSize> noiseValues;
+					for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+					{
+						for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+						{
+							Nz::Vector2i facePosition = getFacePosition(x, y);
+							noiseX[y * Planet::ChunkSize + x] = facePosition.x * scale;
+							noiseY[y * Planet::ChunkSize + x] = facePosition.y * scale;
+						}
+					}
+
+					BatchedPerlinNoise perlin(seed + static_cast<unsigned int>(face));
+					perlin.NormalizedOctave2D_01(noiseX, noiseY, noiseValues, 4);
+
+					for (std::size_t i = 0; i < noiseValues.size(); ++i)
+					{
+						double height = noiseValues[i] * heightScale;
+						terrainDepths[i] = std::round(std::min<double>(height * (faceMaxHeight / 2 - freeSpace) + freeSpace, faceMaxHeight / 2));
+					}
+				});
+			};
+
 			// +X
+			auto rightTerrainDepths = GetTerrainDepths(Direction::Right, maxHeight.x, [&](unsigned int x, unsigned int y)
+			{
+				BlockIndices mapPos = GetBlockIndices(chunkIndices, { 0, x, y });
+				return Nz::Vector2i(mapPos.y, mapPos.z);
+			});
+
 			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 			{
 				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 				{
 					BlockIndices mapPos = GetBlockIndices(chunkIndices, { 0, x, y });
-					double height = perlin[Direction::Right].normalizedOctave2D_01(mapPos.y * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.x / 2 - freeSpace) + freeSpace, maxHeight.x / 2));
+					int terrainDepth = (*rightTerrainDepths)[y * Planet::ChunkSize + x];
 					int blockDepth = maxHeight.x - mapPos.x + 1;
 					if (blockDepth < terrainDepth)
 						continue;
@@ -256,14 +313,18 @@ namespace tsom
 			}
 
 			// -X
+			auto leftTerrainDepths = GetTerrainDepths(Direction::Left, maxHeight.x, [&](unsigned int x, unsigned int y)
+			{
+				BlockIndices mapPos = GetBlockIndices(chunkIndices, { Planet::ChunkSize - 1, x, y });
+				return Nz::Vector2i(mapPos.y, mapPos.z);
+			});
+
 			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 			{
 				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 				{
 					BlockIndices mapPos = GetBlockIndices(chunkIndices, { Planet::ChunkSize - 1, x, y });
-					double height = perlin[Direction::Left].normalizedOctave2D_01(mapPos.y * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.x / 2 - freeSpace) + freeSpace, maxHeight.x / 2));
+					int terrainDepth = (*leftTerrainDepths)[y * Planet::ChunkSize + x];
 					int blockDepth = maxHeight.x + mapPos.x + 1;
 					if (blockDepth < terrainDepth)
 						continue;
@@ -281,14 +342,18 @@ namespace tsom
 			}
 
 			// +Y
+			auto upTerrainDepths = GetTerrainDepths(Direction::Up, maxHeight.y, [&](unsigned int x, unsigned int z)
+			{
+				BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, 0 });
+				return Nz::Vector2i(mapPos.x, mapPos.z);
+			});
+
 			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
 			{
 				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 				{
 					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, 0 });
-					double height = perlin[Direction::Up].normalizedOctave2D_01(mapPos.x * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.y / 2 - freeSpace) + freeSpace, maxHeight.y / 2));
+					int terrainDepth = (*upTerrainDepths)[z * Planet::ChunkSize + x];
 					int blockDepth = maxHeight.y - mapPos.y + 1;
 					if (blockDepth < terrainDepth)
 						continue;
@@ -306,14 +371,18 @@ namespace tsom
 			}
 
 			// -Y
+			auto downTerrainDepths = GetTerrainDepths(Direction::Down, maxHeight.y, [&](unsigned int x, unsigned int z)
+			{
+				BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, Planet::ChunkSize - 1 });
+				return Nz::Vector2i(mapPos.x, mapPos.z);
+			});
+
 			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
 			{
 				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 				{
 					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, Planet::ChunkSize - 1 });
-					double height = perlin[Direction::Down].normalizedOctave2D_01(mapPos.x * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.y / 2 - freeSpace) + freeSpace, maxHeight.y / 2));
+					int terrainDepth = (*downTerrainDepths)[z * Planet::ChunkSize + x];
 					int blockDepth = maxHeight.y + mapPos.y + 1;
 					if (blockDepth < terrainDepth)
 						continue;
@@ -331,14 +400,18 @@ namespace tsom
 			}
 
 			// +Z
+			auto backTerrainDepths = GetTerrainDepths(Direction::Back, maxHeight.z, [&](unsigned int x, unsigned int y)
+			{
+				BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, 0, y });
+				return Nz::Vector2i(mapPos.x, mapPos.y);
+			});
+
 			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 			{
 				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 				{
 					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, 0, y });
-					double height = perlin[Direction::Back].normalizedOctave2D_01(mapPos.x * scale, mapPos.y * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.z / 2 - freeSpace) + freeSpace, maxHeight.z / 2));
+					int terrainDepth = (*backTerrainDepths)[y * Planet::ChunkSize + x];
 					int blockDepth = maxHeight.z - mapPos.z + 1;
 					if (blockDepth < terrainDepth)
 						continue;
@@ -356,14 +429,18 @@ namespace tsom
 			}
 
 			// -Z
+			auto frontTerrainDepths = GetTerrainDepths(Direction::Front, maxHeight.z, [&](unsigned int x, unsigned int y)
+			{
+				BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, Planet::ChunkSize - 1, y });
+				return Nz::Vector2i(mapPos.x, mapPos.y);
+			});
+
 			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 			{
 				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 				{
 					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, Planet::ChunkSize - 1, y });
-					double height = perlin[Direction::Front].normalizedOctave2D_01(mapPos.x * scale, mapPos.y * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.z / 2 - freeSpace) + freeSpace, maxHeight.z / 2));
+					int terrainDepth = (*frontTerrainDepths)[y * Planet::ChunkSize + x];
 					int blockDepth = maxHeight.z + mapPos.z + 1;
 					if (blockDepth < terrainDepth)
 						continue;
@@ -421,6 +498,9 @@ namespace tsom
 		BlockIndex borderBlockIndex = blockLibrary.GetBlockIndex("copper_block");
 		BlockIndex interiorBlockIndex = blockLibrary.GetBlockIndex("stone_bricks");
 
+		// Platform may span multiple chunks, batch updates per chunk to lock and notify each of them only once
+		tsl::hopscotch_map<Chunk*, std::vector<Chunk::BlockUpdate>> chunkUpdates;
+
 		BlockIndices originalCoordinates = coordinates;
 		for (unsigned int y = 0; y < freeHeight; ++y)
 		{
@@ -441,7 +521,7 @@ namespace tsom
 					Nz::Vector3ui innerCoordinates;
 					ChunkIndices chunkIndices = GetChunkIndicesByBlockIndices(coordinates, &innerCoordinates);
 					if (Chunk* chunk = GetChunk(chunkIndices))
-						chunk->UpdateBlock(innerCoordinates, blockIndex);
+						chunkUpdates[chunk].push_back({ innerCoordinates, blockIndex });
 
 					xPos += dirAxis.rightDir;
 				}
@@ -497,7 +577,7 @@ namespace tsom
 					}
 
 					hasEmpty = true;
-					chunk->UpdateBlock(innerCoordinates, planksBlockIndex);
+					chunkUpdates[chunk].push_back({ innerCoordinates, planksBlockIndex });
 				}
 
 				xPos = startingX;
@@ -509,6 +589,13 @@ namespace tsom
 
 			zPos = startingZ;
 		}
+
+		for (auto&& [chunk, blockUpdates] : chunkUpdates)
+		{
+			chunk->LockWrite();
+			chunk->UpdateBlocks(blockUpdates);
+			chunk->UnlockWrite();
+		}
 	}
 
 	void Planet::RemoveChunk(const ChunkIndices& indices)
@@ -519,4 +606,33 @@ namespace tsom
 		OnChunkRemove(this, it->second.chunk.get());
 		m_chunks.erase(it);
 	}
+
+	std::shared_ptr<CompressionDictionary> Planet::TrainChunkDictionary(const BlockLibrary& blockLibrary, Nz::UInt32 dictionaryId)
+	{
+		// Used offline to produce the dictionary asset, train it on a fixed small planet (covering core, underground and surface chunks)
+		constexpr Nz::UInt32 seed = 42;
+		const Nz::Vector3ui chunkCount(3);
+
+		Planet planet(1.f, 16.f, 9.81f);
+		planet.GetHeightmapCache().UpdateCapacity(0);
+
+		std::vector<std::span<const Nz::UInt8>> samples;
+
+		Nz::Vector3i halfChunkCount = Nz::Vector3i(chunkCount) / 2;
+		for (int z = -halfChunkCount.z; z <= halfChunkCount.z; ++z)
+		{
+			for (int y = -halfChunkCount.y; y <= halfChunkCount.y; ++y)
+			{
+				for (int x = -halfChunkCount.x; x <= halfChunkCount.x; ++x)
+				{
+					Chunk& chunk = planet.AddChunk(blockLibrary, { x, y, z });
+					planet.GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+
+					samples.emplace_back(reinterpret_cast<const Nz::UInt8*>(chunk.GetContent()), chunk.GetBlockCount() * sizeof(BlockIndex));
+				}
+			}
+		}
+
+		return CompressionDictionary::Train(dictionaryId, samples);
+	}
 }
@@ -0,0 +1,67 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/PlanetHeightmapCache.hpp>
+
+namespace tsom
+{
+	void PlanetHeightmapCache::Clear()
+	{
+		std::lock_guard lock(m_mutex);
+		m_tiles.clear();
+		m_lruList.clear();
+	}
+
+	std::shared_ptr<const PlanetHeightmapCache::Tile> PlanetHeightmapCache::GetTile(const TileKey& key, const Nz::FunctionRef<void(Tile& tile)>& generator)
+	{
+		std::shared_ptr<TileEntry> entry;
+		{
+			std::lock_guard lock(m_mutex);
+			if (m_capacity == 0)
+				entry = std::make_shared<TileEntry>(); //< caching is disabled
+			else if (auto it = m_tiles.find(key); it != m_tiles.end())
+			{
+				entry = it->second;
+				m_lruList.splice(m_lruList.begin(), m_lruList, entry->lruIt);
+			}
+			else
+			{
+				entry = std::make_shared<TileEntry>();
+				m_lruList.push_front(key);
+				entry->lruIt = m_lruList.begin();
+				m_tiles.emplace(key, entry);
+
+				EvictTiles();
+			}
+		}
+
+		// Generate the tile outside of the lock, other threads requesting the same tile will wait for it
+		// (evicted tiles stay alive as long as someone holds them)
+		std::call_once(entry->generated, [&] { generator(entry->tile); });
+
+		return std::shared_ptr<const Tile>(entry, &entry->tile);
+	}
+
+	std::size_t PlanetHeightmapCache::GetTileCount() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_tiles.size();
+	}
+
+	void PlanetHeightmapCache::UpdateCapacity(std::size_t capacity)
+	{
+		std::lock_guard lock(m_mutex);
+		m_capacity = capacity;
+		EvictTiles();
+	}
+
+	void PlanetHeightmapCache::EvictTiles()
+	{
+		while (m_tiles.size() > m_capacity)
+		{
+			m_tiles.erase(m_lruList.back());
+			m_lruList.pop_back();
+		}
+	}
+}
@@ -3,11 +3,13 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <CommonLib/Protocol/Packets.hpp>
+#include <CommonLib/InternalConstants.hpp>
 #include <CommonLib/Version.hpp>
 #include <CommonLib/Utility/BinaryCompressor.hpp>
 #include <NazaraUtils/TypeTraits.hpp>
 #include <lz4.h>
 #include <fmt/format.h>
+#include <cassert>
 
 namespace tsom
 {
@@ -32,6 +34,14 @@ namespace tsom
 
 	namespace Packets
 	{
+		namespace
+		{
+			CompressedUnsigned<Nz::UInt32> GetBlockRunHeader(const ChunkUpdate::BlockRun& run)
+			{
+				return CompressedUnsigned<Nz::UInt32>(Nz::SafeCast<Nz::UInt32>(((run.length - 1) << 1) | ((run.isUniform) ? 1 : 0)));
+			}
+		}
+
 		namespace Helper
 		{
 			void Serialize(PacketSerializer& serializer, EntityState& data)
@@ -99,6 +109,53 @@ namespace tsom
 			}
 		}
 
+		void BuildChunkUpdateRuns(std::span<const ChunkUpdate::BlockUpdate> updates, std::vector<ChunkUpdate::BlockRun>& runs)
+		{
+			runs.clear();
+			for (std::size_t i = 0; i < updates.size();)
+			{
+				const auto& firstUpdate = updates[i];
+
+				ChunkUpdate::BlockRun& run = runs.emplace_back(ChunkUpdate::BlockRun{ i, 1, true });
+				for (; i + run.length < updates.size(); ++run.length)
+				{
+					const auto& update = updates[i + run.length];
+					if (update.voxelLoc.x != firstUpdate.voxelLoc.x + run.length || update.voxelLoc.y != firstUpdate.voxelLoc.y || update.voxelLoc.z != firstUpdate.voxelLoc.z)
+						break;
+
+					if (update.newContent != firstUpdate.newContent)
+						run.isUniform = false;
+				}
+
+				i += run.length;
+			}
+		}
+
+		std::size_t ComputeChunkUpdateSize(std::span<const ChunkUpdate::BlockUpdate> updates, Nz::UInt32 protocolVersion)
+		{
+			// Size of the updates as written by Serialize(ChunkUpdate), without the packet header
+			constexpr std::size_t VoxelLocationSize = 3;
+
+			if (protocolVersion < Constants::ProtocolChunkUpdateRunsVersion)
+				return CompressedUnsigned<Nz::UInt32>(Nz::SafeCast<Nz::UInt32>(updates.size())).GetEncodedSize() + updates.size() * (VoxelLocationSize + sizeof(BlockIndex));
+
+			static thread_local std::vector<ChunkUpdate::BlockRun> runs;
+			BuildChunkUpdateRuns(updates, runs);
+
+			std::size_t size = CompressedUnsigned<Nz::UInt32>(Nz::SafeCast<Nz::UInt32>(runs.size())).GetEncodedSize();
+			for (const ChunkUpdate::BlockRun& run : runs)
+			{
+				size += VoxelLocationSize;
+				size += GetBlockRunHeader(run).GetEncodedSize();
+
+				std::size_t blockCount = (run.isUniform) ? 1 : run.length;
+				for (std::size_t i = 0; i < blockCount; ++i)
+					size += CompressedUnsigned<BlockIndex>(updates[run.firstUpdate + i].newContent).GetEncodedSize();
+			}
+
+			return size;
+		}
+
 		void Serialize(PacketSerializer& serializer, AuthRequest& data)
 		{
 			serializer &= data.gameVersion;
@@ -129,6 +186,15 @@ namespace tsom
 					}
 				});
 			}
+
+			if (data.gameVersion >= Constants::ProtocolCompressionFrameVersion)
+			{
+				serializer &= data.compressionCapabilities.codecMask;
+				serializer &= data.compressionCapabilities.dictionaries;
+			}
+
+			if (data.gameVersion >= Constants::ProtocolChunkCacheVersion)
+				serializer &= data.hasChunkContentCache;
 		}
 
 		void Serialize(PacketSerializer& serializer, AuthResponse& data)
@@ -140,6 +206,40 @@ namespace tsom
 			}
 		}
 
+		void Serialize(PacketSerializer& serializer, BulkCancel& data)
+		{
+			serializer &= data.transferId;
+		}
+
+		void Serialize(PacketSerializer& serializer, BulkCommit& data)
+		{
+			serializer &= data.transferId;
+		}
+
+		void Serialize(PacketSerializer& serializer, BulkFragment& data)
+		{
+			serializer &= data.transferId;
+			serializer &= data.offset;
+			serializer &= data.totalSize;
+
+			// Check size before allocating memory
+			CompressedUnsigned<Nz::UInt32> fragmentSize;
+			if (serializer.IsWriting())
+				fragmentSize = Nz::SafeCast<Nz::UInt32>(data.data.size());
+
+			serializer &= fragmentSize;
+			if (fragmentSize > Constants::BulkFragmentMaxSize)
+				throw std::runtime_error(fmt::format("malformed packet (fragment size exceeds max fragment size: {0} > {1})", Nz::UInt32(fragmentSize), Constants::BulkFragmentMaxSize));
+
+			if (serializer.IsWriting())
+				serializer.Write(data.data.data(), data.data.size());
+			else
+			{
+				data.data.resize(fragmentSize);
+				serializer.Read(data.data.data(), data.data.size());
+			}
+		}
+
 		void Serialize(PacketSerializer& serializer, ChatMessage& data)
 		{
 			serializer &= data.message;
@@ -160,6 +260,12 @@ namespace tsom
 			serializer &= data.chunkSizeY;
 			serializer &= data.chunkSizeZ;
 			serializer &= data.cellSize;
+
+			if (serializer.GetProtocolVersion() < Constants::ProtocolChunkCacheVersion)
+				return;
+
+			serializer.SerializePresence(data.contentHash);
+			serializer.Serialize(data.contentHash);
 		}
 
 		void Serialize(PacketSerializer& serializer, ChunkDestroy& data)
@@ -177,17 +283,39 @@ namespace tsom
 			serializer &= data.entityId;
 			serializer &= data.chunkId;
 
-			serializer.SerializeArraySize(data.content);
+			if (serializer.IsWriting() && data.snapshot)
+			{
+				CompressedUnsigned<Nz::UInt32> blockCount(Nz::SafeCast<Nz::UInt32>(data.snapshot->GetBlockCount()));
+				serializer &= blockCount;
+			}
+			else
+				serializer.SerializeArraySize(data.content);
+
 			std::size_t bufferSize = data.content.size() * sizeof(BlockIndex);
 
+			// Since 0.6.0 chunk content is sent as a compression frame, allowing codec and dictionary to be negotiated
+			bool useFrame = serializer.GetProtocolVersion() >= Constants::ProtocolCompressionFrameVersion;
+
+			// Session profile has been negotiated during the handshake, fallback to plain LZ4 when serializing outside of a session
+			const CompressionProfile* compressionProfile = serializer.GetCompressionProfile();
+
 			BinaryCompressor& binaryCompressor = serializer.GetBinaryCompressor();
 			if (serializer.IsWriting())
 			{
-				std::optional compressedData = binaryCompressor.Compress(data.content.data(), bufferSize);
+				const CompressionProfile& profile = (compressionProfile) ? *compressionProfile : CompressionProfile{};
+
+				std::optional<std::span<const Nz::UInt8>> compressedData;
+				if (data.snapshot)
+					compressedData = data.snapshot->GetCompressedContent(profile, useFrame);
+				else if (useFrame)
+					compressedData = binaryCompressor.CompressFrame(profile, data.content.data(), bufferSize);
+				else
+					compressedData = binaryCompressor.Compress(data.content.data(), bufferSize);
+
 				if (!compressedData)
 					throw std::runtime_error("failed to compress chunk");
 
-				std::span<Nz::UInt8>& buffer = *compressedData;
+				std::span<const Nz::UInt8>& buffer = *compressedData;
 
 				CompressedUnsigned<Nz::UInt32> compressedSize(Nz::SafeCast<Nz::UInt32>(buffer.size()));
 				serializer &= compressedSize;
@@ -202,7 +330,12 @@ namespace tsom
 				Nz::Stream* stream = serializer.GetByteStream().GetStream();
 				const char* srcData = static_cast<const char*>(stream->GetMappedPointer()) + stream->GetCursorPos();
 
-				std::optional<std::size_t> decompressedSize = binaryCompressor.Decompress(srcData, compressedSize, data.content.data(), bufferSize);
+				std::optional<std::size_t> decompressedSize;
+				if (useFrame)
+					decompressedSize = binaryCompressor.DecompressFrame(srcData, compressedSize, data.content.data(), bufferSize, (compressionProfile) ? compressionProfile->dictionary.get() : nullptr);
+				else
+					decompressedSize = binaryCompressor.Decompress(srcData, compressedSize, data.content.data(), bufferSize);
+
 				if (!decompressedSize)
 					throw std::runtime_error("failed to decompress chunk");
 
@@ -211,17 +344,77 @@ namespace tsom
 			}
 		}
 
+		void Serialize(PacketSerializer& serializer, ChunkResetRequest& data)
+		{
+			serializer &= data.chunkId;
+		}
+
 		void Serialize(PacketSerializer& serializer, ChunkUpdate& data)
 		{
 			serializer &= data.tickIndex;
 			serializer &= data.entityId;
 			serializer &= data.chunkId;
 
-			serializer.SerializeArraySize(data.updates);
-			for (auto& update : data.updates)
+			if (serializer.GetProtocolVersion() < Constants::ProtocolChunkUpdateRunsVersion)
+			{
+				serializer.SerializeArraySize(data.updates);
+				for (auto& update : data.updates)
+				{
+					Helper::Serialize(serializer, update.voxelLoc);
+					serializer &= update.newContent;
+				}
+
+				return;
+			}
+
+			// Consecutive blocks along the X axis are sent as runs, sharing their location and (if uniform) their content
+			if (serializer.IsWriting())
 			{
-				Helper::Serialize(serializer, update.voxelLoc);
-				serializer &= update.newContent;
+				std::vector<ChunkUpdate::BlockRun> runs;
+				BuildChunkUpdateRuns(data.updates, runs);
+
+				serializer &= CompressedUnsigned<Nz::UInt32>(Nz::SafeCast<Nz::UInt32>(runs.size()));
+				for (const ChunkUpdate::BlockRun& run : runs)
+				{
+					Helper::Serialize(serializer, data.updates[run.firstUpdate].voxelLoc);
+					serializer &= GetBlockRunHeader(run);
+
+					std::size_t blockCount = (run.isUniform) ? 1 : run.length;
+					for (std::size_t i = 0; i < blockCount; ++i)
+						serializer &= CompressedUnsigned<BlockIndex>(data.updates[run.firstUpdate + i].newContent);
+				}
+			}
+			else
+			{
+				CompressedUnsigned<Nz::UInt32> runCount;
+				serializer &= runCount;
+
+				data.updates.clear();
+				for (Nz::UInt32 i = 0; i < runCount; ++i)
+				{
+					Helper::VoxelLocation voxelLoc;
+					Helper::Serialize(serializer, voxelLoc);
+
+					CompressedUnsigned<Nz::UInt32> runHeader;
+					serializer &= runHeader;
+
+					bool isUniform = (runHeader & 1) != 0;
+					Nz::UInt32 runLength = (runHeader >> 1) + 1;
+					if (voxelLoc.x + runLength > 0x100)
+						throw std::runtime_error(fmt::format("malformed packet (block run exceeds chunk size: {0} + {1})", voxelLoc.x, runLength));
+
+					CompressedUnsigned<BlockIndex> blockContent;
+					for (Nz::UInt32 j = 0; j < runLength; ++j)
+					{
+						if (j == 0 || !isUniform)
+							serializer &= blockContent;
+
+						data.updates.push_back({
+							Helper::VoxelLocation{ Nz::SafeCast<Nz::UInt8>(voxelLoc.x + j), voxelLoc.y, voxelLoc.z },
+							blockContent
+						});
+					}
+				}
 			}
 		}
 
@@ -310,8 +503,25 @@ namespace tsom
 		{
 			serializer &= data.tickIndex;
 			serializer &= data.entity;
-			serializer &= data.propertyIndex;
-			serializer &= data.propertyValue;
+
+			if (serializer.GetProtocolVersion() < Constants::ProtocolBatchedPropertyUpdateVersion)
+			{
+				// Older versions only had one property per packet
+				if (!serializer.IsWriting())
+					data.properties.resize(1);
+
+				assert(data.properties.size() == 1);
+				serializer &= data.properties.front().propertyIndex;
+				serializer &= data.properties.front().propertyValue;
+				return;
+			}
+
+			serializer.SerializeArraySize(data.properties);
+			for (auto& property : data.properties)
+			{
+				serializer &= property.propertyIndex;
+				serializer &= property.propertyValue;
+			}
 		}
 
 		void Serialize(PacketSerializer& serializer, EnvironmentCreate& data)
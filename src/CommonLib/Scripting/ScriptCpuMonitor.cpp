@@ -0,0 +1,208 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace tsom
+{
+	namespace
+	{
+		// Only its address matters, used as the registry key of the monitor
+		constexpr char s_registryKey = 0;
+	}
+
+	ScriptCpuMonitor::ScriptCpuMonitor(lua_State* L) :
+	m_state(L),
+	m_lastTickTime(Nz::Time::Zero()),
+	m_tickTime(Nz::Time::Zero()),
+	m_instructionCount(0),
+	m_hookInterval(0)
+	{
+		lua_pushlightuserdata(m_state, this);
+		lua_rawsetp(m_state, LUA_REGISTRYINDEX, &s_registryKey);
+	}
+
+	ScriptCpuMonitor::~ScriptCpuMonitor()
+	{
+		lua_pushnil(m_state);
+		lua_rawsetp(m_state, LUA_REGISTRYINDEX, &s_registryKey);
+	}
+
+	ScriptCpuStats& ScriptCpuMonitor::GetOrCreateClassStats(std::string_view className)
+	{
+		// std::map nodes are stable, entities keep a pointer to their class stats
+		auto it = m_classStats.find(className);
+		if (it == m_classStats.end())
+			it = m_classStats.emplace(std::string(className), ScriptCpuStats{}).first;
+
+		return it->second;
+	}
+
+	void ScriptCpuMonitor::ResetStats()
+	{
+		// Don't erase entries as entities reference them
+		for (auto&& [className, stats] : m_classStats)
+			stats = ScriptCpuStats{};
+	}
+
+	ScriptCpuMonitor& ScriptCpuMonitor::Retrieve(lua_State* L)
+	{
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &s_registryKey);
+		ScriptCpuMonitor* monitor = static_cast<ScriptCpuMonitor*>(lua_touserdata(L, -1));
+		lua_pop(L, 1);
+
+		assert(monitor);
+		return *monitor;
+	}
+
+	void ScriptCpuMonitor::BeginCall(lua_State* L, ScriptCpuStats* classStats, ScriptCpuStats* entityStats)
+	{
+		Nz::Time now = Nz::GetElapsedNanoseconds();
+
+		CallFrame frame;
+		frame.classStats = classStats;
+		frame.entityStats = entityStats;
+		frame.abortReason = AbortReason::None;
+		frame.childTime = Nz::Time::Zero();
+		frame.childInstructionCount = 0;
+		frame.startTime = now;
+		frame.startInstructionCount = m_instructionCount;
+
+		frame.deadline = Nz::Time::Nanoseconds(std::numeric_limits<Nz::Int64>::max());
+		frame.deadlineReason = AbortReason::None;
+		if (m_budget.callTime > Nz::Time::Zero())
+		{
+			frame.deadline = now + m_budget.callTime;
+			frame.deadlineReason = AbortReason::CallTime;
+		}
+
+		if (m_budget.tickTime > Nz::Time::Zero())
+		{
+			Nz::Time tickDeadline = now + std::max(m_budget.tickTime - m_tickTime, Nz::Time::Zero());
+			if (tickDeadline < frame.deadline)
+			{
+				frame.deadline = tickDeadline;
+				frame.deadlineReason = AbortReason::TickTime;
+			}
+		}
+
+		frame.instructionLimit = std::numeric_limits<Nz::UInt64>::max();
+		if (m_budget.callInstructions > 0)
+			frame.instructionLimit = m_instructionCount + m_budget.callInstructions;
+
+		if (!m_callFrames.empty())
+		{
+			// Nested calls (such as property update callbacks triggered by a script) can't extend the budget of their caller
+			const CallFrame& parentFrame = m_callFrames.back();
+			if (parentFrame.deadline < frame.deadline)
+			{
+				frame.deadline = parentFrame.deadline;
+				frame.deadlineReason = parentFrame.deadlineReason;
+			}
+
+			frame.instructionLimit = std::min(frame.instructionLimit, parentFrame.instructionLimit);
+		}
+		else
+			SetHookInterval(L, HookInstructionInterval);
+
+		m_callFrames.push_back(frame);
+	}
+
+	void ScriptCpuMonitor::EndCall(lua_State* L)
+	{
+		assert(!m_callFrames.empty());
+		CallFrame frame = m_callFrames.back();
+		m_callFrames.pop_back();
+
+		Nz::Time callTime = Nz::GetElapsedNanoseconds() - frame.startTime;
+		Nz::UInt64 instructionCount = m_instructionCount - frame.startInstructionCount;
+
+		// Nested calls are accounted to their own class and entity, only keep what was spent in this one
+		Nz::Time selfTime = callTime - frame.childTime;
+		Nz::UInt64 selfInstructionCount = instructionCount - frame.childInstructionCount;
+
+		for (ScriptCpuStats* stats : { frame.classStats, frame.entityStats })
+		{
+			if (!stats)
+				continue;
+
+			stats->callCount++;
+			stats->instructionCount += selfInstructionCount;
+			stats->maxCallTime = std::max(stats->maxCallTime, callTime);
+			stats->totalTime += selfTime;
+
+			if (frame.abortReason != AbortReason::None)
+				stats->abortCount++;
+		}
+
+		if (!m_callFrames.empty())
+		{
+			CallFrame& parentFrame = m_callFrames.back();
+			parentFrame.childTime += callTime;
+			parentFrame.childInstructionCount += instructionCount;
+
+			if (parentFrame.abortReason == AbortReason::None && m_hookInterval != HookInstructionInterval)
+				SetHookInterval(L, HookInstructionInterval);
+		}
+		else
+		{
+			m_tickTime += callTime;
+
+			lua_sethook(L, nullptr, 0, 0);
+			m_hookInterval = 0;
+		}
+	}
+
+	void ScriptCpuMonitor::SetHookInterval(lua_State* L, int instructionInterval)
+	{
+		lua_sethook(L, &ScriptCpuMonitor::HookCallback, LUA_MASKCOUNT, instructionInterval);
+		m_hookInterval = instructionInterval;
+	}
+
+	void ScriptCpuMonitor::HookCallback(lua_State* L, lua_Debug* /*ar*/)
+	{
+		ScriptCpuMonitor& monitor = Retrieve(L);
+		if (monitor.m_callFrames.empty())
+			return;
+
+		monitor.m_instructionCount += monitor.m_hookInterval;
+
+		CallFrame& frame = monitor.m_callFrames.back();
+		if (frame.abortReason == AbortReason::None)
+		{
+			if (monitor.m_instructionCount >= frame.instructionLimit)
+				frame.abortReason = AbortReason::CallInstructions;
+			else if (Nz::GetElapsedNanoseconds() >= frame.deadline)
+				frame.abortReason = frame.deadlineReason;
+
+			// Raise the error on every instruction from now on, so scripts catching it with pcall can't carry on
+			if (frame.abortReason != AbortReason::None)
+				monitor.SetHookInterval(L, 1);
+		}
+
+		// No C++ object with a destructor must be alive here as luaL_error doesn't return
+		const Budget& budget = monitor.m_budget;
+		switch (frame.abortReason)
+		{
+			case AbortReason::None:
+				break;
+
+			case AbortReason::CallInstructions:
+				luaL_error(L, "script call exceeded its instruction budget (%I instructions)", static_cast<LUAI_UACINT>(budget.callInstructions));
+				break;
+
+			case AbortReason::CallTime:
+				luaL_error(L, "script call exceeded its time budget (%I us)", static_cast<LUAI_UACINT>(budget.callTime.AsMicroseconds()));
+				break;
+
+			case AbortReason::TickTime:
+				luaL_error(L, "script tick time budget exhausted (%I us)", static_cast<LUAI_UACINT>(budget.tickTime.AsMicroseconds()));
+				break;
+		}
+	}
+}
@@ -172,6 +172,7 @@ namespace tsom
 	}
 
 	ScriptingContext::ScriptingContext(Nz::ApplicationBase& app) :
+	m_cpuMonitor(m_state.lua_state()),
 	m_app(app)
 	{
 		m_state.open_libraries();
@@ -10,8 +10,10 @@
 #include <CommonLib/PhysicsConstants.hpp>
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/ScriptedEntityComponent.hpp>
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
 #include <CommonLib/Scripting/ScriptingProperties.hpp>
 #include <CommonLib/Scripting/ScriptingUtils.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/ServerPlayer.hpp>
 #include <Nazara/Core/Components/NodeComponent.hpp>
 #include <Nazara/Physics3D/Collider3D.hpp>
@@ -20,6 +22,8 @@
 #include <fmt/format.h>
 #include <frozen/string.h>
 #include <frozen/unordered_map.h>
+#include <cassert>
+#include <variant>
 
 SOL_BASE_CLASSES(Nz::BoxCollider3D, Nz::Collider3D);
 SOL_BASE_CLASSES(Nz::RigidBody3DComponent, Nz::RigidBody3D);
@@ -33,12 +37,46 @@ namespace tsom
 		struct EntityBuilder
 		{
 			sol::table classMetatable;
+			std::shared_ptr<EntityPropertyHandle::ClassBinding> classBinding = std::make_shared<EntityPropertyHandle::ClassBinding>();
 			std::vector<EntityClass::RemoteProcedureCall> clientRpcs;
 			std::vector<EntityClass::Property> properties;
 			std::vector<sol::protected_function> propertyUpdateCallbacks;
 			EntityClass::Callbacks callbacks;
 		};
 
+		// Scalar properties are pushed as-is, sol pushes the active alternative without creating a registry reference
+		using LuaPropertyValue = std::variant<bool, float, Nz::Int64, std::string_view, sol::object>;
+
+		Nz::UInt32 ResolvePropertyIndex(lua_State* L, const ClassInstanceComponent& classInstance, const sol::stack_object& property)
+		{
+			if (property.get_type() == sol::type::string)
+			{
+				std::string_view propertyName = property.as<std::string_view>();
+
+				Nz::UInt32 propertyIndex = classInstance.FindPropertyIndex(propertyName);
+				if (propertyIndex == EntityClass::InvalidIndex)
+					TriggerLuaArgError(L, 2, fmt::format("invalid property {}", propertyName));
+
+				return propertyIndex;
+			}
+
+			if (!property.is<EntityPropertyHandle>())
+				TriggerLuaArgError(L, 2, "expected a property name or handle");
+
+			const EntityPropertyHandle& propertyHandle = property.as<const EntityPropertyHandle&>();
+
+			// Compare ownership instead of locking the weak pointer, a class freed on reload is never mistaken for a new one at the same address
+			const std::shared_ptr<const EntityClass>& entityClassPtr = classInstance.GetClass();
+			const std::weak_ptr<const EntityClass>& handleClass = propertyHandle.classBinding->entityClass;
+			const EntityClass& entityClass = *entityClassPtr;
+			if (handleClass.owner_before(entityClassPtr) || entityClassPtr.owner_before(handleClass))
+				TriggerLuaArgError(L, 2, fmt::format("property {} doesn't belong to class {}", propertyHandle.name, entityClass.GetName()));
+
+			assert(propertyHandle.index < entityClass.GetPropertyCount());
+
+			return propertyHandle.index;
+		}
+
 		constexpr auto s_components = frozen::make_unordered_map<frozen::string, SharedEntityScriptingLibrary::ComponentEntry>({
 			{
 				"node", SharedEntityScriptingLibrary::ComponentEntry::Default<Nz::NodeComponent>()
@@ -100,6 +138,8 @@ namespace tsom
 
 	void SharedEntityScriptingLibrary::Register(sol::state& state)
 	{
+		m_cpuMonitor = &ScriptCpuMonitor::Retrieve(state.lua_state());
+
 		RegisterConstants(state);
 
 		RegisterComponents(state);
@@ -164,20 +204,28 @@ namespace tsom
 			return getComponent(L, entity);
 		});
 
-		entityMetatable["GetProperty"] = LuaFunction([this](sol::this_state L, sol::table entityTable, std::string_view propertyName)
+		entityMetatable["GetProperty"] = LuaFunction([this](sol::this_state L, sol::table entityTable, sol::stack_object property) -> LuaPropertyValue
 		{
 			entt::handle entity = AssertScriptEntity(entityTable);
 
-			auto& classComponent = entity.get<ClassInstanceComponent>();
-			Nz::UInt32 propertyIndex = classComponent.FindPropertyIndex(propertyName);
-			if (propertyIndex == EntityClass::InvalidIndex)
-				TriggerLuaArgError(L, 2, fmt::format("invalid property {}", propertyName));
+			auto& classInstance = entity.get<ClassInstanceComponent>();
+			Nz::UInt32 propertyIndex = ResolvePropertyIndex(L, classInstance, property);
+
+			const EntityProperty& value = classInstance.GetProperty(propertyIndex);
+			if (const auto* boolValue = std::get_if<EntityPropertySingleValue<EntityPropertyType::Bool>>(&value))
+				return LuaPropertyValue(std::in_place_type<bool>, **boolValue);
+			else if (const auto* floatValue = std::get_if<EntityPropertySingleValue<EntityPropertyType::Float>>(&value))
+				return LuaPropertyValue(std::in_place_type<float>, **floatValue);
+			else if (const auto* integerValue = std::get_if<EntityPropertySingleValue<EntityPropertyType::Integer>>(&value))
+				return LuaPropertyValue(std::in_place_type<Nz::Int64>, **integerValue);
+			else if (const auto* stringValue = std::get_if<EntityPropertySingleValue<EntityPropertyType::String>>(&value))
+				return LuaPropertyValue(std::in_place_type<std::string_view>, **stringValue);
 
 			sol::state_view state(L);
-			return TranslatePropertyToLua(state, classComponent.GetProperty(propertyIndex));
+			return LuaPropertyValue(std::in_place_type<sol::object>, TranslatePropertyToLua(state, value));
 		});
 
-		entityMetatable["UpdateProperty"] = LuaFunction([this](sol::this_state L, sol::table entityTable, std::string_view propertyName, sol::object value)
+		entityMetatable["GetPropertyHandle"] = LuaFunction([this](sol::this_state L, sol::table entityTable, std::string_view propertyName)
 		{
 			entt::handle entity = AssertScriptEntity(entityTable);
 
@@ -186,8 +234,35 @@ namespace tsom
 			if (propertyIndex == EntityClass::InvalidIndex)
 				TriggerLuaArgError(L, 2, fmt::format("invalid property {}", propertyName));
 
-			const auto& property = classInstance.GetClass()->GetProperty(propertyIndex);
-			classInstance.UpdateProperty(propertyIndex, TranslatePropertyFromLua(value, property.type, property.isArray));
+			return EntityPropertyHandle{
+				.classBinding = std::make_shared<EntityPropertyHandle::ClassBinding>(EntityPropertyHandle::ClassBinding{ classInstance.GetClass() }),
+				.name = std::string(propertyName),
+				.index = propertyIndex
+			};
+		});
+
+		entityMetatable["UpdateProperty"] = LuaFunction([this](sol::this_state L, sol::table entityTable, sol::stack_object property, sol::stack_object value)
+		{
+			entt::handle entity = AssertScriptEntity(entityTable);
+
+			auto& classInstance = entity.get<ClassInstanceComponent>();
+			Nz::UInt32 propertyIndex = ResolvePropertyIndex(L, classInstance, property);
+
+			const auto& propertyData = classInstance.GetClass()->GetProperty(propertyIndex);
+			if (!propertyData.isArray)
+			{
+				// Read scalar values straight from the Lua stack
+				switch (propertyData.type)
+				{
+					case EntityPropertyType::Bool:    return classInstance.UpdateProperty<EntityPropertyType::Bool>(propertyIndex, value.as<bool>());
+					case EntityPropertyType::Float:   return classInstance.UpdateProperty<EntityPropertyType::Float>(propertyIndex, value.as<float>());
+					case EntityPropertyType::Integer: return classInstance.UpdateProperty<EntityPropertyType::Integer>(propertyIndex, value.as<Nz::Int64>());
+					case EntityPropertyType::String:  return classInstance.UpdateProperty<EntityPropertyType::String>(propertyIndex, value.as<std::string>());
+					default: break;
+				}
+			}
+
+			classInstance.UpdateProperty(propertyIndex, TranslatePropertyFromLua(sol::object(L, value.stack_index()), propertyData.type, propertyData.isArray));
 		});
 	}
 
@@ -276,6 +351,14 @@ namespace tsom
 
 	void SharedEntityScriptingLibrary::RegisterEntityBuilder(sol::state& state)
 	{
+		state.new_usertype<EntityPropertyHandle>("EntityPropertyHandle",
+			sol::no_constructor,
+			"GetName", LuaFunction([](const EntityPropertyHandle& propertyHandle) -> const std::string&
+			{
+				return propertyHandle.name;
+			})
+		);
+
 		state.new_usertype<EntityBuilder>("EntityBuilder",
 			sol::no_constructor,
 			"AddClientRPC", LuaFunction([](EntityBuilder& entityBuilder, std::string rpcName)
@@ -290,16 +373,35 @@ namespace tsom
 				bool isArray = propertyData.get_or("isArray", false);
 				bool isNetworked = propertyData.get_or("isNetworked", false);
 
+				// Maximum network updates per second, unlimited by default
+				Nz::Time sendInterval = Nz::Time::Zero();
+				if (sol::optional<double> sendRate = propertyData["sendRate"])
+				{
+					if (*sendRate <= 0.0)
+						throw std::runtime_error("sendRate must be positive");
+
+					sendInterval = Nz::Time::Seconds(1.0 / *sendRate);
+				}
+
 				EntityPropertyType propertyType = ParseEntityPropertyType(type);
 				EntityProperty entityProperty = TranslatePropertyFromLua(propertyData["default"], propertyType, isArray);
 
+				EntityPropertyHandle propertyHandle{
+					.classBinding = entityBuilder.classBinding,
+					.name = propertyName,
+					.index = Nz::UInt32(entityBuilder.properties.size())
+				};
+
 				entityBuilder.properties.push_back({
 					.name = std::move(propertyName),
 					.type = propertyType,
 					.defaultValue = std::move(entityProperty),
 					.isArray = isArray,
-					.isNetworked = isNetworked
+					.isNetworked = isNetworked,
+					.sendInterval = sendInterval
 				});
+
+				return propertyHandle;
 			}),
 			"On", LuaFunction([this](sol::this_state L, EntityBuilder& entityBuilder, std::string_view eventName, sol::protected_function callback)
 			{
@@ -317,11 +419,11 @@ namespace tsom
 				if (rpcIt == entityBuilder.clientRpcs.end())
 					TriggerLuaError(L, fmt::format("unknown client rpc {}", eventName));
 
-				rpcIt->onCalled = [cb = std::move(callback), en = std::move(eventName)](entt::handle entity)
+				rpcIt->onCalled = [this, cb = std::move(callback), en = std::move(eventName)](entt::handle entity)
 				{
 					auto& entityScripted = entity.get<ScriptedEntityComponent>();
 
-					auto res = cb(entityScripted.entityTable);
+					auto res = m_cpuMonitor->Call(cb, entityScripted.classCpuStats, &entityScripted.cpuStats, entityScripted.entityTable);
 					if (!res.valid())
 					{
 						sol::error err = res;
@@ -380,11 +482,14 @@ namespace tsom
 		{
 			sol::state_view state(L);
 
+			// Entries are never removed from the monitor, so this stays valid across script reloads
+			ScriptCpuStats* classCpuStats = &m_cpuMonitor->GetOrCreateClassStats(name);
+
 			std::shared_ptr sharedCallbacks = std::make_shared<std::vector<sol::protected_function>>(std::move(entityBuilder.propertyUpdateCallbacks));
-			entityBuilder.callbacks.onInit = [this, state, metatable = std::move(entityBuilder.classMetatable), sharedCallbacks](entt::handle entity) mutable
+			entityBuilder.callbacks.onInit = [this, state, metatable = std::move(entityBuilder.classMetatable), sharedCallbacks, classCpuStats](entt::handle entity) mutable
 			{
 				auto& entityInstance = entity.get<ClassInstanceComponent>();
-				entityInstance.OnPropertyUpdate.Connect([entity, sharedCallbacks, state](ClassInstanceComponent* classInstance, Nz::UInt32 propertyIndex, const EntityProperty& newValue) mutable
+				entityInstance.OnPropertyUpdate.Connect([this, entity, sharedCallbacks, state](ClassInstanceComponent* classInstance, Nz::UInt32 propertyIndex, const EntityProperty& newValue) mutable
 				{
 					auto& callbacks = (*sharedCallbacks);
 					if (propertyIndex >= callbacks.size() || !callbacks[propertyIndex])
@@ -392,7 +497,8 @@ namespace tsom
 
 					auto& entityScripted = entity.get<ScriptedEntityComponent>();
 
-					auto res = callbacks[propertyIndex](entityScripted.entityTable, TranslatePropertyToLua(state, newValue));
+					TickProfiler::Zone profileZone("Script property update callback");
+					auto res = m_cpuMonitor->Call(callbacks[propertyIndex], entityScripted.classCpuStats, &entityScripted.cpuStats, entityScripted.entityTable, TranslatePropertyToLua(state, newValue));
 					if (!res.valid())
 					{
 						const auto& propertyData = classInstance->GetClass()->GetProperty(propertyIndex);
@@ -407,13 +513,15 @@ namespace tsom
 				entityScripted.entityTable = state.create_table();
 				entityScripted.entityTable[sol::metatable_key] = entityScripted.classMetatable;
 				entityScripted.entityTable["_Entity"] = entity;
+				entityScripted.classCpuStats = classCpuStats;
 
 				HandleInit(entityScripted.classMetatable, entity);
 
 				sol::optional<sol::protected_function> initCallback = entityScripted.classMetatable["_Init"];
 				if (initCallback)
 				{
-					auto res = (*initCallback)(entityScripted.entityTable);
+					TickProfiler::Zone profileZone("Script init callback");
+					auto res = m_cpuMonitor->Call(*initCallback, entityScripted.classCpuStats, &entityScripted.cpuStats, entityScripted.entityTable);
 					if (!res.valid())
 					{
 						sol::error err = res;
@@ -422,7 +530,11 @@ namespace tsom
 				}
 			};
 
+			std::string className = name;
 			m_entityRegistry.RegisterClass(EntityClass{ std::move(name), std::move(entityBuilder.properties), std::move(entityBuilder.callbacks), std::move(entityBuilder.clientRpcs) });
+
+			// Handles returned by AddProperty can only be used once the class exists
+			entityBuilder.classBinding->entityClass = m_entityRegistry.FindClass(className);
 		});
 	}
 
@@ -11,6 +11,11 @@ namespace tsom
 {
 	SessionHandler::~SessionHandler() = default;
 
+	const CompressionProfile& SessionHandler::GetCompressionProfile() const
+	{
+		return m_session->GetCompressionProfile();
+	}
+
 	Nz::UInt32 SessionHandler::GetProtocolVersion() const
 	{
 		return m_session->GetProtocolVersion();
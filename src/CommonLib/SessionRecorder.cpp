@@ -0,0 +1,78 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/SessionRecorder.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <NazaraUtils/Algorithm.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace tsom
+{
+	SessionRecorder::SessionRecorder(const std::filesystem::path& filePath, const Header& header) :
+	m_filePath(filePath),
+	m_stream(&m_buffer, Nz::OpenMode::Write),
+	m_startTime(Nz::GetElapsedNanoseconds())
+	{
+		if (std::filesystem::path directory = m_filePath.parent_path(); !directory.empty())
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(directory, ec);
+		}
+
+		if (!m_file.Open(m_filePath, Nz::OpenMode::Write | Nz::OpenMode::Truncate))
+			throw std::runtime_error(fmt::format("failed to open {0}", Nz::PathToString(m_filePath)));
+
+		m_stream << FileMagic << FileVersion;
+		m_stream << header.seed << header.saveDirectory;
+
+		Flush();
+	}
+
+	SessionRecorder::~SessionRecorder()
+	{
+		Flush();
+	}
+
+	void SessionRecorder::BeginFrame(Nz::Time elapsedTime, Nz::UInt16 tickIndex)
+	{
+		// Packets are only written to the file between frames so a crashed server leaves a replayable recording
+		if (m_stream.GetStream()->GetCursorPos() >= FlushThreshold)
+			Flush();
+
+		Nz::Time timestamp = Nz::GetElapsedNanoseconds() - m_startTime;
+
+		m_stream << Nz::UInt8(SessionRecordType::Frame);
+		m_stream << Nz::UInt64(timestamp.AsMicroseconds()) << Nz::UInt64(elapsedTime.AsMicroseconds()) << tickIndex;
+	}
+
+	void SessionRecorder::Flush()
+	{
+		Nz::UInt64 size = m_stream.GetStream()->GetCursorPos();
+		if (size == 0)
+			return;
+
+		m_file.Write(m_buffer.GetConstBuffer(), size);
+		m_file.Flush();
+
+		m_stream.GetStream()->SetCursorPos(0);
+	}
+
+	void SessionRecorder::RecordConnection(std::size_t peerIndex)
+	{
+		m_stream << Nz::UInt8(SessionRecordType::Connection) << Nz::SafeCast<Nz::UInt16>(peerIndex);
+	}
+
+	void SessionRecorder::RecordDisconnection(std::size_t peerIndex, bool timeout)
+	{
+		m_stream << Nz::UInt8(SessionRecordType::Disconnection) << Nz::SafeCast<Nz::UInt16>(peerIndex) << Nz::UInt8((timeout) ? 1 : 0);
+	}
+
+	void SessionRecorder::RecordPacket(std::size_t peerIndex, const Nz::ByteArray& payload)
+	{
+		m_stream << Nz::UInt8(SessionRecordType::Packet) << Nz::SafeCast<Nz::UInt16>(peerIndex) << Nz::SafeCast<Nz::UInt32>(payload.GetSize());
+		m_stream.Write(payload.GetConstBuffer(), payload.GetSize());
+	}
+}
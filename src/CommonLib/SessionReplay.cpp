@@ -0,0 +1,142 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/SessionReplay.hpp>
+#include <CommonLib/NetworkSessionManager.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/ErrorFlags.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Network/IpAddress.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <fmt/color.h>
+#include <fmt/format.h>
+#include <cassert>
+#include <optional>
+#include <stdexcept>
+
+namespace tsom
+{
+	SessionReplay::SessionReplay(const std::filesystem::path& filePath)
+	{
+		std::optional<std::vector<Nz::UInt8>> fileContent = Nz::File::ReadWhole(filePath);
+		if (!fileContent)
+			throw std::runtime_error(fmt::format("failed to read {0}", Nz::PathToString(filePath)));
+
+		Nz::ByteStream byteStream(fileContent->data(), fileContent->size());
+
+		Nz::ErrorFlags errFlags(Nz::ErrorMode::Silent | Nz::ErrorMode::ThrowException);
+
+		try
+		{
+			Nz::UInt32 magic, version;
+			byteStream >> magic >> version;
+			if (magic != SessionRecorder::FileMagic)
+				throw std::runtime_error("not a session recording");
+
+			if (version != SessionRecorder::FileVersion)
+				throw std::runtime_error(fmt::format("unsupported recording version {0}", version));
+
+			byteStream >> m_header.seed >> m_header.saveDirectory;
+		}
+		catch (const std::exception& e)
+		{
+			throw std::runtime_error(fmt::format("failed to load {0}: {1}", Nz::PathToString(filePath), e.what()));
+		}
+
+		// A recording may be truncated if the server stopped unexpectedly, keep every complete event
+		try
+		{
+			while (!byteStream.EndOfStream())
+			{
+				Nz::UInt8 recordType;
+				byteStream >> recordType;
+
+				switch (SessionRecordType(recordType))
+				{
+					case SessionRecordType::Frame:
+					{
+						Nz::UInt64 timestamp, elapsedTime;
+						Nz::UInt16 tickIndex;
+						byteStream >> timestamp >> elapsedTime >> tickIndex;
+
+						Frame& frame = m_frames.emplace_back();
+						frame.elapsedTime = Nz::Time::Microseconds(static_cast<Nz::Int64>(elapsedTime));
+						frame.timestamp = Nz::Time::Microseconds(static_cast<Nz::Int64>(timestamp));
+						frame.tickIndex = tickIndex;
+						break;
+					}
+
+					case SessionRecordType::Connection:
+					case SessionRecordType::Disconnection:
+					case SessionRecordType::Packet:
+					{
+						Event event;
+						event.type = SessionRecordType(recordType);
+
+						Nz::UInt16 peerIndex;
+						byteStream >> peerIndex;
+						event.peerIndex = peerIndex;
+
+						if (event.type == SessionRecordType::Disconnection)
+						{
+							Nz::UInt8 timeout;
+							byteStream >> timeout;
+
+							event.timeout = (timeout != 0);
+						}
+						else if (event.type == SessionRecordType::Packet)
+						{
+							Nz::UInt32 payloadSize;
+							byteStream >> payloadSize;
+
+							event.payload.Resize(payloadSize);
+							if (byteStream.Read(event.payload.GetBuffer(), payloadSize) != payloadSize)
+								throw std::runtime_error("truncated packet");
+						}
+
+						// Events recorded outside of a frame are replayed before the first one
+						if (m_frames.empty())
+							m_frames.emplace_back();
+
+						m_frames.back().events.push_back(std::move(event));
+						break;
+					}
+
+					default:
+						throw std::runtime_error(fmt::format("unknown record type {0}", recordType));
+				}
+			}
+		}
+		catch (const std::exception& e)
+		{
+			fmt::print(fg(fmt::color::yellow), "{0} is truncated or corrupted ({1}), replaying {2} frames\n", Nz::PathToString(filePath), e.what(), m_frames.size());
+		}
+	}
+
+	void SessionReplay::InjectFrame(std::size_t frameIndex, NetworkSessionManager& sessionManager) const
+	{
+		const Frame& frame = GetFrame(frameIndex);
+		for (const Event& event : frame.events)
+		{
+			switch (event.type)
+			{
+				case SessionRecordType::Connection:
+					sessionManager.HandleConnection(event.peerIndex, Nz::IpAddress::LoopbackIpV4);
+					break;
+
+				case SessionRecordType::Disconnection:
+					sessionManager.HandleDisconnection(event.peerIndex, event.timeout);
+					break;
+
+				case SessionRecordType::Packet:
+					sessionManager.HandlePacket(event.peerIndex, Nz::ByteArray(event.payload));
+					break;
+
+				case SessionRecordType::Frame:
+					assert(!"unexpected frame event");
+					break;
+			}
+		}
+	}
+}
@@ -9,9 +9,35 @@
 #include <Nazara/Physics3D/Collider3D.hpp>
 #include <fmt/format.h>
 #include <random>
+#include <vector>
 
 namespace tsom
 {
+	namespace
+	{
+		// Neighbor chunks touched by an update spanning the [minIndices, maxIndices] region
+		DirectionMask ComputeNeighborMask(const Chunk& chunk, const Nz::Vector3ui& minIndices, const Nz::Vector3ui& maxIndices)
+		{
+			DirectionMask neighborMask;
+			if (minIndices.x == 0)
+				neighborMask |= Direction::Left;
+			if (maxIndices.x == chunk.GetSize().x - 1)
+				neighborMask |= Direction::Right;
+
+			if (minIndices.y == 0)
+				neighborMask |= Direction::Front;
+			if (maxIndices.y == chunk.GetSize().y - 1)
+				neighborMask |= Direction::Back;
+
+			if (minIndices.z == 0)
+				neighborMask |= Direction::Up;
+			if (maxIndices.z == chunk.GetSize().z - 1)
+				neighborMask |= Direction::Down;
+
+			return neighborMask;
+		}
+	}
+
 	Ship::Ship(float tileSize) :
 	ChunkContainer(tileSize),
 	m_upDirection(Nz::Vector3f::Up())
@@ -34,23 +60,12 @@ namespace tsom
 
 		chunkData.onUpdated.Connect(chunkData.chunk->OnBlockUpdated, [this](Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex /*newBlock*/)
 		{
-			DirectionMask neighborMask;
-			if (indices.x == 0)
-				neighborMask |= Direction::Left;
-			else if (indices.x == chunk->GetSize().x - 1)
-				neighborMask |= Direction::Right;
-
-			if (indices.y == 0)
-				neighborMask |= Direction::Front;
-			else if (indices.y == chunk->GetSize().y - 1)
-				neighborMask |= Direction::Back;
-
-			if (indices.z == 0)
-				neighborMask |= Direction::Up;
-			else if (indices.z == chunk->GetSize().z - 1)
-				neighborMask |= Direction::Down;
+			OnChunkUpdated(this, chunk, ComputeNeighborMask(*chunk, indices, indices));
+		});
 
-			OnChunkUpdated(this, chunk, neighborMask);
+		chunkData.onBlocksUpdated.Connect(chunkData.chunk->OnBlocksUpdated, [this](Chunk* chunk, const Nz::Bitset<Nz::UInt64>& /*updatedBlocks*/, const Nz::Vector3ui& minIndices, const Nz::Vector3ui& maxIndices)
+		{
+			OnChunkUpdated(this, chunk, ComputeNeighborMask(*chunk, minIndices, maxIndices));
 		});
 
 		auto it = m_chunks.insert_or_assign(indices, std::move(chunkData)).first;
@@ -125,9 +140,7 @@ namespace tsom
 		unsigned int height = (small) ? 4 : 6;
 		Nz::Vector3ui startPos = chunk.GetSize() / 2 - Nz::Vector3ui(boxSize / 2, boxSize / 2, height / 2);
 
-		chunk.LockWrite();
-		chunk.Reset();
-
+		std::vector<Chunk::BlockUpdate> blockUpdates;
 		for (unsigned int z = 0; z < height; ++z)
 		{
 			for (unsigned int y = 0; y < boxSize; ++y)
@@ -140,13 +153,16 @@ namespace tsom
 						continue;
 
 					if (x == 0 && y == boxSize / 2 && z > 0 && z < height - 1)
-						chunk.UpdateBlock(startPos + Nz::Vector3ui{ x, y, z }, forcefieldIndex);
+						blockUpdates.push_back({ startPos + Nz::Vector3ui{ x, y, z }, forcefieldIndex });
 					else
-						chunk.UpdateBlock(startPos + Nz::Vector3ui{ x, y, z }, hullIndex);
+						blockUpdates.push_back({ startPos + Nz::Vector3ui{ x, y, z }, hullIndex });
 				}
 			}
 		}
 
+		chunk.LockWrite();
+		chunk.Reset();
+		chunk.UpdateBlocks(blockUpdates);
 		chunk.UnlockWrite();
 	}
 
@@ -5,6 +5,7 @@
 #include <CommonLib/Systems/GravityPhysicsSystem.hpp>
 #include <CommonLib/GravityController.hpp>
 #include <CommonLib/Components/PlanetComponent.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <Nazara/Core/Components/DisabledComponent.hpp>
 #include <Nazara/Physics3D/PhysWorld3D.hpp>
 #include <Nazara/Physics3D/Components/RigidBody3DComponent.hpp>
@@ -27,6 +28,8 @@ namespace tsom
 
 	void GravityPhysicsSystem::PreSimulate(float /*elapsedTime*/)
 	{
+		TickProfiler::Zone profileZone("GravityPhysicsSystem::PreSimulate");
+
 		auto view = m_registry.view<Nz::RigidBody3DComponent>(entt::exclude<Nz::DisabledComponent>);
 		for (auto&& [entity, rigidBody] : view.each())
 		{
@@ -4,6 +4,7 @@
 
 #include <CommonLib/Systems/PlanetSystem.hpp>
 #include <CommonLib/Components/PlanetComponent.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <Nazara/Core/Components/DisabledComponent.hpp>
 #include <entt/entt.hpp>
 
@@ -11,6 +12,8 @@ namespace tsom
 {
 	void PlanetSystem::Update(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("PlanetSystem::Update");
+
 		auto view = m_registry.view<PlanetComponent>(entt::exclude<Nz::DisabledComponent>);
 		for (entt::entity entity : view)
 		{
@@ -4,6 +4,7 @@
 
 #include <CommonLib/Systems/ShipSystem.hpp>
 #include <CommonLib/Components/ShipComponent.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <Nazara/Core/Components/DisabledComponent.hpp>
 #include <entt/entt.hpp>
 
@@ -11,6 +12,8 @@ namespace tsom
 {
 	void ShipSystem::Update(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("ShipSystem::Update");
+
 		auto view = m_registry.view<ShipComponent>(entt::exclude<Nz::DisabledComponent>);
 		for (entt::entity entity : view)
 		{
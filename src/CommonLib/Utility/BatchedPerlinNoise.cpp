@@ -0,0 +1,374 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/BatchedPerlinNoise.hpp>
+#include <NazaraUtils/Assert.hpp>
+#include <PerlinNoise.hpp>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TSOM_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define TSOM_NOISE_AVX2
+#include <immintrin.h>
+#endif
+
+// Results have to be identical whatever the instruction set, prevent the compiler from fusing multiplications and additions
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace tsom
+{
+	namespace
+	{
+		// Perlin gradients expressed as coefficients, to compute them with multiplications instead of branches
+		// (this gives the same results as siv::PerlinNoise as every coefficient is -1, 0 or 1)
+		struct GradientCoefficients
+		{
+			double x;
+			double y;
+			double z;
+		};
+
+		constexpr std::array<GradientCoefficients, 16> s_gradients = {
+			GradientCoefficients{  1.0,  1.0,  0.0 }, //< 0: x + y
+			GradientCoefficients{ -1.0,  1.0,  0.0 }, //< 1: -x + y
+			GradientCoefficients{  1.0, -1.0,  0.0 }, //< 2: x - y
+			GradientCoefficients{ -1.0, -1.0,  0.0 }, //< 3: -x - y
+			GradientCoefficients{  1.0,  0.0,  1.0 }, //< 4: x + z
+			GradientCoefficients{ -1.0,  0.0,  1.0 }, //< 5: -x + z
+			GradientCoefficients{  1.0,  0.0, -1.0 }, //< 6: x - z
+			GradientCoefficients{ -1.0,  0.0, -1.0 }, //< 7: -x - z
+			GradientCoefficients{  0.0,  1.0,  1.0 }, //< 8: y + z
+			GradientCoefficients{  0.0, -1.0,  1.0 }, //< 9: -y + z
+			GradientCoefficients{  0.0,  1.0, -1.0 }, //< 10: y - z
+			GradientCoefficients{  0.0, -1.0, -1.0 }, //< 11: -y - z
+			GradientCoefficients{  1.0,  1.0,  0.0 }, //< 12: y + x
+			GradientCoefficients{  0.0, -1.0,  1.0 }, //< 13: -y + z
+			GradientCoefficients{ -1.0,  1.0,  0.0 }, //< 14: y - x
+			GradientCoefficients{  0.0, -1.0, -1.0 }, //< 15: -y - z
+		};
+
+		struct ScalarOps
+		{
+			using Vec = double;
+			static constexpr std::size_t Width = 1;
+
+			static Vec Add(Vec a, Vec b) { return a + b; }
+			static Vec Div(Vec a, Vec b) { return a / b; }
+			static Vec Floor(Vec v) { return std::floor(v); }
+			static Vec Load(const double* ptr) { return *ptr; }
+			static Vec Mul(Vec a, Vec b) { return a * b; }
+			static Vec Set1(double value) { return value; }
+			static void Store(double* ptr, Vec v) { *ptr = v; }
+			static void StoreInt(Nz::Int32* ptr, Vec v) { *ptr = static_cast<Nz::Int32>(v); }
+			static Vec Sub(Vec a, Vec b) { return a - b; }
+
+			static Vec RemapClamp01(Vec v)
+			{
+				if (v <= -1.0)
+					return 0.0;
+				else if (1.0 <= v)
+					return 1.0;
+
+				return v * 0.5 + 0.5;
+			}
+		};
+
+#ifdef TSOM_NOISE_SSE2
+		struct SSE2Ops
+		{
+			using Vec = __m128d;
+			static constexpr std::size_t Width = 2;
+
+			static Vec Add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+			static Vec Div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+			static Vec Load(const double* ptr) { return _mm_loadu_pd(ptr); }
+			static Vec Mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+			static Vec Set1(double value) { return _mm_set1_pd(value); }
+			static void Store(double* ptr, Vec v) { _mm_storeu_pd(ptr, v); }
+			static Vec Sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+
+			static Vec Floor(Vec v)
+			{
+				// SSE2 has no floor instruction, truncate and fix negative values (inputs are way below 2^31)
+				__m128d truncated = _mm_cvtepi32_pd(_mm_cvttpd_epi32(v));
+				__m128d correction = _mm_and_pd(_mm_cmpgt_pd(truncated, v), _mm_set1_pd(1.0));
+				return _mm_sub_pd(truncated, correction);
+			}
+
+			static void StoreInt(Nz::Int32* ptr, Vec v)
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), _mm_cvttpd_epi32(v));
+			}
+
+			static Vec RemapClamp01(Vec v)
+			{
+				__m128d remapped = _mm_add_pd(_mm_mul_pd(v, _mm_set1_pd(0.5)), _mm_set1_pd(0.5));
+
+				__m128d lowMask = _mm_cmple_pd(v, _mm_set1_pd(-1.0));
+				remapped = _mm_andnot_pd(lowMask, remapped); //< 0.0
+
+				__m128d highMask = _mm_cmpge_pd(v, _mm_set1_pd(1.0));
+				return _mm_or_pd(_mm_andnot_pd(highMask, remapped), _mm_and_pd(highMask, _mm_set1_pd(1.0)));
+			}
+		};
+#endif
+
+#ifdef TSOM_NOISE_AVX2
+		struct AVX2Ops
+		{
+			using Vec = __m256d;
+			static constexpr std::size_t Width = 4;
+
+			static Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+			static Vec Div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+			static Vec Floor(Vec v) { return _mm256_floor_pd(v); }
+			static Vec Load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+			static Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+			static Vec Set1(double value) { return _mm256_set1_pd(value); }
+			static void Store(double* ptr, Vec v) { _mm256_storeu_pd(ptr, v); }
+			static void StoreInt(Nz::Int32* ptr, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), _mm256_cvttpd_epi32(v)); }
+			static Vec Sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+
+			static Vec RemapClamp01(Vec v)
+			{
+				__m256d remapped = _mm256_add_pd(_mm256_mul_pd(v, _mm256_set1_pd(0.5)), _mm256_set1_pd(0.5));
+				remapped = _mm256_blendv_pd(remapped, _mm256_setzero_pd(), _mm256_cmp_pd(v, _mm256_set1_pd(-1.0), _CMP_LE_OQ));
+				return _mm256_blendv_pd(remapped, _mm256_set1_pd(1.0), _mm256_cmp_pd(v, _mm256_set1_pd(1.0), _CMP_GE_OQ));
+			}
+		};
+#endif
+
+		template<typename Ops>
+		struct NoiseKernel
+		{
+			using Vec = typename Ops::Vec;
+			static constexpr std::size_t Width = Ops::Width;
+
+			static Vec Fade(Vec t)
+			{
+				// t * t * t * (t * (t * 6 - 15) + 10)
+				Vec t3 = Ops::Mul(Ops::Mul(t, t), t);
+				return Ops::Mul(t3, Ops::Add(Ops::Mul(t, Ops::Sub(Ops::Mul(t, Ops::Set1(6.0)), Ops::Set1(15.0))), Ops::Set1(10.0)));
+			}
+
+			static Vec Lerp(Vec a, Vec b, Vec t)
+			{
+				return Ops::Add(a, Ops::Mul(Ops::Sub(b, a), t));
+			}
+
+			static Vec Grad(const double (&coefficients)[3][Width], Vec x, Vec y, Vec z)
+			{
+				Vec gradX = Ops::Mul(Ops::Load(coefficients[0]), x);
+				Vec gradY = Ops::Mul(Ops::Load(coefficients[1]), y);
+				Vec gradZ = Ops::Mul(Ops::Load(coefficients[2]), z);
+				return Ops::Add(Ops::Add(gradX, gradY), gradZ);
+			}
+
+			static void Evaluate(const BatchedPerlinNoise::Permutation& p, const double* xInput, const double* yInput, double* output, Nz::Int32 octaves, double persistence, double maxAmplitude)
+			{
+				// z is constant for 2D noise
+				const double flooredZ = std::floor(BatchedPerlinNoise::DefaultZ);
+				const int iz = static_cast<Nz::Int32>(flooredZ) & 255;
+				const Vec fz = Ops::Set1(BatchedPerlinNoise::DefaultZ - flooredZ);
+				const Vec fz1 = Ops::Sub(fz, Ops::Set1(1.0));
+				const Vec w = Fade(fz);
+
+				const Vec one = Ops::Set1(1.0);
+				const Vec two = Ops::Set1(2.0);
+
+				Vec x = Ops::Load(xInput);
+				Vec y = Ops::Load(yInput);
+				Vec result = Ops::Set1(0.0);
+				double amplitude = 1.0;
+
+				for (Nz::Int32 octave = 0; octave < octaves; ++octave)
+				{
+					Vec flooredX = Ops::Floor(x);
+					Vec flooredY = Ops::Floor(y);
+
+					alignas(32) Nz::Int32 ix[Width];
+					alignas(32) Nz::Int32 iy[Width];
+					Ops::StoreInt(ix, flooredX);
+					Ops::StoreInt(iy, flooredY);
+
+					// Permutation lookups are done per lane, gradients are then computed for all lanes at once
+					alignas(32) double gradients[8][3][Width];
+					for (std::size_t lane = 0; lane < Width; ++lane)
+					{
+						int X = ix[lane] & 255;
+						int Y = iy[lane] & 255;
+
+						int A = (p[X] + Y) & 255;
+						int B = (p[(X + 1) & 255] + Y) & 255;
+
+						int AA = (p[A] + iz) & 255;
+						int AB = (p[(A + 1) & 255] + iz) & 255;
+						int BA = (p[B] + iz) & 255;
+						int BB = (p[(B + 1) & 255] + iz) & 255;
+
+						std::array<int, 8> hashes = {
+							p[AA], p[BA], p[AB], p[BB],
+							p[(AA + 1) & 255], p[(BA + 1) & 255], p[(AB + 1) & 255], p[(BB + 1) & 255]
+						};
+
+						for (std::size_t corner = 0; corner < hashes.size(); ++corner)
+						{
+							const GradientCoefficients& gradient = s_gradients[hashes[corner] & 15];
+							gradients[corner][0][lane] = gradient.x;
+							gradients[corner][1][lane] = gradient.y;
+							gradients[corner][2][lane] = gradient.z;
+						}
+					}
+
+					Vec fx = Ops::Sub(x, flooredX);
+					Vec fy = Ops::Sub(y, flooredY);
+					Vec fx1 = Ops::Sub(fx, one);
+					Vec fy1 = Ops::Sub(fy, one);
+
+					Vec u = Fade(fx);
+					Vec v = Fade(fy);
+
+					Vec p0 = Grad(gradients[0], fx,  fy,  fz);
+					Vec p1 = Grad(gradients[1], fx1, fy,  fz);
+					Vec p2 = Grad(gradients[2], fx,  fy1, fz);
+					Vec p3 = Grad(gradients[3], fx1, fy1, fz);
+					Vec p4 = Grad(gradients[4], fx,  fy,  fz1);
+					Vec p5 = Grad(gradients[5], fx1, fy,  fz1);
+					Vec p6 = Grad(gradients[6], fx,  fy1, fz1);
+					Vec p7 = Grad(gradients[7], fx1, fy1, fz1);
+
+					Vec q0 = Lerp(p0, p1, u);
+					Vec q1 = Lerp(p2, p3, u);
+					Vec q2 = Lerp(p4, p5, u);
+					Vec q3 = Lerp(p6, p7, u);
+
+					Vec r0 = Lerp(q0, q1, v);
+					Vec r1 = Lerp(q2, q3, v);
+
+					Vec noise = Lerp(r0, r1, w);
+					result = Ops::Add(result, Ops::Mul(noise, Ops::Set1(amplitude)));
+
+					x = Ops::Mul(x, two);
+					y = Ops::Mul(y, two);
+					amplitude *= persistence;
+				}
+
+				result = Ops::Div(result, Ops::Set1(maxAmplitude));
+				Ops::Store(output, Ops::RemapClamp01(result));
+			}
+		};
+
+		template<typename Ops>
+		void EvaluateNoise(const BatchedPerlinNoise::Permutation& permutation, const double* x, const double* y, double* output, std::size_t count, Nz::Int32 octaves, double persistence)
+		{
+			double maxAmplitude = 0.0;
+			double amplitude = 1.0;
+			for (Nz::Int32 octave = 0; octave < octaves; ++octave)
+			{
+				maxAmplitude += amplitude;
+				amplitude *= persistence;
+			}
+
+			std::size_t i = 0;
+			for (; i + Ops::Width <= count; i += Ops::Width)
+				NoiseKernel<Ops>::Evaluate(permutation, &x[i], &y[i], &output[i], octaves, persistence, maxAmplitude);
+
+			for (; i < count; ++i)
+				NoiseKernel<ScalarOps>::Evaluate(permutation, &x[i], &y[i], &output[i], octaves, persistence, maxAmplitude);
+		}
+	}
+
+	BatchedPerlinNoise::BatchedPerlinNoise() :
+	m_permutation(siv::PerlinNoise{}.serialize())
+	{
+	}
+
+	BatchedPerlinNoise::BatchedPerlinNoise(Nz::UInt32 seed)
+	{
+		Reseed(seed);
+	}
+
+	void BatchedPerlinNoise::NormalizedOctave2D_01(std::span<const double> x, std::span<const double> y, std::span<double> output, Nz::Int32 octaves, double persistence) const
+	{
+		return NormalizedOctave2D_01(GetBestImplementation(), x, y, output, octaves, persistence);
+	}
+
+	void BatchedPerlinNoise::NormalizedOctave2D_01(Implementation implementation, std::span<const double> x, std::span<const double> y, std::span<double> output, Nz::Int32 octaves, double persistence) const
+	{
+		NazaraAssert(x.size() == y.size() && x.size() == output.size(), "sample count mismatch");
+
+		switch (implementation)
+		{
+			case Implementation::Scalar:
+				return EvaluateNoise<ScalarOps>(m_permutation, x.data(), y.data(), output.data(), output.size(), octaves, persistence);
+
+			case Implementation::SSE2:
+#ifdef TSOM_NOISE_SSE2
+				return EvaluateNoise<SSE2Ops>(m_permutation, x.data(), y.data(), output.data(), output.size(), octaves, persistence);
+#else
+				break;
+#endif
+
+			case Implementation::AVX2:
+#ifdef TSOM_NOISE_AVX2
+				return EvaluateNoise<AVX2Ops>(m_permutation, x.data(), y.data(), output.data(), output.size(), octaves, persistence);
+#else
+				break;
+#endif
+		}
+
+		throw std::runtime_error("unsupported noise implementation");
+	}
+
+	void BatchedPerlinNoise::Reseed(Nz::UInt32 seed)
+	{
+		// Reuse siv::PerlinNoise permutation to get the exact same noise
+		m_permutation = siv::PerlinNoise(seed).serialize();
+	}
+
+	auto BatchedPerlinNoise::GetBestImplementation() -> Implementation
+	{
+#if defined(TSOM_NOISE_AVX2)
+		return Implementation::AVX2;
+#elif defined(TSOM_NOISE_SSE2)
+		return Implementation::SSE2;
+#else
+		return Implementation::Scalar;
+#endif
+	}
+
+	bool BatchedPerlinNoise::IsSupported(Implementation implementation)
+	{
+		switch (implementation)
+		{
+			case Implementation::Scalar:
+				return true;
+
+			case Implementation::SSE2:
+#ifdef TSOM_NOISE_SSE2
+				return true;
+#else
+				return false;
+#endif
+
+			case Implementation::AVX2:
+#ifdef TSOM_NOISE_AVX2
+				return true;
+#else
+				return false;
+#endif
+		}
+
+		return false;
+	}
+}
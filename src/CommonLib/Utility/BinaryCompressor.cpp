@@ -5,13 +5,37 @@
 #include <CommonLib/Utility/BinaryCompressor.hpp>
 #include <NazaraUtils/Algorithm.hpp>
 #include <lz4.h>
+#include <lz4hc.h>
+#include <algorithm>
+
+#ifdef TSOM_WITH_ZSTD
+#include <zstd.h>
+#endif
 
 namespace tsom
 {
+	namespace
+	{
+		// Frames start with the codec, flagged when followed by the (little-endian) dictionary id
+		constexpr Nz::UInt8 FrameDictionaryFlag = 0x80;
+		constexpr std::size_t FrameMaxHeaderSize = 1 + sizeof(Nz::UInt32);
+	}
+
 	BinaryCompressor::~BinaryCompressor()
 	{
 		if (m_state)
 			LZ4_freeStream(m_state);
+
+		if (m_stateHC)
+			LZ4_freeStreamHC(m_stateHC);
+
+#ifdef TSOM_WITH_ZSTD
+		if (m_zstdCompressionContext)
+			ZSTD_freeCCtx(m_zstdCompressionContext);
+
+		if (m_zstdDecompressionContext)
+			ZSTD_freeDCtx(m_zstdDecompressionContext);
+#endif
 	}
 
 	std::optional<std::span<Nz::UInt8>> BinaryCompressor::Compress(const void* data, std::size_t size)
@@ -35,6 +59,70 @@ namespace tsom
 		return m_compressedData;
 	}
 
+	std::optional<std::span<Nz::UInt8>> BinaryCompressor::CompressFrame(const CompressionProfile& profile, const void* data, std::size_t size)
+	{
+		if (!IsCodecSupported(profile.codec))
+			return std::nullopt;
+
+		std::size_t maxCompressedSize;
+		switch (profile.codec)
+		{
+			case CompressionCodec::LZ4:
+			case CompressionCodec::LZ4HC:
+			{
+				int bound = LZ4_compressBound(Nz::SafeCast<int>(size));
+				if (bound <= 0)
+					return std::nullopt;
+
+				maxCompressedSize = static_cast<std::size_t>(bound);
+				break;
+			}
+
+			case CompressionCodec::Zstd:
+#ifdef TSOM_WITH_ZSTD
+				maxCompressedSize = ZSTD_compressBound(size);
+				break;
+#else
+				return std::nullopt;
+#endif
+		}
+
+		m_compressedData.resize(FrameMaxHeaderSize + maxCompressedSize);
+
+		std::size_t headerSize = 1;
+		m_compressedData[0] = static_cast<Nz::UInt8>(profile.codec);
+		if (profile.dictionary)
+		{
+			m_compressedData[0] |= FrameDictionaryFlag;
+
+			Nz::UInt32 dictionaryId = profile.dictionary->GetId();
+			for (std::size_t i = 0; i < sizeof(dictionaryId); ++i)
+				m_compressedData[headerSize++] = static_cast<Nz::UInt8>(dictionaryId >> (i * 8));
+		}
+
+		std::optional<std::size_t> compressedSize;
+		switch (profile.codec)
+		{
+			case CompressionCodec::LZ4:
+				compressedSize = CompressLZ4(profile, static_cast<const char*>(data), Nz::SafeCast<int>(size), reinterpret_cast<char*>(&m_compressedData[headerSize]), Nz::SafeCast<int>(maxCompressedSize));
+				break;
+
+			case CompressionCodec::LZ4HC:
+				compressedSize = CompressLZ4HC(profile, static_cast<const char*>(data), Nz::SafeCast<int>(size), reinterpret_cast<char*>(&m_compressedData[headerSize]), Nz::SafeCast<int>(maxCompressedSize));
+				break;
+
+			case CompressionCodec::Zstd:
+				compressedSize = CompressZstd(profile, data, size, &m_compressedData[headerSize], maxCompressedSize);
+				break;
+		}
+
+		if (!compressedSize)
+			return std::nullopt;
+
+		m_compressedData.resize(headerSize + *compressedSize);
+		return m_compressedData;
+	}
+
 	std::optional<std::size_t> BinaryCompressor::Decompress(const void* compressedData, std::size_t compressedSize, void* output, std::size_t maxOutputSize)
 	{
 		const char* src = static_cast<const char*>(compressedData);
@@ -46,9 +134,226 @@ namespace tsom
 		return static_cast<std::size_t>(decompressedSize);
 	}
 
+	std::optional<std::size_t> BinaryCompressor::DecompressFrame(const void* frameData, std::size_t frameSize, void* output, std::size_t maxOutputSize, const CompressionDictionary* dictionary)
+	{
+		const Nz::UInt8* frame = static_cast<const Nz::UInt8*>(frameData);
+		if (frameSize < 1)
+			return std::nullopt;
+
+		std::size_t headerSize = 1;
+		Nz::UInt8 codecValue = frame[0] & ~FrameDictionaryFlag;
+		if (codecValue > static_cast<Nz::UInt8>(CompressionCodec::Max))
+			return std::nullopt;
+
+		CompressionCodec codec = static_cast<CompressionCodec>(codecValue);
+		if (!IsCodecSupported(codec))
+			return std::nullopt;
+
+		if (frame[0] & FrameDictionaryFlag)
+		{
+			if (frameSize < headerSize + sizeof(Nz::UInt32))
+				return std::nullopt;
+
+			Nz::UInt32 dictionaryId = 0;
+			for (std::size_t i = 0; i < sizeof(dictionaryId); ++i)
+				dictionaryId |= Nz::UInt32(frame[headerSize++]) << (i * 8);
+
+			// Decompressing with another dictionary would silently produce garbage
+			if (!dictionary || dictionary->GetId() != dictionaryId)
+				return std::nullopt;
+		}
+		else
+			dictionary = nullptr;
+
+		const Nz::UInt8* payload = frame + headerSize;
+		std::size_t payloadSize = frameSize - headerSize;
+
+		switch (codec)
+		{
+			case CompressionCodec::LZ4:
+			case CompressionCodec::LZ4HC:
+			{
+				const char* src = reinterpret_cast<const char*>(payload);
+
+				int decompressedSize;
+				if (dictionary)
+				{
+					const std::vector<Nz::UInt8>& dictionaryContent = dictionary->GetContent();
+					decompressedSize = LZ4_decompress_safe_usingDict(src, static_cast<char*>(output), Nz::SafeCast<int>(payloadSize), Nz::SafeCast<int>(maxOutputSize), reinterpret_cast<const char*>(dictionaryContent.data()), Nz::SafeCast<int>(dictionaryContent.size()));
+				}
+				else
+					decompressedSize = LZ4_decompress_safe(src, static_cast<char*>(output), Nz::SafeCast<int>(payloadSize), Nz::SafeCast<int>(maxOutputSize));
+
+				if (decompressedSize < 0)
+					return std::nullopt;
+
+				return static_cast<std::size_t>(decompressedSize);
+			}
+
+			case CompressionCodec::Zstd:
+			{
+#ifdef TSOM_WITH_ZSTD
+				if (!m_zstdDecompressionContext)
+					m_zstdDecompressionContext = ZSTD_createDCtx();
+
+				std::size_t decompressedSize;
+				if (dictionary)
+				{
+					const std::vector<Nz::UInt8>& dictionaryContent = dictionary->GetContent();
+					decompressedSize = ZSTD_decompress_usingDict(m_zstdDecompressionContext, output, maxOutputSize, payload, payloadSize, dictionaryContent.data(), dictionaryContent.size());
+				}
+				else
+					decompressedSize = ZSTD_decompressDCtx(m_zstdDecompressionContext, output, maxOutputSize, payload, payloadSize);
+
+				if (ZSTD_isError(decompressedSize))
+					return std::nullopt;
+
+				return decompressedSize;
+#else
+				return std::nullopt;
+#endif
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::optional<std::size_t> BinaryCompressor::CompressLZ4(const CompressionProfile& profile, const char* src, int srcSize, char* dst, int dstCapacity)
+	{
+		if (!m_state)
+			m_state = LZ4_createStream();
+
+		int compressedSize;
+		if (profile.dictionary)
+		{
+			const std::vector<Nz::UInt8>& dictionaryContent = profile.dictionary->GetContent();
+
+			// Loading a dictionary resets the stream
+			LZ4_loadDict(m_state, reinterpret_cast<const char*>(dictionaryContent.data()), Nz::SafeCast<int>(dictionaryContent.size()));
+			compressedSize = LZ4_compress_fast_continue(m_state, src, dst, srcSize, dstCapacity, profile.acceleration);
+		}
+		else
+			compressedSize = LZ4_compress_fast_extState(m_state, src, dst, srcSize, dstCapacity, profile.acceleration);
+
+		if (compressedSize <= 0)
+			return std::nullopt;
+
+		return static_cast<std::size_t>(compressedSize);
+	}
+
+	std::optional<std::size_t> BinaryCompressor::CompressLZ4HC(const CompressionProfile& profile, const char* src, int srcSize, char* dst, int dstCapacity)
+	{
+		if (!m_stateHC)
+			m_stateHC = LZ4_createStreamHC();
+
+		int level = (profile.level > 0) ? profile.level : LZ4HC_CLEVEL_DEFAULT;
+
+		int compressedSize;
+		if (profile.dictionary)
+		{
+			const std::vector<Nz::UInt8>& dictionaryContent = profile.dictionary->GetContent();
+
+			LZ4_resetStreamHC_fast(m_stateHC, level);
+			LZ4_loadDictHC(m_stateHC, reinterpret_cast<const char*>(dictionaryContent.data()), Nz::SafeCast<int>(dictionaryContent.size()));
+			compressedSize = LZ4_compress_HC_continue(m_stateHC, src, dst, srcSize, dstCapacity);
+		}
+		else
+			compressedSize = LZ4_compress_HC_extStateHC(m_stateHC, src, dst, srcSize, dstCapacity, level);
+
+		if (compressedSize <= 0)
+			return std::nullopt;
+
+		return static_cast<std::size_t>(compressedSize);
+	}
+
+	std::optional<std::size_t> BinaryCompressor::CompressZstd([[maybe_unused]] const CompressionProfile& profile, [[maybe_unused]] const void* src, [[maybe_unused]] std::size_t srcSize, [[maybe_unused]] void* dst, [[maybe_unused]] std::size_t dstCapacity)
+	{
+#ifdef TSOM_WITH_ZSTD
+		if (!m_zstdCompressionContext)
+			m_zstdCompressionContext = ZSTD_createCCtx();
+
+		std::size_t compressedSize;
+		if (profile.dictionary)
+		{
+			const std::vector<Nz::UInt8>& dictionaryContent = profile.dictionary->GetContent();
+			compressedSize = ZSTD_compress_usingDict(m_zstdCompressionContext, dst, dstCapacity, src, srcSize, dictionaryContent.data(), dictionaryContent.size(), profile.level);
+		}
+		else
+			compressedSize = ZSTD_compressCCtx(m_zstdCompressionContext, dst, dstCapacity, src, srcSize, profile.level);
+
+		if (ZSTD_isError(compressedSize))
+			return std::nullopt;
+
+		return compressedSize;
+#else
+		return std::nullopt;
+#endif
+	}
+
+	CompressionCapabilities BinaryCompressor::GetLocalCapabilities()
+	{
+		CompressionCapabilities capabilities;
+		for (CompressionCodec codec : { CompressionCodec::LZ4, CompressionCodec::LZ4HC, CompressionCodec::Zstd })
+		{
+			if (IsCodecSupported(codec))
+				capabilities.codecMask |= Nz::UInt8(1) << static_cast<Nz::UInt8>(codec);
+		}
+
+		// Dictionaries are assets owned by the application, it's up to it to advertise them
+		return capabilities;
+	}
+
 	BinaryCompressor& BinaryCompressor::GetThreadCompressor()
 	{
 		static thread_local BinaryCompressor binaryCompressor;
 		return binaryCompressor;
 	}
+
+	bool BinaryCompressor::IsCodecSupported(CompressionCodec codec)
+	{
+		switch (codec)
+		{
+			case CompressionCodec::LZ4:
+			case CompressionCodec::LZ4HC:
+				return true;
+
+			case CompressionCodec::Zstd:
+#ifdef TSOM_WITH_ZSTD
+				return true;
+#else
+				return false;
+#endif
+		}
+
+		return false;
+	}
+
+	CompressionProfile BinaryCompressor::NegotiateProfile(const CompressionProfile& profile, const CompressionCapabilities& peerCapabilities)
+	{
+		CompressionProfile negotiatedProfile = profile;
+
+		// LZ4 is always supported
+		if ((peerCapabilities.codecMask & (Nz::UInt8(1) << static_cast<Nz::UInt8>(profile.codec))) == 0)
+		{
+			negotiatedProfile.codec = CompressionCodec::LZ4;
+			negotiatedProfile.level = 0;
+		}
+
+		if (profile.dictionary && std::find(peerCapabilities.dictionaries.begin(), peerCapabilities.dictionaries.end(), profile.dictionary->GetId()) == peerCapabilities.dictionaries.end())
+			negotiatedProfile.dictionary = nullptr;
+
+		return negotiatedProfile;
+	}
+
+	std::optional<CompressionCodec> BinaryCompressor::ParseCodec(std::string_view codecName)
+	{
+		if (codecName == "lz4")
+			return CompressionCodec::LZ4;
+		else if (codecName == "lz4hc")
+			return CompressionCodec::LZ4HC;
+		else if (codecName == "zstd")
+			return CompressionCodec::Zstd;
+
+		return std::nullopt;
+	}
 }
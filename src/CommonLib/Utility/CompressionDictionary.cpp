@@ -0,0 +1,116 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/CompressionDictionary.hpp>
+#include <Nazara/Core/File.hpp>
+#include <NazaraUtils/Algorithm.hpp>
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+#ifdef TSOM_WITH_ZSTD
+#include <zdict.h>
+#endif
+
+namespace tsom
+{
+	CompressionDictionary::CompressionDictionary(Nz::UInt32 id, std::vector<Nz::UInt8> content) :
+	m_content(std::move(content)),
+	m_id(id)
+	{
+		if (m_id == 0)
+			throw std::runtime_error("compression dictionary id 0 is reserved");
+
+		if (m_content.empty())
+			throw std::runtime_error("compression dictionary cannot be empty");
+	}
+
+	bool CompressionDictionary::SaveToFile(const std::filesystem::path& filePath) const
+	{
+		// Magic and id (little-endian) followed by the raw content
+		std::vector<Nz::UInt8> fileContent;
+		fileContent.reserve(2 * sizeof(Nz::UInt32) + m_content.size());
+		for (Nz::UInt32 value : { FileMagic, m_id })
+		{
+			for (std::size_t i = 0; i < sizeof(value); ++i)
+				fileContent.push_back(static_cast<Nz::UInt8>(value >> (i * 8)));
+		}
+		fileContent.insert(fileContent.end(), m_content.begin(), m_content.end());
+
+		return Nz::File::WriteWhole(filePath, fileContent.data(), fileContent.size());
+	}
+
+	std::shared_ptr<CompressionDictionary> CompressionDictionary::LoadFromFile(const std::filesystem::path& filePath)
+	{
+		std::optional<std::vector<Nz::UInt8>> fileContentOpt = Nz::File::ReadWhole(filePath);
+		if (!fileContentOpt)
+			return nullptr;
+
+		const std::vector<Nz::UInt8>& fileContent = *fileContentOpt;
+		constexpr std::size_t HeaderSize = 2 * sizeof(Nz::UInt32);
+		if (fileContent.size() <= HeaderSize)
+			return nullptr;
+
+		auto ReadUInt32 = [&](std::size_t offset)
+		{
+			Nz::UInt32 value = 0;
+			for (std::size_t i = 0; i < sizeof(value); ++i)
+				value |= Nz::UInt32(fileContent[offset + i]) << (i * 8);
+
+			return value;
+		};
+
+		if (ReadUInt32(0) != FileMagic)
+			return nullptr;
+
+		Nz::UInt32 dictionaryId = ReadUInt32(sizeof(Nz::UInt32));
+		if (dictionaryId == 0)
+			return nullptr;
+
+		return std::make_shared<CompressionDictionary>(dictionaryId, std::vector<Nz::UInt8>(fileContent.begin() + HeaderSize, fileContent.end()));
+	}
+
+	std::shared_ptr<CompressionDictionary> CompressionDictionary::Train(Nz::UInt32 id, std::span<const std::span<const Nz::UInt8>> samples, std::size_t maxSize)
+	{
+		std::vector<Nz::UInt8> sampleData;
+		std::vector<std::size_t> sampleSizes;
+		for (std::span<const Nz::UInt8> sample : samples)
+		{
+			sampleData.insert(sampleData.end(), sample.begin(), sample.end());
+			sampleSizes.push_back(sample.size());
+		}
+
+		if (sampleData.empty())
+			return nullptr;
+
+#ifdef TSOM_WITH_ZSTD
+		std::vector<Nz::UInt8> dictionary(maxSize);
+		std::size_t dictionarySize = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), sampleData.data(), sampleSizes.data(), Nz::SafeCast<unsigned int>(sampleSizes.size()));
+		if (!ZDICT_isError(dictionarySize))
+		{
+			dictionary.resize(dictionarySize);
+			return std::make_shared<CompressionDictionary>(id, std::move(dictionary));
+		}
+
+		// zstd needs a lot of samples to train, fallback to raw content
+#endif
+
+		// A raw dictionary is just content the compressor can reference, keep a slice of every sample (from its middle) so they're all represented
+		if (sampleData.size() <= maxSize)
+			return std::make_shared<CompressionDictionary>(id, std::move(sampleData));
+
+		std::size_t sliceSize = std::max<std::size_t>(maxSize / samples.size(), 1);
+
+		std::vector<Nz::UInt8> dictionary;
+		dictionary.reserve(maxSize);
+		for (std::span<const Nz::UInt8> sample : samples)
+		{
+			std::size_t size = std::min({ sliceSize, sample.size(), maxSize - dictionary.size() });
+			std::size_t offset = (sample.size() - size) / 2;
+			dictionary.insert(dictionary.end(), sample.begin() + offset, sample.begin() + offset + size);
+		}
+
+		return std::make_shared<CompressionDictionary>(id, std::move(dictionary));
+	}
+}
@@ -0,0 +1,298 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/MetricsRegistry.hpp>
+#include <Nazara/Core/File.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace tsom
+{
+	namespace
+	{
+		void AppendEscaped(std::string& output, std::string_view str, bool escapeQuotes)
+		{
+			for (char c : str)
+			{
+				switch (c)
+				{
+					case '\\': output += "\\\\"; break;
+					case '\n': output += "\\n"; break;
+					case '"':
+						output += (escapeQuotes) ? "\\\"" : "\"";
+						break;
+
+					default:
+						output += c;
+						break;
+				}
+			}
+		}
+
+		void AppendLabels(std::string& output, const MetricsRegistry::Labels& labels, std::string_view bucketBound = {})
+		{
+			if (labels.empty() && bucketBound.empty())
+				return;
+
+			output += '{';
+			bool first = true;
+			for (const auto& [labelName, labelValue] : labels)
+			{
+				if (!first)
+					output += ',';
+
+				output += labelName;
+				output += "=\"";
+				AppendEscaped(output, labelValue, true);
+				output += '"';
+
+				first = false;
+			}
+
+			if (!bucketBound.empty())
+			{
+				if (!first)
+					output += ',';
+
+				output += "le=\"";
+				output += bucketBound;
+				output += '"';
+			}
+
+			output += '}';
+		}
+
+		std::string FormatValue(double value)
+		{
+			if (std::isnan(value))
+				return "NaN";
+
+			if (std::isinf(value))
+				return (value > 0.0) ? "+Inf" : "-Inf";
+
+			return fmt::format("{}", value);
+		}
+
+		bool IsValidName(std::string_view name)
+		{
+			if (name.empty() || (name[0] >= '0' && name[0] <= '9'))
+				return false;
+
+			return std::all_of(name.begin(), name.end(), [](char c)
+			{
+				return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == ':';
+			});
+		}
+	}
+
+	auto MetricsRegistry::GetCounter(std::string_view name, std::string_view help, Labels labels) -> Counter&
+	{
+		return GetMetric<Counter>(MetricType::Counter, name, help, std::move(labels), []
+		{
+			return std::make_unique<Counter>();
+		});
+	}
+
+	auto MetricsRegistry::GetGauge(std::string_view name, std::string_view help, Labels labels) -> Gauge&
+	{
+		return GetMetric<Gauge>(MetricType::Gauge, name, help, std::move(labels), []
+		{
+			return std::make_unique<Gauge>();
+		});
+	}
+
+	auto MetricsRegistry::GetHistogram(std::string_view name, std::string_view help, std::vector<double> bucketBounds, Labels labels) -> Histogram&
+	{
+		return GetMetric<Histogram>(MetricType::Histogram, name, help, std::move(labels), [&]
+		{
+			return std::make_unique<Histogram>(std::move(bucketBounds));
+		});
+	}
+
+	std::string MetricsRegistry::ToPrometheusText() const
+	{
+		std::string output;
+
+		std::unique_lock lock(m_mutex);
+		for (const auto& [name, family] : m_families)
+		{
+			output += "# HELP ";
+			output += name;
+			output += ' ';
+			AppendEscaped(output, family.help, false);
+			output += '\n';
+
+			output += "# TYPE ";
+			output += name;
+			switch (family.type)
+			{
+				case MetricType::Counter:   output += " counter\n"; break;
+				case MetricType::Gauge:     output += " gauge\n"; break;
+				case MetricType::Histogram: output += " histogram\n"; break;
+			}
+
+			for (const auto& [labels, metric] : family.metrics)
+			{
+				std::visit([&, &name = name, &labels = labels](auto&& metricPtr)
+				{
+					using T = std::decay_t<decltype(*metricPtr)>;
+					if constexpr (std::is_same_v<T, Histogram>)
+					{
+						const std::vector<double>& bucketBounds = metricPtr->GetBucketBounds();
+						std::vector<Nz::UInt64> cumulativeCounts = metricPtr->GetCumulativeCounts();
+						for (std::size_t i = 0; i < cumulativeCounts.size(); ++i)
+						{
+							output += name;
+							output += "_bucket";
+							AppendLabels(output, labels, (i < bucketBounds.size()) ? FormatValue(bucketBounds[i]) : "+Inf");
+							output += fmt::format(" {}\n", cumulativeCounts[i]);
+						}
+
+						// Use the +Inf bucket as count so the exposition stays consistent even if values are observed meanwhile
+						output += name;
+						output += "_sum";
+						AppendLabels(output, labels);
+						output += ' ';
+						output += FormatValue(metricPtr->GetSum());
+						output += '\n';
+
+						output += name;
+						output += "_count";
+						AppendLabels(output, labels);
+						output += fmt::format(" {}\n", cumulativeCounts.back());
+					}
+					else
+					{
+						output += name;
+						AppendLabels(output, labels);
+						output += ' ';
+						output += FormatValue(metricPtr->GetValue());
+						output += '\n';
+					}
+				}, metric);
+			}
+		}
+
+		return output;
+	}
+
+	bool MetricsRegistry::WriteToFile(const std::filesystem::path& filePath) const
+	{
+		std::string content = ToPrometheusText();
+
+		// Write to a temporary file first so readers never see a partially written file
+		std::filesystem::path tempPath = filePath;
+		tempPath += ".tmp";
+
+		if (!Nz::File::WriteWhole(tempPath, content.data(), content.size()))
+			return false;
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, filePath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		return true;
+	}
+
+	std::vector<double> MetricsRegistry::ExponentialBuckets(double start, double factor, std::size_t count)
+	{
+		assert(start > 0.0 && factor > 1.0);
+
+		std::vector<double> bucketBounds(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			bucketBounds[i] = start;
+			start *= factor;
+		}
+
+		return bucketBounds;
+	}
+
+	std::vector<double> MetricsRegistry::LinearBuckets(double start, double width, std::size_t count)
+	{
+		assert(width > 0.0);
+
+		std::vector<double> bucketBounds(count);
+		for (std::size_t i = 0; i < count; ++i)
+			bucketBounds[i] = start + width * i;
+
+		return bucketBounds;
+	}
+
+	template<typename T, typename F>
+	T& MetricsRegistry::GetMetric(MetricType type, std::string_view name, std::string_view help, Labels&& labels, F&& factory)
+	{
+		assert(IsValidName(name));
+		assert(std::all_of(labels.begin(), labels.end(), [](const auto& label) { return IsValidName(label.first) && label.first != "le"; }));
+
+		std::unique_lock lock(m_mutex);
+
+		auto it = m_families.find(name);
+		if (it == m_families.end())
+		{
+			Family family;
+			family.help = help;
+			family.type = type;
+
+			it = m_families.emplace(std::string(name), std::move(family)).first;
+		}
+		else if (it->second.type != type)
+			throw std::runtime_error(fmt::format("metric {0} was already registered with another type", name));
+
+		Family& family = it->second;
+		for (auto& [metricLabels, metric] : family.metrics)
+		{
+			if (metricLabels == labels)
+				return *std::get<std::unique_ptr<T>>(metric);
+		}
+
+		std::unique_ptr<T> metric = factory();
+		T& metricRef = *metric;
+		family.metrics.emplace_back(std::move(labels), std::move(metric));
+
+		return metricRef;
+	}
+
+
+	MetricsRegistry::Histogram::Histogram(std::vector<double> bucketBounds) :
+	m_bucketBounds(std::move(bucketBounds))
+	{
+		assert(std::is_sorted(m_bucketBounds.begin(), m_bucketBounds.end()));
+
+		// Last bucket is +Inf
+		m_bucketCounts = std::make_unique<std::atomic<Nz::UInt64>[]>(m_bucketBounds.size() + 1);
+	}
+
+	std::vector<Nz::UInt64> MetricsRegistry::Histogram::GetCumulativeCounts() const
+	{
+		std::vector<Nz::UInt64> cumulativeCounts(m_bucketBounds.size() + 1);
+
+		Nz::UInt64 count = 0;
+		for (std::size_t i = 0; i < cumulativeCounts.size(); ++i)
+		{
+			count += m_bucketCounts[i].load(std::memory_order_relaxed);
+			cumulativeCounts[i] = count;
+		}
+
+		return cumulativeCounts;
+	}
+
+	void MetricsRegistry::Histogram::Observe(double value)
+	{
+		// Buckets are upper inclusive bounds (le)
+		auto it = std::lower_bound(m_bucketBounds.begin(), m_bucketBounds.end(), value);
+		std::size_t bucketIndex = std::distance(m_bucketBounds.begin(), it);
+
+		m_bucketCounts[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+		m_sum.fetch_add(value, std::memory_order_relaxed);
+	}
+}
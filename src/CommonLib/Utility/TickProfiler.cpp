@@ -0,0 +1,185 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/TickProfiler.hpp>
+#include <Nazara/Core/File.hpp>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace tsom
+{
+	namespace
+	{
+		struct ThreadBuffer
+		{
+			std::mutex mutex;
+			std::string threadName;
+			std::vector<TickProfiler::Event> events;
+			std::size_t nextIndex = 0;
+			unsigned int threadId;
+		};
+
+		struct ThreadBufferRegistry
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		};
+
+		std::atomic_bool s_profilerEnabled(false);
+
+		ThreadBufferRegistry& GetThreadBufferRegistry()
+		{
+			static ThreadBufferRegistry registry;
+			return registry;
+		}
+
+		// Buffers are never freed so events of finished threads can still be dumped
+		ThreadBuffer& GetThreadBuffer()
+		{
+			static thread_local ThreadBuffer* threadBuffer = nullptr;
+			if (!threadBuffer)
+			{
+				ThreadBufferRegistry& registry = GetThreadBufferRegistry();
+
+				std::unique_lock lock(registry.mutex);
+				auto& buffer = registry.buffers.emplace_back(std::make_unique<ThreadBuffer>());
+				buffer->threadId = static_cast<unsigned int>(registry.buffers.size());
+				buffer->threadName = fmt::format("Thread #{}", buffer->threadId);
+
+				threadBuffer = buffer.get();
+			}
+
+			return *threadBuffer;
+		}
+	}
+
+	void TickProfiler::Clear()
+	{
+		ThreadBufferRegistry& registry = GetThreadBufferRegistry();
+
+		std::unique_lock lock(registry.mutex);
+		for (auto& buffer : registry.buffers)
+		{
+			std::unique_lock bufferLock(buffer->mutex);
+			buffer->events.clear();
+			buffer->nextIndex = 0;
+		}
+	}
+
+	auto TickProfiler::CollectEvents() -> std::vector<ThreadEvents>
+	{
+		ThreadBufferRegistry& registry = GetThreadBufferRegistry();
+
+		std::vector<ThreadEvents> threadEvents;
+
+		std::unique_lock lock(registry.mutex);
+		for (auto& buffer : registry.buffers)
+		{
+			auto& events = threadEvents.emplace_back();
+			events.threadId = buffer->threadId;
+
+			std::unique_lock bufferLock(buffer->mutex);
+			events.threadName = buffer->threadName;
+
+			// Once the ring buffer is full, the oldest event is the one which will be overwritten next
+			events.events.reserve(buffer->events.size());
+			events.events.insert(events.events.end(), buffer->events.begin() + buffer->nextIndex, buffer->events.end());
+			events.events.insert(events.events.end(), buffer->events.begin(), buffer->events.begin() + buffer->nextIndex);
+		}
+
+		return threadEvents;
+	}
+
+	void TickProfiler::Enable(bool enable)
+	{
+		s_profilerEnabled.store(enable, std::memory_order_relaxed);
+	}
+
+	bool TickProfiler::IsEnabled()
+	{
+		return s_profilerEnabled.load(std::memory_order_relaxed);
+	}
+
+	void TickProfiler::RecordEvent(const char* name, Nz::Time beginTime, Nz::Time endTime)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		// Only contended while dumping
+		std::unique_lock lock(buffer.mutex);
+		if (buffer.events.size() < ThreadEventCapacity)
+		{
+			if (buffer.events.empty())
+				buffer.events.reserve(ThreadEventCapacity);
+
+			buffer.events.push_back(Event{ name, beginTime, endTime });
+		}
+		else
+		{
+			buffer.events[buffer.nextIndex] = Event{ name, beginTime, endTime };
+			buffer.nextIndex = (buffer.nextIndex + 1) % ThreadEventCapacity;
+		}
+	}
+
+	void TickProfiler::SetThreadName(std::string threadName)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		std::unique_lock lock(buffer.mutex);
+		buffer.threadName = std::move(threadName);
+	}
+
+	std::string TickProfiler::ToChromeTrace()
+	{
+		auto ToMicroseconds = [](Nz::Time time)
+		{
+			return time.AsNanoseconds() / 1000.0;
+		};
+
+		nlohmann::json traceEvents = nlohmann::json::array();
+		for (ThreadEvents& threadEvents : CollectEvents())
+		{
+			traceEvents.push_back({
+				{ "name", "thread_name" },
+				{ "ph", "M" },
+				{ "pid", 1 },
+				{ "tid", threadEvents.threadId },
+				{ "args", { { "name", threadEvents.threadName } } }
+			});
+
+			for (const Event& event : threadEvents.events)
+			{
+				traceEvents.push_back({
+					{ "name", event.name },
+					{ "cat", "tick" },
+					{ "ph", "X" },
+					{ "ts", ToMicroseconds(event.beginTime) },
+					{ "dur", ToMicroseconds(event.endTime - event.beginTime) },
+					{ "pid", 1 },
+					{ "tid", threadEvents.threadId }
+				});
+			}
+		}
+
+		nlohmann::json trace;
+		trace["displayTimeUnit"] = "ms";
+		trace["traceEvents"] = std::move(traceEvents);
+
+		return trace.dump();
+	}
+
+	bool TickProfiler::WriteChromeTrace(const std::filesystem::path& filePath)
+	{
+		if (std::filesystem::path directory = filePath.parent_path(); !directory.empty())
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(directory, ec);
+		}
+
+		std::string trace = ToChromeTrace();
+		return Nz::File::WriteWhole(filePath, trace.data(), trace.size());
+	}
+}
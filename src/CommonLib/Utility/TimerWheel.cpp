@@ -0,0 +1,296 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/TimerWheel.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace tsom
+{
+	TimerWheel::TimerWheel() :
+	m_currentTick(0),
+	m_nextSequence(0),
+	m_activeTimerCount(0)
+	{
+		m_buckets.fill(InvalidIndex);
+	}
+
+	auto TimerWheel::AddRepeatingTimer(Nz::UInt64 intervalTicks, Callback callback, entt::entity owner) -> TimerId
+	{
+		return AllocateTimer(intervalTicks, std::max<Nz::UInt64>(intervalTicks, 1), std::move(callback), owner);
+	}
+
+	auto TimerWheel::AddTimer(Nz::UInt64 delayTicks, Callback callback, entt::entity owner) -> TimerId
+	{
+		return AllocateTimer(delayTicks, 0, std::move(callback), owner);
+	}
+
+	void TimerWheel::Advance()
+	{
+		m_currentTick++;
+
+		// Move timers from the upper levels down when the lower level wraps around
+		for (unsigned int level = 1; level < LevelCount; ++level)
+		{
+			if ((m_currentTick >> (LevelBits * (level - 1))) & (SlotCount - 1))
+				break;
+
+			Cascade(level);
+		}
+
+		assert(m_expiredTimers.empty());
+
+		Nz::UInt32 timerIndex = DetachBucket(Nz::UInt32(m_currentTick & (SlotCount - 1)));
+		while (timerIndex != InvalidIndex)
+		{
+			Timer& timer = m_timers[timerIndex];
+			assert(timer.expiration == m_currentTick);
+			m_expiredTimers.push_back(BuildTimerId(timerIndex, timer.generation));
+
+			timerIndex = timer.next;
+		}
+
+		// Buckets are unordered, restore scheduling order
+		std::sort(m_expiredTimers.begin(), m_expiredTimers.end(), [&](TimerId lhs, TimerId rhs)
+		{
+			return m_timers[GetTimerIndex(lhs)].sequence < m_timers[GetTimerIndex(rhs)].sequence;
+		});
+
+		for (TimerId timerId : m_expiredTimers)
+		{
+			// Timer may have been cancelled by a previous callback
+			Nz::UInt32 expiredIndex = GetTimerIndex(timerId);
+			if (!RetrieveTimer(timerId))
+				continue;
+
+			// Callbacks may add timers (and reallocate m_timers), move the callback out before calling it
+			Timer& timer = m_timers[expiredIndex];
+			Callback callback = std::move(timer.callback);
+			if (timer.interval == 0)
+			{
+				FreeTimer(expiredIndex);
+				callback();
+			}
+			else
+			{
+				timer.expiration = m_currentTick + timer.interval;
+				timer.sequence = m_nextSequence++;
+
+				callback();
+
+				// Repeating timers can be cancelled from their own callback
+				if (RetrieveTimer(timerId))
+				{
+					m_timers[expiredIndex].callback = std::move(callback);
+					InsertTimer(expiredIndex);
+				}
+			}
+		}
+		m_expiredTimers.clear();
+	}
+
+	bool TimerWheel::CancelTimer(TimerId timerId)
+	{
+		if (!RetrieveTimer(timerId))
+			return false;
+
+		FreeTimer(GetTimerIndex(timerId));
+		return true;
+	}
+
+	std::size_t TimerWheel::CancelTimers(entt::entity owner)
+	{
+		auto it = m_ownerTimers.find(owner);
+		if (it == m_ownerTimers.end())
+			return 0;
+
+		std::size_t cancelCount = 0;
+
+		// FreeTimer updates the owner list head, consume it until the owner has no timer left
+		Nz::UInt32 timerIndex = it->second;
+		while (timerIndex != InvalidIndex)
+		{
+			Nz::UInt32 nextIndex = m_timers[timerIndex].ownerNext;
+			FreeTimer(timerIndex);
+			cancelCount++;
+
+			timerIndex = nextIndex;
+		}
+
+		return cancelCount;
+	}
+
+	entt::entity TimerWheel::GetTimerOwner(TimerId timerId) const
+	{
+		const Timer* timer = RetrieveTimer(timerId);
+		if (!timer)
+			return entt::null;
+
+		return timer->owner;
+	}
+
+	bool TimerWheel::IsTimerActive(TimerId timerId) const
+	{
+		return RetrieveTimer(timerId) != nullptr;
+	}
+
+	auto TimerWheel::AllocateTimer(Nz::UInt64 delayTicks, Nz::UInt64 intervalTicks, Callback&& callback, entt::entity owner) -> TimerId
+	{
+		assert(callback);
+
+		Nz::UInt32 timerIndex;
+		if (!m_freeTimers.empty())
+		{
+			timerIndex = m_freeTimers.back();
+			m_freeTimers.pop_back();
+		}
+		else
+		{
+			timerIndex = Nz::UInt32(m_timers.size());
+			m_timers.emplace_back();
+		}
+
+		Timer& timer = m_timers[timerIndex];
+		timer.callback = std::move(callback);
+		timer.owner = owner;
+		timer.expiration = m_currentTick + std::max<Nz::UInt64>(delayTicks, 1);
+		timer.interval = intervalTicks;
+		timer.sequence = m_nextSequence++;
+		timer.isActive = true;
+
+		if (owner != entt::null)
+		{
+			auto it = m_ownerTimers.find(owner);
+			if (it != m_ownerTimers.end())
+			{
+				timer.ownerNext = it->second;
+				m_timers[it->second].ownerPrev = timerIndex;
+				it.value() = timerIndex;
+			}
+			else
+				m_ownerTimers.emplace(owner, timerIndex);
+		}
+
+		InsertTimer(timerIndex);
+		m_activeTimerCount++;
+
+		return BuildTimerId(timerIndex, timer.generation);
+	}
+
+	void TimerWheel::Cascade(unsigned int level)
+	{
+		Nz::UInt32 slot = Nz::UInt32((m_currentTick >> (LevelBits * level)) & (SlotCount - 1));
+
+		Nz::UInt32 timerIndex = DetachBucket(level * SlotCount + slot);
+		while (timerIndex != InvalidIndex)
+		{
+			Nz::UInt32 nextIndex = m_timers[timerIndex].next;
+			InsertTimer(timerIndex);
+
+			timerIndex = nextIndex;
+		}
+	}
+
+	Nz::UInt32 TimerWheel::DetachBucket(Nz::UInt32 bucketIndex)
+	{
+		Nz::UInt32 firstIndex = m_buckets[bucketIndex];
+		m_buckets[bucketIndex] = InvalidIndex;
+
+		for (Nz::UInt32 timerIndex = firstIndex; timerIndex != InvalidIndex; timerIndex = m_timers[timerIndex].next)
+			m_timers[timerIndex].bucket = InvalidIndex;
+
+		return firstIndex;
+	}
+
+	void TimerWheel::FreeTimer(Nz::UInt32 timerIndex)
+	{
+		Timer& timer = m_timers[timerIndex];
+		assert(timer.isActive);
+
+		UnlinkFromBucket(timer);
+
+		if (timer.owner != entt::null)
+		{
+			if (timer.ownerPrev != InvalidIndex)
+				m_timers[timer.ownerPrev].ownerNext = timer.ownerNext;
+			else if (timer.ownerNext != InvalidIndex)
+				m_ownerTimers[timer.owner] = timer.ownerNext;
+			else
+				m_ownerTimers.erase(timer.owner);
+
+			if (timer.ownerNext != InvalidIndex)
+				m_timers[timer.ownerNext].ownerPrev = timer.ownerPrev;
+		}
+
+		timer.callback = {};
+		timer.owner = entt::null;
+		timer.ownerPrev = InvalidIndex;
+		timer.ownerNext = InvalidIndex;
+		timer.isActive = false;
+
+		// Invalidates outstanding ids, zero is kept for InvalidTimer
+		timer.generation++;
+		if (timer.generation == 0)
+			timer.generation = 1;
+
+		m_freeTimers.push_back(timerIndex);
+		m_activeTimerCount--;
+	}
+
+	void TimerWheel::InsertTimer(Nz::UInt32 timerIndex)
+	{
+		Timer& timer = m_timers[timerIndex];
+		assert(timer.bucket == InvalidIndex);
+
+		// Timers too far in the future are stored in the last slot reachable by the top level, and reinserted when it cascades
+		Nz::UInt64 delta = timer.expiration - m_currentTick;
+		Nz::UInt64 expiration = (delta < MaxRange) ? timer.expiration : m_currentTick + MaxRange - 1;
+
+		unsigned int level = 0;
+		while (level < LevelCount - 1 && delta >= (Nz::UInt64(1) << (LevelBits * (level + 1))))
+			level++;
+
+		Nz::UInt32 slot = Nz::UInt32((expiration >> (LevelBits * level)) & (SlotCount - 1));
+		Nz::UInt32 bucketIndex = level * SlotCount + slot;
+
+		timer.bucket = bucketIndex;
+		timer.prev = InvalidIndex;
+		timer.next = m_buckets[bucketIndex];
+		if (timer.next != InvalidIndex)
+			m_timers[timer.next].prev = timerIndex;
+
+		m_buckets[bucketIndex] = timerIndex;
+	}
+
+	auto TimerWheel::RetrieveTimer(TimerId timerId) const -> const Timer*
+	{
+		Nz::UInt32 timerIndex = GetTimerIndex(timerId);
+		if (timerIndex >= m_timers.size())
+			return nullptr;
+
+		const Timer& timer = m_timers[timerIndex];
+		if (!timer.isActive || timer.generation != GetTimerGeneration(timerId))
+			return nullptr;
+
+		return &timer;
+	}
+
+	void TimerWheel::UnlinkFromBucket(Timer& timer)
+	{
+		if (timer.bucket == InvalidIndex)
+			return;
+
+		if (timer.prev != InvalidIndex)
+			m_timers[timer.prev].next = timer.next;
+		else
+			m_buckets[timer.bucket] = timer.next;
+
+		if (timer.next != InvalidIndex)
+			m_timers[timer.next].prev = timer.prev;
+
+		timer.bucket = InvalidIndex;
+		timer.prev = InvalidIndex;
+		timer.next = InvalidIndex;
+	}
+}
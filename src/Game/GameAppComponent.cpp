@@ -15,6 +15,8 @@
 #include <CommonLib/Physics/PhysicsSettings.hpp>
 #include <CommonLib/Systems/PlanetSystem.hpp>
 #include <CommonLib/Systems/ShipSystem.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
+#include <Game/GameConfigAppComponent.hpp>
 #include <Game/States/BackgroundState.hpp>
 #include <Game/States/ConnectionState.hpp>
 #include <Game/States/DebugInfoState.hpp>
@@ -34,6 +36,7 @@
 #include <Nazara/Physics3D/Systems/Physics3DSystem.hpp>
 #include <Nazara/Platform/MessageBox.hpp>
 #include <Nazara/Platform/WindowingAppComponent.hpp>
+#include <NazaraUtils/PathUtils.hpp>
 #include <fmt/color.h>
 #include <fmt/core.h>
 #include <charconv>
@@ -57,10 +60,16 @@ namespace tsom
 			SetupCanvas(world, window);
 			SetupCamera(renderTarget, world);
 
+			auto& gameConfig = GetApp().GetComponent<GameConfigAppComponent>().GetConfig();
+			if (std::string_view chunkCacheDirectory = gameConfig.GetStringValue("Cache.ChunkDirectory"); !chunkCacheDirectory.empty())
+				m_chunkContentCache.emplace(Nz::Utf8Path(chunkCacheDirectory));
+
 			std::shared_ptr<tsom::StateData> stateData = std::make_shared<tsom::StateData>();
 			stateData->app = &GetApp();
 			stateData->blockLibrary = &m_blockLibrary.value();
 			stateData->canvas = &m_canvas.value();
+			stateData->chunkCompressionDictionary = m_chunkCompressionDictionary;
+			stateData->chunkContentCache = (m_chunkContentCache) ? &m_chunkContentCache.value() : nullptr;
 			stateData->renderTarget = std::move(renderTarget);
 			stateData->window = &window;
 			stateData->world = &world;
@@ -179,6 +188,12 @@ namespace tsom
 		m_blockLibrary.emplace(app);
 		m_blockLibrary->BuildTexture();
 
+		// Advertised to the server during the handshake, chunks are compressed without it if it's missing or outdated
+		std::filesystem::path dictionaryPath = Nz::Utf8Path(Constants::ChunkCompressionDictionaryPath);
+		m_chunkCompressionDictionary = CompressionDictionary::LoadFromFile(dictionaryPath);
+		if (!m_chunkCompressionDictionary)
+			fmt::print(fg(fmt::color::yellow), "failed to load chunk dictionary from {0}\n", Nz::PathToString(dictionaryPath));
+
 		return true;
 	}
 
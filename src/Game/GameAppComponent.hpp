@@ -8,11 +8,14 @@
 #define TSOM_GAME_GAMEAPPCOMPONENT_HPP
 
 #include <ClientLib/ClientBlockLibrary.hpp>
+#include <CommonLib/ChunkContentCache.hpp>
 #include <CommonLib/Systems/GravityPhysicsSystem.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
 #include <Nazara/Core/ApplicationComponent.hpp>
 #include <Nazara/Core/StateMachine.hpp>
 #include <Nazara/Widgets/Canvas.hpp>
 #include <NazaraUtils/Prerequisites.hpp>
+#include <memory>
 #include <optional>
 
 namespace Nz
@@ -48,7 +51,9 @@ namespace tsom
 			Nz::Window& SetupWindow();
 			Nz::EnttWorld& SetupWorld();
 
+			std::shared_ptr<const CompressionDictionary> m_chunkCompressionDictionary;
 			std::optional<Nz::Canvas> m_canvas;
+			std::optional<ChunkContentCache> m_chunkContentCache;
 			std::optional<ClientBlockLibrary> m_blockLibrary;
 			Nz::StateMachine m_stateMachine;
 	};
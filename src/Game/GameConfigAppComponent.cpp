@@ -12,6 +12,7 @@ namespace tsom
 	GameConfigFile::GameConfigFile()
 	{
 		RegisterStringOption("Api.Url");
+		RegisterStringOption("Cache.ChunkDirectory", "cache/chunks");
 		RegisterStringOption("Menu.Login", "Mingebag", [](std::string value) -> Nz::Result<std::string, std::string>
 		{
 			if (value.empty())
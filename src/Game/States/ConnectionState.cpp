@@ -6,6 +6,7 @@
 #include <ClientLib/ClientSessionHandler.hpp>
 #include <CommonLib/SessionHandler.hpp>
 #include <CommonLib/Version.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
 #include <Game/States/BackgroundState.hpp>
 #include <Game/States/GameState.hpp>
 #include <Nazara/Core/StateMachine.hpp>
@@ -62,7 +63,13 @@ namespace tsom
 		m_serverSession.emplace(*reactor, peerId, serverAddress);
 		m_serverSession->SetProtocolVersion(GameVersion);
 
+		// Only the dictionary matters on the receiving side, frames tell which codec they use
+		CompressionProfile compressionProfile;
+		compressionProfile.dictionary = stateData.chunkCompressionDictionary;
+		m_serverSession->SetCompressionProfile(std::move(compressionProfile));
+
 		ClientSessionHandler& sessionHandler = m_serverSession->SetupHandler<ClientSessionHandler>(*stateData.app, *stateData.world, *stateData.blockLibrary);
+		sessionHandler.SetChunkContentCache(stateData.chunkContentCache);
 		ConnectSignal(sessionHandler.OnAuthResponse, [this](const Packets::AuthResponse& authResponse)
 		{
 			if (authResponse.authResult.IsOk())
@@ -124,6 +131,11 @@ namespace tsom
 			Packets::AuthRequest request;
 			request.gameVersion = GameVersion;
 			request.token = m_playerData;
+			request.compressionCapabilities = BinaryCompressor::GetLocalCapabilities();
+			if (const auto& dictionary = m_serverSession->GetCompressionProfile().dictionary)
+				request.compressionCapabilities.dictionaries.push_back(dictionary->GetId());
+
+			request.hasChunkContentCache = (GetStateData().chunkContentCache != nullptr);
 
 			m_serverSession->SendPacket(request);
 		};
@@ -651,6 +651,8 @@ namespace tsom
 		if (!stateData.networkSession)
 			return true;
 
+		stateData.sessionHandler->Update();
+
 		m_timerManager.Update(elapsedTime);
 
 		if (m_debugOverlay)
@@ -22,19 +22,23 @@ namespace Nz
 
 namespace tsom
 {
+	class ChunkContentCache;
 	class ClientBlockLibrary;
 	class ClientSessionHandler;
+	class CompressionDictionary;
 	class ConnectionState;
 	class NetworkSession;
 
 	struct StateData : std::enable_shared_from_this<StateData>
 	{
+		std::shared_ptr<const CompressionDictionary> chunkCompressionDictionary;
 		std::shared_ptr<Nz::RenderTarget> renderTarget;
 		Nz::ApplicationBase* app;
 		Nz::Canvas* canvas;
 		Nz::EnttWorld* world;
 		Nz::Window* window;
 		ConnectionState* connectionState = nullptr;
+		ChunkContentCache* chunkContentCache = nullptr;
 		ClientBlockLibrary* blockLibrary = nullptr;
 		ClientSessionHandler* sessionHandler = nullptr;
 		NetworkSession* networkSession = nullptr;
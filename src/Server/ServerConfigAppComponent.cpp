@@ -7,6 +7,7 @@
 #include <cppcodec/base64_rfc4648.hpp>
 #include <fmt/color.h>
 #include <fmt/format.h>
+#include <limits>
 
 namespace tsom
 {
@@ -16,9 +17,27 @@ namespace tsom
 		RegisterStringOption("ConnectionToken.EncryptionKey", "");
 		RegisterIntegerOption("Server.Port", 1, 0xFFFF, 29536);
 		RegisterIntegerOption("Server.MaxStuckSeconds", 0, 60, 10);
+		RegisterBoolOption("Server.ParallelDispatch", true);
 		RegisterBoolOption("Server.SleepWhenEmpty", true);
 		RegisterStringOption("Save.Directory", "saves/chunks");
 		RegisterIntegerOption("Save.Interval", 0, 60 * 60, 30);
+		RegisterStringOption("Compression.ChunkCodec", "lz4");
+		RegisterIntegerOption("Compression.ChunkAcceleration", 1, 65537, 1);
+		RegisterIntegerOption("Compression.ChunkLevel", 0, 22, 0);
+		RegisterBoolOption("Compression.ChunkDictionary", true);
+		RegisterStringOption("Compression.ShipCodec", "lz4hc");
+		RegisterBoolOption("Profiler.Enabled", false);
+		RegisterBoolOption("Profiler.DumpOnTickOverrun", false);
+		RegisterStringOption("Profiler.Directory", "profiles");
+		RegisterBoolOption("Metrics.Enabled", false);
+		RegisterStringOption("Metrics.File", "metrics.prom");
+		RegisterIntegerOption("Metrics.ExportInterval", 1, 60 * 60, 15);
+		RegisterIntegerOption("Metrics.HttpPort", 0, 0xFFFF, 0);
+		RegisterBoolOption("Recording.Enabled", false);
+		RegisterStringOption("Recording.Directory", "recordings");
+		RegisterIntegerOption("Scripting.CallTimeBudget", 0, 60 * 1000, 0);
+		RegisterIntegerOption("Scripting.TickTimeBudget", 0, 60 * 1000, 0);
+		RegisterIntegerOption("Scripting.CallInstructionBudget", 0, std::numeric_limits<long long>::max(), 0);
 	}
 
 	void ServerConfigFile::PostLoad()
@@ -2,14 +2,23 @@
 // This file is part of the "This Space Of Mine" project
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/HealthCheckerAppComponent.hpp>
 #include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/SessionRecorder.hpp>
+#include <CommonLib/SessionReplay.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <Server/ServerConfigAppComponent.hpp>
+#include <ServerLib/MetricsExporterAppComponent.hpp>
 #include <ServerLib/PlayerTokenAppComponent.hpp>
 #include <ServerLib/ServerInstanceAppComponent.hpp>
 #include <ServerLib/ServerPlanetEnvironment.hpp>
 #include <ServerLib/Session/InitialSessionHandler.hpp>
 #include <Nazara/Core/Application.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/Core.hpp>
 #include <Nazara/Core/FilesystemAppComponent.hpp>
 #include <Nazara/Core/SignalHandlerAppComponent.hpp>
@@ -19,10 +28,56 @@
 #include <Nazara/Physics3D/Physics3D.hpp>
 #include <NazaraUtils/PathUtils.hpp>
 #include <Main/Main.hpp>
+#include <fmt/chrono.h>
 #include <fmt/color.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	void ReplaySession(tsom::ServerInstance& instance, tsom::NetworkSessionManager& sessionManager, const tsom::SessionReplay& sessionReplay, bool realTime)
+	{
+		fmt::print("replaying {0} frames{1}...\n", sessionReplay.GetFrameCount(), (realTime) ? " in real time" : "");
+
+		Nz::Time maxUpdateTime = Nz::Time::Zero();
+		Nz::Time totalUpdateTime = Nz::Time::Zero();
+
+		Nz::Time replayStartTime = Nz::GetElapsedNanoseconds();
+		for (std::size_t frameIndex = 0; frameIndex < sessionReplay.GetFrameCount(); ++frameIndex)
+		{
+			const tsom::SessionReplay::Frame& frame = sessionReplay.GetFrame(frameIndex);
+			if (realTime)
+			{
+				Nz::Time replayTime = Nz::GetElapsedNanoseconds() - replayStartTime;
+				if (frame.timestamp > replayTime)
+					std::this_thread::sleep_for((frame.timestamp - replayTime).AsDuration<std::chrono::microseconds>());
+			}
+
+			Nz::Time updateStartTime = Nz::GetElapsedNanoseconds();
+
+			sessionReplay.InjectFrame(frameIndex, sessionManager);
+			instance.Update(frame.elapsedTime);
+
+			Nz::Time updateTime = Nz::GetElapsedNanoseconds() - updateStartTime;
+			maxUpdateTime = std::max(maxUpdateTime, updateTime);
+			totalUpdateTime += updateTime;
+		}
+
+		Nz::Time replayTime = Nz::GetElapsedNanoseconds() - replayStartTime;
+		Nz::Time recordedTime = (sessionReplay.GetFrameCount() > 0) ? sessionReplay.GetFrame(sessionReplay.GetFrameCount() - 1).timestamp : Nz::Time::Zero();
+		double averageUpdateTime = (sessionReplay.GetFrameCount() > 0) ? totalUpdateTime.AsSeconds<double>() * 1000.0 / sessionReplay.GetFrameCount() : 0.0;
+
+		fmt::print(fg(fmt::color::lime_green), "replayed {0:.1f}s of recorded traffic in {1:.1f}s (update time: {2:.2f}ms avg, {3:.2f}ms max)\n", recordedTime.AsSeconds<double>(), replayTime.AsSeconds<double>(), averageUpdateTime, maxUpdateTime.AsSeconds<double>() * 1000.0);
+	}
+}
 
 int ServerMain(int argc, char* argv[])
 {
+	// Declared before the application as they're referenced by the server instance until it's destroyed
+	tsom::MetricsRegistry metricsRegistry;
+	std::optional<tsom::SessionRecorder> sessionRecorder;
+
 	Nz::Application<Nz::Core, Nz::Physics3D, Nz::Network> app(argc, argv);
 
 	app.AddComponent<Nz::SignalHandlerAppComponent>();
@@ -44,24 +99,198 @@ int ServerMain(int argc, char* argv[])
 
 	auto& config = configAppComponent.GetConfig();
 
-	if (Nz::UInt32 maxStuckTime = config.GetIntegerValue<Nz::UInt32>("Server.MaxStuckSeconds"))
+	const Nz::CommandLineParameters& cmdParams = app.GetCommandLineParameters();
+
+	// Offline mode (see xmake train-chunk-dictionary), produces the chunk dictionary asset shipped with the game and the server, its id must be bumped once an asset was released
+	if (std::string_view dictionaryPath; cmdParams.GetParameter("train-chunk-dictionary", &dictionaryPath))
+	{
+		tsom::BlockLibrary blockLibrary;
+		std::shared_ptr<tsom::CompressionDictionary> dictionary = tsom::Planet::TrainChunkDictionary(blockLibrary, tsom::Constants::ChunkCompressionDictionaryId);
+		if (!dictionary || !dictionary->SaveToFile(Nz::Utf8Path(dictionaryPath)))
+		{
+			fmt::print(fg(fmt::color::red), "failed to train chunk dictionary to {0}\n", dictionaryPath);
+			return EXIT_FAILURE;
+		}
+
+		fmt::print(fg(fmt::color::lime_green), "trained chunk dictionary {0} ({1} bytes) to {2}\n", dictionary->GetId(), dictionary->GetContent().size(), dictionaryPath);
+		return EXIT_SUCCESS;
+	}
+
+	// Replay mode feeds a session recording to a headless instance instead of listening for players
+	std::optional<tsom::SessionReplay> sessionReplay;
+	if (std::string_view replayPath; cmdParams.GetParameter("replay", &replayPath))
+	{
+		try
+		{
+			sessionReplay.emplace(Nz::Utf8Path(replayPath));
+		}
+		catch (const std::exception& e)
+		{
+			fmt::print(fg(fmt::color::red), "{0}\n", e.what());
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (Nz::UInt32 maxStuckTime = config.GetIntegerValue<Nz::UInt32>("Server.MaxStuckSeconds"); maxStuckTime > 0 && !sessionReplay)
 		app.AddComponent<tsom::HealthCheckerAppComponent>(maxStuckTime);
 
-	Nz::UInt16 serverPort = config.GetIntegerValue<Nz::UInt16>("Server.Port");
+	Nz::UInt16 serverPort = (!sessionReplay) ? config.GetIntegerValue<Nz::UInt16>("Server.Port") : 0; //< 0 binds an ephemeral port on loopback only, replays don't accept connections
 	std::filesystem::path saveDirectory = Nz::Utf8Path(config.GetStringValue("Save.Directory"));
+	Nz::UInt32 planetSeed = 42;
+
+	if (sessionReplay)
+	{
+		// Work on a copy of the recorded save so replays don't alter it and can be run again
+		std::filesystem::path replaySaveDirectory = std::filesystem::temp_directory_path() / Nz::Utf8Path(fmt::format("tsom_replay_{0}", std::chrono::system_clock::now().time_since_epoch().count()));
+
+		std::error_code ec;
+		std::filesystem::create_directories(replaySaveDirectory, ec);
+		if (std::filesystem::path recordedSaveDirectory = Nz::Utf8Path(sessionReplay->GetHeader().saveDirectory); std::filesystem::is_directory(recordedSaveDirectory, ec))
+			std::filesystem::copy(recordedSaveDirectory, replaySaveDirectory, std::filesystem::copy_options::recursive, ec);
+		else
+			fmt::print(fg(fmt::color::yellow), "recorded save directory {0} is missing, replaying on a freshly generated world\n", sessionReplay->GetHeader().saveDirectory);
+
+		if (ec)
+		{
+			fmt::print(fg(fmt::color::red), "failed to copy recorded save to {0}: {1}\n", Nz::PathToString(replaySaveDirectory), ec.message());
+			return EXIT_FAILURE;
+		}
+
+		saveDirectory = std::move(replaySaveDirectory);
+		planetSeed = sessionReplay->GetHeader().seed;
+	}
+
+	auto ParseCodec = [&](std::string_view optionName) -> std::optional<tsom::CompressionCodec>
+	{
+		std::string_view codecName = config.GetStringValue(optionName);
+		std::optional<tsom::CompressionCodec> codec = tsom::BinaryCompressor::ParseCodec(codecName);
+		if (!codec)
+		{
+			fmt::print(fg(fmt::color::red), "{0}: unknown compression codec \"{1}\"\n", optionName, codecName);
+			return std::nullopt;
+		}
+
+		if (!tsom::BinaryCompressor::IsCodecSupported(*codec))
+		{
+			fmt::print(fg(fmt::color::red), "{0}: compression codec \"{1}\" is not supported by this build\n", optionName, codecName);
+			return std::nullopt;
+		}
+
+		return codec;
+	};
+
+	std::optional<tsom::CompressionCodec> chunkCodec = ParseCodec("Compression.ChunkCodec");
+	std::optional<tsom::CompressionCodec> shipCodec = ParseCodec("Compression.ShipCodec");
+	if (!chunkCodec || !shipCodec)
+		return EXIT_FAILURE;
+
+	tsom::TickProfiler::SetThreadName("Main");
+	tsom::TickProfiler::Enable(config.GetBoolValue("Profiler.Enabled"));
 
 	tsom::ServerInstance::Config instanceConfig;
+	instanceConfig.chunkCompression.codec = *chunkCodec;
+	instanceConfig.chunkCompression.acceleration = config.GetIntegerValue<int>("Compression.ChunkAcceleration");
+	instanceConfig.chunkCompression.level = config.GetIntegerValue<int>("Compression.ChunkLevel");
+	instanceConfig.shipCompression.codec = *shipCodec;
+
+	if (config.GetBoolValue("Compression.ChunkDictionary"))
+	{
+		// Clients ship the same asset and advertise its id during the handshake, sessions without it don't use the dictionary
+		std::filesystem::path dictionaryPath = Nz::Utf8Path(tsom::Constants::ChunkCompressionDictionaryPath);
+		std::shared_ptr<tsom::CompressionDictionary> chunkDictionary = tsom::CompressionDictionary::LoadFromFile(dictionaryPath);
+		if (!chunkDictionary)
+			fmt::print(fg(fmt::color::red), "failed to load chunk dictionary from {0}, chunks will be compressed without it\n", Nz::PathToString(dictionaryPath));
+		else if (chunkDictionary->GetId() != tsom::Constants::ChunkCompressionDictionaryId)
+			fmt::print(fg(fmt::color::red), "chunk dictionary {0} has id {1} (expected {2}), chunks will be compressed without it\n", Nz::PathToString(dictionaryPath), chunkDictionary->GetId(), tsom::Constants::ChunkCompressionDictionaryId);
+		else
+			instanceConfig.chunkCompression.dictionary = std::move(chunkDictionary);
+	}
+
+	instanceConfig.dumpProfileOnTickOverrun = config.GetBoolValue("Profiler.DumpOnTickOverrun");
+	instanceConfig.profileDirectory = Nz::Utf8Path(config.GetStringValue("Profiler.Directory"));
+	instanceConfig.parallelDispatch = config.GetBoolValue("Server.ParallelDispatch");
 	instanceConfig.pauseWhenEmpty = config.GetBoolValue("Server.SleepWhenEmpty");
 	instanceConfig.saveInterval = Nz::Time::Seconds(config.GetIntegerValue<long long>("Save.Interval"));
 	instanceConfig.connectionTokenEncryptionKey = config.GetConnectionTokenEncryptionKey();
+	instanceConfig.scriptBudget.callInstructions = config.GetIntegerValue<Nz::UInt64>("Scripting.CallInstructionBudget");
+	instanceConfig.scriptBudget.callTime = Nz::Time::Milliseconds(config.GetIntegerValue<long long>("Scripting.CallTimeBudget"));
+	instanceConfig.scriptBudget.tickTime = Nz::Time::Milliseconds(config.GetIntegerValue<long long>("Scripting.TickTimeBudget"));
+
+	// Time budgets depend on the machine load and would make replays diverge, only keep the instruction budget
+	if (sessionReplay)
+	{
+		instanceConfig.scriptBudget.callTime = Nz::Time::Zero();
+		instanceConfig.scriptBudget.tickTime = Nz::Time::Zero();
+	}
+
+	if (config.GetBoolValue("Metrics.Enabled") && !sessionReplay)
+	{
+		tsom::MetricsExporterAppComponent::Config metricsConfig;
+		metricsConfig.exportPath = Nz::Utf8Path(config.GetStringValue("Metrics.File"));
+		metricsConfig.exportInterval = Nz::Time::Seconds(config.GetIntegerValue<long long>("Metrics.ExportInterval"));
+		metricsConfig.httpPort = config.GetIntegerValue<Nz::UInt16>("Metrics.HttpPort");
+
+		app.AddComponent<tsom::MetricsExporterAppComponent>(metricsRegistry, std::move(metricsConfig));
+		instanceConfig.metricsRegistry = &metricsRegistry;
+	}
+
+	if (config.GetBoolValue("Recording.Enabled") && !sessionReplay)
+	{
+		std::filesystem::path recordingDirectory = Nz::Utf8Path(config.GetStringValue("Recording.Directory"));
+		std::string recordingName = fmt::format("{0:%Y%m%d_%H%M%S}", std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+
+		// Snapshot the save as it was when recording started, so replays start from the same world
+		std::filesystem::path saveSnapshotDirectory = recordingDirectory / Nz::Utf8Path(recordingName + "_save");
+
+		std::error_code ec;
+		std::filesystem::create_directories(saveSnapshotDirectory, ec);
+		if (!ec && std::filesystem::is_directory(saveDirectory, ec))
+			std::filesystem::copy(saveDirectory, saveSnapshotDirectory, std::filesystem::copy_options::recursive, ec);
+
+		if (ec)
+		{
+			fmt::print(fg(fmt::color::red), "failed to snapshot save directory to {0}: {1}\n", Nz::PathToString(saveSnapshotDirectory), ec.message());
+			return EXIT_FAILURE;
+		}
+
+		tsom::SessionRecorder::Header recordingHeader;
+		recordingHeader.saveDirectory = Nz::PathToString(saveSnapshotDirectory);
+		recordingHeader.seed = planetSeed;
+
+		try
+		{
+			sessionRecorder.emplace(recordingDirectory / Nz::Utf8Path(recordingName + ".tsrec"), recordingHeader);
+		}
+		catch (const std::exception& e)
+		{
+			fmt::print(fg(fmt::color::red), "failed to start session recording: {0}\n", e.what());
+			return EXIT_FAILURE;
+		}
+
+		fmt::print("recording sessions to {0}\n", Nz::PathToString(sessionRecorder->GetFilePath()));
+		instanceConfig.sessionRecorder = &*sessionRecorder;
+	}
 
 	auto& instance = worldAppComponent.AddInstance(instanceConfig);
 	auto& sessionManager = instance.AddSessionManager(serverPort);
 	sessionManager.SetDefaultHandler<tsom::InitialSessionHandler>(std::ref(instance));
 
-	tsom::ServerPlanetEnvironment planet(instance, saveDirectory, 42, Nz::Vector3ui(5));
+	tsom::ServerPlanetEnvironment planet(instance, saveDirectory, planetSeed, Nz::Vector3ui(5));
 	instance.SetDefaultSpawnpoint(&planet, Nz::Vector3f::Up() * 100.f + Nz::Vector3f::Backward() * 5.f, Nz::Quaternionf::Identity());
 
+	if (sessionReplay)
+	{
+		// Replayed peers aren't connected, acknowledge their packets so reliable and bulk transfers keep flowing
+		sessionManager.GetReactor().EnableFakePeers();
+
+		ReplaySession(instance, sessionManager, *sessionReplay, cmdParams.HasFlag("replay-realtime"));
+
+		std::error_code ec;
+		std::filesystem::remove_all(saveDirectory, ec);
+
+		return EXIT_SUCCESS;
+	}
+
 	fmt::print(fg(fmt::color::lime_green), "server ready.\n");
 
 	return app.Run();
@@ -0,0 +1,99 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <ServerLib/MetricsExporterAppComponent.hpp>
+#include <ServerLib/ServerConstants.hpp>
+#include <Nazara/Network/IpAddress.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <fmt/color.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+
+namespace tsom
+{
+	MetricsExporterAppComponent::MetricsExporterAppComponent(Nz::ApplicationBase& app, MetricsRegistry& registry, Config config) :
+	ApplicationComponent(app),
+	m_exportPath(std::move(config.exportPath)),
+	m_exportInterval(config.exportInterval),
+	m_registry(registry)
+	{
+		if (config.httpPort != 0)
+		{
+			// Metrics are not meant to be public, only listen on loopback (use a reverse proxy to expose them)
+			Nz::IpAddress listenAddress = Nz::IpAddress::LoopbackIpV4;
+			listenAddress.SetPort(config.httpPort);
+
+			m_httpServer.emplace();
+			if (m_httpServer->Listen(listenAddress) == Nz::SocketState::Bound)
+				m_httpServer->EnableBlocking(false);
+			else
+			{
+				fmt::print(fg(fmt::color::red), "failed to listen on {0} for metrics HTTP endpoint\n", listenAddress.ToString());
+				m_httpServer.reset();
+			}
+		}
+	}
+
+	void MetricsExporterAppComponent::Update(Nz::Time /*elapsedTime*/)
+	{
+		if (!m_exportPath.empty() && m_exportClock.RestartIfOver(m_exportInterval))
+			ExportToFile();
+
+		if (m_httpServer)
+			PollHttpClients();
+	}
+
+	void MetricsExporterAppComponent::ExportToFile()
+	{
+		if (!m_registry.WriteToFile(m_exportPath))
+			fmt::print(fg(fmt::color::red), "failed to write metrics to {0}\n", Nz::PathToString(m_exportPath));
+	}
+
+	void MetricsExporterAppComponent::PollHttpClients()
+	{
+		for (;;)
+		{
+			auto client = std::make_unique<HttpClient>();
+			if (!m_httpServer->AcceptClient(&client->socket))
+				break;
+
+			client->socket.EnableBlocking(false);
+			m_httpClients.push_back(std::move(client));
+		}
+
+		auto it = std::remove_if(m_httpClients.begin(), m_httpClients.end(), [&](std::unique_ptr<HttpClient>& client)
+		{
+			std::array<char, 1024> buffer;
+			std::size_t received;
+			while (client->socket.Receive(buffer.data(), buffer.size(), &received) && received > 0)
+			{
+				client->request.append(buffer.data(), received);
+				if (client->request.size() > Constants::MetricsHttpMaxRequestSize)
+					return true;
+			}
+
+			if (client->socket.GetState() != Nz::SocketState::Connected)
+				return true;
+
+			// Only the request line matters, we reply with the metrics to any complete request
+			if (client->request.find("\r\n\r\n") == std::string::npos)
+				return client->connectionClock.GetElapsedTime() > Constants::MetricsHttpRequestTimeout;
+
+			bool isGetRequest = client->request.starts_with("GET ");
+
+			std::string body = (isGetRequest) ? m_registry.ToPrometheusText() : std::string{};
+			std::string response = fmt::format("HTTP/1.1 {0}\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: {1}\r\nConnection: close\r\n\r\n", (isGetRequest) ? "200 OK" : "405 Method Not Allowed", body.size());
+			response += body;
+
+			// Response is small and the peer is local, send it in one go
+			client->socket.EnableBlocking(true);
+			client->socket.Send(response.data(), response.size());
+			client->socket.Disconnect();
+
+			return true;
+		});
+		m_httpClients.erase(it, m_httpClients.end());
+	}
+}
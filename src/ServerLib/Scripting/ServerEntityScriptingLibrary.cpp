@@ -5,7 +5,10 @@
 #include <ServerLib/Scripting/ServerEntityScriptingLibrary.hpp>
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/ScriptedEntityComponent.hpp>
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
 #include <CommonLib/Scripting/ScriptingUtils.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
+#include <ServerLib/ServerEnvironment.hpp>
 #include <ServerLib/ServerPlanetEnvironment.hpp>
 #include <ServerLib/ServerPlayer.hpp>
 #include <ServerLib/ServerShipEnvironment.hpp>
@@ -31,6 +34,22 @@ namespace tsom
 			instance.TriggerClientRpc(rpcIndex, targetPlayer.value_or(ServerPlayerHandle{}));
 		});
 
+		entityMetatable["CancelTimer"] = LuaFunction([](sol::table entityTable, Nz::Int64 timerId) -> bool
+		{
+			entt::handle entity = AssertScriptEntity(entityTable);
+
+			ServerEnvironment** environment = entity.registry()->ctx().find<ServerEnvironment*>();
+			if (!environment)
+				throw std::runtime_error("no environment found");
+
+			// Entities can only cancel their own timers
+			TimerWheel& timerWheel = (*environment)->GetTimerWheel();
+			if (timerWheel.GetTimerOwner(static_cast<TimerWheel::TimerId>(timerId)) != entity.entity())
+				return false;
+
+			return timerWheel.CancelTimer(static_cast<TimerWheel::TimerId>(timerId));
+		});
+
 		entityMetatable["GetEnvironment"] = LuaFunction([](sol::this_state L, sol::table entityTable) -> sol::object
 		{
 			entt::handle entity = AssertScriptEntity(entityTable);
@@ -57,6 +76,46 @@ namespace tsom
 
 			interactibleComponent->isEnabled = isInteractible;
 		});
+
+		entityMetatable["SetTimer"] = LuaFunction([this](sol::this_state L, sol::table entityTable, double delay, sol::protected_function callback, std::optional<bool> isRepeating) -> Nz::Int64
+		{
+			entt::handle entity = AssertScriptEntity(entityTable);
+			if (!(delay >= 0.0))
+				TriggerLuaArgError(L, 2, "timer delay must be positive");
+
+			ServerEnvironment** environment = entity.registry()->ctx().find<ServerEnvironment*>();
+			if (!environment)
+				throw std::runtime_error("no environment found");
+
+			// Timers are triggered once per tick, round the delay up to the next tick
+			Nz::Int64 tickDuration = (*environment)->GetServerInstance().GetTickDuration().AsMicroseconds();
+			Nz::Int64 delayDuration = Nz::Time::Seconds(delay).AsMicroseconds();
+			Nz::UInt64 delayTicks = std::max<Nz::UInt64>(static_cast<Nz::UInt64>((delayDuration + tickDuration - 1) / tickDuration), 1);
+
+			auto timerCallback = [this, entity, cb = std::move(callback)]
+			{
+				auto& entityScripted = entity.get<ScriptedEntityComponent>();
+
+				TickProfiler::Zone profileZone("Script timer callback");
+				auto res = GetCpuMonitor().Call(cb, entityScripted.classCpuStats, &entityScripted.cpuStats, entityScripted.entityTable);
+				if (!res.valid())
+				{
+					sol::error err = res;
+					fmt::print(fg(fmt::color::red), "entity timer callback failed: {}\n", err.what());
+				}
+			};
+
+			// Timers are owned by the entity, ServerEnvironment cancels them when it's destroyed
+			TimerWheel& timerWheel = (*environment)->GetTimerWheel();
+
+			TimerWheel::TimerId timerId;
+			if (isRepeating.value_or(false))
+				timerId = timerWheel.AddRepeatingTimer(delayTicks, std::move(timerCallback), entity.entity());
+			else
+				timerId = timerWheel.AddTimer(delayTicks, std::move(timerCallback), entity.entity());
+
+			return static_cast<Nz::Int64>(timerId);
+		});
 	}
 
 	void ServerEntityScriptingLibrary::HandleInit(sol::table classMetatable, entt::handle entity)
@@ -66,11 +125,12 @@ namespace tsom
 		{
 			auto& entityInteractible = entity.emplace<ServerInteractibleComponent>();
 			entityInteractible.isEnabled = false;
-			entityInteractible.onInteraction = [cb = std::move(*interactCallback)](entt::handle entity, ServerPlayer* triggeringPlayer)
+			entityInteractible.onInteraction = [this, cb = std::move(*interactCallback)](entt::handle entity, ServerPlayer* triggeringPlayer)
 			{
 				auto& entityScripted = entity.get<ScriptedEntityComponent>();
 
-				auto res = cb(entityScripted.entityTable, (triggeringPlayer) ? triggeringPlayer->CreateHandle() : Nz::ObjectHandle<ServerPlayer>{});
+				TickProfiler::Zone profileZone("Script interact callback");
+				auto res = GetCpuMonitor().Call(cb, entityScripted.classCpuStats, &entityScripted.cpuStats, entityScripted.entityTable, (triggeringPlayer) ? triggeringPlayer->CreateHandle() : Nz::ObjectHandle<ServerPlayer>{});
 				if (!res.valid())
 				{
 					sol::error err = res;
@@ -3,7 +3,9 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <ServerLib/ServerEnvironment.hpp>
+#include <CommonLib/Components/ScriptedEntityComponent.hpp>
 #include <CommonLib/Physics/PhysicsSettings.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/Systems/EnvironmentProxySystem.hpp>
 #include <ServerLib/Systems/NetworkedEntitiesSystem.hpp>
 #include <Nazara/Physics3D/Systems/Physics3DSystem.hpp>
@@ -19,6 +21,8 @@ namespace tsom
 		auto& registry = m_world->GetRegistry();
 		registry.ctx().insert_or_assign<ServerEnvironment*>(this);
 
+		m_scriptedEntityDestroyConnection = registry.on_destroy<ScriptedEntityComponent>().connect<&ServerEnvironment::OnScriptedEntityDestroy>(this);
+
 		m_world->AddSystem<EnvironmentProxySystem>();
 		m_world->AddSystem<NetworkedEntitiesSystem>(*this);
 
@@ -35,6 +39,9 @@ namespace tsom
 		auto& registry = m_world->GetRegistry();
 		registry.clear();
 
+		// The registry is moved out below
+		m_scriptedEntityDestroyConnection.release();
+
 		ForEachPlayer([this](ServerPlayer& player)
 		{
 			player.RemoveFromEnvironment(this);
@@ -79,6 +86,14 @@ namespace tsom
 
 	void ServerEnvironment::OnTick(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("ServerEnvironment::OnTick");
+
+		// Timers run before systems so their effects are replicated during the same tick
+		{
+			TickProfiler::Zone timerZone("ServerEnvironment::Timers");
+			m_timerWheel.Advance();
+		}
+
 		m_world->Update(elapsedTime);
 	}
 
@@ -94,6 +109,11 @@ namespace tsom
 		m_registeredPlayers.Reset(player->GetPlayerIndex());
 	}
 
+	void ServerEnvironment::OnScriptedEntityDestroy(entt::registry& /*registry*/, entt::entity entity)
+	{
+		m_timerWheel.CancelTimers(entity);
+	}
+
 	void ServerEnvironment::UpdateConnectedTransform(ServerEnvironment& environment, const EnvironmentTransform& transform)
 	{
 		auto it = m_connectedEnvironments.find(&environment);
@@ -4,33 +4,100 @@
 
 #include <ServerLib/ServerInstance.hpp>
 #include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/SessionRecorder.hpp>
+#include <CommonLib/Components/PlanetComponent.hpp>
+#include <CommonLib/Components/ShipComponent.hpp>
 #include <CommonLib/Entities/ChunkClassLibrary.hpp>
 #include <CommonLib/Scripting/MathScriptingLibrary.hpp>
 #include <CommonLib/Scripting/SharedScriptingLibrary.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
+#include <ServerLib/ServerConstants.hpp>
 #include <ServerLib/ServerPlanetEnvironment.hpp>
 #include <ServerLib/Scripting/ServerEntityScriptingLibrary.hpp>
 #include <ServerLib/Scripting/ServerScriptingLibrary.hpp>
 #include <Nazara/Core/ApplicationBase.hpp>
+#include <Nazara/Core/TaskSchedulerAppComponent.hpp>
+#include <Nazara/Core/Components/NodeComponent.hpp>
 #include <Nazara/Physics3D/Systems/Physics3DSystem.hpp>
+#include <fmt/chrono.h>
 #include <fmt/color.h>
 #include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <span>
 
 namespace tsom
 {
+	namespace
+	{
+		// Shared between the tick thread and the scheduler tasks of a visibility dispatch, as tasks may only start once every player was dispatched
+		struct DispatchGroup
+		{
+			std::atomic_size_t nextPlayer = 0;
+			std::condition_variable dispatchedCondition;
+			std::mutex dispatchedMutex;
+			std::size_t remainingPlayers;
+			std::span<ServerPlayer* const> players;
+			Nz::UInt16 tickIndex;
+		};
+
+		void DispatchPlayers(DispatchGroup& dispatchGroup)
+		{
+			for (;;)
+			{
+				std::size_t playerIndex = dispatchGroup.nextPlayer.fetch_add(1, std::memory_order_relaxed);
+				if (playerIndex >= dispatchGroup.players.size())
+					break;
+
+				{
+					TickProfiler::Zone profileZone("SessionVisibilityHandler::Dispatch");
+					dispatchGroup.players[playerIndex]->GetVisibilityHandler().Dispatch(dispatchGroup.tickIndex);
+				}
+
+				std::lock_guard lock(dispatchGroup.dispatchedMutex);
+				if (--dispatchGroup.remainingPlayers == 0)
+					dispatchGroup.dispatchedCondition.notify_one();
+			}
+		}
+	}
+
 	ServerInstance::ServerInstance(Nz::ApplicationBase& application, Config config) :
 	m_connectionTokenEncryptionKey(config.connectionTokenEncryptionKey),
+	m_profileDirectory(std::move(config.profileDirectory)),
 	m_players(256),
 	m_saveInterval(config.saveInterval),
 	m_tickAccumulator(Nz::Time::Zero()),
 	m_tickDuration(Constants::TickDuration),
 	m_tickIndex(0),
 	m_application(application),
+	m_metricsRegistry(config.metricsRegistry),
+	m_tickOverrunCounter(nullptr),
+	m_saveDurationHistogram(nullptr),
+	m_tickDurationHistogram(nullptr),
+	m_sessionRecorder(config.sessionRecorder),
+	m_chunkCompressionProfile(std::move(config.chunkCompression)),
+	m_shipCompressionProfile(std::move(config.shipCompression)),
 	m_scriptingContext(application),
+	m_dumpProfileOnTickOverrun(config.dumpProfileOnTickOverrun),
+	m_parallelDispatch(config.parallelDispatch),
 	m_pauseWhenEmpty(config.pauseWhenEmpty)
 	{
 		m_entityRegistry.RegisterClassLibrary<ChunkClassLibrary>(m_application, m_blockLibrary);
 
+		if (m_metricsRegistry)
+		{
+			m_tickOverrunCounter = &m_metricsRegistry->GetCounter("tsom_tick_overruns_total", "Ticks which took longer than the tick duration");
+			m_saveDurationHistogram = &m_metricsRegistry->GetHistogram("tsom_save_duration_seconds", "Time spent saving environments", MetricsRegistry::ExponentialBuckets(0.001, 4.0, 8));
+			m_tickDurationHistogram = &m_metricsRegistry->GetHistogram("tsom_tick_duration_seconds", "Time spent processing a tick", { 0.001, 0.0025, 0.005, 0.0075, 0.01, 0.0125, 0.015, Constants::TickDuration.AsSeconds<double>(), 0.025, 0.05, 0.1, 0.25 });
+		}
+
+		m_scriptingContext.GetCpuMonitor().UpdateBudget(config.scriptBudget);
+
 		m_scriptingContext.RegisterLibrary<MathScriptingLibrary>();
 		m_scriptingContext.RegisterLibrary<SharedScriptingLibrary>();
 		ServerEntityScriptingLibrary& entityScriptingLibrary = m_scriptingContext.RegisterLibrary<ServerEntityScriptingLibrary>(m_entityRegistry);
@@ -149,6 +216,18 @@ namespace tsom
 		m_players.Free(playerIndex);
 	}
 
+	std::optional<std::filesystem::path> ServerInstance::DumpTickProfile(std::string_view reason)
+	{
+		std::filesystem::path profilePath = m_profileDirectory / Nz::Utf8Path(fmt::format("{0:%Y%m%d_%H%M%S}_{1}.json", std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()), reason));
+		if (!TickProfiler::WriteChromeTrace(profilePath))
+		{
+			fmt::print(fg(fmt::color::red), "failed to write tick profile to {0}\n", Nz::PathToString(profilePath));
+			return std::nullopt;
+		}
+
+		return profilePath;
+	}
+
 	std::unique_ptr<Nz::EnttWorld> ServerInstance::RegisterEnvironment(ServerEnvironment* environment)
 	{
 		assert(std::find(m_environments.begin(), m_environments.end(), environment) == m_environments.end());
@@ -176,11 +255,21 @@ namespace tsom
 
 	Nz::Time ServerInstance::Update(Nz::Time elapsedTime)
 	{
+		// Session events polled below are recorded as part of this frame, so replaying them with the same elapsed time reproduces the ticks
+		if (m_sessionRecorder)
+			m_sessionRecorder->BeginFrame(elapsedTime, m_tickIndex);
+
 		if (m_saveClock.RestartIfOver(m_saveInterval))
 			OnSave();
 
-		for (auto&& sessionManagerPtr : m_sessionManagers)
-			sessionManagerPtr->Poll();
+		if (m_metricsRegistry && m_metricsClock.RestartIfOver(Constants::MetricsUpdateInterval))
+			UpdateMetrics();
+
+		{
+			TickProfiler::Zone profileZone("NetworkSessionManager::Poll");
+			for (auto&& sessionManagerPtr : m_sessionManagers)
+				sessionManagerPtr->Poll();
+		}
 
 		// No player? Pause instance for 100ms
 		if (m_pauseWhenEmpty && m_players.begin() == m_players.end())
@@ -189,8 +278,25 @@ namespace tsom
 		m_tickAccumulator += elapsedTime;
 		while (m_tickAccumulator >= m_tickDuration)
 		{
+			Nz::Time tickStartTime = Nz::GetElapsedNanoseconds();
 			OnTick(m_tickDuration);
 			m_tickAccumulator -= m_tickDuration;
+
+			Nz::Time tickTime = Nz::GetElapsedNanoseconds() - tickStartTime;
+			if (m_tickDurationHistogram)
+				m_tickDurationHistogram->Observe(tickTime.AsSeconds<double>());
+
+			if (tickTime > m_tickDuration)
+			{
+				if (m_tickOverrunCounter)
+					m_tickOverrunCounter->Increment();
+
+				if (m_dumpProfileOnTickOverrun && TickProfiler::IsEnabled() && m_profileDumpClock.RestartIfOver(Constants::TickProfileDumpMinInterval))
+				{
+					if (std::optional<std::filesystem::path> profilePath = DumpTickProfile(fmt::format("tick{0}_overrun", m_tickIndex)))
+						fmt::print(fg(fmt::color::yellow), "tick {0} took {1}ms (max: {2}ms), profile written to {3}\n", m_tickIndex, tickTime.AsMilliseconds(), m_tickDuration.AsMilliseconds(), Nz::PathToString(*profilePath));
+				}
+			}
 		}
 
 		return m_tickDuration - m_tickAccumulator;
@@ -216,6 +322,8 @@ namespace tsom
 
 	void ServerInstance::OnNetworkTick()
 	{
+		TickProfiler::Zone profileZone("ServerInstance::OnNetworkTick");
+
 		// Handle disconnected players
 		for (std::size_t playerIndex : m_disconnectedPlayers.IterBits())
 		{
@@ -293,30 +401,171 @@ namespace tsom
 		}
 		m_newPlayers.Clear();
 
+		// Visibility dispatch only reads the world, run it in parallel for every player and hand their packets to the network once done
+		// (packets are buffered per session, so each player receives the same packet stream as if dispatching sequentially)
+		m_dispatchedPlayers.clear();
 		ForEachPlayer([&](ServerPlayer& serverPlayer)
 		{
-			serverPlayer.GetVisibilityHandler().Dispatch(m_tickIndex);
+			serverPlayer.GetVisibilityHandler().PrepareDispatch();
+			m_dispatchedPlayers.push_back(&serverPlayer);
 		});
+
+		TickProfiler::Zone dispatchProfileZone("Visibility dispatch");
+		if (m_parallelDispatch && m_dispatchedPlayers.size() > 1)
+		{
+			for (ServerPlayer* serverPlayer : m_dispatchedPlayers)
+			{
+				if (NetworkSession* session = serverPlayer->GetSession())
+					session->BeginPacketBuffering();
+			}
+
+			std::shared_ptr<DispatchGroup> dispatchGroup = std::make_shared<DispatchGroup>();
+			dispatchGroup->players = m_dispatchedPlayers;
+			dispatchGroup->remainingPlayers = m_dispatchedPlayers.size();
+			dispatchGroup->tickIndex = m_tickIndex;
+
+			// The application scheduler also runs unrelated jobs (chunk colliders, saves): the tick thread dispatches players as well
+			// and only waits for the dispatches of this tick, instead of waiting for the scheduler to be idle
+			auto& taskScheduler = m_application.GetComponent<Nz::TaskSchedulerAppComponent>();
+			std::size_t taskCount = std::min<std::size_t>(taskScheduler.GetWorkerCount(), m_dispatchedPlayers.size() - 1);
+			for (std::size_t i = 0; i < taskCount; ++i)
+			{
+				taskScheduler.AddTask([dispatchGroup]
+				{
+					DispatchPlayers(*dispatchGroup);
+				});
+			}
+
+			DispatchPlayers(*dispatchGroup);
+
+			std::unique_lock lock(dispatchGroup->dispatchedMutex);
+			dispatchGroup->dispatchedCondition.wait(lock, [&] { return dispatchGroup->remainingPlayers == 0; });
+			lock.unlock();
+
+			for (ServerPlayer* serverPlayer : m_dispatchedPlayers)
+			{
+				if (NetworkSession* session = serverPlayer->GetSession())
+					session->FlushBufferedPackets();
+			}
+		}
+		else
+		{
+			for (ServerPlayer* serverPlayer : m_dispatchedPlayers)
+			{
+				TickProfiler::Zone profileZone("SessionVisibilityHandler::Dispatch");
+				serverPlayer->GetVisibilityHandler().Dispatch(m_tickIndex);
+			}
+		}
 	}
 
 	void ServerInstance::OnSave()
 	{
+		TickProfiler::Zone profileZone("ServerInstance::OnSave");
+
+		Nz::Time saveStartTime = Nz::GetElapsedNanoseconds();
+
 		for (ServerEnvironment* env : m_environments)
 			env->OnSave();
+
+		if (m_saveDurationHistogram)
+			m_saveDurationHistogram->Observe((Nz::GetElapsedNanoseconds() - saveStartTime).AsSeconds<double>());
 	}
 
 	void ServerInstance::OnTick(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("ServerInstance::OnTick");
+
 		m_tickIndex++;
 
-		ForEachPlayer([&](ServerPlayer& serverPlayer)
 		{
-			serverPlayer.Tick();
-		});
+			TickProfiler::Zone playerProfileZone("ServerPlayer::Tick");
+			ForEachPlayer([&](ServerPlayer& serverPlayer)
+			{
+				serverPlayer.Tick();
+			});
+		}
 
 		for (ServerEnvironment* env : m_environments)
 			env->OnTick(elapsedTime);
 
 		OnNetworkTick();
+
+		// Scripts triggered while polling sessions are accounted on the next tick
+		m_scriptingContext.GetCpuMonitor().ResetTickTime();
+	}
+
+	void ServerInstance::UpdateMetrics()
+	{
+		assert(m_metricsRegistry);
+
+		std::size_t playerCount = 0;
+		ForEachPlayer([&](const ServerPlayer& /*serverPlayer*/)
+		{
+			playerCount++;
+		});
+
+		m_metricsRegistry->GetGauge("tsom_players", "Connected players").Set(static_cast<double>(playerCount));
+
+		struct EnvironmentStats
+		{
+			ServerEnvironmentType type;
+			std::string_view name;
+			std::size_t chunkCount = 0;
+			std::size_t entityCount = 0;
+			std::size_t environmentCount = 0;
+			std::size_t pendingColliderJobCount = 0;
+		};
+
+		std::array<EnvironmentStats, 2> environmentStats = {
+			EnvironmentStats{ .type = ServerEnvironmentType::Planet, .name = "planet" },
+			EnvironmentStats{ .type = ServerEnvironmentType::Ship, .name = "ship" }
+		};
+
+		for (ServerEnvironment* environment : m_environments)
+		{
+			auto it = std::find_if(environmentStats.begin(), environmentStats.end(), [&](const EnvironmentStats& stats) { return stats.type == environment->GetType(); });
+			assert(it != environmentStats.end());
+
+			EnvironmentStats& stats = *it;
+			stats.environmentCount++;
+
+			entt::registry& registry = environment->GetWorld().GetRegistry();
+			stats.entityCount += registry.view<Nz::NodeComponent>().size();
+
+			for (auto&& [entity, planetComponent] : registry.view<PlanetComponent>().each())
+			{
+				stats.chunkCount += planetComponent.planet->GetChunkCount();
+				if (planetComponent.planetEntities)
+					stats.pendingColliderJobCount += planetComponent.planetEntities->GetPendingJobCount();
+			}
+
+			for (auto&& [entity, shipComponent] : registry.view<ShipComponent>().each())
+			{
+				stats.chunkCount += shipComponent.ship->GetChunkCount();
+				if (shipComponent.shipEntities)
+					stats.pendingColliderJobCount += shipComponent.shipEntities->GetPendingJobCount();
+			}
+		}
+
+		for (const EnvironmentStats& stats : environmentStats)
+		{
+			MetricsRegistry::Labels labels = { { "type", std::string(stats.name) } };
+
+			m_metricsRegistry->GetGauge("tsom_environments", "Loaded environments", labels).Set(static_cast<double>(stats.environmentCount));
+			m_metricsRegistry->GetGauge("tsom_environment_entities", "Entities with a position, by environment type", labels).Set(static_cast<double>(stats.entityCount));
+			m_metricsRegistry->GetGauge("tsom_loaded_chunks", "Loaded chunks, by environment type", labels).Set(static_cast<double>(stats.chunkCount));
+			m_metricsRegistry->GetGauge("tsom_pending_collider_jobs", "Chunk collider jobs waiting to be applied, by environment type", labels).Set(static_cast<double>(stats.pendingColliderJobCount));
+		}
+
+		std::size_t incomingQueueSize = 0;
+		std::size_t outgoingQueueSize = 0;
+		for (auto&& sessionManagerPtr : m_sessionManagers)
+		{
+			incomingQueueSize += sessionManagerPtr->GetReactor().GetIncomingQueueSize();
+			outgoingQueueSize += sessionManagerPtr->GetReactor().GetOutgoingQueueSize();
+		}
+
+		m_metricsRegistry->GetGauge("tsom_network_queue_size", "Events waiting in network reactor queues", { { "queue", "incoming" } }).Set(static_cast<double>(incomingQueueSize));
+		m_metricsRegistry->GetGauge("tsom_network_queue_size", "Events waiting in network reactor queues", { { "queue", "outgoing" } }).Set(static_cast<double>(outgoingQueueSize));
 	}
 }
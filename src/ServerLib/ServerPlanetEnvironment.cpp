@@ -5,6 +5,8 @@
 #include <ServerLib/ServerPlanetEnvironment.hpp>
 #include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/ChunkEntities.hpp>
+#include <CommonLib/ChunkSave.hpp>
+#include <CommonLib/FlatChunk.hpp>
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/PlanetComponent.hpp>
 #include <CommonLib/Systems/GravityPhysicsSystem.hpp>
@@ -28,11 +30,13 @@
 
 namespace tsom
 {
-	constexpr unsigned int chunkSaveVersion = 1;
+	constexpr unsigned int chunkSaveVersion = 3;
 
 	ServerPlanetEnvironment::ServerPlanetEnvironment(ServerInstance& serverInstance, std::filesystem::path savePath, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount) :
 	ServerEnvironment(serverInstance, ServerEnvironmentType::Planet),
-	m_savePath(std::move(savePath))
+	m_savePath(std::move(savePath)),
+	m_seed(seed),
+	m_chunkCount(chunkCount)
 	{
 		m_world->AddSystem<EnvironmentSwitchSystem>(this);
 		m_world->GetRegistry().ctx().emplace<ServerPlanetEnvironment*>(this);
@@ -77,6 +81,9 @@ namespace tsom
 
 	ServerPlanetEnvironment::~ServerPlanetEnvironment()
 	{
+		// Save tasks reference the planet
+		WaitForSave();
+
 		m_world->GetRegistry().ctx().erase<ServerPlanetEnvironment*>();
 
 		m_planetEntity.destroy();
@@ -107,26 +114,54 @@ namespace tsom
 		if (m_dirtyChunks.empty())
 			return;
 
+		// Don't let the previous save overwrite the files of this one
+		WaitForSave();
+
 		fmt::print("saving {} dirty chunks...\n", m_dirtyChunks.size());
 
 		if (!std::filesystem::is_directory(m_savePath))
 			std::filesystem::create_directories(m_savePath);
 
-		Nz::ByteArray byteArray;
+		std::string version = std::to_string(chunkSaveVersion);
+		Nz::File::WriteWhole(m_savePath / Nz::Utf8Path("version.txt"), version.data(), version.size());
+
+		SaveHeader();
+
+		auto& blockLibrary = m_serverInstance.GetBlockLibrary();
+		Planet& planet = *m_planetEntity.get<PlanetComponent>().planet;
+
+		auto& taskScheduler = m_serverInstance.GetApplication().GetComponent<Nz::TaskSchedulerAppComponent>();
+
+		std::shared_ptr<SaveJob> saveJob = std::make_shared<SaveJob>();
+		saveJob->remainingChunkCount = m_dirtyChunks.size();
+
+		// Regenerating chunks to diff them is too slow for the tick thread, chunks are saved from their snapshots by the task scheduler
 		for (const ChunkIndices& chunkIndices : m_dirtyChunks)
 		{
-			byteArray.Clear();
+			std::shared_ptr<const Chunk> chunk = planet.GetChunk(chunkIndices)->shared_from_this();
+			std::filesystem::path chunkPath = m_savePath / Nz::Utf8Path(fmt::format("{0:+}_{1:+}_{2:+}.chunk", chunkIndices.x, chunkIndices.y, chunkIndices.z));
 
-			Nz::ByteStream byteStream(&byteArray);
-			m_planetEntity.get<PlanetComponent>().planet->GetChunk(chunkIndices)->Serialize(byteStream);
+			taskScheduler.AddTask([&blockLibrary, &planet, saveJob, chunk = std::move(chunk), chunkPath = std::move(chunkPath), seed = m_seed, chunkCount = m_chunkCount]
+			{
+				// Regenerate the chunk to only save the blocks that differ from it
+				FlatChunk generatedChunk(blockLibrary, planet, chunk->GetIndices(), chunk->GetSize(), chunk->GetBlockSize());
+				planet.GenerateChunk(blockLibrary, generatedChunk, seed, chunkCount);
 
-			if (!Nz::File::WriteWhole(m_savePath / Nz::Utf8Path(fmt::format("{0:+}_{1:+}_{2:+}.chunk", chunkIndices.x, chunkIndices.y, chunkIndices.z)), byteArray.GetBuffer(), byteArray.GetSize()))
-				fmt::print(stderr, "failed to save chunk {}\n", fmt::streamed(chunkIndices));
+				Nz::ByteArray byteArray;
+				Nz::ByteStream byteStream(&byteArray);
+				if (SaveChunk(byteStream, *chunk, generatedChunk) == ChunkSaveFormat::Delta)
+					saveJob->deltaChunkCount++;
+
+				if (!Nz::File::WriteWhole(chunkPath, byteArray.GetBuffer(), byteArray.GetSize()))
+					fmt::print(stderr, "failed to save chunk {}\n", fmt::streamed(chunk->GetIndices()));
+
+				if (saveJob->remainingChunkCount.fetch_sub(1) == 1)
+					fmt::print("saved {} chunks as delta\n", saveJob->deltaChunkCount.load());
+			});
 		}
 		m_dirtyChunks.clear();
 
-		std::string version = std::to_string(chunkSaveVersion);
-		Nz::File::WriteWhole(m_savePath / Nz::Utf8Path("version.txt"), version.data(), version.size());
+		m_saveJob = std::move(saveJob);
 	}
 
 	void ServerPlanetEnvironment::LoadFromDirectory()
@@ -196,27 +231,164 @@ namespace tsom
 			didConvert = true;
 		}
 
+		if (saveVersion == 1)
+		{
+			// Chunk files are now prefixed by their save format, previous saves always stored the full chunk content
+			std::filesystem::path oldSave = m_savePath / Nz::Utf8Path("old1");
+			std::filesystem::create_directory(oldSave);
+			for (const auto& entry : std::filesystem::directory_iterator(m_savePath))
+			{
+				if (!entry.is_regular_file())
+					continue;
+
+				if (entry.path().extension() != Nz::Utf8Path(".chunk"))
+					continue;
+
+				std::filesystem::copy_file(entry.path(), oldSave / entry.path().filename());
+
+				auto contentOpt = Nz::File::ReadWhole(entry.path());
+				if (!contentOpt)
+				{
+					fmt::print(stderr, fg(fmt::color::red), "planet conversion: failed to read chunk {}\n", entry.path());
+					continue;
+				}
+
+				contentOpt->insert(contentOpt->begin(), static_cast<Nz::UInt8>(ChunkSaveFormat::Full));
+				if (!Nz::File::WriteWhole(entry.path(), contentOpt->data(), contentOpt->size()))
+					fmt::print(stderr, fg(fmt::color::red), "planet conversion: failed to write chunk {}\n", entry.path());
+			}
+
+			saveVersion++;
+			didConvert = true;
+		}
+
+		if (saveVersion == 2)
+		{
+			// Saves now store the generator parameters their deltas were computed against, previous saves had no way to tell so assume the current ones
+			SaveHeader();
+
+			saveVersion++;
+			didConvert = true;
+		}
+
 		if (didConvert)
 		{
 			std::string version = std::to_string(saveVersion);
 			Nz::File::WriteWhole(m_savePath / Nz::Utf8Path("version.txt"), version.data(), version.size());
 		}
 
-		m_planetEntity.get<PlanetComponent>().planet->ForEachChunk([&](const ChunkIndices& chunkIndices, Chunk& chunk)
+		auto& blockLibrary = m_serverInstance.GetBlockLibrary();
+		Planet& planet = *m_planetEntity.get<PlanetComponent>().planet;
+
+		PlanetSaveHeader currentHeader{ Planet::GeneratorVersion, m_seed, m_chunkCount };
+
+		std::optional<PlanetSaveHeader> savedHeader = LoadSaveHeader();
+		bool headerMismatch = !savedHeader || *savedHeader != currentHeader;
+		if (headerMismatch)
 		{
-			Nz::File chunkFile(m_savePath / Nz::Utf8Path(fmt::format("{0:+}_{1:+}_{2:+}.chunk", chunkIndices.x, chunkIndices.y, chunkIndices.z)), Nz::OpenMode::Read);
-			if (!chunkFile.IsOpen())
-				return;
+			if (!savedHeader || savedHeader->generatorVersion != Planet::GeneratorVersion)
+				fmt::print(stderr, fg(fmt::color::red), "planet save was made with another generator, delta chunks will be discarded\n");
+			else
+				fmt::print("planet save was made with another seed or chunk count, delta chunks will be converted to full chunks\n");
+		}
 
-			try
+		std::filesystem::path discardedSave = m_savePath / Nz::Utf8Path("discarded_deltas");
+
+		planet.ForEachChunk([&](const ChunkIndices& chunkIndices, Chunk& chunk)
+		{
+			std::filesystem::path chunkPath = m_savePath / Nz::Utf8Path(fmt::format("{0:+}_{1:+}_{2:+}.chunk", chunkIndices.x, chunkIndices.y, chunkIndices.z));
+
+			bool deltaRefused = false;
+			ChunkSaveFormat saveFormat = ChunkSaveFormat::Full;
 			{
-				Nz::ByteStream fileStream(&chunkFile);
-				chunk.Deserialize(fileStream);
+				Nz::File chunkFile(chunkPath, Nz::OpenMode::Read);
+				if (!chunkFile.IsOpen())
+					return;
+
+				try
+				{
+					Nz::ByteStream fileStream(&chunkFile);
+					saveFormat = LoadChunk(fileStream, chunk, [&](Chunk& generatedChunk)
+					{
+						// Deltas can only be applied on the chunk they were computed against
+						if (!savedHeader || savedHeader->generatorVersion != Planet::GeneratorVersion)
+						{
+							deltaRefused = true;
+							return false;
+						}
+
+						planet.GenerateChunk(blockLibrary, generatedChunk, savedHeader->seed, savedHeader->chunkCount);
+						return true;
+					});
+				}
+				catch (const std::exception& e)
+				{
+					fmt::print(stderr, fg(fmt::color::red), "failed to load chunk {}: {}\n", fmt::streamed(chunkIndices), e.what());
+					if (!deltaRefused)
+						return;
+				}
+			}
+
+			if (deltaRefused)
+			{
+				// Keep the discarded delta aside, as it would be applied on the wrong chunk once the header is updated
+				std::filesystem::create_directory(discardedSave);
+				std::filesystem::rename(chunkPath, discardedSave / chunkPath.filename());
+				return;
 			}
-			catch (const std::exception& e)
+
+			if (headerMismatch && saveFormat == ChunkSaveFormat::Delta)
 			{
-				fmt::print(stderr, fg(fmt::color::red), "failed to load chunk {}: {}\n", fmt::streamed(chunkIndices), e.what());
+				// The delta was computed against other generator parameters, store the whole chunk before updating the header
+				Nz::ByteArray byteArray;
+				Nz::ByteStream byteStream(&byteArray);
+				SaveFullChunk(byteStream, chunk);
+
+				if (!Nz::File::WriteWhole(chunkPath, byteArray.GetBuffer(), byteArray.GetSize()))
+					fmt::print(stderr, fg(fmt::color::red), "failed to convert chunk {} to a full chunk\n", fmt::streamed(chunkIndices));
 			}
 		});
+
+		if (headerMismatch)
+			SaveHeader();
+	}
+
+	std::optional<PlanetSaveHeader> ServerPlanetEnvironment::LoadSaveHeader() const
+	{
+		Nz::File headerFile(m_savePath / Nz::Utf8Path("header.bin"), Nz::OpenMode::Read);
+		if (!headerFile.IsOpen())
+		{
+			fmt::print(stderr, fg(fmt::color::red), "failed to open planet save header\n");
+			return std::nullopt;
+		}
+
+		Nz::ByteStream headerStream(&headerFile);
+		return LoadPlanetSaveHeader(headerStream);
+	}
+
+	void ServerPlanetEnvironment::SaveHeader()
+	{
+		PlanetSaveHeader header{ Planet::GeneratorVersion, m_seed, m_chunkCount };
+
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		SavePlanetSaveHeader(byteStream, header);
+
+		if (!Nz::File::WriteWhole(m_savePath / Nz::Utf8Path("header.bin"), byteArray.GetBuffer(), byteArray.GetSize()))
+			fmt::print(stderr, fg(fmt::color::red), "failed to save planet save header\n");
+	}
+
+	void ServerPlanetEnvironment::WaitForSave()
+	{
+		if (!m_saveJob)
+			return;
+
+		if (m_saveJob->remainingChunkCount.load() > 0)
+		{
+			auto& taskScheduler = m_serverInstance.GetApplication().GetComponent<Nz::TaskSchedulerAppComponent>();
+			taskScheduler.WaitForTasks();
+		}
+
+		m_saveJob.reset();
 	}
 }
@@ -9,6 +9,7 @@
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/ShipComponent.hpp>
 #include <CommonLib/Systems/ShipSystem.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/PlayerTokenAppComponent.hpp>
 #include <ServerLib/ServerInstance.hpp>
 #include <ServerLib/Components/EnvironmentEnterTriggerComponent.hpp>
@@ -179,7 +180,7 @@ namespace tsom
 		try
 		{
 			Nz::UInt32 version = data["version"];
-			if (version != 1)
+			if (version < 1 || version > 2)
 				return Nz::Err(fmt::format("unhandled version {}", version));
 
 			const nlohmann::json& chunks = data["chunks"];
@@ -199,7 +200,14 @@ namespace tsom
 				using base64 = cppcodec::base64_rfc4648;
 				std::vector<Nz::UInt8> compressedData = base64::decode(chunkData);
 				std::vector<Nz::UInt8> decompressedData(chunkDataSize);
-				std::optional compressedDataOpt = binaryCompressor.Decompress(compressedData.data(), compressedData.size(), decompressedData.data(), decompressedData.size());
+
+				// version 1 stored raw LZ4 blocks, version 2 stores compression frames (never using a dictionary)
+				std::optional<std::size_t> compressedDataOpt;
+				if (version >= 2)
+					compressedDataOpt = binaryCompressor.DecompressFrame(compressedData.data(), compressedData.size(), decompressedData.data(), decompressedData.size(), nullptr);
+				else
+					compressedDataOpt = binaryCompressor.Decompress(compressedData.data(), compressedData.size(), decompressedData.data(), decompressedData.size());
+
 				if (!compressedDataOpt)
 					return Nz::Err("chunk decompression failed");
 
@@ -228,6 +236,8 @@ namespace tsom
 		nlohmann::json chunks;
 
 		BinaryCompressor& binaryCompressor = BinaryCompressor::GetThreadCompressor();
+		const CompressionProfile& compressionProfile = m_serverInstance.GetShipCompressionProfile();
+
 		Nz::ByteArray byteArray;
 		GetShip().ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
 		{
@@ -240,7 +250,7 @@ namespace tsom
 			Nz::ByteStream byteStream(&byteArray);
 			chunk.Serialize(byteStream);
 
-			std::optional compressedDataOpt = binaryCompressor.Compress(byteArray.GetBuffer(), byteArray.GetSize());
+			std::optional compressedDataOpt = binaryCompressor.CompressFrame(compressionProfile, byteArray.GetBuffer(), byteArray.GetSize());
 			if NAZARA_UNLIKELY(!compressedDataOpt)
 				throw std::runtime_error("chunk compression failed");
 
@@ -253,7 +263,7 @@ namespace tsom
 
 		nlohmann::json shipData;
 		shipData["chunks"] = std::move(chunks);
-		shipData["version"] = Nz::UInt32(1);
+		shipData["version"] = Nz::UInt32(2);
 
 		nlohmann::json body;
 		body["data"] = shipData.dump();
@@ -273,6 +283,8 @@ namespace tsom
 
 	void ServerShipEnvironment::OnTick(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("ServerShipEnvironment::OnTick");
+
 		// Check and apply chunk areas update
 		for (auto it = m_areaUpdateJobs.begin(); it != m_areaUpdateJobs.end();)
 		{
@@ -122,6 +122,14 @@ namespace tsom
 		NetworkSession* session = GetSession();
 		session->SetProtocolVersion(authRequest.gameVersion);
 
+		const CompressionProfile& chunkCompressionProfile = m_instance.GetChunkCompressionProfile();
+		CompressionProfile sessionCompressionProfile = BinaryCompressor::NegotiateProfile(chunkCompressionProfile, authRequest.compressionCapabilities);
+		if (chunkCompressionProfile.dictionary && !sessionCompressionProfile.dictionary)
+			fmt::print(fg(fmt::color::yellow), "{0} doesn't have chunk dictionary {1}, chunks will be compressed without it\n", login, chunkCompressionProfile.dictionary->GetId());
+
+		session->SetCompressionProfile(std::move(sessionCompressionProfile));
+		session->EnableChunkContentCache(authRequest.hasChunkContentCache);
+
 		ServerPlayer* player;
 		if (uuid.has_value())
 			player = m_instance.CreateAuthenticatedPlayer(session, *uuid, std::move(login), permissions);
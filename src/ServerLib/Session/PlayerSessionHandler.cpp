@@ -13,7 +13,9 @@
 #include <CommonLib/Components/ChunkComponent.hpp>
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/PlanetComponent.hpp>
+#include <CommonLib/Components/ScriptedEntityComponent.hpp>
 #include <CommonLib/Components/ShipComponent.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/PlayerTokenAppComponent.hpp>
 #include <ServerLib/ServerEnvironment.hpp>
 #include <ServerLib/ServerInstance.hpp>
@@ -29,13 +31,18 @@
 #include <Nazara/Physics3D/Collider3D.hpp>
 #include <Nazara/Physics3D/Systems/Physics3DSystem.hpp>
 #include <fmt/color.h>
+#include <fmt/format.h>
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <charconv>
 #include <numeric>
 
 namespace tsom
 {
 	constexpr SessionHandler::SendAttributeTable s_packetAttributes = SessionHandler::BuildAttributeTable({
+		{ PacketIndex<Packets::BulkCancel>,              { .channel = 3, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::BulkCommit>,              { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::BulkFragment>,            { .channel = 3, .flags = Nz::ENetPacketFlag::Reliable } },
 		{ PacketIndex<Packets::ChatMessage>,             { .channel = 0, .flags = Nz::ENetPacketFlag::Reliable } },
 		{ PacketIndex<Packets::ChunkCreate>,             { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
 		{ PacketIndex<Packets::ChunkDestroy>,            { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
@@ -71,6 +78,11 @@ namespace tsom
 		m_player->Destroy();
 	}
 
+	void PlayerSessionHandler::HandlePacket(Packets::ChunkResetRequest&& chunkResetRequest)
+	{
+		m_player->GetVisibilityHandler().RequestChunkReset(chunkResetRequest.chunkId);
+	}
+
 	void PlayerSessionHandler::HandlePacket(Packets::ExitShipControl&& exitShipControl)
 	{
 		m_player->GetCharacterController()->SetShipController(nullptr);
@@ -409,6 +421,98 @@ namespace tsom
 // 			}
 			return;
 		}
+		else if (message.starts_with("/profile") && m_player->HasPermission(PlayerPermission::Admin))
+		{
+			if (message == "/profile start")
+			{
+				TickProfiler::Clear();
+				TickProfiler::Enable(true);
+				m_player->SendChatMessage("tick profiler enabled");
+			}
+			else if (message == "/profile stop")
+			{
+				TickProfiler::Enable(false);
+				m_player->SendChatMessage("tick profiler disabled");
+			}
+			else if (message == "/profile dump")
+			{
+				if (std::optional<std::filesystem::path> profilePath = m_player->GetServerInstance().DumpTickProfile("manual"))
+					m_player->SendChatMessage(fmt::format("tick profile written to {0}", Nz::PathToString(*profilePath)));
+				else
+					m_player->SendChatMessage("failed to write tick profile");
+			}
+			else
+				m_player->SendChatMessage("usage: /profile start|stop|dump");
+
+			return;
+		}
+		else if (message.starts_with("/scriptstats") && m_player->HasPermission(PlayerPermission::Admin))
+		{
+			constexpr std::size_t MaxDisplayedEntries = 5;
+
+			ServerInstance& serverInstance = m_player->GetServerInstance();
+			ScriptCpuMonitor& cpuMonitor = serverInstance.GetScriptingContext().GetCpuMonitor();
+
+			if (message == "/scriptstats reset")
+			{
+				cpuMonitor.ResetStats();
+				serverInstance.ForEachEnvironment([](ServerEnvironment& environment)
+				{
+					for (auto&& [entity, entityScripted] : environment.GetWorld().GetRegistry().view<ScriptedEntityComponent>().each())
+						entityScripted.cpuStats = ScriptCpuStats{};
+				});
+
+				m_player->SendChatMessage("script statistics reset");
+				return;
+			}
+			else if (message != "/scriptstats")
+			{
+				m_player->SendChatMessage("usage: /scriptstats [reset]");
+				return;
+			}
+
+			auto FormatStats = [](std::string_view name, const ScriptCpuStats& stats)
+			{
+				return fmt::format("{0}: {1:.2f}ms in {2} calls (max: {3:.2f}ms, {4} instructions, {5} aborted)", name, stats.totalTime.AsSeconds<double>() * 1000.0, stats.callCount, stats.maxCallTime.AsSeconds<double>() * 1000.0, stats.instructionCount, stats.abortCount);
+			};
+
+			auto SortByTotalTime = [](auto& entries)
+			{
+				std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) { return lhs.second->totalTime > rhs.second->totalTime; });
+			};
+
+			std::vector<std::pair<std::string_view, const ScriptCpuStats*>> classEntries;
+			for (const auto& [className, stats] : cpuMonitor.GetClassStats())
+			{
+				if (stats.callCount > 0)
+					classEntries.emplace_back(className, &stats);
+			}
+			SortByTotalTime(classEntries);
+
+			std::vector<std::pair<std::string, const ScriptCpuStats*>> entityEntries;
+			serverInstance.ForEachEnvironment([&](ServerEnvironment& environment)
+			{
+				entt::registry& registry = environment.GetWorld().GetRegistry();
+				for (auto&& [entity, entityScripted, classInstance] : registry.view<ScriptedEntityComponent, ClassInstanceComponent>().each())
+				{
+					if (entityScripted.cpuStats.callCount > 0)
+						entityEntries.emplace_back(fmt::format("{0} #{1}", classInstance.GetClass()->GetName(), entt::to_integral(entity)), &entityScripted.cpuStats);
+				}
+			});
+			SortByTotalTime(entityEntries);
+
+			m_player->SendChatMessage(fmt::format("script time during last tick: {0:.2f}ms", cpuMonitor.GetLastTickTime().AsSeconds<double>() * 1000.0));
+
+			m_player->SendChatMessage("most expensive classes:");
+			for (std::size_t i = 0; i < std::min(classEntries.size(), MaxDisplayedEntries); ++i)
+				m_player->SendChatMessage(FormatStats(classEntries[i].first, *classEntries[i].second));
+
+			m_player->SendChatMessage("most expensive entities:");
+			for (std::size_t i = 0; i < std::min(entityEntries.size(), MaxDisplayedEntries); ++i)
+				m_player->SendChatMessage(FormatStats(entityEntries[i].first, *entityEntries[i].second));
+
+			return;
+		}
 		else if (message == "/spawnplanet" && m_player->HasPermission(PlayerPermission::Admin))
 		{
 			entt::handle playerEntity = m_player->GetControlledEntity();
@@ -5,16 +5,26 @@
 #include <ServerLib/SessionVisibilityHandler.hpp>
 #include <CommonLib/CharacterController.hpp>
 #include <CommonLib/ChunkContainer.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
 #include <CommonLib/EntityClass.hpp>
+#include <CommonLib/InternalConstants.hpp>
 #include <CommonLib/NetworkSession.hpp>
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/PlanetComponent.hpp>
 #include <CommonLib/Components/ShipComponent.hpp>
 #include <Nazara/Core/Components/NodeComponent.hpp>
+#include <Nazara/Physics3D/Components/RigidBody3DComponent.hpp>
 #include <NazaraUtils/Algorithm.hpp>
+#include <mutex>
 
 namespace tsom
 {
+	namespace
+	{
+		// Sessions are dispatched in parallel, chunk signals are shared between all of them
+		std::mutex s_chunkSignalMutex;
+	}
+
 	bool SessionVisibilityHandler::CreateChunk(entt::handle entity, Chunk& chunk)
 	{
 		assert(m_chunkNetworkMaps.contains(entity));
@@ -115,6 +125,8 @@ namespace tsom
 			chunkData.chunk = nullptr;
 			chunkData.entityOwner = entt::handle{};
 			chunkData.onBlockUpdatedSlot.Disconnect(); //< shouldn't be connected yet
+			chunkData.onBlocksUpdatedSlot.Disconnect();
+			chunkData.onResetSlot.Disconnect();
 		}
 		else
 			m_newlyHiddenChunk.UnboundedSet(chunkIndex);
@@ -154,11 +166,50 @@ namespace tsom
 
 	void SessionVisibilityHandler::Dispatch(Nz::UInt16 tickIndex)
 	{
+		// This only reads the shared world state and can be run in parallel for multiple sessions
 		DispatchEnvironments(tickIndex);
 		DispatchEntities(tickIndex);
 		DispatchChunks(tickIndex);
 	}
 
+	void SessionVisibilityHandler::PrepareDispatch()
+	{
+		// Feed the chunk stream controller with the connection stats (RTT, packet loss)
+		if (m_peerInfoClock.RestartIfOver(PeerInfoPollInterval))
+		{
+			m_networkSession->QueryInfo([controller = m_chunkStreamController](NetworkReactor::PeerInfo& peerInfo)
+			{
+				controller->Update(Nz::GetElapsedNanoseconds(), peerInfo);
+			});
+		}
+
+		// Global transforms are lazily computed by nodes (shared between sessions), retrieve them before dispatch
+		if (m_controlledEntity)
+		{
+			auto& entityNode = m_controlledEntity.get<Nz::NodeComponent>();
+
+			Nz::Quaternionf viewRotation = entityNode.GetGlobalRotation();
+			if (m_controlledCharacter)
+				viewRotation = viewRotation * Nz::EulerAnglesf(m_controlledCharacter->GetCameraRotation().pitch, 0.f, 0.f);
+
+			auto& viewer = m_viewer.emplace();
+			viewer.position = entityNode.GetGlobalPosition();
+			viewer.direction = viewRotation * Nz::Vector3f::Forward();
+		}
+		else
+			m_viewer.reset();
+	}
+
+	void SessionVisibilityHandler::RequestChunkReset(ChunkId chunkId)
+	{
+		// Clients can only request the content of chunks announced by their hash, once per announcement
+		if (!m_hashOnlyChunk.UnboundedTest(chunkId))
+			return;
+
+		m_hashOnlyChunk.Reset(chunkId);
+		m_requestedResetChunk.UnboundedSet(chunkId);
+	}
+
 	void SessionVisibilityHandler::UpdateEntityEnvironment(ServerEnvironment& newEnvironment, entt::handle oldEntity, entt::handle newEntity)
 	{
 		// Don't remove from created entities as client will need it to update its environment
@@ -213,6 +264,26 @@ namespace tsom
 			m_environmentUpdates.push_back({ newEntity, previousEnv.environment, &newEnvironment });
 	}
 
+	void SessionVisibilityHandler::CancelChunkTransfer(std::size_t chunkIndex)
+	{
+		ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
+		if (!visibleChunk.transferId)
+			return;
+
+		BulkTransferSender::TransferId transferId = *visibleChunk.transferId;
+		visibleChunk.transferId.reset();
+		m_chunkTransfers.erase(transferId);
+
+		// Client may have received fragments, let it free them
+		if (m_chunkTransferSender.Cancel(transferId))
+		{
+			Packets::BulkCancel cancelPacket;
+			cancelPacket.transferId = transferId;
+
+			m_networkSession->SendPacket(cancelPacket);
+		}
+	}
+
 	void SessionVisibilityHandler::DispatchChunks(Nz::UInt16 tickIndex)
 	{
 		for (std::size_t chunkIndex : m_newlyHiddenChunk.IterBits())
@@ -229,8 +300,14 @@ namespace tsom
 			// Handle chunk liberation only when dispatching to prevent chunk index reuse if resurrection happens
 			chunkNetworkIndices.erase(visibleChunk.chunk->GetIndices());
 			m_freeChunkIds.Set(chunkIndex);
+			m_hashOnlyChunk.UnboundedReset(chunkIndex);
+			m_requestedResetChunk.UnboundedReset(chunkIndex);
 			m_resetChunk.UnboundedReset(chunkIndex);
+			m_newResetChunk.UnboundedReset(chunkIndex);
 			m_updatedChunk.UnboundedReset(chunkIndex);
+			m_chunkResetQueue.Erase(chunkIndex); //< don't send content of chunks that left the area
+			visibleChunk.changeSet.Clear();
+			CancelChunkTransfer(chunkIndex);
 
 			Packets::ChunkDestroy chunkDestroyPacket;
 			chunkDestroyPacket.chunkId = Nz::SafeCast<ChunkId>(chunkIndex);
@@ -241,23 +318,91 @@ namespace tsom
 
 			visibleChunk.chunk = nullptr;
 			visibleChunk.entityOwner = entt::handle{};
+
+			std::lock_guard lock(s_chunkSignalMutex);
 			visibleChunk.onBlockUpdatedSlot.Disconnect();
+			visibleChunk.onBlocksUpdatedSlot.Disconnect();
+			visibleChunk.onResetSlot.Disconnect();
 		}
 		m_newlyHiddenChunk.Clear();
 
 		if (m_newlyVisibleChunk.GetSize() > 0)
 			DispatchChunkCreation(tickIndex);
 
-		if (m_resetChunk.GetSize() > 0)
-			DispatchChunkReset(tickIndex);
+		// Chunk contents requested by the client are rate-limited, remaining requests are handled during next ticks
+		std::size_t resetRequestCount = 0;
+		for (std::size_t chunkIndex = m_requestedResetChunk.FindFirst(); chunkIndex != m_requestedResetChunk.npos && resetRequestCount < ChunkResetRequestsPerTick; chunkIndex = m_requestedResetChunk.FindNext(chunkIndex))
+		{
+			m_requestedResetChunk.Reset(chunkIndex);
+			resetRequestCount++;
+
+			// Chunk content is already going to be sent
+			if (m_resetChunk.UnboundedTest(chunkIndex) || m_visibleChunks[chunkIndex].transferId)
+				continue;
+
+			m_resetChunk.UnboundedSet(chunkIndex);
+			m_newResetChunk.UnboundedSet(chunkIndex);
+		}
+
+		// Chunk content fragments were all received, deliver them in order with other chunk packets
+		m_chunkTransferSender.PollCompletedTransfers([&](BulkTransferSender::TransferId transferId)
+		{
+			auto it = m_chunkTransfers.find(transferId);
+			assert(it != m_chunkTransfers.end());
+			std::size_t chunkIndex = it->second;
+			m_chunkTransfers.erase(it);
+
+			Packets::BulkCommit commitPacket;
+			commitPacket.transferId = transferId;
 
+			m_networkSession->SendPacket(commitPacket);
+
+			ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
+			visibleChunk.transferId.reset();
+
+			// Send blocks updated since the chunk content was sent
+			if (!visibleChunk.changeSet.IsEmpty())
+				m_updatedChunk.UnboundedSet(chunkIndex);
+		});
+
+		Nz::UInt32 protocolVersion = m_networkSession->GetProtocolVersion();
+		bool useCompressionFrame = protocolVersion >= Constants::ProtocolCompressionFrameVersion;
 		for (std::size_t chunkIndex : m_updatedChunk.IterBits())
 		{
 			ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
+
+			// Whole chunk content is going to be sent
+			if (m_resetChunk.UnboundedTest(chunkIndex))
+			{
+				visibleChunk.changeSet.Clear();
+				continue;
+			}
+
+			// Chunk content is being sent, keep updates until it's committed
+			if (visibleChunk.transferId)
+				continue;
+
+			visibleChunk.changeSet.BuildUpdates(*visibleChunk.chunk, visibleChunk.chunkUpdatePacket.updates);
+			visibleChunk.changeSet.Clear();
+
+			// Large edits (explosions, regenerations) are cheaper to send as a chunk reset, whose compressed content is then already cached by the snapshot
+			std::size_t updateSize = Packets::ComputeChunkUpdateSize(visibleChunk.chunkUpdatePacket.updates, protocolVersion);
+			if (updateSize >= ChunkChangeSet::EstimateResetSize(*visibleChunk.chunk->GetSnapshot(), m_networkSession->GetCompressionProfile(), useCompressionFrame))
+			{
+				visibleChunk.chunkUpdatePacket.updates.clear();
+				m_resetChunk.UnboundedSet(chunkIndex);
+				m_newResetChunk.UnboundedSet(chunkIndex);
+				continue;
+			}
+
+			visibleChunk.chunkUpdatePacket.tickIndex = tickIndex;
 			m_networkSession->SendPacket(visibleChunk.chunkUpdatePacket);
 			visibleChunk.chunkUpdatePacket.updates.clear();
 		}
 		m_updatedChunk.Clear();
+
+		if (m_resetChunk.GetSize() > 0 || m_chunkTransferSender.HasQueuedData())
+			DispatchChunkReset(tickIndex);
 	}
 
 	void SessionVisibilityHandler::DispatchChunkCreation(Nz::UInt16 tickIndex)
@@ -269,38 +414,40 @@ namespace tsom
 			// Connect update signal on dispatch to prevent updates made during the same tick to be sent as update
 			visibleChunk.chunkUpdatePacket.entityId = Nz::Retrieve(m_entityIndices, visibleChunk.entityOwner);
 
-			visibleChunk.onBlockUpdatedSlot.Connect(visibleChunk.chunk->OnBlockUpdated, [this, chunkIndex]([[maybe_unused]] Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex newBlock)
+			std::unique_lock signalLock(s_chunkSignalMutex);
+			visibleChunk.onBlockUpdatedSlot.Connect(visibleChunk.chunk->OnBlockUpdated, [this, chunkIndex](Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex /*newBlock*/)
 			{
-				m_updatedChunk.UnboundedSet(chunkIndex);
+				// Chunk content has been reset or wasn't already sent
+				if (m_resetChunk.UnboundedTest(chunkIndex))
+					return;
 
 				ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
 				assert(visibleChunk.chunk == chunk);
 
+				// Only the final content of the block is sent, on dispatch
+				visibleChunk.changeSet.MarkBlock(chunk->GetBlockLocalIndex(indices));
+				m_updatedChunk.UnboundedSet(chunkIndex);
+			});
+
+			visibleChunk.onBlocksUpdatedSlot.Connect(visibleChunk.chunk->OnBlocksUpdated, [this, chunkIndex](Chunk* chunk, const Nz::Bitset<Nz::UInt64>& updatedBlocks, const Nz::Vector3ui& /*minIndices*/, const Nz::Vector3ui& /*maxIndices*/)
+			{
 				// Chunk content has been reset or wasn't already sent
 				if (m_resetChunk.UnboundedTest(chunkIndex))
 					return;
 
-				auto comp = [](Packets::ChunkUpdate::BlockUpdate& blockUpdate, const Nz::Vector3ui& indices)
-				{
-					return Nz::Vector3ui(blockUpdate.voxelLoc.x, blockUpdate.voxelLoc.y, blockUpdate.voxelLoc.z) < indices;
-				};
+				ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
+				assert(visibleChunk.chunk == chunk);
 
-				auto it = std::lower_bound(visibleChunk.chunkUpdatePacket.updates.begin(), visibleChunk.chunkUpdatePacket.updates.end(), indices, comp);
-				if (it == visibleChunk.chunkUpdatePacket.updates.end() || Nz::Vector3ui(it->voxelLoc.x, it->voxelLoc.y, it->voxelLoc.z) != indices)
-				{
-					visibleChunk.chunkUpdatePacket.updates.insert(it, {
-						Packets::Helper::VoxelLocation{ Nz::SafeCast<Nz::UInt8>(indices.x), Nz::SafeCast<Nz::UInt8>(indices.y), Nz::SafeCast<Nz::UInt8>(indices.z) },
-						Nz::SafeCast<Nz::UInt8>(newBlock)
-					});
-				}
-				else
-					it->newContent = Nz::SafeCast<Nz::UInt8>(newBlock);
+				visibleChunk.changeSet.MarkBlocks(updatedBlocks);
+				m_updatedChunk.UnboundedSet(chunkIndex);
 			});
 
 			visibleChunk.onResetSlot.Connect(visibleChunk.chunk->OnReset, [this, chunkIndex](Chunk*)
 			{
 				m_resetChunk.UnboundedSet(chunkIndex);
+				m_newResetChunk.UnboundedSet(chunkIndex);
 			});
+			signalLock.unlock();
 
 			// Register chunk to environment
 			EntityId entityIndex = Nz::Retrieve(m_entityIndices, visibleChunk.entityOwner);
@@ -320,67 +467,123 @@ namespace tsom
 			chunkCreatePacket.entityId = entityIndex;
 			chunkCreatePacket.tickIndex = tickIndex;
 
+			// Clients advertising a chunk content cache only receive its hash, and request the content on cache miss (see RequestChunkReset)
+			bool sendContentHash = false;
+			if (m_networkSession->IsChunkContentCacheEnabled())
+			{
+				std::shared_ptr<const ChunkSnapshot> snapshot = visibleChunk.chunk->GetSnapshot();
+				if (snapshot->HasContent())
+				{
+					chunkCreatePacket.contentHash = snapshot->GetContentHash();
+					sendContentHash = true;
+				}
+			}
+
 			m_networkSession->SendPacket(chunkCreatePacket);
 
 			m_newlyVisibleChunk.UnboundedReset(chunkIndex);
-			m_resetChunk.UnboundedSet(chunkIndex);
+			if (sendContentHash)
+				m_hashOnlyChunk.UnboundedSet(chunkIndex);
+			else
+			{
+				m_resetChunk.UnboundedSet(chunkIndex);
+				m_newResetChunk.UnboundedSet(chunkIndex);
+			}
 		}
 		m_newlyVisibleChunk.Clear();
 	}
 
 	void SessionVisibilityHandler::DispatchChunkReset(Nz::UInt16 tickIndex)
 	{
-		m_orderedChunkList.clear();
-		for (std::size_t chunkIndex : m_resetChunk.IterBits())
+		for (std::size_t chunkIndex : m_newResetChunk.IterBits())
 		{
 			const Chunk* chunk = m_visibleChunks[chunkIndex].chunk;
 			Nz::Vector3f chunkPosition = chunk->GetContainer().GetChunkOffset(chunk->GetIndices());
-			m_orderedChunkList.push_back(ChunkWithPos{ chunkIndex, chunkPosition + Nz::Vector3f(chunk->GetSize()) * chunk->GetBlockSize() });
+			Nz::Vector3f chunkCenter = chunkPosition + Nz::Vector3f(chunk->GetSize()) * chunk->GetBlockSize() * 0.5f;
+
+			m_chunkResetQueue.Push(chunkIndex, chunkCenter, ChunkSendQueue::ComputeVisibilityHint(*chunk->GetSnapshot()));
 		}
+		m_newResetChunk.Clear();
 
-		if (m_controlledEntity)
+		// Chunks close to the controlled entity and in front of its camera get sent in priority
+		if (m_viewer)
+			m_chunkResetQueue.Update(m_viewer->position, m_viewer->direction);
+
+		auto BuildChunkResetPacket = [&](std::size_t chunkIndex)
 		{
-			// Sort chunks based on distance to reference position (closers chunks get sent in priority)
-			Nz::Vector3f referencePosition = m_controlledEntity.get<Nz::NodeComponent>().GetGlobalPosition();
+			ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
 
-			std::sort(m_orderedChunkList.begin(), m_orderedChunkList.end(), [&](const ChunkWithPos& chunkA, const ChunkWithPos& chunkB)
-			{
-				return chunkA.chunkCenter.SquaredDistance(referencePosition) < chunkB.chunkCenter.SquaredDistance(referencePosition);
-			});
-		}
+			Packets::ChunkReset chunkResetPacket;
+			chunkResetPacket.chunkId = Nz::SafeCast<ChunkId>(chunkIndex);
+			chunkResetPacket.entityId = Nz::Retrieve(m_entityIndices, visibleChunk.entityOwner);
+			chunkResetPacket.tickIndex = tickIndex;
 
-		for (const ChunkWithPos& chunk : m_orderedChunkList)
+			// Content is compressed once per chunk revision and negotiated profile, and shared between all sessions resetting this chunk
+			chunkResetPacket.snapshot = visibleChunk.chunk->GetSnapshot();
+
+			return chunkResetPacket;
+		};
+
+		if (m_networkSession->GetProtocolVersion() >= Constants::ProtocolBulkTransferVersion)
 		{
-			if (*m_activeChunkUpdates >= MaxConcurrentChunkUpdate)
-				return;
+			// Chunk content is split in fragments sent on a dedicated channel, with a per-tick budget to leave room for gameplay packets
+			auto SendFragment = [&](const Packets::BulkFragment& fragment, std::function<void(std::size_t packetSize)> acknowledgeCallback)
+			{
+				return m_networkSession->SendPacket(fragment, std::move(acknowledgeCallback));
+			};
 
-			ChunkData& visibleChunk = m_visibleChunks[chunk.chunkIndex];
+			std::size_t byteBudget = ChunkTransferBudgetPerTick;
+			for (;;)
+			{
+				// Only serialize the next chunk once the previous one was entirely handed to the network, so closer chunks can still overtake it
+				if (!m_chunkTransferSender.HasQueuedData())
+				{
+					if (m_chunkResetQueue.IsEmpty())
+						break;
 
-			ChunkIndices chunkLocation = visibleChunk.chunk->GetIndices();
-			Nz::Vector3ui chunkSize = visibleChunk.chunk->GetSize();
+					std::size_t chunkIndex = m_chunkResetQueue.Pop();
+					CancelChunkTransfer(chunkIndex); //< chunk was reset again before its previous content was committed
 
-			Packets::ChunkReset chunkResetPacket;
-			chunkResetPacket.chunkId = Nz::SafeCast<ChunkId>(chunk.chunkIndex);
-			chunkResetPacket.entityId = Nz::Retrieve(m_entityIndices, visibleChunk.entityOwner);
-			chunkResetPacket.tickIndex = tickIndex;
+					BulkTransferSender::TransferId transferId = m_chunkTransferSender.Enqueue(m_networkSession->SerializePacket(BuildChunkResetPacket(chunkIndex)));
+					m_chunkTransfers.emplace(transferId, chunkIndex);
+					m_visibleChunks[chunkIndex].transferId = transferId;
 
-			unsigned int blockCount = chunkSize.x * chunkSize.y * chunkSize.z;
-			chunkResetPacket.content.resize(blockCount);
+					m_resetChunk.UnboundedReset(chunkIndex);
+				}
 
-			const BlockIndex* chunkContent = visibleChunk.chunk->GetContent();
-			std::memcpy(chunkResetPacket.content.data(), chunkContent, blockCount * sizeof(BlockIndex));
+				byteBudget -= std::min(byteBudget, m_chunkTransferSender.Flush(byteBudget, SendFragment));
 
-			(*m_activeChunkUpdates)++;
-			m_networkSession->SendPacket(chunkResetPacket, [chunkLocation, chunkUpdateCount = m_activeChunkUpdates]
+				// Stop when the tick budget or the congestion window is exhausted
+				if (m_chunkTransferSender.HasQueuedData())
+					return;
+			}
+		}
+		else
+		{
+			bool useCompressionFrame = m_networkSession->GetProtocolVersion() >= Constants::ProtocolCompressionFrameVersion;
+			while (!m_chunkResetQueue.IsEmpty())
 			{
-				assert(*chunkUpdateCount > 0);
-				(*chunkUpdateCount)--;
-			});
+				std::size_t chunkIndex = m_chunkResetQueue.GetTop();
+				ChunkData& visibleChunk = m_visibleChunks[chunkIndex];
+
+				// Stop when the number of bytes in flight reaches the window
+				if (!m_chunkStreamController->CanSend(ChunkChangeSet::EstimateResetSize(*visibleChunk.chunk->GetSnapshot(), m_networkSession->GetCompressionProfile(), useCompressionFrame)))
+					return;
+
+				m_chunkResetQueue.Pop();
 
-			m_resetChunk.UnboundedReset(chunk.chunkIndex);
+				// The acknowledgment may be processed before OnSent, in-flight bytes use modular arithmetic so this is fine as long as CanSend is called after OnSent
+				std::size_t packetSize = m_networkSession->SendPacket(BuildChunkResetPacket(chunkIndex), [controller = m_chunkStreamController](std::size_t packetSize)
+				{
+					controller->OnAcknowledged(packetSize);
+				});
+				m_chunkStreamController->OnSent(packetSize);
+
+				m_resetChunk.UnboundedReset(chunkIndex);
+			}
 		}
 
-		// If we get there, we didn't hit the concurrent chunk limit, we can clear the chunk bitset
+		// If we get there, we didn't hit the chunk stream window, we can clear the chunk bitset
 		assert(m_resetChunk.TestNone());
 		m_resetChunk.Clear();
 	}
@@ -447,6 +650,9 @@ namespace tsom
 
 				m_entityIndices[handle] = entityIndex;
 
+				// Initial state is sent with the creation packet
+				m_entityStateTracker.Reset(Nz::SafeCast<EntityId>(entityIndex), tickIndex, { data.initialRotation, data.initialPosition });
+
 				auto& entityData = creationPacket.entities.emplace_back();
 				if (data.entityClass)
 					entityData.entityClass = m_networkSession->GetStringStore().CheckStringIndex(data.entityClass->GetName());
@@ -475,32 +681,57 @@ namespace tsom
 				envUpdatePacket.newEnvironmentId = envIndex;
 
 				m_networkSession->SendPacket(envUpdatePacket);
+
+				// Entity state is now relative to its new environment
+				m_entityStateTracker.Invalidate(entityIndex);
 			}
 			m_environmentUpdates.clear();
 		}
 
 		if (!m_propertyUpdatedEntities.empty())
 		{
-			for (auto&& [entity, propertyFlags] : m_propertyUpdatedEntities)
+			bool batchProperties = m_networkSession->GetProtocolVersion() >= Constants::ProtocolBatchedPropertyUpdateVersion;
+
+			for (auto&& [entity, properties] : m_propertyUpdatedEntities)
 			{
 				EntityId entityIndex = Nz::Retrieve(m_entityIndices, entity);
 
 				auto& entityInstance = entity.get<ClassInstanceComponent>();
+				Nz::UInt32 propertyCount = entityInstance.GetClass()->GetPropertyCount();
 
-				Nz::UInt32 propertyBits = propertyFlags;
-				while (Nz::UInt32 propertyIndex = Nz::FindFirstBit(propertyBits))
+				// Only the latest value of each changed property is sent, in a single packet per entity
+				Packets::EntityPropertyUpdate propertyUpdatePacket;
+				propertyUpdatePacket.entity = entityIndex;
+				propertyUpdatePacket.tickIndex = tickIndex;
+
+				for (std::size_t propertyIndex : properties.IterBits())
 				{
-					propertyIndex--; //< FFB returns 0 if no bit was found
+					if (propertyIndex >= propertyCount)
+						break; //< class was reloaded with less properties
+
+					auto& propertyUpdate = propertyUpdatePacket.properties.emplace_back();
+					propertyUpdate.propertyIndex = Nz::SafeCast<Nz::UInt32>(propertyIndex);
+					propertyUpdate.propertyValue = entityInstance.GetProperty(propertyUpdate.propertyIndex);
+				}
 
-					Packets::EntityPropertyUpdate propertyUpdatePacket;
-					propertyUpdatePacket.entity = entityIndex;
-					propertyUpdatePacket.propertyIndex = propertyIndex;
-					propertyUpdatePacket.propertyValue = entityInstance.GetProperty(propertyIndex);
-					propertyUpdatePacket.tickIndex = tickIndex;
+				if (propertyUpdatePacket.properties.empty())
+					continue;
 
+				if (batchProperties)
 					m_networkSession->SendPacket(propertyUpdatePacket);
+				else
+				{
+					Packets::EntityPropertyUpdate singlePropertyPacket;
+					singlePropertyPacket.entity = entityIndex;
+					singlePropertyPacket.tickIndex = tickIndex;
 
-					propertyBits = Nz::ClearBit(propertyBits, propertyIndex);
+					for (auto& propertyUpdate : propertyUpdatePacket.properties)
+					{
+						singlePropertyPacket.properties.clear();
+						singlePropertyPacket.properties.push_back(std::move(propertyUpdate));
+
+						m_networkSession->SendPacket(singlePropertyPacket);
+					}
 				}
 			}
 			m_propertyUpdatedEntities.clear();
@@ -543,14 +774,25 @@ namespace tsom
 
 		for (const entt::handle& handle : m_movingEntities)
 		{
-			auto& entityData = stateUpdate.entities.emplace_back();
-
 			auto& entityNode = handle.get<Nz::NodeComponent>();
 
-			entityData.entityId = Nz::Retrieve(m_entityIndices, handle);
+			EntityId entityId = Nz::Retrieve(m_entityIndices, handle);
+
+			Packets::Helper::EntityState entityState;
+			entityState.position = entityNode.GetPosition();
+			entityState.rotation = entityNode.GetRotation();
+
+			bool isSleeping = false;
+			if (Nz::RigidBody3DComponent* rigidBody = handle.try_get<Nz::RigidBody3DComponent>())
+				isSleeping = rigidBody->IsSleeping();
+
+			// Skip entities which didn't move since their last sent state (they're still sent at a low rate in case of packet loss)
+			if (!m_entityStateTracker.ShouldSend(entityId, tickIndex, entityState, isSleeping))
+				continue;
 
-			entityData.newStates.position = entityNode.GetPosition();
-			entityData.newStates.rotation = entityNode.GetRotation();
+			auto& entityData = stateUpdate.entities.emplace_back();
+			entityData.entityId = entityId;
+			entityData.newStates = entityState;
 		}
 
 		if (!stateUpdate.entities.empty() || stateUpdate.controlledCharacter.has_value())
@@ -601,6 +843,7 @@ namespace tsom
 						envUpdatePacket.newEnvironmentId = envIndex;
 
 						m_networkSession->SendPacket(envUpdatePacket);
+						m_entityStateTracker.Invalidate(entityIndex);
 
 						it = m_environmentUpdates.erase(it);
 					}
@@ -703,13 +946,24 @@ namespace tsom
 				auto& visibleChunk = m_visibleChunks[chunkIndex];
 				visibleChunk.chunk = nullptr;
 				visibleChunk.entityOwner = entt::handle{};
-				visibleChunk.onBlockUpdatedSlot.Disconnect();
+
+				{
+					std::lock_guard lock(s_chunkSignalMutex);
+					visibleChunk.onBlockUpdatedSlot.Disconnect();
+					visibleChunk.onBlocksUpdatedSlot.Disconnect();
+					visibleChunk.onResetSlot.Disconnect();
+				}
 
 				m_freeChunkIds.Set(chunkIndex, true);
 				m_newlyHiddenChunk.UnboundedReset(chunkIndex);
 				m_newlyVisibleChunk.UnboundedReset(chunkIndex);
+				m_hashOnlyChunk.UnboundedReset(chunkIndex);
+				m_requestedResetChunk.UnboundedReset(chunkIndex);
 				m_resetChunk.UnboundedReset(chunkIndex);
+				m_newResetChunk.UnboundedReset(chunkIndex);
 				m_updatedChunk.UnboundedReset(chunkIndex);
+				m_chunkResetQueue.Erase(chunkIndex);
+				CancelChunkTransfer(chunkIndex);
 			}
 
 			m_chunkNetworkMaps.erase(it);
@@ -5,6 +5,7 @@
 #include <ServerLib/Systems/EnvironmentProxySystem.hpp>
 #include <CommonLib/EnvironmentTransform.hpp>
 #include <CommonLib/Components/ShipComponent.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/ServerEnvironment.hpp>
 #include <ServerLib/ServerPlayer.hpp>
 #include <ServerLib/SessionVisibilityHandler.hpp>
@@ -18,6 +19,8 @@ namespace tsom
 {
 	void EnvironmentProxySystem::Update(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("EnvironmentProxySystem::Update");
+
 		auto view = m_registry.view<Nz::NodeComponent, EnvironmentProxyComponent>();
 		for (entt::entity entity : view)
 		{
@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <ServerLib/Systems/EnvironmentSwitchSystem.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/ServerEnvironment.hpp>
 #include <ServerLib/ServerInstance.hpp>
 #include <ServerLib/ServerPlayer.hpp>
@@ -15,6 +16,8 @@ namespace tsom
 {
 	void EnvironmentSwitchSystem::Update(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("EnvironmentSwitchSystem::Update");
+
 		auto view = m_registry.view<Nz::NodeComponent, EnvironmentEnterTriggerComponent>();
 
 		for (entt::entity entity : view)
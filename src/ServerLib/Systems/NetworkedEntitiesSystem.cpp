@@ -7,6 +7,7 @@
 #include <CommonLib/Components/ClassInstanceComponent.hpp>
 #include <CommonLib/Components/PlanetComponent.hpp>
 #include <CommonLib/Components/ShipComponent.hpp>
+#include <CommonLib/Utility/TickProfiler.hpp>
 #include <ServerLib/ServerEnvironment.hpp>
 #include <ServerLib/Components/NetworkedComponent.hpp>
 #include <ServerLib/Components/ServerPlayerControlledComponent.hpp>
@@ -20,7 +21,8 @@ namespace tsom
 	NetworkedEntitiesSystem::NetworkedEntitiesSystem(entt::registry& registry, ServerEnvironment& environment) :
 	m_networkedConstructObserver(registry, entt::collector.group<Nz::NodeComponent, NetworkedComponent>(entt::exclude<Nz::DisabledComponent>)),
 	m_registry(registry),
-	m_environment(environment)
+	m_environment(environment),
+	m_currentTime(Nz::Time::Zero())
 	{
 		m_disabledConstructConnection = m_registry.on_construct<Nz::DisabledComponent>().connect<&NetworkedEntitiesSystem::OnNetworkedDestroy>(this);
 		m_networkedDestroyConnection = m_registry.on_destroy<NetworkedComponent>().connect<&NetworkedEntitiesSystem::OnNetworkedDestroy>(this);
@@ -49,10 +51,15 @@ namespace tsom
 	void NetworkedEntitiesSystem::ForgetEntity(entt::entity entity)
 	{
 		m_networkedEntities.erase(entity);
+		m_propertyTracker.Forget(entity);
 	}
 
 	void NetworkedEntitiesSystem::Update(Nz::Time elapsedTime)
 	{
+		TickProfiler::Zone profileZone("NetworkedEntitiesSystem::Update");
+
+		m_currentTime += elapsedTime;
+
 		m_networkedConstructObserver.each([&](entt::entity entity)
 		{
 			assert(!m_networkedEntities.contains(entity));
@@ -76,14 +83,12 @@ namespace tsom
 
 				entityData.onPropertyUpdate.Connect(entityInstance->OnPropertyUpdate, [this, entity](ClassInstanceComponent* emitter, Nz::UInt32 propertyIndex, const EntityProperty& /*newValue*/)
 				{
-					if (!emitter->GetClass()->GetProperty(propertyIndex).isNetworked)
+					const auto& property = emitter->GetClass()->GetProperty(propertyIndex);
+					if (!property.isNetworked)
 						return;
 
-					entt::handle handle(m_registry, entity);
-					ForEachVisibility([&](SessionVisibilityHandler& visibility)
-					{
-						visibility.UpdateEntityProperty(handle, propertyIndex);
-					});
+					// Flushed at the end of Update, so only the latest value of the tick is sent
+					m_propertyTracker.MarkDirty(entity, propertyIndex, property.sendInterval);
 				});
 			}
 
@@ -97,6 +102,18 @@ namespace tsom
 				CreateEntity(visibility, entt::handle(m_registry, entity), createData);
 			});
 		});
+
+		if (m_propertyTracker.HasPendingUpdates())
+		{
+			m_propertyTracker.Flush(m_currentTime, [&](entt::entity entity, const Nz::Bitset<Nz::UInt64>& properties)
+			{
+				entt::handle handle(m_registry, entity);
+				ForEachVisibility([&](SessionVisibilityHandler& visibility)
+				{
+					visibility.UpdateEntityProperties(handle, properties);
+				});
+			});
+		}
 	}
 
 	SessionVisibilityHandler::CreateEntityData NetworkedEntitiesSystem::BuildCreateEntityData(entt::entity entity) const
@@ -168,6 +185,7 @@ namespace tsom
 			return;
 
 		m_networkedEntities.erase(entity);
+		m_propertyTracker.Forget(entity);
 
 		ForEachVisibility([&](SessionVisibilityHandler& visibility)
 		{
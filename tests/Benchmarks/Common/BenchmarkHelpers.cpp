@@ -0,0 +1,28 @@
+#include "BenchmarkHelpers.hpp"
+#include <CommonLib/Chunk.hpp>
+#include <random>
+
+using namespace tsom;
+
+void FillTerrain(Chunk& chunk, BlockIndex blockIndex)
+{
+	const Nz::Vector3ui& chunkSize = chunk.GetSize();
+
+	std::minstd_rand rand(42);
+	std::uniform_int_distribution<unsigned int> heightDis(chunkSize.z / 2 - 2, chunkSize.z / 2 + 2);
+
+	chunk.LockWrite();
+	chunk.Reset([&](BlockIndex* blocks)
+	{
+		for (unsigned int y = 0; y < chunkSize.y; ++y)
+		{
+			for (unsigned int x = 0; x < chunkSize.x; ++x)
+			{
+				unsigned int height = heightDis(rand);
+				for (unsigned int z = 0; z < height; ++z)
+					blocks[chunk.GetBlockLocalIndex({ x, y, z })] = blockIndex;
+			}
+		}
+	});
+	chunk.UnlockWrite();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#ifndef TSOM_BENCHMARKS_BENCHMARKHELPERS_HPP
+#define TSOM_BENCHMARKS_BENCHMARKHELPERS_HPP
+
+#include <CommonLib/BlockIndex.hpp>
+
+namespace tsom
+{
+	class Chunk;
+}
+
+// Terrain-like content: solid ground with a noisy surface (same content on every call)
+void FillTerrain(tsom::Chunk& chunk, tsom::BlockIndex blockIndex);
+
+#endif // TSOM_BENCHMARKS_BENCHMARKHELPERS_HPP
@@ -0,0 +1,95 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <array>
+#include <string_view>
+
+using namespace tsom;
+
+TEST_CASE("Chunk compression", "[Compression]")
+{
+	constexpr Nz::UInt32 seed = 1337; //< not the dictionary seed
+	const Nz::Vector3ui chunkCount(3);
+
+	BlockLibrary blockLibrary;
+
+	// Measure the dictionary which is actually shipped
+	std::shared_ptr<const CompressionDictionary> dictionary = CompressionDictionary::LoadFromFile(Nz::Utf8Path(Constants::ChunkCompressionDictionaryPath));
+	REQUIRE(dictionary);
+
+	Planet planet(1.f, 16.f, 9.81f);
+	planet.GetHeightmapCache().UpdateCapacity(0);
+
+	std::vector<std::vector<BlockIndex>> contents;
+	for (int y = -1; y <= 1; ++y)
+	{
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, y, 0 });
+		planet.GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+
+		contents.emplace_back(chunk.GetContent(), chunk.GetContent() + chunk.GetBlockCount());
+	}
+
+	std::size_t totalSize = 0;
+	for (const auto& content : contents)
+		totalSize += content.size() * sizeof(BlockIndex);
+
+	BinaryCompressor compressor;
+
+	for (CompressionCodec codec : { CompressionCodec::LZ4, CompressionCodec::LZ4HC, CompressionCodec::Zstd })
+	{
+		if (!BinaryCompressor::IsCodecSupported(codec))
+			continue;
+
+		constexpr std::array<std::string_view, 3> codecNames = { "lz4", "lz4hc", "zstd" };
+
+		for (bool useDictionary : { false, true })
+		{
+			CompressionProfile profile;
+			profile.codec = codec;
+			if (useDictionary)
+				profile.dictionary = dictionary;
+
+			std::string modeName = fmt::format("{0}{1}", codecNames[static_cast<std::size_t>(codec)], (useDictionary) ? " + dictionary" : "");
+
+			std::vector<std::vector<Nz::UInt8>> frames;
+			std::size_t compressedSize = 0;
+			for (const auto& content : contents)
+			{
+				std::optional compressedData = compressor.CompressFrame(profile, content.data(), content.size() * sizeof(BlockIndex));
+				REQUIRE(compressedData);
+
+				compressedSize += compressedData->size();
+				frames.emplace_back(compressedData->begin(), compressedData->end());
+			}
+
+			CHECK(compressedSize < totalSize);
+
+			// Divide the total size by the mean time to get the throughput
+			BENCHMARK(fmt::format("Compress ({0}, {1} bytes per iteration)", modeName, totalSize))
+			{
+				std::size_t size = 0;
+				for (const auto& content : contents)
+					size += compressor.CompressFrame(profile, content.data(), content.size() * sizeof(BlockIndex))->size();
+
+				return size;
+			};
+
+			std::vector<BlockIndex> decompressedContent(contents.front().size());
+			BENCHMARK(fmt::format("Decompress ({0}, {1} bytes per iteration)", modeName, totalSize))
+			{
+				std::size_t size = 0;
+				for (const auto& frame : frames)
+					size += *compressor.DecompressFrame(frame.data(), frame.size(), decompressedContent.data(), decompressedContent.size() * sizeof(BlockIndex), profile.dictionary.get());
+
+				return size;
+			};
+		}
+	}
+}
@@ -0,0 +1,199 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+using namespace tsom;
+
+namespace
+{
+	std::size_t BuildPositionMesh(const Chunk& chunk)
+	{
+		std::vector<Nz::UInt32> indices;
+		std::vector<Nz::Vector3f> positions;
+
+		chunk.BuildMesh(indices, Nz::Vector3f::Zero(), [&](Nz::UInt32 count)
+		{
+			Chunk::VertexAttributes vertexAttributes;
+
+			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
+			positions.resize(positions.size() + count);
+			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&positions[vertexAttributes.firstIndex]);
+
+			return vertexAttributes;
+		});
+
+		return indices.size();
+	}
+}
+
+TEST_CASE("Chunk meshing", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = Planet::ChunkSize;
+
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+	// Mesh the center chunk of a 3x3x3 chunk grid so every border has a neighbor
+	auto BuildPlanet = [&](Planet& planet, const Nz::FunctionRef<void(BlockIndex* blocks)>& initCallback)
+	{
+		for (int z = -1; z <= 1; ++z)
+		{
+			for (int y = -1; y <= 1; ++y)
+			{
+				for (int x = -1; x <= 1; ++x)
+					planet.AddChunk(blockLibrary, { x, y, z }, initCallback);
+			}
+		}
+	};
+
+	SECTION("Interior chunk")
+	{
+		// Ground up to half of the chunk, with a dirt layer: faces are mostly inside the chunk
+		Planet planet(1.f, 0.f, 9.81f);
+		BuildPlanet(planet, [&](BlockIndex* blocks)
+		{
+			for (unsigned int z = 0; z < ChunkSize / 2; ++z)
+			{
+				BlockIndex blockIndex = (z + 1 == ChunkSize / 2) ? dirtBlock : stoneBlock;
+				std::fill_n(&blocks[z * ChunkSize * ChunkSize], ChunkSize * ChunkSize, blockIndex);
+			}
+		});
+
+		const Chunk& chunk = *planet.GetChunk({ 0, 0, 0 });
+		BENCHMARK("BuildMesh (interior chunk)")
+		{
+			return BuildPositionMesh(chunk);
+		};
+	}
+
+	SECTION("Border-heavy chunk")
+	{
+		// Checkerboard pattern: every block exposes its six faces, including those on the chunk borders
+		Planet planet(1.f, 0.f, 9.81f);
+		BuildPlanet(planet, [&](BlockIndex* blocks)
+		{
+			for (unsigned int z = 0; z < ChunkSize; ++z)
+			{
+				for (unsigned int y = 0; y < ChunkSize; ++y)
+				{
+					for (unsigned int x = 0; x < ChunkSize; ++x)
+						blocks[(z * ChunkSize + y) * ChunkSize + x] = ((x + y + z) % 2 == 0) ? stoneBlock : EmptyBlockIndex;
+				}
+			}
+		});
+
+		const Chunk& chunk = *planet.GetChunk({ 0, 0, 0 });
+		BENCHMARK("BuildMesh (border-heavy chunk)")
+		{
+			return BuildPositionMesh(chunk);
+		};
+	}
+
+	SECTION("Meshing after neighbor edits")
+	{
+		auto InitGround = [&](BlockIndex* blocks)
+		{
+			std::fill_n(blocks, ChunkSize * ChunkSize * ChunkSize / 2, stoneBlock);
+		};
+
+		// Toggle a block facing the center chunk in each of its six neighbors, as players editing around it would
+		auto EditNeighborBorders = [&](Planet& planet, bool filled)
+		{
+			for (auto&& [direction, chunkOffset] : s_chunkDirOffset.iter_kv())
+			{
+				Chunk& neighborChunk = *planet.GetChunk(chunkOffset);
+
+				Nz::Vector3ui indices(ChunkSize / 2);
+				for (unsigned int axis = 0; axis < 3; ++axis)
+				{
+					if (s_blockDirOffset[direction][axis] != 0)
+						indices[axis] = (s_blockDirOffset[direction][axis] > 0) ? 0 : ChunkSize - 1;
+				}
+
+				neighborChunk.LockWrite();
+				neighborChunk.UpdateBlock(indices, (filled) ? stoneBlock : EmptyBlockIndex);
+				neighborChunk.UnlockWrite();
+			}
+		};
+
+		Planet borderSlicePlanet(1.f, 0.f, 9.81f);
+		BuildPlanet(borderSlicePlanet, InitGround);
+
+		const Chunk& borderSliceChunk = *borderSlicePlanet.GetChunk({ 0, 0, 0 });
+		bool borderSliceFilled = false;
+		BENCHMARK("BuildMesh after neighbor edits (border slices)")
+		{
+			borderSliceFilled = !borderSliceFilled;
+			EditNeighborBorders(borderSlicePlanet, borderSliceFilled);
+
+			return BuildPositionMesh(borderSliceChunk);
+		};
+
+		// Previous path: meshing read neighbor borders through their snapshots, which have to be copied again after every edit
+		Planet snapshotPlanet(1.f, 0.f, 9.81f);
+		BuildPlanet(snapshotPlanet, InitGround);
+
+		const Chunk& snapshotChunk = *snapshotPlanet.GetChunk({ 0, 0, 0 });
+		bool snapshotFilled = false;
+		BENCHMARK("BuildMesh after neighbor edits (neighbor snapshots, previous path)")
+		{
+			snapshotFilled = !snapshotFilled;
+			EditNeighborBorders(snapshotPlanet, snapshotFilled);
+
+			std::size_t blockCount = 0;
+			for (const Nz::Vector3i& chunkOffset : s_chunkDirOffset)
+				blockCount += snapshotPlanet.GetChunk(chunkOffset)->GetSnapshot()->GetBlockCount();
+
+			return BuildPositionMesh(snapshotChunk) + blockCount;
+		};
+
+		CHECK(BuildPositionMesh(borderSliceChunk) == BuildPositionMesh(snapshotChunk));
+	}
+}
+
+TEST_CASE("Chunk serialization", "[Chunks]")
+{
+	BlockLibrary blockLibrary;
+
+	Planet planet(1.f, 16.f, 9.81f);
+
+	// Core, underground and surface chunks of a generated planet
+	for (int y : { 0, 1, 2 })
+	{
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, y, 0 });
+		planet.GenerateChunk(blockLibrary, chunk, 42, Nz::Vector3ui(5));
+
+		Nz::ByteArray byteArray;
+		{
+			Nz::ByteStream byteStream(&byteArray);
+			chunk.Serialize(byteStream);
+		}
+
+		// Version 1 used one byte per block
+		CHECK(byteArray.GetSize() < chunk.GetBlockCount());
+
+		BENCHMARK(fmt::format("Serialize (chunk {})", y))
+		{
+			Nz::ByteArray serializedData;
+			Nz::ByteStream byteStream(&serializedData);
+			chunk.Serialize(byteStream);
+
+			return serializedData.GetSize();
+		};
+
+		Chunk& loadedChunk = planet.AddChunk(blockLibrary, { 1, y, 0 });
+		BENCHMARK(fmt::format("Deserialize (chunk {})", y))
+		{
+			Nz::ByteStream byteStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+			loadedChunk.Deserialize(byteStream);
+
+			return loadedChunk.GetBlockContent(0);
+		};
+	}
+}
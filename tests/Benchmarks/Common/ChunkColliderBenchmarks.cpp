@@ -0,0 +1,45 @@
+#include "BenchmarkHelpers.hpp"
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/Modules.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <Nazara/Physics3D/Physics3D.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tsom;
+
+TEST_CASE("Chunk collider generation", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = Planet::ChunkSize;
+
+	Nz::Modules<Nz::Physics3D> nazara;
+
+	BlockLibrary blockLibrary;
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+	Planet planet(1.f, 0.f, 9.81f);
+
+	FlatChunk flatChunk(blockLibrary, planet, { 0, 0, 0 }, Nz::Vector3ui(ChunkSize), 1.f);
+	FillTerrain(flatChunk, stoneBlock);
+
+	// Box merging only, without building the physics shapes
+	BENCHMARK("FlatChunk box merging")
+	{
+		Nz::Bitset<Nz::UInt64> collisionCellMask = flatChunk.GetCollisionCellMask();
+
+		std::size_t boxCount = 0;
+		FlatChunk::BuildCollider(flatChunk.GetSize(), std::move(collisionCellMask), [&](const Nz::Boxf& /*box*/)
+		{
+			boxCount++;
+		});
+
+		return boxCount;
+	};
+
+	BENCHMARK("FlatChunk::BuildCollider")
+	{
+		return flatChunk.BuildCollider();
+	};
+}
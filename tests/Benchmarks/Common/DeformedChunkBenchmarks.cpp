@@ -0,0 +1,60 @@
+#include "BenchmarkHelpers.hpp"
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/DeformedChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/Modules.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <Nazara/Physics3D/Physics3D.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tsom;
+
+TEST_CASE("Deformed chunk collider generation", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = Planet::ChunkSize;
+	const Nz::Vector3f deformationCenter(ChunkSize * 0.5f);
+
+	Nz::Modules<Nz::Physics3D> nazara;
+
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 0.f, 9.81f);
+
+	DeformedChunk chunk(blockLibrary, planet, { 0, 0, 0 }, Nz::Vector3ui(ChunkSize), 1.f, deformationCenter, 8.f);
+
+	FillTerrain(chunk, blockLibrary.GetBlockIndex("stone"));
+
+	BENCHMARK("Render mesh path")
+	{
+		std::vector<Nz::UInt32> indices;
+		std::vector<Nz::Vector3f> positions;
+
+		chunk.BuildMesh(indices, deformationCenter, [&](Nz::UInt32 count)
+		{
+			Chunk::VertexAttributes vertexAttributes;
+
+			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
+			positions.resize(positions.size() + count);
+			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&positions[vertexAttributes.firstIndex]);
+
+			return vertexAttributes;
+		});
+
+		return indices.size();
+	};
+
+	BENCHMARK("Collision mesh path")
+	{
+		std::vector<Nz::UInt32> indices;
+		std::vector<Nz::Vector3f> positions;
+		chunk.BuildCollisionMesh(positions, indices);
+
+		return indices.size();
+	};
+
+	// Collision mesh path followed by the physics shape creation
+	BENCHMARK("DeformedChunk::BuildCollider")
+	{
+		return chunk.BuildCollider();
+	};
+}
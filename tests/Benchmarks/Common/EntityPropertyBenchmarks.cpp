@@ -0,0 +1,77 @@
+#include <CommonLib/EntityRegistry.hpp>
+#include <CommonLib/Components/ClassInstanceComponent.hpp>
+#include <CommonLib/Components/ScriptedEntityComponent.hpp>
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
+#include <CommonLib/Scripting/SharedEntityScriptingLibrary.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+using namespace tsom;
+
+TEST_CASE("Entity property access from scripts", "[Scripting]")
+{
+	constexpr int IterationCount = 1000;
+
+	sol::state state;
+	state.open_libraries(sol::lib::base);
+
+	ScriptCpuMonitor cpuMonitor(state.lua_state());
+
+	EntityRegistry entityRegistry;
+	SharedEntityScriptingLibrary entityLibrary(entityRegistry);
+	entityLibrary.Register(state);
+
+	state.script(R"(
+		local classData = EntityRegistry.ClassBuilder()
+		classData:AddProperty("active", { type = "bool", default = false })
+		classData:AddProperty("label", { type = "string", default = "bench" })
+		local ammo = classData:AddProperty("ammo", { type = "integer", default = 0 })
+		local speed = classData:AddProperty("speed", { type = "float", default = 0.0 })
+		EntityRegistry.RegisterClass("bench", classData)
+
+		function GetSetByName(entity, n)
+			for i = 1, n do
+				entity:UpdateProperty("speed", entity:GetProperty("speed") + 1.0)
+				entity:UpdateProperty("ammo", entity:GetProperty("ammo") + 1)
+			end
+		end
+
+		function GetSetByHandle(entity, n)
+			for i = 1, n do
+				entity:UpdateProperty(speed, entity:GetProperty(speed) + 1.0)
+				entity:UpdateProperty(ammo, entity:GetProperty(ammo) + 1)
+			end
+		end
+	)");
+
+	std::shared_ptr<const EntityClass> benchClass = entityRegistry.FindClass("bench");
+	REQUIRE(benchClass);
+
+	entt::registry registry;
+	entt::handle entity(registry, registry.create());
+	auto& classInstance = entity.emplace<ClassInstanceComponent>(benchClass);
+	benchClass->ActivateEntity(entity);
+
+	sol::table entityTable = entity.get<ScriptedEntityComponent>().entityTable;
+	sol::protected_function getSetByName = state["GetSetByName"];
+	sol::protected_function getSetByHandle = state["GetSetByHandle"];
+
+	SECTION("Both access paths update the same values")
+	{
+		REQUIRE(getSetByName(entityTable, IterationCount).valid());
+		REQUIRE(getSetByHandle(entityTable, IterationCount).valid());
+		CHECK(*classInstance.GetProperty<EntityPropertyType::Integer>("ammo") == 2 * IterationCount);
+		CHECK(*classInstance.GetProperty<EntityPropertyType::Float>("speed") == float(2 * IterationCount));
+	}
+
+	BENCHMARK("Property get/set by name (1000 iterations)")
+	{
+		return getSetByName(entityTable, IterationCount).valid();
+	};
+
+	BENCHMARK("Property get/set by handle (1000 iterations)")
+	{
+		return getSetByHandle(entityTable, IterationCount).valid();
+	};
+}
@@ -0,0 +1,104 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+using namespace tsom;
+
+namespace
+{
+	template<typename T>
+	Nz::ByteArray SerializePacket(T& packet)
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+
+		PacketSerializer serializer(byteStream, true, BuildVersion(0, 6, 0));
+		Packets::Serialize(serializer, packet);
+
+		byteStream.FlushBits();
+
+		return byteArray;
+	}
+
+	template<typename T>
+	T DeserializePacket(const Nz::ByteArray& byteArray)
+	{
+		Nz::ByteStream byteStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+
+		T packet;
+		PacketSerializer serializer(byteStream, false, BuildVersion(0, 6, 0));
+		Packets::Serialize(serializer, packet);
+
+		return packet;
+	}
+}
+
+TEST_CASE("Packet serialization", "[Network]")
+{
+	SECTION("EntitiesStateUpdate")
+	{
+		constexpr std::size_t EntityCount = 200;
+
+		Packets::EntitiesStateUpdate stateUpdate;
+		stateUpdate.tickIndex = 42;
+		stateUpdate.lastInputIndex = 0;
+
+		for (std::size_t i = 0; i < EntityCount; ++i)
+		{
+			auto& entityData = stateUpdate.entities.emplace_back();
+			entityData.entityId = static_cast<Packets::Helper::EntityId>(i);
+			entityData.newStates.position = Nz::Vector3f(float(i), float(i) * 0.5f, 0.f);
+			entityData.newStates.rotation = Nz::Quaternionf::Identity();
+		}
+
+		Nz::ByteArray byteArray = SerializePacket(stateUpdate);
+
+		BENCHMARK(fmt::format("Serialize EntitiesStateUpdate ({} entities)", EntityCount))
+		{
+			return SerializePacket(stateUpdate).GetSize();
+		};
+
+		BENCHMARK(fmt::format("Deserialize EntitiesStateUpdate ({} entities)", EntityCount))
+		{
+			return DeserializePacket<Packets::EntitiesStateUpdate>(byteArray).entities.size();
+		};
+	}
+
+	SECTION("ChunkReset")
+	{
+		BlockLibrary blockLibrary;
+
+		// Surface chunk of a generated planet
+		Planet planet(1.f, 16.f, 9.81f);
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, 2, 0 });
+		planet.GenerateChunk(blockLibrary, chunk, 42, Nz::Vector3ui(5));
+
+		Packets::ChunkReset chunkReset;
+		chunkReset.tickIndex = 42;
+		chunkReset.chunkId = 0;
+		chunkReset.entityId = 0;
+		chunkReset.content.assign(chunk.GetContent(), chunk.GetContent() + chunk.GetBlockCount());
+
+		Nz::ByteArray byteArray = SerializePacket(chunkReset);
+
+		// Chunk content is compressed
+		CHECK(byteArray.GetSize() < chunk.GetBlockCount() * sizeof(BlockIndex));
+
+		BENCHMARK("Serialize ChunkReset")
+		{
+			return SerializePacket(chunkReset).GetSize();
+		};
+
+		BENCHMARK("Deserialize ChunkReset")
+		{
+			return DeserializePacket<Packets::ChunkReset>(byteArray).content.size();
+		};
+	}
+}
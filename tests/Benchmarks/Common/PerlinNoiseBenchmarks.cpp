@@ -0,0 +1,59 @@
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Utility/BatchedPerlinNoise.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <PerlinNoise.hpp>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Perlin noise", "[Noise]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	constexpr double scale = 0.02;
+	constexpr unsigned int sampleCount = Planet::ChunkSize * Planet::ChunkSize;
+
+	// One chunk face worth of samples
+	std::vector<double> sampleX(sampleCount);
+	std::vector<double> sampleY(sampleCount);
+	for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+	{
+		for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+		{
+			sampleX[y * Planet::ChunkSize + x] = (x + 17.0) * scale;
+			sampleY[y * Planet::ChunkSize + x] = (y - 41.0) * scale;
+		}
+	}
+
+	std::vector<double> output(sampleCount);
+
+	BENCHMARK("siv::PerlinNoise (scalar)")
+	{
+		siv::PerlinNoise noise(seed);
+		for (unsigned int i = 0; i < sampleCount; ++i)
+			output[i] = noise.normalizedOctave2D_01(sampleX[i], sampleY[i], 4);
+
+		return output.back();
+	};
+
+	BatchedPerlinNoise batchedNoise(seed);
+	for (BatchedPerlinNoise::Implementation implementation : { BatchedPerlinNoise::Implementation::Scalar, BatchedPerlinNoise::Implementation::SSE2, BatchedPerlinNoise::Implementation::AVX2 })
+	{
+		if (!BatchedPerlinNoise::IsSupported(implementation))
+			continue;
+
+		const char* name;
+		switch (implementation)
+		{
+			case BatchedPerlinNoise::Implementation::Scalar: name = "BatchedPerlinNoise (scalar)"; break;
+			case BatchedPerlinNoise::Implementation::SSE2:   name = "BatchedPerlinNoise (SSE2)"; break;
+			case BatchedPerlinNoise::Implementation::AVX2:   name = "BatchedPerlinNoise (AVX2)"; break;
+		}
+
+		BENCHMARK(name)
+		{
+			batchedNoise.NormalizedOctave2D_01(implementation, sampleX, sampleY, output, 4);
+			return output.back();
+		};
+	}
+}
@@ -0,0 +1,46 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+using namespace tsom;
+
+TEST_CASE("Planet generation", "[Planet]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(5);
+
+	BlockLibrary blockLibrary;
+	Nz::TaskScheduler taskScheduler;
+
+	// Divide the mean time by the chunk count to get the chunk throughput
+	for (std::size_t capacity : { std::size_t(0), Planet::DefaultHeightmapCacheCapacity })
+	{
+		BENCHMARK(fmt::format("GenerateChunks ({0} chunks, heightmap cache capacity: {1})", chunkCount.x * chunkCount.y * chunkCount.z, capacity))
+		{
+			Planet planet(1.f, 16.f, 9.81f);
+			planet.GetHeightmapCache().UpdateCapacity(capacity);
+			planet.GenerateChunks(blockLibrary, taskScheduler, seed, chunkCount);
+
+			return planet.GetChunkCount();
+		};
+	}
+
+	// Core, underground and surface chunks generated one by one
+	for (int y : { 0, 1, 2 })
+	{
+		Planet planet(1.f, 16.f, 9.81f);
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, y, 0 });
+
+		BENCHMARK(fmt::format("GenerateChunk (chunk {})", y))
+		{
+			planet.GetHeightmapCache().Clear();
+			planet.GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+
+			return chunk.GetBlockContent(0);
+		};
+	}
+}
@@ -0,0 +1,281 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <CommonLib/NetworkSession.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/SessionHandler.hpp>
+#include <CommonLib/Components/PlanetComponent.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <ServerLib/ServerEnvironment.hpp>
+#include <ServerLib/ServerInstance.hpp>
+#include <ServerLib/SessionVisibilityHandler.hpp>
+#include <Nazara/Core/Application.hpp>
+#include <Nazara/Core/FilesystemAppComponent.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <Nazara/Core/Components/NodeComponent.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <Nazara/Physics3D/Physics3D.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	class DispatchEnvironment final : public ServerEnvironment
+	{
+		public:
+			DispatchEnvironment(ServerInstance& serverInstance) :
+			ServerEnvironment(serverInstance, ServerEnvironmentType::Planet)
+			{
+			}
+
+			entt::handle CreateEntity() override
+			{
+				return m_world->CreateEntity();
+			}
+
+			const GravityController* GetGravityController() const override
+			{
+				return nullptr;
+			}
+
+			void OnSave() override
+			{
+			}
+	};
+
+	constexpr SessionHandler::SendAttributeTable s_packetAttributes = SessionHandler::BuildAttributeTable({
+		{ PacketIndex<Packets::BulkCancel>,          { .channel = 3, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::BulkCommit>,          { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::BulkFragment>,        { .channel = 3, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkCreate>,         { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkReset>,          { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkUpdate>,         { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EntitiesCreation>,    { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EntitiesStateUpdate>, { .channel = 1, .flags = Nz::ENetPacketFlag_Unreliable } },
+		{ PacketIndex<Packets::EnvironmentCreate>,   { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+	});
+
+	class DispatchSessionHandler : public SessionHandler
+	{
+		public:
+			DispatchSessionHandler(NetworkSession* session) :
+			SessionHandler(session)
+			{
+				SetupHandlerTable(this);
+				SetupAttributeTable(s_packetAttributes);
+			}
+	};
+
+	struct DispatchSession
+	{
+		std::unique_ptr<NetworkSession> session;
+		std::unique_ptr<SessionVisibilityHandler> visibility;
+	};
+}
+
+TEST_CASE("Session dispatch", "[Network]")
+{
+	constexpr std::size_t SessionCount = 100;
+	constexpr std::size_t MovingEntityCount = 200;
+	constexpr std::size_t BlockUpdatePerTick = 16;
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(3);
+
+	Nz::Application<Nz::Network, Nz::Physics3D> app;
+	app.AddComponent<Nz::FilesystemAppComponent>();
+
+	BlockLibrary blockLibrary;
+	BlockIndex copperBlock = blockLibrary.GetBlockIndex("copper_block");
+	BlockIndex stoneBricksBlock = blockLibrary.GetBlockIndex("stone_bricks");
+
+	ServerInstance::Config instanceConfig;
+	instanceConfig.parallelDispatch = false; //< dispatch is driven by the benchmark
+
+	ServerInstance serverInstance(app, std::move(instanceConfig));
+	DispatchEnvironment environment(serverInstance);
+
+	entt::handle planetEntity = environment.CreateEntity();
+	planetEntity.emplace<Nz::NodeComponent>();
+	auto& planetComponent = planetEntity.emplace<PlanetComponent>();
+	planetComponent.planet = std::make_unique<Planet>(1.f, 16.f, 9.81f);
+
+	std::vector<Chunk*> chunks;
+	for (int y = -1; y <= 1; ++y)
+	{
+		Chunk& chunk = planetComponent.planet->AddChunk(blockLibrary, { 0, y, 0 });
+		planetComponent.planet->GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+		chunks.push_back(&chunk);
+	}
+
+	std::vector<entt::handle> movingEntities;
+	for (std::size_t i = 0; i < MovingEntityCount; ++i)
+	{
+		entt::handle entity = environment.CreateEntity();
+		entity.emplace<Nz::NodeComponent>(Nz::Vector3f(0.f, float(i), 0.f));
+		movingEntities.push_back(entity);
+	}
+
+	// Sessions aren't connected to any peer, the reactor drops their packets once they're flushed
+	NetworkReactor reactor(0, Nz::NetProtocol::IPv4, 0, SessionCount);
+
+	Nz::UInt16 tickIndex = 0;
+
+	// Every session sees the planet (its chunk contents are known through the client cache) and the moving entities
+	auto CreateSessions = [&]
+	{
+		std::vector<DispatchSession> sessions;
+		for (std::size_t i = 0; i < SessionCount; ++i)
+		{
+			auto& dispatchSession = sessions.emplace_back();
+			dispatchSession.session = std::make_unique<NetworkSession>(reactor, i, Nz::IpAddress::LoopbackIpV4);
+			dispatchSession.session->SetProtocolVersion(Constants::ProtocolChunkCacheVersion);
+			dispatchSession.session->SetupHandler<DispatchSessionHandler>();
+
+			dispatchSession.visibility = std::make_unique<SessionVisibilityHandler>(dispatchSession.session.get());
+
+			SessionVisibilityHandler& visibility = *dispatchSession.visibility;
+			visibility.CreateEnvironment(environment, EnvironmentTransform(Nz::Vector3f::Zero(), Nz::Quaternionf::Identity()));
+			visibility.CreateEntity(planetEntity, {
+				.environment = &environment,
+				.initialRotation = Nz::Quaternionf::Identity(),
+				.initialPosition = Nz::Vector3f::Zero(),
+				.isMoving = false
+			});
+
+			for (Chunk* chunk : chunks)
+				visibility.CreateChunk(planetEntity, *chunk);
+
+			for (const entt::handle& entity : movingEntities)
+			{
+				visibility.CreateEntity(entity, {
+					.environment = &environment,
+					.initialRotation = Nz::Quaternionf::Identity(),
+					.initialPosition = entity.get<Nz::NodeComponent>().GetPosition(),
+					.isMoving = true
+				});
+			}
+
+			visibility.Dispatch(tickIndex);
+			dispatchSession.session->FlushBufferedPackets();
+		}
+
+		return sessions;
+	};
+
+	// Moves entities and edits chunks like a server tick would, before visibility dispatch
+	auto UpdateWorld = [&]
+	{
+		tickIndex++;
+
+		for (const entt::handle& entity : movingEntities)
+			entity.get<Nz::NodeComponent>().Move(Nz::Vector3f(0.f, 0.f, 0.1f));
+
+		for (Chunk* chunk : chunks)
+		{
+			const Nz::Vector3ui& chunkSize = chunk->GetSize();
+			for (std::size_t i = 0; i < BlockUpdatePerTick; ++i)
+			{
+				unsigned int blockIndex = Nz::SafeCast<unsigned int>((tickIndex * BlockUpdatePerTick + i) * 7919 % chunk->GetBlockCount());
+				Nz::Vector3ui position(blockIndex % chunkSize.x, (blockIndex / chunkSize.x) % chunkSize.y, blockIndex / (chunkSize.x * chunkSize.y));
+				chunk->UpdateBlock(position, (tickIndex % 2) ? copperBlock : stoneBricksBlock);
+			}
+		}
+	};
+
+	// Dispatches every session like the server network tick does, returns the number of bytes sent
+	auto DispatchTick = [&](std::vector<DispatchSession>& sessions, Nz::TaskScheduler* taskScheduler, std::vector<std::vector<Nz::ByteArray>>* packets = nullptr)
+	{
+		for (auto& dispatchSession : sessions)
+			dispatchSession.session->BeginPacketBuffering();
+
+		if (taskScheduler)
+		{
+			for (auto& dispatchSession : sessions)
+			{
+				taskScheduler->AddTask([&dispatchSession, tickIndex]
+				{
+					dispatchSession.visibility->Dispatch(tickIndex);
+				});
+			}
+
+			taskScheduler->WaitForTasks();
+		}
+		else
+		{
+			for (auto& dispatchSession : sessions)
+				dispatchSession.visibility->Dispatch(tickIndex);
+		}
+
+		std::size_t byteCount = 0;
+		for (auto& dispatchSession : sessions)
+		{
+			std::vector<Nz::ByteArray>* sessionPackets = (packets) ? &packets->emplace_back() : nullptr;
+			for (const NetworkSession::BufferedPacket& bufferedPacket : dispatchSession.session->GetBufferedPackets())
+			{
+				byteCount += bufferedPacket.payload.GetSize();
+				if (sessionPackets)
+					sessionPackets->push_back(bufferedPacket.payload);
+			}
+
+			dispatchSession.session->FlushBufferedPackets();
+		}
+
+		return byteCount;
+	};
+
+	unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+
+	Nz::TaskScheduler singleThreadScheduler(1);
+	Nz::TaskScheduler multiThreadScheduler(threadCount);
+
+	SECTION("Packet streams are the same when dispatching in parallel")
+	{
+		std::vector<DispatchSession> sequentialSessions = CreateSessions();
+		std::vector<DispatchSession> parallelSessions = CreateSessions();
+
+		for (std::size_t tick = 0; tick < 3; ++tick)
+		{
+			UpdateWorld();
+
+			std::vector<std::vector<Nz::ByteArray>> sequentialPackets;
+			DispatchTick(sequentialSessions, nullptr, &sequentialPackets);
+
+			std::vector<std::vector<Nz::ByteArray>> parallelPackets;
+			DispatchTick(parallelSessions, &multiThreadScheduler, &parallelPackets);
+
+			CHECK(sequentialPackets == parallelPackets);
+		}
+	}
+
+	SECTION("Benchmark")
+	{
+		std::vector<DispatchSession> sessions = CreateSessions();
+
+		// Divide the mean time by the session count to get the dispatch cost per player
+		BENCHMARK(fmt::format("Dispatch ({0} sessions, tick thread)", SessionCount))
+		{
+			UpdateWorld();
+			return DispatchTick(sessions, nullptr);
+		};
+
+		BENCHMARK(fmt::format("Dispatch ({0} sessions, 1 worker)", SessionCount))
+		{
+			UpdateWorld();
+			return DispatchTick(sessions, &singleThreadScheduler);
+		};
+
+		BENCHMARK(fmt::format("Dispatch ({0} sessions, {1} workers)", SessionCount, threadCount))
+		{
+			UpdateWorld();
+			return DispatchTick(sessions, &multiThreadScheduler);
+		};
+	}
+}
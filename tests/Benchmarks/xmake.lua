@@ -0,0 +1,8 @@
+target("Benchmarks", function ()
+    add_deps("CommonLib", "ServerLib")
+    add_packages("catch2", "perlinnoise")
+    add_files("**.cpp")
+
+    -- Results are also written as XML so they can be compared between commits (see xmake compare-benchmarks)
+    set_runargs("--reporter", "console", "--reporter", "xml::out=benchmarks.xml")
+end)
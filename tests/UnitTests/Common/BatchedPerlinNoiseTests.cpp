@@ -0,0 +1,101 @@
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Utility/BatchedPerlinNoise.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <PerlinNoise.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Batched perlin noise", "[Noise]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	constexpr double scale = 0.02;
+
+	// Sample the noise on the same points as the planet generator does for a 5x5x5 chunk planet (+Z face)
+	Planet planet(1.f, 0.f, 9.81f);
+
+	std::vector<double> sampleX;
+	std::vector<double> sampleY;
+	for (int chunkY = -2; chunkY <= 2; ++chunkY)
+	{
+		for (int chunkX = -2; chunkX <= 2; ++chunkX)
+		{
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices({ chunkX, chunkY, 2 }, { x, 0, y });
+					sampleX.push_back(mapPos.x * scale);
+					sampleY.push_back(mapPos.y * scale);
+				}
+			}
+		}
+	}
+
+	// Add a few samples so the count isn't a multiple of any SIMD width
+	for (unsigned int i = 0; i < 7; ++i)
+	{
+		sampleX.push_back(-1.37 + i * 0.511);
+		sampleY.push_back(2.71 - i * 0.173);
+	}
+
+	SECTION("Matching siv::PerlinNoise")
+	{
+		// Both sides use the same operations in the same order, the only way for them to differ would be for the compiler
+		// to contract the reference code floating-point operations (FMA), which doesn't happen with default build flags
+		for (Nz::UInt32 faceSeed = seed; faceSeed < seed + 6; ++faceSeed)
+		{
+			siv::PerlinNoise reference(faceSeed);
+			BatchedPerlinNoise noise(faceSeed);
+
+			std::vector<double> output(sampleX.size());
+			noise.NormalizedOctave2D_01(BatchedPerlinNoise::Implementation::Scalar, sampleX, sampleY, output, 4);
+
+			std::size_t mismatchCount = 0;
+			for (std::size_t i = 0; i < sampleX.size(); ++i)
+			{
+				if (output[i] != reference.normalizedOctave2D_01(sampleX[i], sampleY[i], 4))
+					mismatchCount++;
+			}
+
+			CHECK(mismatchCount == 0);
+		}
+	}
+
+	SECTION("Every implementation gives the same result")
+	{
+		BatchedPerlinNoise noise(seed);
+
+		std::vector<double> expected(sampleX.size());
+		noise.NormalizedOctave2D_01(BatchedPerlinNoise::Implementation::Scalar, sampleX, sampleY, expected, 4);
+
+		for (BatchedPerlinNoise::Implementation implementation : { BatchedPerlinNoise::Implementation::SSE2, BatchedPerlinNoise::Implementation::AVX2 })
+		{
+			if (!BatchedPerlinNoise::IsSupported(implementation))
+				continue;
+
+			// Also check partial batches
+			for (std::size_t sampleCount : { std::size_t(1), std::size_t(3), std::size_t(5), sampleX.size() })
+			{
+				std::vector<double> output(sampleCount);
+				noise.NormalizedOctave2D_01(implementation, std::span(sampleX).first(sampleCount), std::span(sampleY).first(sampleCount), output, 4);
+
+				CHECK(std::equal(output.begin(), output.end(), expected.begin()));
+			}
+		}
+
+		std::vector<double> output(sampleX.size());
+		noise.NormalizedOctave2D_01(sampleX, sampleY, output, 4);
+		CHECK(output == expected);
+	}
+
+	SECTION("Reseeding")
+	{
+		BatchedPerlinNoise noise;
+		noise.Reseed(seed);
+
+		CHECK(noise.GetPermutation() == BatchedPerlinNoise(seed).GetPermutation());
+		CHECK(noise.GetPermutation() != BatchedPerlinNoise(seed + 1).GetPermutation());
+	}
+}
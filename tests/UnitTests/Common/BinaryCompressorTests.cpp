@@ -0,0 +1,216 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <CommonLib/Utility/BinaryCompressor.hpp>
+#include <CommonLib/Utility/CompressionDictionary.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <NazaraUtils/PathUtils.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+
+using namespace tsom;
+
+TEST_CASE("Binary compressor", "[Compression]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(3);
+
+	BlockLibrary blockLibrary;
+
+	Planet planet(1.f, 16.f, 9.81f);
+	Chunk& chunk = planet.AddChunk(blockLibrary, { 0, 1, 0 });
+	planet.GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+
+	std::vector<BlockIndex> content(chunk.GetContent(), chunk.GetContent() + chunk.GetBlockCount());
+	std::size_t contentSize = content.size() * sizeof(BlockIndex);
+
+	std::shared_ptr<const CompressionDictionary> dictionary = Planet::TrainChunkDictionary(blockLibrary, Constants::ChunkCompressionDictionaryId);
+	REQUIRE(dictionary);
+	REQUIRE(dictionary->GetId() == Constants::ChunkCompressionDictionaryId);
+	REQUIRE(dictionary->GetContent().size() <= CompressionDictionary::MaxSize);
+
+	BinaryCompressor compressor;
+
+	auto CheckRoundTrip = [&](const CompressionProfile& profile)
+	{
+		std::optional compressedData = compressor.CompressFrame(profile, content.data(), contentSize);
+		REQUIRE(compressedData);
+
+		std::vector<Nz::UInt8> frame(compressedData->begin(), compressedData->end());
+		CHECK(frame.size() < contentSize);
+
+		std::vector<BlockIndex> decompressedContent(content.size());
+		std::optional<std::size_t> decompressedSize = compressor.DecompressFrame(frame.data(), frame.size(), decompressedContent.data(), contentSize, profile.dictionary.get());
+		REQUIRE(decompressedSize);
+		CHECK(*decompressedSize == contentSize);
+		CHECK(decompressedContent == content);
+	};
+
+	SECTION("Legacy LZ4 blocks")
+	{
+		std::optional compressedData = compressor.Compress(content.data(), contentSize);
+		REQUIRE(compressedData);
+
+		std::vector<Nz::UInt8> compressed(compressedData->begin(), compressedData->end());
+
+		std::vector<BlockIndex> decompressedContent(content.size());
+		std::optional<std::size_t> decompressedSize = compressor.Decompress(compressed.data(), compressed.size(), decompressedContent.data(), contentSize);
+		REQUIRE(decompressedSize);
+		CHECK(*decompressedSize == contentSize);
+		CHECK(decompressedContent == content);
+	}
+
+	SECTION("Frames round-trip")
+	{
+		for (CompressionCodec codec : { CompressionCodec::LZ4, CompressionCodec::LZ4HC, CompressionCodec::Zstd })
+		{
+			if (!BinaryCompressor::IsCodecSupported(codec))
+			{
+				CompressionProfile profile;
+				profile.codec = codec;
+				CHECK_FALSE(compressor.CompressFrame(profile, content.data(), contentSize));
+				continue;
+			}
+
+			CompressionProfile profile;
+			profile.codec = codec;
+			CheckRoundTrip(profile);
+
+			profile.dictionary = dictionary;
+			CheckRoundTrip(profile);
+		}
+	}
+
+	SECTION("Mismatching dictionaries are rejected")
+	{
+		std::vector<Nz::UInt8> otherContent(1024);
+		for (std::size_t i = 0; i < otherContent.size(); ++i)
+			otherContent[i] = static_cast<Nz::UInt8>(i * 7);
+
+		CompressionDictionary otherDictionary(dictionary->GetId() + 1, std::move(otherContent));
+
+		CompressionProfile profile;
+		profile.dictionary = dictionary;
+
+		std::optional compressedData = compressor.CompressFrame(profile, content.data(), contentSize);
+		REQUIRE(compressedData);
+
+		std::vector<Nz::UInt8> frame(compressedData->begin(), compressedData->end());
+
+		std::vector<BlockIndex> decompressedContent(content.size());
+		CHECK_FALSE(compressor.DecompressFrame(frame.data(), frame.size(), decompressedContent.data(), contentSize, nullptr));
+		CHECK_FALSE(compressor.DecompressFrame(frame.data(), frame.size(), decompressedContent.data(), contentSize, &otherDictionary));
+		CHECK(compressor.DecompressFrame(frame.data(), frame.size(), decompressedContent.data(), contentSize, dictionary.get()));
+
+		// Corrupted codec
+		frame[0] = 0x7F;
+		CHECK_FALSE(compressor.DecompressFrame(frame.data(), frame.size(), decompressedContent.data(), contentSize, dictionary.get()));
+	}
+
+	SECTION("Dictionary files")
+	{
+		std::filesystem::path dictionaryPath = std::filesystem::temp_directory_path() / Nz::Utf8Path("tsom_test_dictionary.tsdict");
+		REQUIRE(dictionary->SaveToFile(dictionaryPath));
+
+		std::shared_ptr<CompressionDictionary> loadedDictionary = CompressionDictionary::LoadFromFile(dictionaryPath);
+		std::filesystem::remove(dictionaryPath);
+
+		REQUIRE(loadedDictionary);
+		CHECK(loadedDictionary->GetId() == dictionary->GetId());
+		CHECK(loadedDictionary->GetContent() == dictionary->GetContent());
+
+		// The shipped asset (produced by xmake train-chunk-dictionary) must be the trainer output under the id peers advertise
+		std::filesystem::path shippedDictionaryPath = Nz::Utf8Path(Constants::ChunkCompressionDictionaryPath);
+		if (std::filesystem::exists(shippedDictionaryPath))
+		{
+			std::shared_ptr<CompressionDictionary> shippedDictionary = CompressionDictionary::LoadFromFile(shippedDictionaryPath);
+			REQUIRE(shippedDictionary);
+			CHECK(shippedDictionary->GetId() == Constants::ChunkCompressionDictionaryId);
+			CHECK(shippedDictionary->GetContent() == dictionary->GetContent());
+
+			CompressionProfile profile;
+			profile.dictionary = shippedDictionary;
+			CheckRoundTrip(profile);
+		}
+	}
+
+	SECTION("Profile negotiation")
+	{
+		CompressionProfile profile;
+		profile.codec = CompressionCodec::LZ4HC;
+		profile.level = 12;
+		profile.dictionary = dictionary;
+
+		CompressionCapabilities legacyPeer; //< peer which didn't advertise anything
+		CompressionProfile negotiatedProfile = BinaryCompressor::NegotiateProfile(profile, legacyPeer);
+		CHECK(negotiatedProfile.codec == CompressionCodec::LZ4);
+		CHECK(negotiatedProfile.level == 0);
+		CHECK_FALSE(negotiatedProfile.dictionary);
+
+		CompressionCapabilities localCapabilities = BinaryCompressor::GetLocalCapabilities();
+		CHECK(localCapabilities.codecMask & (1 << static_cast<int>(CompressionCodec::LZ4)));
+		CHECK(localCapabilities.dictionaries.empty());
+
+		// Peer without our dictionary version
+		localCapabilities.dictionaries.push_back(dictionary->GetId() + 1);
+		negotiatedProfile = BinaryCompressor::NegotiateProfile(profile, localCapabilities);
+		CHECK(negotiatedProfile.codec == CompressionCodec::LZ4HC);
+		CHECK_FALSE(negotiatedProfile.dictionary);
+
+		localCapabilities.dictionaries.push_back(dictionary->GetId());
+		negotiatedProfile = BinaryCompressor::NegotiateProfile(profile, localCapabilities);
+		CHECK(negotiatedProfile.codec == CompressionCodec::LZ4HC);
+		CHECK(negotiatedProfile.level == 12);
+		CHECK(negotiatedProfile.dictionary == dictionary);
+
+		// Acceleration is a separate LZ4 setting
+		profile.codec = CompressionCodec::LZ4;
+		profile.acceleration = 8;
+		CheckRoundTrip(profile);
+
+		CHECK(BinaryCompressor::ParseCodec("lz4hc") == CompressionCodec::LZ4HC);
+		CHECK_FALSE(BinaryCompressor::ParseCodec("deflate"));
+	}
+
+	SECTION("ChunkReset packet")
+	{
+		for (Nz::UInt32 protocolVersion : { BuildVersion(0, 5, 0), Constants::ProtocolCompressionFrameVersion })
+		{
+			Packets::ChunkReset chunkReset;
+			chunkReset.tickIndex = 42;
+			chunkReset.entityId = 1;
+			chunkReset.chunkId = 2;
+			chunkReset.content = content;
+
+			// Both sessions hold the same dictionary after the handshake
+			CompressionProfile sessionProfile;
+			sessionProfile.codec = CompressionCodec::LZ4HC;
+			sessionProfile.dictionary = dictionary;
+
+			Nz::ByteArray byteArray;
+			{
+				Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+
+				PacketSerializer serializer(byteStream, true, protocolVersion, compressor);
+				serializer.SetCompressionProfile(&sessionProfile);
+				Packets::Serialize(serializer, chunkReset);
+			}
+
+			Nz::ByteStream byteStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+
+			Packets::ChunkReset receivedChunkReset;
+			PacketSerializer serializer(byteStream, false, protocolVersion, compressor);
+			serializer.SetCompressionProfile(&sessionProfile);
+			Packets::Serialize(serializer, receivedChunkReset);
+
+			CHECK(receivedChunkReset.tickIndex == chunkReset.tickIndex);
+			CHECK(receivedChunkReset.entityId == chunkReset.entityId);
+			CHECK(receivedChunkReset.chunkId == chunkReset.chunkId);
+			CHECK(receivedChunkReset.content == content);
+		}
+	}
+}
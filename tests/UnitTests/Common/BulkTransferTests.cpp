@@ -0,0 +1,343 @@
+#include <CommonLib/BulkTransferReceiver.hpp>
+#include <CommonLib/BulkTransferSender.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/Modules.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	constexpr Nz::UInt32 ProtocolVersion = BuildVersion(0, 6, 0);
+
+	template<typename T>
+	Nz::ByteArray SerializePacket(const T& packet)
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+		byteStream << Nz::UInt8(PacketIndex<T>);
+
+		PacketSerializer serializer(byteStream, true, ProtocolVersion);
+		Packets::Serialize(serializer, const_cast<T&>(packet));
+
+		byteStream.FlushBits();
+
+		return byteArray;
+	}
+
+	template<typename T>
+	T DeserializePacket(const Nz::ByteArray& byteArray)
+	{
+		Nz::ByteStream byteStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+
+		Nz::UInt8 opcode;
+		byteStream >> opcode;
+		REQUIRE(opcode == PacketIndex<T>);
+
+		T packet;
+		PacketSerializer serializer(byteStream, false, ProtocolVersion);
+		Packets::Serialize(serializer, packet);
+
+		return packet;
+	}
+
+	Nz::ByteArray BuildPayload(std::size_t size, Nz::UInt32 seed)
+	{
+		std::minstd_rand rand(seed);
+
+		Nz::ByteArray payload;
+		payload.Resize(size);
+		for (std::size_t i = 0; i < size; ++i)
+			payload[i] = Nz::UInt8(rand());
+
+		return payload;
+	}
+}
+
+TEST_CASE("Bulk transfers", "[Network]")
+{
+	constexpr std::size_t FragmentSize = 100;
+
+	BulkTransferSender sender(nullptr, FragmentSize);
+	BulkTransferReceiver receiver;
+
+	// Fragments go through their serialization, acknowledgments are kept to be triggered later
+	std::vector<std::function<void()>> pendingAcks;
+	auto SendFragment = [&](const Packets::BulkFragment& fragment, std::function<void(std::size_t packetSize)> acknowledgeCallback)
+	{
+		Nz::ByteArray packet = SerializePacket(fragment);
+		CHECK(receiver.HandleFragment(DeserializePacket<Packets::BulkFragment>(packet)));
+
+		// Budgets are checked against the expected packet size
+		std::size_t packetSize = packet.GetSize();
+		CHECK(packetSize == BulkTransferSender::ComputeFragmentPacketSize(fragment.transferId, fragment.offset, fragment.totalSize, fragment.data.size()));
+		pendingAcks.push_back([acknowledgeCallback, packetSize] { acknowledgeCallback(packetSize); });
+
+		return packetSize;
+	};
+
+	auto AcknowledgeAll = [&]
+	{
+		for (auto& ack : pendingAcks)
+			ack();
+
+		pendingAcks.clear();
+	};
+
+	std::vector<BulkTransferSender::TransferId> completedTransfers;
+	auto PollCompleted = [&]
+	{
+		completedTransfers.clear();
+		sender.PollCompletedTransfers([&](BulkTransferSender::TransferId transferId) { completedTransfers.push_back(transferId); });
+	};
+
+	SECTION("Payloads are reassembled and delivered on commit")
+	{
+		Nz::ByteArray firstPayload = BuildPayload(250, 1);
+		Nz::ByteArray secondPayload = BuildPayload(0, 2);
+
+		BulkTransferSender::TransferId firstTransfer = sender.Enqueue(firstPayload);
+		BulkTransferSender::TransferId secondTransfer = sender.Enqueue(secondPayload);
+		CHECK(sender.GetQueuedBytes() == 250);
+
+		std::size_t firstFragmentSize = BulkTransferSender::ComputeFragmentPacketSize(firstTransfer, 0, 250, 100);
+		std::size_t secondFragmentSize = BulkTransferSender::ComputeFragmentPacketSize(firstTransfer, 100, 250, 100);
+		std::size_t thirdFragmentSize = BulkTransferSender::ComputeFragmentPacketSize(firstTransfer, 200, 250, 50);
+		std::size_t emptyFragmentSize = BulkTransferSender::ComputeFragmentPacketSize(secondTransfer, 0, 0, 0);
+
+		// Only whole fragments are sent within the budget, including their header
+		CHECK(sender.Flush(firstFragmentSize + 99, SendFragment) == firstFragmentSize);
+		CHECK(pendingAcks.size() == 1);
+		CHECK(sender.HasQueuedData());
+
+		CHECK(sender.Flush(secondFragmentSize - 1, SendFragment) == 0);
+		CHECK(pendingAcks.size() == 1);
+
+		CHECK(sender.Flush(1000, SendFragment) == secondFragmentSize + thirdFragmentSize + emptyFragmentSize);
+		CHECK(pendingAcks.size() == 4); //< 100 + 50 + empty payload
+		CHECK_FALSE(sender.HasQueuedData());
+		CHECK(sender.GetInFlightTransferCount() == 2);
+
+		// Nothing can be committed before all fragments are acknowledged
+		PollCompleted();
+		CHECK(completedTransfers.empty());
+
+		AcknowledgeAll();
+		PollCompleted();
+		CHECK(completedTransfers == std::vector<BulkTransferSender::TransferId>{ firstTransfer, secondTransfer });
+		CHECK(sender.GetInFlightTransferCount() == 0);
+
+		std::optional<Nz::ByteArray> firstReceived = receiver.Commit(firstTransfer);
+		REQUIRE(firstReceived);
+		CHECK(*firstReceived == firstPayload);
+
+		std::optional<Nz::ByteArray> secondReceived = receiver.Commit(secondTransfer);
+		REQUIRE(secondReceived);
+		CHECK(secondReceived->GetSize() == 0);
+
+		CHECK(receiver.GetPendingTransferCount() == 0);
+		CHECK(receiver.GetPendingBytes() == 0);
+	}
+
+	SECTION("Cancelled transfers are dropped on both sides")
+	{
+		BulkTransferSender::TransferId transferId = sender.Enqueue(BuildPayload(1000, 3));
+
+		// Transfers not started yet don't require to notify the receiver
+		BulkTransferSender::TransferId unsentTransferId = sender.Enqueue(BuildPayload(1000, 4));
+		CHECK_FALSE(sender.Cancel(unsentTransferId));
+
+		std::size_t budget = 0;
+		for (Nz::UInt32 offset : { 0, 100, 200 })
+			budget += BulkTransferSender::ComputeFragmentPacketSize(transferId, offset, 1000, FragmentSize);
+
+		CHECK(sender.Flush(budget, SendFragment) == budget);
+		CHECK(pendingAcks.size() == 3);
+		CHECK(receiver.GetPendingTransferCount() == 1);
+		CHECK_FALSE(receiver.Commit(transferId)); //< incomplete
+
+		CHECK(sender.Cancel(transferId));
+		receiver.Cancel(transferId);
+
+		CHECK_FALSE(sender.HasQueuedData());
+		CHECK(sender.GetQueuedBytes() == 0);
+		CHECK(receiver.GetPendingTransferCount() == 0);
+		CHECK(receiver.GetPendingBytes() == 0);
+
+		// Late acknowledgments of cancelled transfers are harmless
+		AcknowledgeAll();
+		PollCompleted();
+		CHECK(completedTransfers.empty());
+	}
+
+	SECTION("Receiver rejects malformed fragments")
+	{
+		Packets::BulkFragment fragment;
+		fragment.transferId = 42;
+		fragment.offset = 10; //< transfer was never started
+		fragment.totalSize = 20;
+		fragment.data.resize(10);
+		CHECK_FALSE(receiver.HandleFragment(std::move(fragment)));
+
+		Packets::BulkFragment oversizedFragment;
+		oversizedFragment.transferId = 43;
+		oversizedFragment.offset = 0;
+		oversizedFragment.totalSize = 5;
+		oversizedFragment.data.resize(10);
+		CHECK_FALSE(receiver.HandleFragment(std::move(oversizedFragment)));
+
+		Packets::BulkFragment hugeFragment;
+		hugeFragment.transferId = 44;
+		hugeFragment.offset = 0;
+		hugeFragment.totalSize = Nz::UInt32(Constants::BulkTransferMaxSize + 1);
+		CHECK_FALSE(receiver.HandleFragment(std::move(hugeFragment)));
+	}
+}
+
+TEST_CASE("Bulk transfers don't delay gameplay packets", "[Network]")
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr Nz::UInt8 GameplayChannel = 1;
+	constexpr Nz::UInt8 BulkChannel = 3;
+	constexpr std::size_t ChunkCount = 64;
+	constexpr std::size_t ChunkSize = 64 * 1024;
+	constexpr std::size_t TickBudget = 32 * 1024;
+	constexpr auto TickDuration = std::chrono::milliseconds(16);
+	constexpr auto Timeout = std::chrono::seconds(30);
+
+	constexpr std::size_t FragmentsPerChunk = (ChunkSize + Constants::BulkFragmentMaxSize - 1) / Constants::BulkFragmentMaxSize;
+	constexpr std::size_t TotalFragmentCount = ChunkCount * FragmentsPerChunk;
+
+	Nz::Modules<Nz::Network> nazara;
+
+	std::atomic_size_t acknowledgedFragments = 0; //< incremented on the reactor thread, must outlive it
+
+	// Port 0 binds an ephemeral port, so concurrent test runs don't collide
+	NetworkReactor serverReactor(0, Nz::NetProtocol::IPv4, 0, 1);
+	NetworkReactor clientReactor(0, Nz::NetProtocol::IPv4, 0, 1);
+	REQUIRE(serverReactor.GetBoundPort() != 0);
+
+	std::size_t serverPeerId = NetworkReactor::InvalidPeerId;
+	bool isClientConnected = false;
+	bool gameplayPacketReceived = false;
+	std::size_t receivedFragments = 0;
+	std::optional<std::size_t> receivedFragmentsBeforeGameplay;
+
+	auto PollReactors = [&]
+	{
+		serverReactor.Poll([&](bool /*outgoingConnection*/, std::size_t peerId, const Nz::IpAddress& /*remoteAddress*/, Nz::UInt32 /*data*/)
+		{
+			serverPeerId = peerId;
+		},
+		[](std::size_t /*peerId*/, Nz::UInt32 /*data*/, bool /*timeout*/) {},
+		[](std::size_t /*peerId*/, Nz::ByteArray&& /*packet*/) {});
+
+		clientReactor.Poll([&](bool /*outgoingConnection*/, std::size_t /*peerId*/, const Nz::IpAddress& /*remoteAddress*/, Nz::UInt32 /*data*/)
+		{
+			isClientConnected = true;
+		},
+		[](std::size_t /*peerId*/, Nz::UInt32 /*data*/, bool /*timeout*/) {},
+		[&](std::size_t /*peerId*/, Nz::ByteArray&& packet)
+		{
+			if (packet.GetSize() == 0)
+				return;
+
+			if (packet[0] == PacketIndex<Packets::BulkFragment>)
+				receivedFragments++;
+			else if (packet[0] == PacketIndex<Packets::EntitiesCreation>)
+			{
+				gameplayPacketReceived = true;
+				receivedFragmentsBeforeGameplay = receivedFragments;
+			}
+		});
+	};
+
+	Nz::IpAddress serverAddress = Nz::IpAddress::LoopbackIpV4;
+	serverAddress.SetPort(serverReactor.GetBoundPort());
+	REQUIRE(clientReactor.ConnectTo(serverAddress) != NetworkReactor::InvalidPeerId);
+
+	Clock::time_point connectionStart = Clock::now();
+	while ((serverPeerId == NetworkReactor::InvalidPeerId || !isClientConnected) && Clock::now() - connectionStart < Timeout)
+	{
+		PollReactors();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	REQUIRE(serverPeerId != NetworkReactor::InvalidPeerId);
+	REQUIRE(isClientConnected);
+
+	Packets::EntitiesCreation entitiesCreation;
+	entitiesCreation.tickIndex = 0;
+	Nz::ByteArray gameplayPacket = SerializePacket(entitiesCreation);
+
+	std::size_t sentFragments = 0;
+	std::size_t maxFlushedBytes = 0;
+
+	BulkTransferSender sender;
+	auto FlushFragments = [&]
+	{
+		std::size_t flushedBytes = sender.Flush(TickBudget, [&](const Packets::BulkFragment& fragment, std::function<void(std::size_t packetSize)> acknowledgeCallback)
+		{
+			Nz::ByteArray packet = SerializePacket(fragment);
+			std::size_t packetSize = packet.GetSize();
+			serverReactor.SendData(serverPeerId, BulkChannel, Nz::ENetPacketFlag::Reliable, std::move(packet), [&acknowledgedFragments, acknowledgeCallback, packetSize]
+			{
+				acknowledgedFragments++;
+				acknowledgeCallback(packetSize);
+			});
+
+			sentFragments++;
+			return packetSize;
+		});
+
+		maxFlushedBytes = std::max(maxFlushedBytes, flushedBytes);
+	};
+
+	for (std::size_t i = 0; i < ChunkCount; ++i)
+		sender.Enqueue(BuildPayload(ChunkSize, Nz::UInt32(i)));
+
+	// Only a tick worth of fragments is handed to the network before the gameplay packet
+	FlushFragments();
+	std::size_t fragmentsPerTick = sentFragments;
+	CHECK(fragmentsPerTick > 0);
+	CHECK(fragmentsPerTick <= TickBudget / Constants::BulkFragmentMaxSize);
+
+	serverReactor.SendData(serverPeerId, GameplayChannel, Nz::ENetPacketFlag::Reliable, Nz::ByteArray(gameplayPacket));
+
+	std::size_t completedTransfers = 0;
+	Clock::time_point transferStart = Clock::now();
+	while ((sender.HasQueuedData() || sender.GetInFlightTransferCount() > 0 || receivedFragments < TotalFragmentCount) && Clock::now() - transferStart < Timeout)
+	{
+		FlushFragments();
+		sender.PollCompletedTransfers([&](BulkTransferSender::TransferId) { completedTransfers++; });
+		PollReactors();
+		std::this_thread::sleep_for(TickDuration);
+	}
+
+	CHECK(maxFlushedBytes <= TickBudget);
+	CHECK(sentFragments == TotalFragmentCount);
+	CHECK(acknowledgedFragments == TotalFragmentCount);
+	CHECK(receivedFragments == TotalFragmentCount);
+	CHECK(completedTransfers == ChunkCount);
+
+	// The gameplay packet didn't wait for the burst, it arrived while most fragments were still queued on the sender
+	REQUIRE(gameplayPacketReceived);
+	REQUIRE(receivedFragmentsBeforeGameplay);
+	INFO(*receivedFragmentsBeforeGameplay << " fragments were received before the gameplay packet (" << fragmentsPerTick << " per tick)");
+	CHECK(*receivedFragmentsBeforeGameplay < TotalFragmentCount / 2);
+}
@@ -0,0 +1,192 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkChangeSet.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace tsom;
+
+namespace
+{
+	std::size_t SendUpdate(const Packets::ChunkUpdate& chunkUpdate, Nz::UInt32 protocolVersion, Chunk& clientChunk)
+	{
+		Nz::ByteArray byteArray;
+		{
+			Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+
+			PacketSerializer serializer(byteStream, true, protocolVersion);
+			Packets::Serialize(serializer, const_cast<Packets::ChunkUpdate&>(chunkUpdate));
+		}
+
+		Nz::ByteStream byteStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+
+		Packets::ChunkUpdate receivedChunkUpdate;
+		PacketSerializer serializer(byteStream, false, protocolVersion);
+		Packets::Serialize(serializer, receivedChunkUpdate);
+
+		for (auto&& [blockPos, blockIndex] : receivedChunkUpdate.updates)
+			clientChunk.UpdateBlock({ blockPos.x, blockPos.y, blockPos.z }, blockIndex);
+
+		return byteArray.GetSize();
+	}
+}
+
+TEST_CASE("Chunk change sets", "[Chunks]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(3);
+	const ChunkIndices chunkIndices(0, 1, 0); //< surface chunk
+
+	BlockLibrary blockLibrary;
+	BlockIndex copperBlock = blockLibrary.GetBlockIndex("copper_block");
+	BlockIndex stoneBricksBlock = blockLibrary.GetBlockIndex("stone_bricks");
+
+	Planet serverPlanet(1.f, 16.f, 9.81f);
+	Chunk& serverChunk = serverPlanet.AddChunk(blockLibrary, chunkIndices);
+	serverPlanet.GenerateChunk(blockLibrary, serverChunk, seed, chunkCount);
+
+	Planet clientPlanet(1.f, 16.f, 9.81f);
+	Chunk& clientChunk = clientPlanet.AddChunk(blockLibrary, chunkIndices);
+	clientPlanet.GenerateChunk(blockLibrary, clientChunk, seed, chunkCount);
+
+	// Same tracking as the server session visibility handler
+	ChunkChangeSet changeSet;
+	NazaraSlot(Chunk, OnBlockUpdated, onBlockUpdated);
+	onBlockUpdated.Connect(serverChunk.OnBlockUpdated, [&](Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex /*newBlock*/)
+	{
+		changeSet.MarkBlock(chunk->GetBlockLocalIndex(indices));
+	});
+
+	auto CheckClientContent = [&]
+	{
+		CHECK(std::equal(clientChunk.GetContent(), clientChunk.GetContent() + clientChunk.GetBlockCount(), serverChunk.GetContent()));
+	};
+
+	std::mt19937 rand(seed);
+	const Nz::Vector3ui chunkSize = serverChunk.GetSize();
+
+	SECTION("Repeated edits only send the final content")
+	{
+		for (BlockIndex blockIndex : { copperBlock, stoneBricksBlock, EmptyBlockIndex, copperBlock })
+			serverChunk.UpdateBlock({ 1, 2, 3 }, blockIndex);
+
+		CHECK(changeSet.GetChangedBlockCount() == 1);
+
+		Packets::ChunkUpdate chunkUpdate;
+		chunkUpdate.tickIndex = 0;
+		chunkUpdate.chunkId = 0;
+		chunkUpdate.entityId = 0;
+		changeSet.BuildUpdates(serverChunk, chunkUpdate.updates);
+		REQUIRE(chunkUpdate.updates.size() == 1);
+		CHECK(chunkUpdate.updates.front().newContent == copperBlock);
+
+		SendUpdate(chunkUpdate, Constants::ProtocolChunkUpdateRunsVersion, clientChunk);
+		CheckClientContent();
+	}
+
+	SECTION("Random edit bursts")
+	{
+		for (unsigned int burst = 0; burst < 20; ++burst)
+		{
+			changeSet.Clear();
+
+			// Mix of scattered edits and explosion-like spheres
+			std::uniform_int_distribution<unsigned int> editCountDis(1, 200);
+			unsigned int editCount = editCountDis(rand);
+			for (unsigned int i = 0; i < editCount; ++i)
+			{
+				Nz::Vector3ui position(rand() % chunkSize.x, rand() % chunkSize.y, rand() % chunkSize.z);
+				serverChunk.UpdateBlock(position, (rand() % 2) ? copperBlock : stoneBricksBlock);
+			}
+
+			if (burst % 4 == 0)
+			{
+				Nz::Vector3i center(rand() % chunkSize.x, rand() % chunkSize.y, rand() % chunkSize.z);
+				int radius = 2 + burst / 4;
+				for (unsigned int z = 0; z < chunkSize.z; ++z)
+				{
+					for (unsigned int y = 0; y < chunkSize.y; ++y)
+					{
+						for (unsigned int x = 0; x < chunkSize.x; ++x)
+						{
+							if (Nz::Vector3i(x, y, z).SquaredDistance(center) <= radius * radius)
+								serverChunk.UpdateBlock({ x, y, z }, EmptyBlockIndex);
+						}
+					}
+				}
+			}
+
+			Packets::ChunkUpdate chunkUpdate;
+			chunkUpdate.tickIndex = Nz::SafeCast<Nz::UInt16>(burst);
+			chunkUpdate.chunkId = 0;
+			chunkUpdate.entityId = 0;
+			changeSet.BuildUpdates(serverChunk, chunkUpdate.updates);
+			CHECK(chunkUpdate.updates.size() == changeSet.GetChangedBlockCount());
+
+			std::size_t estimatedLegacySize = Packets::ComputeChunkUpdateSize(chunkUpdate.updates, BuildVersion(0, 5, 0));
+			std::size_t estimatedSize = Packets::ComputeChunkUpdateSize(chunkUpdate.updates, Constants::ProtocolChunkUpdateRunsVersion);
+
+			// Legacy encoding is applied to another client chunk to compare sizes
+			Planet legacyPlanet(1.f, 16.f, 9.81f);
+			Chunk& legacyChunk = legacyPlanet.AddChunk(blockLibrary, chunkIndices, [&](BlockIndex* blocks)
+			{
+				std::copy(clientChunk.GetContent(), clientChunk.GetContent() + clientChunk.GetBlockCount(), blocks);
+			});
+
+			std::size_t legacySize = SendUpdate(chunkUpdate, BuildVersion(0, 5, 0), legacyChunk);
+			std::size_t runSize = SendUpdate(chunkUpdate, Constants::ProtocolChunkUpdateRunsVersion, clientChunk);
+			CheckClientContent();
+			CHECK(std::equal(legacyChunk.GetContent(), legacyChunk.GetContent() + legacyChunk.GetBlockCount(), serverChunk.GetContent()));
+
+			CHECK(runSize <= legacySize);
+			CHECK(estimatedSize <= runSize); //< estimation doesn't include packet header
+			CHECK(runSize - estimatedSize < 16);
+			CHECK(estimatedLegacySize <= legacySize);
+			CHECK(legacySize - estimatedLegacySize < 16);
+		}
+	}
+
+	SECTION("Large edits fall back to chunk reset")
+	{
+		for (unsigned int z = 0; z < chunkSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < chunkSize.y; ++y)
+			{
+				for (unsigned int x = 0; x < chunkSize.x; x += 2)
+					serverChunk.UpdateBlock({ x, y, z }, (y % 2) ? copperBlock : stoneBricksBlock);
+			}
+		}
+
+		std::vector<Packets::ChunkUpdate::BlockUpdate> updates;
+		changeSet.BuildUpdates(serverChunk, updates);
+
+		std::shared_ptr<const ChunkSnapshot> snapshot = serverChunk.GetSnapshot();
+		std::size_t estimatedResetSize = ChunkChangeSet::EstimateResetSize(*snapshot, CompressionProfile{}, true);
+		CHECK(Packets::ComputeChunkUpdateSize(updates, Constants::ProtocolChunkUpdateRunsVersion) >= estimatedResetSize);
+
+		// Reset estimation is the compressed content the reset packet will send
+		Packets::ChunkReset chunkReset;
+		chunkReset.tickIndex = 0;
+		chunkReset.chunkId = 0;
+		chunkReset.entityId = 0;
+		chunkReset.snapshot = snapshot;
+
+		Nz::ByteArray byteArray;
+		{
+			Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+
+			PacketSerializer serializer(byteStream, true, Constants::ProtocolCompressionFrameVersion);
+			Packets::Serialize(serializer, chunkReset);
+		}
+
+		CHECK(estimatedResetSize <= byteArray.GetSize());
+		CHECK(byteArray.GetSize() - estimatedResetSize < 16);
+	}
+}
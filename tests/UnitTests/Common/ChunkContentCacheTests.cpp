@@ -0,0 +1,419 @@
+#include <ClientLib/ClientBlockLibrary.hpp>
+#include <ClientLib/ClientSessionHandler.hpp>
+#include <ClientLib/Components/ChunkNetworkMapComponent.hpp>
+#include <ClientLib/Components/ClientEntityNetworkIndex.hpp>
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkContentCache.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/EntityClass.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <CommonLib/NetworkSession.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/SessionHandler.hpp>
+#include <CommonLib/Components/PlanetComponent.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <ServerLib/ServerEnvironment.hpp>
+#include <ServerLib/ServerInstance.hpp>
+#include <ServerLib/SessionVisibilityHandler.hpp>
+#include <Nazara/Core/Application.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/EnttWorld.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Core/FilesystemAppComponent.hpp>
+#include <Nazara/Core/Components/NodeComponent.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <Nazara/Physics3D/Physics3D.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	class TestEnvironment final : public ServerEnvironment
+	{
+		public:
+			TestEnvironment(ServerInstance& serverInstance) :
+			ServerEnvironment(serverInstance, ServerEnvironmentType::Planet)
+			{
+			}
+
+			entt::handle CreateEntity() override
+			{
+				return m_world->CreateEntity();
+			}
+
+			const GravityController* GetGravityController() const override
+			{
+				return nullptr;
+			}
+
+			void OnSave() override
+			{
+			}
+	};
+
+	constexpr SessionHandler::SendAttributeTable s_packetAttributes = SessionHandler::BuildAttributeTable({
+		{ PacketIndex<Packets::BulkCancel>,          { .channel = 3, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::BulkCommit>,          { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::BulkFragment>,        { .channel = 3, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkCreate>,         { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkDestroy>,        { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkReset>,          { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::ChunkUpdate>,         { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EntitiesCreation>,    { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EntitiesDelete>,      { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EntitiesStateUpdate>, { .channel = 1, .flags = Nz::ENetPacketFlag_Unreliable } },
+		{ PacketIndex<Packets::EnvironmentCreate>,   { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+	});
+
+	class TestServerSessionHandler final : public SessionHandler
+	{
+		public:
+			TestServerSessionHandler(NetworkSession* session) :
+			SessionHandler(session)
+			{
+				SetupHandlerTable(this);
+				SetupAttributeTable(s_packetAttributes);
+			}
+	};
+
+	std::optional<std::vector<BlockIndex>> LoadContent(ChunkContentCache& cache, Nz::UInt64 contentHash, const Nz::Vector3ui& size)
+	{
+		std::optional<ChunkContentCache::LoadId> loadId = cache.RequestLoad(contentHash, size);
+		if (!loadId)
+			return std::nullopt;
+
+		cache.WaitForPendingOperations();
+
+		std::optional<std::vector<BlockIndex>> loadedContent;
+		cache.PollLoads([&](ChunkContentCache::LoadId completedLoadId, std::optional<std::vector<BlockIndex>>&& content)
+		{
+			if (completedLoadId == *loadId)
+				loadedContent = std::move(content);
+		});
+
+		return loadedContent;
+	}
+}
+
+TEST_CASE("Chunk content cache", "[Chunks]")
+{
+	const Nz::Vector3ui contentSize(4, 4, 4);
+
+	auto BuildContent = [&](BlockIndex blockIndex)
+	{
+		return std::vector<BlockIndex>(std::size_t(contentSize.x) * contentSize.y * contentSize.z, blockIndex);
+	};
+
+	std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "tsom_chunk_cache_tests";
+	std::filesystem::remove_all(cacheDirectory);
+
+	SECTION("Chunk contents are stored and loaded by hash")
+	{
+		std::vector<BlockIndex> content = BuildContent(1);
+		Nz::UInt64 contentHash = ChunkSnapshot::ComputeContentHash(contentSize, content.data());
+
+		ChunkContentCache cache(cacheDirectory);
+		cache.WaitForPendingOperations();
+		CHECK(cache.GetEntryCount() == 0);
+
+		cache.Store(contentSize, content);
+		cache.WaitForPendingOperations();
+		CHECK(cache.Contains(contentHash));
+		CHECK(cache.GetEntryCount() == 1);
+
+		// Storing the same content again doesn't create a new entry
+		cache.Store(contentSize, content);
+		cache.WaitForPendingOperations();
+		CHECK(cache.GetEntryCount() == 1);
+
+		std::optional<std::vector<BlockIndex>> loadedContent = LoadContent(cache, contentHash, contentSize);
+		REQUIRE(loadedContent);
+		CHECK(*loadedContent == content);
+
+		CHECK_FALSE(cache.RequestLoad(contentHash + 1, contentSize));
+		CHECK_FALSE(LoadContent(cache, contentHash, contentSize * 2u));
+
+		// Entries are kept between sessions
+		ChunkContentCache reopenedCache(cacheDirectory);
+		reopenedCache.WaitForPendingOperations();
+		CHECK(reopenedCache.GetEntryCount() == 1);
+		CHECK(LoadContent(reopenedCache, contentHash, contentSize));
+	}
+
+	SECTION("Corrupted entries are discarded")
+	{
+		std::vector<BlockIndex> content = BuildContent(1);
+		Nz::UInt64 contentHash = ChunkSnapshot::ComputeContentHash(contentSize, content.data());
+
+		ChunkContentCache cache(cacheDirectory);
+		cache.Store(contentSize, content);
+		cache.WaitForPendingOperations();
+
+		std::filesystem::path entryPath;
+		for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory))
+			entryPath = entry.path();
+
+		REQUIRE(!entryPath.empty());
+
+		std::optional<std::vector<Nz::UInt8>> entryData = Nz::File::ReadWhole(entryPath);
+		REQUIRE(entryData);
+		entryData->back() ^= 0xFF;
+		REQUIRE(Nz::File::WriteWhole(entryPath, entryData->data(), entryData->size()));
+
+		CHECK_FALSE(LoadContent(cache, contentHash, contentSize));
+		CHECK_FALSE(cache.Contains(contentHash));
+		CHECK(cache.GetEntryCount() == 0);
+		CHECK_FALSE(std::filesystem::exists(entryPath));
+	}
+
+	SECTION("Least recently used entries are evicted when the cache is full")
+	{
+		std::vector<BlockIndex> firstContent = BuildContent(1);
+		std::vector<BlockIndex> secondContent = BuildContent(2);
+		std::vector<BlockIndex> thirdContent = BuildContent(3);
+
+		Nz::UInt64 firstHash = ChunkSnapshot::ComputeContentHash(contentSize, firstContent.data());
+		Nz::UInt64 secondHash = ChunkSnapshot::ComputeContentHash(contentSize, secondContent.data());
+		Nz::UInt64 thirdHash = ChunkSnapshot::ComputeContentHash(contentSize, thirdContent.data());
+
+		ChunkContentCache cache(cacheDirectory, 2);
+		cache.Store(contentSize, firstContent);
+		cache.Store(contentSize, secondContent);
+		cache.WaitForPendingOperations();
+
+		// Loading an entry makes it the most recently used one
+		CHECK(LoadContent(cache, firstHash, contentSize));
+
+		cache.Store(contentSize, thirdContent);
+		cache.WaitForPendingOperations();
+
+		CHECK(cache.GetEntryCount() == 2);
+		CHECK(cache.Contains(firstHash));
+		CHECK_FALSE(cache.Contains(secondHash));
+		CHECK(cache.Contains(thirdHash));
+
+		std::size_t fileCount = 0;
+		for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory))
+		{
+			if (entry.is_regular_file())
+				fileCount++;
+		}
+
+		CHECK(fileCount == 2);
+	}
+
+	SECTION("Reconnecting only transfers hashes of unchanged chunks")
+	{
+		constexpr std::size_t MaxTickCount = 1000;
+		constexpr Nz::UInt32 seed = 42;
+		const Nz::Vector3ui chunkCount(3);
+
+		Nz::Application<Nz::Network, Nz::Physics3D> app;
+		app.AddComponent<Nz::FilesystemAppComponent>();
+
+		BlockLibrary blockLibrary;
+		BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+		ClientBlockLibrary clientBlockLibrary(app);
+		Nz::EnttWorld clientWorld;
+
+		ServerInstance serverInstance(app, ServerInstance::Config{});
+		TestEnvironment environment(serverInstance);
+
+		// Client doesn't know this class, its entity is created without any script
+		auto planetClass = std::make_shared<EntityClass>("test_planet", std::vector<EntityClass::Property>{}, EntityClass::Callbacks{}, std::vector<EntityClass::RemoteProcedureCall>{});
+
+		entt::handle planetEntity = environment.CreateEntity();
+		planetEntity.emplace<Nz::NodeComponent>();
+		auto& planetComponent = planetEntity.emplace<PlanetComponent>();
+		planetComponent.planet = std::make_unique<Planet>(1.f, 16.f, 9.81f);
+
+		std::vector<Chunk*> chunks;
+		for (int y = -1; y <= 1; ++y)
+		{
+			Chunk& chunk = planetComponent.planet->AddChunk(blockLibrary, { 0, y, 0 });
+			planetComponent.planet->GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+			chunks.push_back(&chunk);
+		}
+
+		NetworkReactor reactor(0, Nz::NetProtocol::IPv4, 0, 2);
+
+		ChunkContentCache cache(cacheDirectory);
+
+		struct ConnectionStats
+		{
+			std::size_t byteCount = 0;
+			std::size_t resetRequestCount = 0;
+			std::size_t transferCount = 0;
+		};
+
+		// Runs the server visibility handler against a client session handler, until every chunk content is known by the client
+		auto Connect = [&](bool hasChunkContentCache)
+		{
+			ConnectionStats stats;
+
+			// Sessions aren't connected to any peer, packets are buffered and handed to the other side like the reactor would
+			NetworkSession serverSession(reactor, 0, Nz::IpAddress::LoopbackIpV4);
+			serverSession.SetProtocolVersion(Constants::ProtocolChunkCacheVersion);
+			serverSession.EnableChunkContentCache(hasChunkContentCache); //< advertised by AuthRequest
+			serverSession.SetupHandler<TestServerSessionHandler>();
+			serverSession.GetStringStore().RegisterString(planetClass->GetName());
+
+			SessionVisibilityHandler visibility(&serverSession);
+
+			NetworkSession clientSession(reactor, 1, Nz::IpAddress::LoopbackIpV4);
+			clientSession.SetProtocolVersion(Constants::ProtocolChunkCacheVersion);
+			clientSession.GetStringStore().RegisterString(planetClass->GetName());
+
+			ClientSessionHandler& clientHandler = clientSession.SetupHandler<ClientSessionHandler>(app, clientWorld, clientBlockLibrary);
+			clientHandler.SetChunkContentCache((hasChunkContentCache) ? &cache : nullptr);
+
+			visibility.CreateEnvironment(environment, EnvironmentTransform(Nz::Vector3f::Zero(), Nz::Quaternionf::Identity()));
+			visibility.CreateEntity(planetEntity, {
+				.environment = &environment,
+				.entityClass = planetClass,
+				.initialRotation = Nz::Quaternionf::Identity(),
+				.initialPosition = Nz::Vector3f::Zero(),
+				.isMoving = false
+			});
+
+			for (Chunk* chunk : chunks)
+				visibility.CreateChunk(planetEntity, *chunk);
+
+			// Planet components are usually added by the entity class scripts, add them as soon as the client creates the entity
+			Planet* clientPlanet = nullptr;
+			auto SetupClientPlanet = [&]
+			{
+				for (auto&& [entity, networkIndex] : clientWorld.GetRegistry().view<ClientEntityNetworkIndex>().each())
+				{
+					entt::handle entityHandle(clientWorld.GetRegistry(), entity);
+					entityHandle.emplace<ChunkNetworkMapComponent>();
+
+					auto& clientPlanetComponent = entityHandle.emplace<PlanetComponent>();
+					clientPlanetComponent.planet = std::make_unique<Planet>(1.f, 16.f, 9.81f);
+
+					clientPlanet = clientPlanetComponent.planet.get();
+				}
+			};
+
+			auto HasReceivedAllChunks = [&]
+			{
+				if (!clientPlanet)
+					return false;
+
+				for (Chunk* chunk : chunks)
+				{
+					const Chunk* clientChunk = clientPlanet->GetChunk(chunk->GetIndices());
+					if (!clientChunk || !clientChunk->HasContent())
+						return false;
+				}
+
+				return true;
+			};
+
+			Nz::UInt16 tickIndex = 0;
+			for (std::size_t tick = 0; tick < MaxTickCount && !HasReceivedAllChunks(); ++tick)
+			{
+				serverSession.BeginPacketBuffering();
+				clientSession.BeginPacketBuffering();
+
+				visibility.Dispatch(tickIndex++);
+
+				// Server to client, packets are acknowledged once handled
+				std::vector<NetworkSession::BufferedPacket> serverPackets = serverSession.GetBufferedPackets();
+				serverSession.FlushBufferedPackets();
+
+				for (NetworkSession::BufferedPacket& packet : serverPackets)
+				{
+					stats.byteCount += packet.payload.GetSize();
+					if (packet.payload[0] == PacketIndex<Packets::BulkCommit>)
+						stats.transferCount++;
+
+					clientSession.HandlePacket(std::move(packet.payload));
+
+					if (!clientPlanet)
+						SetupClientPlanet();
+
+					if (packet.acknowledgeCallback)
+						packet.acknowledgeCallback();
+				}
+
+				// Cached contents are loaded on the cache thread and applied on the next client update
+				cache.WaitForPendingOperations();
+				clientHandler.Update();
+
+				// Client to server
+				for (const NetworkSession::BufferedPacket& packet : clientSession.GetBufferedPackets())
+				{
+					stats.byteCount += packet.payload.GetSize();
+
+					REQUIRE(packet.payload.GetSize() > 0);
+					if (packet.payload[0] != PacketIndex<Packets::ChunkResetRequest>)
+						continue;
+
+					Nz::ByteStream byteStream(packet.payload.GetConstBuffer() + 1, packet.payload.GetSize() - 1);
+
+					Packets::ChunkResetRequest resetRequest;
+					PacketSerializer serializer(byteStream, false, clientSession.GetProtocolVersion());
+					Packets::Serialize(serializer, resetRequest);
+
+					// Requesting the same chunk again must not send its content twice
+					visibility.RequestChunkReset(resetRequest.chunkId);
+					visibility.RequestChunkReset(resetRequest.chunkId);
+					stats.resetRequestCount++;
+				}
+				clientSession.FlushBufferedPackets();
+			}
+
+			REQUIRE(HasReceivedAllChunks());
+
+			for (Chunk* chunk : chunks)
+			{
+				const Chunk* clientChunk = clientPlanet->GetChunk(chunk->GetIndices());
+				CHECK(std::memcmp(clientChunk->GetContent(), chunk->GetContent(), chunk->GetBlockCount() * sizeof(BlockIndex)) == 0);
+			}
+
+			// Received contents are stored on the cache thread
+			cache.WaitForPendingOperations();
+
+			return stats;
+		};
+
+		// Only chunks having content are sent by hash
+		std::size_t hashedChunkCount = 0;
+		for (Chunk* chunk : chunks)
+		{
+			if (chunk->GetSnapshot()->HasContent())
+				hashedChunkCount++;
+		}
+
+		ConnectionStats firstConnection = Connect(true);
+		CHECK(firstConnection.resetRequestCount == hashedChunkCount);
+		CHECK(firstConnection.transferCount == chunks.size()); //< chunks without content are reset directly
+
+		ConnectionStats reconnection = Connect(true);
+		CHECK(reconnection.resetRequestCount == 0);
+		CHECK(reconnection.byteCount * 10 < firstConnection.byteCount);
+
+		// Clients without a cache don't advertise it and receive chunk contents directly
+		ConnectionStats uncachedConnection = Connect(false);
+		CHECK(uncachedConnection.resetRequestCount == 0);
+		CHECK(uncachedConnection.transferCount == chunks.size());
+
+		// Only modified chunks are sent again
+		chunks[1]->LockWrite();
+		chunks[1]->UpdateBlock({ 1, 2, 3 }, (chunks[1]->GetBlockContent({ 1, 2, 3 }) == stoneBlock) ? EmptyBlockIndex : stoneBlock);
+		chunks[1]->UnlockWrite();
+
+		ConnectionStats modifiedReconnection = Connect(true);
+		CHECK(modifiedReconnection.resetRequestCount == 1);
+	}
+
+	std::filesystem::remove_all(cacheDirectory);
+}
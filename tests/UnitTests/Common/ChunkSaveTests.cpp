@@ -0,0 +1,151 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkSave.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tsom;
+
+TEST_CASE("Chunk saves", "[Chunks]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(3);
+	const ChunkIndices chunkIndices(0, 1, 0); //< surface chunk
+
+	BlockLibrary blockLibrary;
+	BlockIndex copperBlock = blockLibrary.GetBlockIndex("copper_block");
+	BlockIndex stoneBricksBlock = blockLibrary.GetBlockIndex("stone_bricks");
+
+	Planet planet(1.f, 16.f, 9.81f);
+	Chunk& chunk = planet.AddChunk(blockLibrary, chunkIndices);
+	planet.GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+
+	FlatChunk generatedChunk(blockLibrary, planet, chunkIndices, chunk.GetSize(), chunk.GetBlockSize());
+	planet.GenerateChunk(blockLibrary, generatedChunk, seed, chunkCount);
+
+	auto RegenerateChunk = [&](Chunk& targetChunk)
+	{
+		planet.GenerateChunk(blockLibrary, targetChunk, seed, chunkCount);
+		return true;
+	};
+
+	auto CheckLoadedChunk = [&](const Nz::ByteArray& byteArray, ChunkSaveFormat expectedFormat)
+	{
+		Planet loadedPlanet(1.f, 16.f, 9.81f);
+		Chunk& loadedChunk = loadedPlanet.AddChunk(blockLibrary, chunkIndices);
+
+		Nz::ByteStream byteStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		CHECK(LoadChunk(byteStream, loadedChunk, [&](Chunk& targetChunk) { loadedPlanet.GenerateChunk(blockLibrary, targetChunk, seed, chunkCount); return true; }) == expectedFormat);
+
+		std::size_t mismatchCount = 0;
+		for (unsigned int i = 0; i < chunk.GetBlockCount(); ++i)
+		{
+			if (loadedChunk.GetBlockContent(i) != chunk.GetBlockContent(i))
+				mismatchCount++;
+		}
+
+		CHECK(mismatchCount == 0);
+	};
+
+	SECTION("Unmodified chunk is saved as an empty delta")
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		CHECK(SaveChunk(byteStream, chunk, generatedChunk) == ChunkSaveFormat::Delta);
+		CHECK(byteArray.GetSize() < 32);
+
+		CheckLoadedChunk(byteArray, ChunkSaveFormat::Delta);
+	}
+
+	SECTION("Sparse edits are saved as a delta")
+	{
+		chunk.UpdateBlock({ 0, 0, 0 }, copperBlock);
+		chunk.UpdateBlock({ 5, 17, 3 }, EmptyBlockIndex);
+		chunk.UpdateBlock({ 31, 31, 31 }, stoneBricksBlock);
+		chunk.UpdateBlock({ 12, 8, 30 }, copperBlock);
+
+		Nz::ByteArray fullByteArray;
+		Nz::ByteStream fullByteStream(&fullByteArray);
+		chunk.Serialize(fullByteStream);
+
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		CHECK(SaveChunk(byteStream, chunk, generatedChunk) == ChunkSaveFormat::Delta);
+		CHECK(byteArray.GetSize() < fullByteArray.GetSize() / 100);
+
+		CheckLoadedChunk(byteArray, ChunkSaveFormat::Delta);
+	}
+
+	SECTION("Dense edits fall back to full content")
+	{
+		for (unsigned int z = 0; z < Planet::ChunkSize / 2; ++z)
+		{
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					chunk.UpdateBlock({ x, y, z }, ((x + y + z) % 2 == 0) ? copperBlock : stoneBricksBlock);
+			}
+		}
+
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		CHECK(SaveChunk(byteStream, chunk, generatedChunk) == ChunkSaveFormat::Full);
+
+		Planet loadedPlanet(1.f, 16.f, 9.81f);
+		Chunk& loadedChunk = loadedPlanet.AddChunk(blockLibrary, chunkIndices);
+
+		// Full content must not require regenerating the chunk
+		bool regenerated = false;
+		Nz::ByteStream readStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		CHECK(LoadChunk(readStream, loadedChunk, [&](Chunk& /*targetChunk*/) { regenerated = true; return true; }) == ChunkSaveFormat::Full);
+		CHECK_FALSE(regenerated);
+
+		CheckLoadedChunk(byteArray, ChunkSaveFormat::Full);
+	}
+
+	SECTION("Deltas are refused when the chunk can't be regenerated")
+	{
+		chunk.UpdateBlock({ 0, 0, 0 }, copperBlock);
+
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		CHECK(SaveChunk(byteStream, chunk, generatedChunk) == ChunkSaveFormat::Delta);
+
+		Planet loadedPlanet(1.f, 16.f, 9.81f);
+		Chunk& loadedChunk = loadedPlanet.AddChunk(blockLibrary, chunkIndices);
+
+		Nz::ByteStream readStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		CHECK_THROWS(LoadChunk(readStream, loadedChunk, [&](Chunk& /*targetChunk*/) { return false; }));
+		CHECK_FALSE(loadedChunk.HasContent());
+	}
+
+	SECTION("Save header round-trip")
+	{
+		PlanetSaveHeader header{ Planet::GeneratorVersion, seed, chunkCount };
+
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		SavePlanetSaveHeader(byteStream, header);
+
+		Nz::ByteStream readStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		PlanetSaveHeader loadedHeader = LoadPlanetSaveHeader(readStream);
+		CHECK(loadedHeader == header);
+
+		PlanetSaveHeader otherSeedHeader = header;
+		otherSeedHeader.seed++;
+		CHECK_FALSE(otherSeedHeader == header);
+	}
+
+	SECTION("Unknown save format")
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		byteStream << Nz::UInt8(42);
+
+		Nz::ByteStream readStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		CHECK_THROWS(LoadChunk(readStream, chunk, RegenerateChunk));
+	}
+}
@@ -0,0 +1,93 @@
+#include <CommonLib/ChunkSendQueue.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk send queue", "[Chunks]")
+{
+	constexpr float ChunkSize = 32.f;
+
+	ChunkSendQueue sendQueue;
+	sendQueue.Update(Nz::Vector3f::Zero(), Nz::Vector3f::UnitX());
+
+	SECTION("Surface chunks in front of the viewer are sent first")
+	{
+		sendQueue.Push(0, Nz::Vector3f(-ChunkSize, 0.f, 0.f), ChunkVisibilityHint::Surface); //< behind
+		sendQueue.Push(1, Nz::Vector3f(0.f, -ChunkSize * 0.5f, 0.f), ChunkVisibilityHint::Buried); //< closer but buried
+		sendQueue.Push(2, Nz::Vector3f(ChunkSize * 3.f, 0.f, 0.f), ChunkVisibilityHint::Surface); //< in front but farther
+		sendQueue.Push(3, Nz::Vector3f(ChunkSize, 0.f, 0.f), ChunkVisibilityHint::Surface); //< in front
+		sendQueue.Push(4, Nz::Vector3f(ChunkSize, ChunkSize, 0.f), ChunkVisibilityHint::Empty);
+
+		REQUIRE(sendQueue.GetPendingCount() == 5);
+
+		std::vector<std::size_t> sendOrder;
+		while (!sendQueue.IsEmpty())
+			sendOrder.push_back(sendQueue.Pop());
+
+		CHECK(sendOrder == std::vector<std::size_t>{ 3, 0, 1, 4, 2 });
+	}
+
+	SECTION("Turning around changes the order")
+	{
+		sendQueue.Push(0, Nz::Vector3f(-ChunkSize, 0.f, 0.f), ChunkVisibilityHint::Surface);
+		sendQueue.Push(1, Nz::Vector3f(ChunkSize, 0.f, 0.f), ChunkVisibilityHint::Surface);
+		CHECK(sendQueue.GetTop() == 1);
+
+		sendQueue.Update(Nz::Vector3f::Zero(), -Nz::Vector3f::UnitX());
+		CHECK(sendQueue.GetTop() == 0);
+	}
+
+	SECTION("Waiting chunks eventually get sent")
+	{
+		sendQueue.Push(0, Nz::Vector3f(-ChunkSize * 4.f, 0.f, 0.f), ChunkVisibilityHint::Buried);
+
+		// Keep pushing closer chunks, the far one must not starve
+		bool farChunkSent = false;
+		for (std::size_t i = 1; i < 1000; ++i)
+		{
+			sendQueue.Push(i, Nz::Vector3f(ChunkSize, 0.f, 0.f), ChunkVisibilityHint::Surface);
+			if (sendQueue.Pop() == 0)
+			{
+				farChunkSent = true;
+				break;
+			}
+
+			sendQueue.Update(Nz::Vector3f::Zero(), Nz::Vector3f::UnitX());
+		}
+
+		CHECK(farChunkSent);
+	}
+
+	SECTION("Pending entries are bounded and can be cancelled")
+	{
+		constexpr std::size_t ChunkCount = 64;
+
+		// Chunks being reset many times before they're sent must only be queued once
+		for (std::size_t tick = 0; tick < 100; ++tick)
+		{
+			for (std::size_t i = 0; i < ChunkCount; ++i)
+				sendQueue.Push(i, Nz::Vector3f(float(i) * ChunkSize, 0.f, 0.f), ChunkVisibilityHint::Surface);
+
+			sendQueue.Update(Nz::Vector3f(float(tick), 0.f, 0.f), Nz::Vector3f::UnitX());
+			CHECK(sendQueue.GetPendingCount() == ChunkCount);
+		}
+
+		// Chunks leaving the area are dropped
+		for (std::size_t i = 0; i < ChunkCount; i += 2)
+			sendQueue.Erase(i);
+
+		CHECK(sendQueue.GetPendingCount() == ChunkCount / 2);
+
+		std::size_t sentCount = 0;
+		while (!sendQueue.IsEmpty())
+		{
+			std::size_t chunkIndex = sendQueue.Pop();
+			CHECK(chunkIndex % 2 == 1);
+			CHECK_FALSE(sendQueue.Contains(chunkIndex));
+			sentCount++;
+		}
+
+		CHECK(sentCount == ChunkCount / 2);
+	}
+}
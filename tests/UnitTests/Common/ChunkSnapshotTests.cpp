@@ -0,0 +1,214 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk snapshots", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = Planet::ChunkSize;
+
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+	Planet planet(1.f, 0.f, 9.81f);
+	FlatChunk chunk(blockLibrary, planet, { 0, 0, 0 }, Nz::Vector3ui(ChunkSize), 1.f);
+
+	chunk.LockWrite();
+	chunk.Reset([&](BlockIndex* blocks)
+	{
+		std::fill_n(blocks, ChunkSize * ChunkSize * ChunkSize, dirtBlock);
+	});
+	chunk.UnlockWrite();
+
+	SECTION("Snapshots are immutable")
+	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = chunk.GetSnapshot();
+		REQUIRE(snapshot->HasContent());
+		CHECK(snapshot->GetRevision() == chunk.GetRevision());
+		CHECK(snapshot->GetBlockContent({ 1, 2, 3 }) == dirtBlock);
+
+		// Unchanged chunks share their snapshot
+		CHECK(chunk.GetSnapshot() == snapshot);
+
+		chunk.LockWrite();
+		chunk.UpdateBlock({ 1, 2, 3 }, stoneBlock);
+		chunk.UnlockWrite();
+
+		std::shared_ptr<const ChunkSnapshot> newSnapshot = chunk.GetSnapshot();
+		CHECK(newSnapshot != snapshot);
+		CHECK(newSnapshot->GetRevision() > snapshot->GetRevision());
+		CHECK(newSnapshot->GetBlockContent({ 1, 2, 3 }) == stoneBlock);
+		CHECK(snapshot->GetBlockContent({ 1, 2, 3 }) == dirtBlock);
+	}
+
+	SECTION("Snapshots are published on write unlock and read without locking the chunk")
+	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = chunk.GetSnapshot();
+
+		chunk.LockWrite();
+		chunk.UpdateBlock({ 7, 8, 9 }, stoneBlock);
+
+		// The chunk is exclusively locked by this thread, locking it again would deadlock
+		CHECK(chunk.GetSnapshot() == snapshot);
+
+		chunk.UnlockWrite();
+
+		std::shared_ptr<const ChunkSnapshot> newSnapshot = chunk.GetSnapshot();
+		CHECK(newSnapshot->GetRevision() == chunk.GetRevision());
+		CHECK(newSnapshot->GetBlockContent({ 7, 8, 9 }) == stoneBlock);
+
+		// Published by the write unlock, reading it again doesn't build a new one
+		CHECK(chunk.GetSnapshot() == newSnapshot);
+	}
+
+	SECTION("Snapshots are built on demand when the chunk was updated without lock")
+	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = chunk.GetSnapshot();
+
+		chunk.UpdateBlock({ 4, 5, 6 }, stoneBlock);
+
+		std::shared_ptr<const ChunkSnapshot> newSnapshot = chunk.GetSnapshot();
+		CHECK(newSnapshot->GetRevision() == chunk.GetRevision());
+		CHECK(newSnapshot->GetBlockContent({ 4, 5, 6 }) == stoneBlock);
+		CHECK(snapshot->GetBlockContent({ 4, 5, 6 }) == dirtBlock);
+	}
+
+	SECTION("Compressed content is shared between sessions")
+	{
+		std::shared_ptr<const ChunkSnapshot> snapshot = chunk.GetSnapshot();
+
+		CompressionProfile lz4Profile;
+		CompressionProfile lz4hcProfile;
+		lz4hcProfile.codec = CompressionCodec::LZ4HC;
+
+		std::optional<std::span<const Nz::UInt8>> lz4Content = snapshot->GetCompressedContent(lz4Profile, true);
+		REQUIRE(lz4Content);
+		CHECK(snapshot->GetCompressedContent(lz4Profile, true)->data() == lz4Content->data());
+
+		// Each negotiated profile (and the legacy block format) gets its own copy
+		std::optional<std::span<const Nz::UInt8>> lz4hcContent = snapshot->GetCompressedContent(lz4hcProfile, true);
+		REQUIRE(lz4hcContent);
+		CHECK(lz4hcContent->data() != lz4Content->data());
+		CHECK(snapshot->GetCompressedContent(lz4Profile, false)->data() != lz4Content->data());
+
+		auto SerializeReset = [&](Nz::UInt32 protocolVersion, const CompressionProfile& profile)
+		{
+			Packets::ChunkReset chunkReset;
+			chunkReset.tickIndex = 1;
+			chunkReset.entityId = 2;
+			chunkReset.chunkId = 3;
+			chunkReset.snapshot = snapshot;
+
+			Nz::ByteArray byteArray;
+			Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+
+			PacketSerializer serializer(byteStream, true, protocolVersion);
+			serializer.SetCompressionProfile(&profile);
+			Packets::Serialize(serializer, chunkReset);
+			byteStream.FlushBits();
+
+			return byteArray;
+		};
+
+		for (Nz::UInt32 protocolVersion : { BuildVersion(0, 5, 0), Constants::ProtocolCompressionFrameVersion })
+		{
+			// Sessions sharing a profile send the same bytes
+			Nz::ByteArray firstSession = SerializeReset(protocolVersion, lz4Profile);
+			Nz::ByteArray secondSession = SerializeReset(protocolVersion, lz4Profile);
+			CHECK(firstSession == secondSession);
+
+			Nz::ByteStream byteStream(firstSession.GetConstBuffer(), firstSession.GetSize());
+
+			Packets::ChunkReset receivedChunkReset;
+			PacketSerializer serializer(byteStream, false, protocolVersion);
+			serializer.SetCompressionProfile(&lz4Profile);
+			Packets::Serialize(serializer, receivedChunkReset);
+
+			CHECK(receivedChunkReset.chunkId == 3);
+			REQUIRE(receivedChunkReset.content.size() == snapshot->GetBlockCount());
+			CHECK(std::equal(receivedChunkReset.content.begin(), receivedChunkReset.content.end(), snapshot->GetContent()));
+		}
+
+		// A new revision doesn't reuse the previous compressed content
+		chunk.LockWrite();
+		chunk.UpdateBlock({ 1, 2, 3 }, stoneBlock);
+		chunk.UnlockWrite();
+
+		std::shared_ptr<const ChunkSnapshot> newSnapshot = chunk.GetSnapshot();
+		REQUIRE(newSnapshot != snapshot);
+		CHECK(newSnapshot->GetCompressedContent(lz4Profile, true)->data() != lz4Content->data());
+	}
+
+	SECTION("Concurrent edits and snapshot reads")
+	{
+		constexpr unsigned int EditCount = 2000;
+		constexpr unsigned int ReaderCount = 4;
+
+		const Nz::Vector3ui firstBlock(0, 0, 0);
+		const Nz::Vector3ui secondBlock(ChunkSize - 1, ChunkSize - 1, ChunkSize - 1);
+		const Nz::UInt64 initialRevision = chunk.GetRevision();
+
+		std::atomic_bool writerDone = false;
+		std::atomic_uint inconsistentSnapshots = 0;
+		std::atomic_uint outOfOrderSnapshots = 0;
+
+		std::vector<std::thread> readers;
+		for (unsigned int i = 0; i < ReaderCount; ++i)
+		{
+			readers.emplace_back([&]
+			{
+				Nz::UInt64 lastRevision = 0;
+				do
+				{
+					std::shared_ptr<const ChunkSnapshot> snapshot = chunk.GetSnapshot();
+
+					// Each edit updates two blocks under the same write lock, a snapshot must never see only one of them
+					if (snapshot->GetBlockContent(firstBlock) != snapshot->GetBlockContent(secondBlock))
+						inconsistentSnapshots++;
+
+					if ((snapshot->GetRevision() - initialRevision) % 2 != 0)
+						inconsistentSnapshots++;
+
+					if (snapshot->GetRevision() < lastRevision)
+						outOfOrderSnapshots++;
+
+					lastRevision = snapshot->GetRevision();
+				}
+				while (!writerDone);
+			});
+		}
+
+		for (unsigned int i = 0; i < EditCount; ++i)
+		{
+			BlockIndex newBlock = (i % 2 == 0) ? stoneBlock : dirtBlock;
+
+			chunk.LockWrite();
+			chunk.UpdateBlock(firstBlock, newBlock);
+			chunk.UpdateBlock(secondBlock, newBlock);
+			chunk.UnlockWrite();
+		}
+		writerDone = true;
+
+		for (std::thread& reader : readers)
+			reader.join();
+
+		CHECK(inconsistentSnapshots == 0);
+		CHECK(outOfOrderSnapshots == 0);
+
+		std::shared_ptr<const ChunkSnapshot> finalSnapshot = chunk.GetSnapshot();
+		CHECK(finalSnapshot->GetRevision() == initialRevision + EditCount * 2);
+		CHECK(finalSnapshot->GetBlockContent(firstBlock) == dirtBlock);
+		CHECK(finalSnapshot->GetBlockContent(secondBlock) == dirtBlock);
+	}
+}
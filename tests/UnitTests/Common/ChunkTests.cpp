@@ -1,7 +1,14 @@
+#include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkChangeSet.hpp>
 #include <CommonLib/ChunkContainer.hpp>
 #include <CommonLib/Planet.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
 
 using namespace tsom;
 
@@ -44,3 +51,341 @@ TEST_CASE("Block positions", "[Chunks]")
 		}
 	}
 }
+
+TEST_CASE("Chunk meshing across borders", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = Planet::ChunkSize;
+
+	BlockLibrary blockLibrary;
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+	Planet planet(1.f, 0.f, 9.81f);
+
+	auto FillStone = [&](BlockIndex* blocks)
+	{
+		std::fill_n(blocks, ChunkSize * ChunkSize * ChunkSize, stoneBlock);
+	};
+
+	auto CountFaces = [](const Chunk& chunk)
+	{
+		std::vector<Nz::UInt32> indices;
+		std::vector<Nz::Vector3f> positions;
+
+		chunk.BuildMesh(indices, Nz::Vector3f::Zero(), [&](Nz::UInt32 count)
+		{
+			Chunk::VertexAttributes vertexAttributes;
+
+			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
+			positions.resize(positions.size() + count);
+			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&positions[vertexAttributes.firstIndex]);
+
+			return vertexAttributes;
+		});
+
+		return indices.size() / 6;
+	};
+
+	Chunk& chunk = planet.AddChunk(blockLibrary, { 0, 0, 0 }, FillStone);
+	CHECK(CountFaces(chunk) == 6 * ChunkSize * ChunkSize);
+
+	// Faces shared with the neighbor chunk are culled
+	Chunk& rightChunk = planet.AddChunk(blockLibrary, { 1, 0, 0 }, FillStone);
+	CHECK(CountFaces(chunk) == 5 * ChunkSize * ChunkSize);
+
+	for (Direction direction : { Direction::Back, Direction::Down, Direction::Front, Direction::Left, Direction::Right, Direction::Up })
+	{
+		INFO("direction: " << int(direction));
+		CHECK(rightChunk.GetSnapshot()->GetBorderSlice(direction).size() == ChunkSize * ChunkSize);
+	}
+
+	// Updating a block on the border of the neighbor publishes a new border slice, previously loaded ones are left untouched
+	std::shared_ptr<const BorderSlice> previousBorderSlice = rightChunk.GetBorderSlice(Direction::Left);
+	unsigned int borderSliceIndex = rightChunk.GetBorderSliceIndex(Direction::Left, { 0, 5, 7 });
+
+	rightChunk.LockWrite();
+	rightChunk.UpdateBlock({ 0, 5, 7 }, EmptyBlockIndex);
+	rightChunk.UnlockWrite();
+
+	CHECK(rightChunk.GetBorderSlice(Direction::Left) != previousBorderSlice);
+	CHECK((*previousBorderSlice)[borderSliceIndex] != EmptyBlockIndex);
+	CHECK((*rightChunk.GetBorderSlice(Direction::Left))[borderSliceIndex] == EmptyBlockIndex);
+	CHECK(rightChunk.GetSnapshot()->GetBorderSlice(Direction::Left)[borderSliceIndex] == EmptyBlockIndex);
+	CHECK(CountFaces(chunk) == 5 * ChunkSize * ChunkSize + 1);
+}
+
+TEST_CASE("Chunk serialization", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = Planet::ChunkSize;
+
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+	Planet planet(1.f, 16.f, 9.81f);
+
+	auto CheckRoundTrip = [&](const Chunk& chunk)
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		chunk.Serialize(byteStream);
+
+		Planet otherPlanet(1.f, 16.f, 9.81f);
+		Chunk& loadedChunk = otherPlanet.AddChunk(blockLibrary, chunk.GetIndices());
+
+		Nz::ByteStream readStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		loadedChunk.Deserialize(readStream);
+
+		CHECK(std::equal(chunk.GetContent(), chunk.GetContent() + chunk.GetBlockCount(), loadedChunk.GetContent()));
+
+		return byteArray.GetSize();
+	};
+
+	SECTION("Generated chunks")
+	{
+		// One chunk per depth of a planet
+		for (int y = 0; y <= 2; ++y)
+		{
+			Chunk& chunk = planet.AddChunk(blockLibrary, { 0, y, 0 });
+			planet.GenerateChunk(blockLibrary, chunk, 42, Nz::Vector3ui(5));
+
+			std::size_t serializedSize = CheckRoundTrip(chunk);
+			CHECK(serializedSize < chunk.GetBlockCount());
+		}
+	}
+
+	SECTION("Layered chunks")
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			Chunk& chunk = planet.AddChunk(blockLibrary, { int(axis), 0, 0 }, [&](BlockIndex* blocks)
+			{
+				for (unsigned int z = 0; z < ChunkSize; ++z)
+				{
+					for (unsigned int y = 0; y < ChunkSize; ++y)
+					{
+						for (unsigned int x = 0; x < ChunkSize; ++x)
+						{
+							Nz::Vector3ui indices(x, y, z);
+
+							// Layers along every axis in turn, each layer must be stored as a single run
+							unsigned int layer = indices[(axis + 1) % 3];
+							*blocks++ = (layer % 3 == 0) ? dirtBlock : (layer % 3 == 1) ? stoneBlock : EmptyBlockIndex;
+						}
+					}
+				}
+			});
+
+			std::size_t serializedSize = CheckRoundTrip(chunk);
+			CHECK(serializedSize < 256);
+		}
+	}
+
+	SECTION("Alternating blocks")
+	{
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, 0, 0 }, [&](BlockIndex* blocks)
+		{
+			for (unsigned int i = 0; i < ChunkSize * ChunkSize * ChunkSize; ++i)
+				blocks[i] = (i % 7 == 0) ? dirtBlock : (i % 2 == 0) ? stoneBlock : EmptyBlockIndex;
+		});
+
+		CheckRoundTrip(chunk);
+	}
+
+	SECTION("Reading version 1 chunks")
+	{
+		// Version 1 stored one palette index per block
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray);
+		byteStream << Nz::UInt32(1) << Nz::Vector3ui(ChunkSize);
+		byteStream << Nz::UInt16(3) << std::string("empty") << std::string("dirt") << std::string("stone");
+		for (unsigned int i = 0; i < ChunkSize * ChunkSize * ChunkSize; ++i)
+			byteStream << Nz::UInt8(i % 3);
+
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, 0, 0 });
+
+		Nz::ByteStream readStream(byteArray.GetConstBuffer(), byteArray.GetSize());
+		chunk.Deserialize(readStream);
+
+		for (unsigned int i = 0; i < chunk.GetBlockCount(); ++i)
+		{
+			BlockIndex expectedBlock = (i % 3 == 0) ? EmptyBlockIndex : (i % 3 == 1) ? dirtBlock : stoneBlock;
+			if (chunk.GetBlockContent(i) != expectedBlock)
+			{
+				FAIL("block " << i << " mismatch");
+				break;
+			}
+		}
+	}
+}
+
+TEST_CASE("Bulk block edits", "[Chunks]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(3);
+	const ChunkIndices chunkIndices(0, 1, 0); //< surface chunk
+
+	BlockLibrary blockLibrary;
+	BlockIndex copperBlock = blockLibrary.GetBlockIndex("copper_block");
+	BlockIndex stoneBricksBlock = blockLibrary.GetBlockIndex("stone_bricks");
+
+	// One planet is edited block per block, the other one through batches
+	Planet singlePlanet(1.f, 16.f, 9.81f);
+	Chunk& singleChunk = singlePlanet.AddChunk(blockLibrary, chunkIndices);
+	singlePlanet.GenerateChunk(blockLibrary, singleChunk, seed, chunkCount);
+
+	Planet bulkPlanet(1.f, 16.f, 9.81f);
+	Chunk& bulkChunk = bulkPlanet.AddChunk(blockLibrary, chunkIndices);
+	bulkPlanet.GenerateChunk(blockLibrary, bulkChunk, seed, chunkCount);
+
+	ChunkChangeSet singleChangeSet;
+	std::size_t singleNotificationCount = 0;
+	DirectionMask singleNeighborMask;
+
+	NazaraSlot(Chunk, OnBlockUpdated, onBlockUpdated);
+	onBlockUpdated.Connect(singleChunk.OnBlockUpdated, [&](Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex /*newBlock*/)
+	{
+		singleChangeSet.MarkBlock(chunk->GetBlockLocalIndex(indices));
+	});
+
+	NazaraSlot(ChunkContainer, OnChunkUpdated, onSingleChunkUpdated);
+	onSingleChunkUpdated.Connect(singlePlanet.OnChunkUpdated, [&](ChunkContainer* /*container*/, Chunk* /*chunk*/, DirectionMask neighborMask)
+	{
+		singleNotificationCount++;
+		singleNeighborMask |= neighborMask;
+	});
+
+	ChunkChangeSet bulkChangeSet;
+	std::size_t bulkNotificationCount = 0;
+	DirectionMask bulkNeighborMask;
+
+	NazaraSlot(Chunk, OnBlocksUpdated, onBlocksUpdated);
+	onBlocksUpdated.Connect(bulkChunk.OnBlocksUpdated, [&](Chunk* /*chunk*/, const Nz::Bitset<Nz::UInt64>& updatedBlocks, const Nz::Vector3ui& /*minIndices*/, const Nz::Vector3ui& /*maxIndices*/)
+	{
+		bulkChangeSet.MarkBlocks(updatedBlocks);
+	});
+
+	NazaraSlot(ChunkContainer, OnChunkUpdated, onBulkChunkUpdated);
+	onBulkChunkUpdated.Connect(bulkPlanet.OnChunkUpdated, [&](ChunkContainer* /*container*/, Chunk* /*chunk*/, DirectionMask neighborMask)
+	{
+		bulkNotificationCount++;
+		bulkNeighborMask |= neighborMask;
+	});
+
+	auto ApplyEdits = [&](const std::vector<Chunk::BlockUpdate>& blockUpdates)
+	{
+		singleChangeSet.Clear();
+		singleNotificationCount = 0;
+		singleNeighborMask = DirectionMask{};
+
+		bulkChangeSet.Clear();
+		bulkNotificationCount = 0;
+		bulkNeighborMask = DirectionMask{};
+
+		singleChunk.LockWrite();
+		for (const Chunk::BlockUpdate& blockUpdate : blockUpdates)
+			singleChunk.UpdateBlock(blockUpdate.indices, blockUpdate.newBlock);
+		singleChunk.UnlockWrite();
+
+		Nz::UInt64 bulkRevision = bulkChunk.GetRevision();
+
+		bulkChunk.LockWrite();
+		bulkChunk.UpdateBlocks(blockUpdates);
+		bulkChunk.UnlockWrite();
+
+		CHECK(bulkChunk.GetRevision() == bulkRevision + 1);
+	};
+
+	auto CheckEquivalence = [&]
+	{
+		std::shared_ptr<const ChunkSnapshot> singleSnapshot = singleChunk.GetSnapshot();
+		std::shared_ptr<const ChunkSnapshot> bulkSnapshot = bulkChunk.GetSnapshot();
+
+		CHECK(std::equal(singleChunk.GetContent(), singleChunk.GetContent() + singleChunk.GetBlockCount(), bulkChunk.GetContent()));
+		CHECK(singleChunk.GetCollisionCellMask() == bulkChunk.GetCollisionCellMask());
+		CHECK(singleSnapshot->GetBlockTypeCount() == bulkSnapshot->GetBlockTypeCount());
+		for (Direction direction : { Direction::Back, Direction::Down, Direction::Front, Direction::Left, Direction::Right, Direction::Up })
+			CHECK(singleSnapshot->GetBorderSlice(direction) == bulkSnapshot->GetBorderSlice(direction));
+
+		CHECK(bulkNotificationCount == 1);
+		CHECK(singleNeighborMask == bulkNeighborMask);
+
+		std::vector<Packets::ChunkUpdate::BlockUpdate> singleUpdates;
+		singleChangeSet.BuildUpdates(singleChunk, singleUpdates);
+
+		std::vector<Packets::ChunkUpdate::BlockUpdate> bulkUpdates;
+		bulkChangeSet.BuildUpdates(bulkChunk, bulkUpdates);
+
+		CHECK(singleChangeSet.GetChangedBlockCount() == bulkChangeSet.GetChangedBlockCount());
+		CHECK(std::equal(singleUpdates.begin(), singleUpdates.end(), bulkUpdates.begin(), bulkUpdates.end(), [](const auto& lhs, const auto& rhs)
+		{
+			return lhs.voxelLoc.x == rhs.voxelLoc.x && lhs.voxelLoc.y == rhs.voxelLoc.y && lhs.voxelLoc.z == rhs.voxelLoc.z && lhs.newContent == rhs.newContent;
+		}));
+	};
+
+	std::mt19937 rand(seed);
+	const Nz::Vector3ui chunkSize = bulkChunk.GetSize();
+
+	SECTION("Repeated edits of the same block")
+	{
+		std::vector<Chunk::BlockUpdate> blockUpdates;
+		for (BlockIndex blockIndex : { copperBlock, stoneBricksBlock, EmptyBlockIndex, copperBlock })
+			blockUpdates.push_back({ { 1, 2, 3 }, blockIndex });
+
+		ApplyEdits(blockUpdates);
+		CheckEquivalence();
+
+		CHECK(singleNotificationCount == blockUpdates.size());
+		CHECK(bulkChangeSet.GetChangedBlockCount() == 1);
+		CHECK(bulkNeighborMask == DirectionMask{});
+	}
+
+	SECTION("Edits touching the chunk borders")
+	{
+		std::vector<Chunk::BlockUpdate> blockUpdates;
+		blockUpdates.push_back({ { 0, 5, 5 }, copperBlock });
+		blockUpdates.push_back({ { 5, chunkSize.y - 1, 5 }, stoneBricksBlock });
+		blockUpdates.push_back({ { 5, 5, chunkSize.z - 1 }, EmptyBlockIndex });
+
+		ApplyEdits(blockUpdates);
+		CheckEquivalence();
+
+		CHECK(bulkNeighborMask == (DirectionMask(Direction::Left) | Direction::Back | Direction::Up));
+	}
+
+	SECTION("Random edit bursts")
+	{
+		for (unsigned int burst = 0; burst < 20; ++burst)
+		{
+			std::uniform_int_distribution<unsigned int> editCountDis(1, 500);
+			unsigned int editCount = editCountDis(rand);
+
+			std::vector<Chunk::BlockUpdate> blockUpdates;
+			for (unsigned int i = 0; i < editCount; ++i)
+			{
+				Nz::Vector3ui position(rand() % chunkSize.x, rand() % chunkSize.y, rand() % chunkSize.z);
+
+				BlockIndex blockIndex;
+				switch (rand() % 3)
+				{
+					case 0:  blockIndex = copperBlock; break;
+					case 1:  blockIndex = stoneBricksBlock; break;
+					default: blockIndex = EmptyBlockIndex; break;
+				}
+
+				blockUpdates.push_back({ position, blockIndex });
+			}
+
+			ApplyEdits(blockUpdates);
+			CheckEquivalence();
+		}
+	}
+
+	SECTION("Empty batches are ignored")
+	{
+		Nz::UInt64 revision = bulkChunk.GetRevision();
+		bulkChunk.UpdateBlocks({});
+
+		CHECK(bulkChunk.GetRevision() == revision);
+		CHECK(bulkNotificationCount == 0);
+	}
+}
@@ -0,0 +1,167 @@
+#include <CommonLib/CongestionController.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <map>
+#include <string_view>
+
+using namespace tsom;
+
+namespace
+{
+	struct LinkProfile
+	{
+		std::string_view name;
+		double bandwidth; //< bytes per second
+		Nz::Time latency; //< one way
+		std::size_t bufferSize; //< bottleneck queue size, packets are lost when it's full
+	};
+
+	struct SimulationResult
+	{
+		double throughput;
+		Nz::Time averageRoundTripTime;
+		std::size_t averageWindowSize;
+	};
+
+	// Simulates a peer continuously streaming chunks through a single bottleneck link
+	SimulationResult SimulateLink(const LinkProfile& link, Nz::Time duration)
+	{
+		constexpr std::size_t PacketSize = 4 * 1024;
+		constexpr Nz::Time PeerInfoPollTime = Nz::Time::Milliseconds(100);
+		constexpr Nz::Time StepTime = Nz::Time::Milliseconds(1);
+
+		struct InFlightPacket
+		{
+			Nz::Time sendTime;
+			bool isRetransmission;
+		};
+
+		CongestionController controller;
+		NetworkReactor::PeerInfo peerInfo = {};
+
+		std::multimap<Nz::Time, InFlightPacket> acknowledgments;
+		std::multimap<Nz::Time, InFlightPacket> retransmissions;
+		double smoothedRoundTripTime = (link.latency * 2).AsSeconds<double>();
+		Nz::Time linkFreeTime = Nz::Time::Zero();
+
+		auto Transmit = [&](Nz::Time now, InFlightPacket packet)
+		{
+			peerInfo.totalPacketSent++;
+
+			Nz::Time queueingDelay = std::max(linkFreeTime - now, Nz::Time::Zero());
+			double queuedBytes = queueingDelay.AsSeconds<double>() * link.bandwidth;
+			if (queuedBytes + PacketSize > link.bufferSize)
+			{
+				// Reliable packets are resent after a timeout
+				peerInfo.totalPacketLost++;
+				retransmissions.emplace(now + Nz::Time::Seconds(smoothedRoundTripTime * 2.0), InFlightPacket{ packet.sendTime, true });
+				return;
+			}
+
+			linkFreeTime = std::max(linkFreeTime, now) + Nz::Time::Seconds(PacketSize / link.bandwidth);
+			acknowledgments.emplace(linkFreeTime + link.latency * 2, packet);
+		};
+
+		Nz::Time measureStart = duration / 2;
+		Nz::Time nextPeerInfoPoll = Nz::Time::Zero();
+		std::size_t deliveredBytes = 0;
+		std::size_t windowSizeSum = 0;
+		std::size_t windowSizeSampleCount = 0;
+		double roundTripTimeSum = 0.0;
+		std::size_t roundTripTimeSampleCount = 0;
+
+		for (Nz::Time now = Nz::Time::Zero(); now < duration; now += StepTime)
+		{
+			for (auto it = acknowledgments.begin(); it != acknowledgments.end() && it->first <= now; it = acknowledgments.erase(it))
+			{
+				controller.OnAcknowledged(PacketSize);
+
+				// Like ENet, don't measure RTT on retransmitted packets
+				if (!it->second.isRetransmission)
+				{
+					double roundTripTime = (it->first - it->second.sendTime).AsSeconds<double>();
+					smoothedRoundTripTime += (roundTripTime - smoothedRoundTripTime) / 8.0;
+
+					if (now >= measureStart)
+					{
+						roundTripTimeSum += roundTripTime;
+						roundTripTimeSampleCount++;
+					}
+				}
+
+				if (now >= measureStart)
+					deliveredBytes += PacketSize;
+			}
+
+			for (auto it = retransmissions.begin(); it != retransmissions.end() && it->first <= now; it = retransmissions.erase(it))
+				Transmit(now, it->second);
+
+			while (controller.CanSend(PacketSize))
+			{
+				controller.OnSent(PacketSize);
+				Transmit(now, InFlightPacket{ now, false });
+			}
+
+			if (now >= nextPeerInfoPoll)
+			{
+				peerInfo.ping = static_cast<Nz::UInt32>(smoothedRoundTripTime * 1000.0);
+				controller.Update(now, peerInfo);
+				nextPeerInfoPoll += PeerInfoPollTime;
+
+				if (now >= measureStart)
+				{
+					windowSizeSum += controller.GetWindowSize();
+					windowSizeSampleCount++;
+				}
+			}
+		}
+
+		SimulationResult result;
+		result.averageRoundTripTime = Nz::Time::Seconds(roundTripTimeSum / std::max<std::size_t>(roundTripTimeSampleCount, 1));
+		result.averageWindowSize = windowSizeSum / std::max<std::size_t>(windowSizeSampleCount, 1);
+		result.throughput = deliveredBytes / (duration - measureStart).AsSeconds<double>();
+
+		return result;
+	}
+}
+
+TEST_CASE("Congestion controller", "[Network]")
+{
+	SECTION("Window is bounded by acknowledgments")
+	{
+		CongestionController controller;
+		CHECK(controller.CanSend(CongestionController::InitialWindowSize * 2)); //< nothing in flight
+
+		controller.OnSent(CongestionController::InitialWindowSize);
+		CHECK_FALSE(controller.CanSend(1));
+
+		controller.OnAcknowledged(CongestionController::InitialWindowSize / 2);
+		CHECK(controller.GetInFlightBytes() == CongestionController::InitialWindowSize / 2);
+		CHECK(controller.CanSend(CongestionController::InitialWindowSize / 2));
+	}
+
+	SECTION("Converges on simulated links")
+	{
+		const LinkProfile profiles[] = {
+			{ "LAN",        50'000'000.0, Nz::Time::Milliseconds(1),   1024 * 1024 },
+			{ "Broadband",   2'000'000.0, Nz::Time::Milliseconds(20),  256 * 1024 },
+			{ "Mobile",        250'000.0, Nz::Time::Milliseconds(80),  64 * 1024 },
+			{ "Satellite",   1'000'000.0, Nz::Time::Milliseconds(300), 512 * 1024 }
+		};
+
+		for (const LinkProfile& profile : profiles)
+		{
+			INFO(profile.name);
+
+			SimulationResult result = SimulateLink(profile, Nz::Time::Seconds(30));
+			INFO("throughput: " << result.throughput << " B/s, average RTT: " << result.averageRoundTripTime.AsMilliseconds() << "ms, average window: " << result.averageWindowSize);
+
+			// Most of the bandwidth should be used, without filling the bottleneck queue
+			CHECK(result.throughput >= profile.bandwidth * 0.7);
+			CHECK(result.averageRoundTripTime <= profile.latency * 4 + CongestionController::QueueingDelayTolerance);
+
+			double bandwidthDelayProduct = profile.bandwidth * (profile.latency * 2).AsSeconds<double>();
+			CHECK(result.averageWindowSize <= std::max(bandwidthDelayProduct * 4.0, double(CongestionController::MinWindowSize) * 2.0));
+		}
+	}
+}
@@ -0,0 +1,249 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/DeformedChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <set>
+#include <tuple>
+
+using namespace tsom;
+
+namespace
+{
+	struct TriangleMesh
+	{
+		std::vector<Nz::Vector3f> positions;
+		std::vector<Nz::UInt32> indices;
+	};
+
+	TriangleMesh BuildLegacyCollisionMesh(const DeformedChunk& chunk, const Nz::Vector3f& center)
+	{
+		TriangleMesh mesh;
+		chunk.BuildMesh(mesh.indices, center, [&](Nz::UInt32 count)
+		{
+			Chunk::VertexAttributes vertexAttributes;
+
+			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(mesh.positions.size());
+			mesh.positions.resize(mesh.positions.size() + count);
+			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&mesh.positions[vertexAttributes.firstIndex]);
+
+			return vertexAttributes;
+		});
+
+		return mesh;
+	}
+
+	std::optional<float> RaycastMesh(const TriangleMesh& mesh, const Nz::Vector3f& origin, const Nz::Vector3f& direction)
+	{
+		std::optional<float> closestHit;
+		for (std::size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			const Nz::Vector3f& a = mesh.positions[mesh.indices[i + 0]];
+			const Nz::Vector3f& b = mesh.positions[mesh.indices[i + 1]];
+			const Nz::Vector3f& c = mesh.positions[mesh.indices[i + 2]];
+
+			// Möller-Trumbore
+			Nz::Vector3f ab = b - a;
+			Nz::Vector3f ac = c - a;
+			Nz::Vector3f p = Nz::Vector3f::CrossProduct(direction, ac);
+			float det = ab.DotProduct(p);
+			if (std::abs(det) < 1e-8f)
+				continue;
+
+			float invDet = 1.f / det;
+			Nz::Vector3f t = origin - a;
+			float u = t.DotProduct(p) * invDet;
+			if (u < 0.f || u > 1.f)
+				continue;
+
+			Nz::Vector3f q = Nz::Vector3f::CrossProduct(t, ab);
+			float v = direction.DotProduct(q) * invDet;
+			if (v < 0.f || u + v > 1.f)
+				continue;
+
+			float distance = ac.DotProduct(q) * invDet;
+			if (distance > 0.f && (!closestHit || distance < *closestHit))
+				closestHit = distance;
+		}
+
+		return closestHit;
+	}
+}
+
+TEST_CASE("Deformed chunk collisions", "[Chunks]")
+{
+	constexpr unsigned int ChunkSize = 16;
+	constexpr float DeformationRadius = 3.f;
+	const Nz::Vector3f deformationCenter(ChunkSize * 0.5f);
+
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 0.f, 9.81f);
+
+	DeformedChunk chunk(blockLibrary, planet, { 0, 0, 0 }, Nz::Vector3ui(ChunkSize), 1.f, deformationCenter, DeformationRadius);
+
+	// Hollow cube with a few holes, so rays can hit both flat and rounded parts
+	auto FillHollowCube = [&]
+	{
+		BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+		std::minstd_rand rand(42);
+		std::bernoulli_distribution holeDis(0.1);
+
+		chunk.LockWrite();
+		chunk.Reset([&](BlockIndex* blocks)
+		{
+			for (unsigned int z = 0; z < ChunkSize; ++z)
+			{
+				for (unsigned int y = 0; y < ChunkSize; ++y)
+				{
+					for (unsigned int x = 0; x < ChunkSize; ++x)
+					{
+						Nz::Vector3f blockCenter(x + 0.5f, z + 0.5f, y + 0.5f);
+						Nz::Vector3f offset = (blockCenter - deformationCenter).GetAbs();
+						float distance = std::max({ offset.x, offset.y, offset.z });
+
+						bool isSolid = distance > 2.5f && distance < 6.5f && !holeDis(rand);
+						blocks[chunk.GetBlockLocalIndex({ x, y, z })] = (isSolid) ? stoneBlock : EmptyBlockIndex;
+					}
+				}
+			}
+		});
+		chunk.UnlockWrite();
+	};
+
+	SECTION("Collision mesh matches the render mesh surface")
+	{
+		FillHollowCube();
+
+		TriangleMesh legacyMesh = BuildLegacyCollisionMesh(chunk, deformationCenter);
+
+		TriangleMesh collisionMesh;
+		chunk.BuildCollisionMesh(collisionMesh.positions, collisionMesh.indices);
+
+		REQUIRE(!collisionMesh.indices.empty());
+		CHECK(collisionMesh.indices.size() % 3 == 0);
+		CHECK(collisionMesh.indices.size() < legacyMesh.indices.size());
+		CHECK(collisionMesh.positions.size() < legacyMesh.positions.size());
+
+		// Vertices are welded
+		std::set<std::tuple<float, float, float>> uniquePositions;
+		for (const Nz::Vector3f& position : collisionMesh.positions)
+			uniquePositions.emplace(position.x, position.y, position.z);
+
+		CHECK(uniquePositions.size() == collisionMesh.positions.size());
+
+		// Cast rays from every side and compare hits, triangulation of rounded faces can differ slightly
+		constexpr unsigned int RayPerAxis = 40;
+		constexpr float Tolerance = 0.05f;
+
+		unsigned int rayCount = 0;
+		unsigned int mismatchCount = 0;
+		for (const Nz::Vector3f& normal : s_dirNormals)
+		{
+			Nz::Vector3f uAxis = (std::abs(normal.x) > 0.5f) ? Nz::Vector3f::UnitY() : Nz::Vector3f::UnitX();
+			Nz::Vector3f vAxis = Nz::Vector3f::CrossProduct(normal, uAxis);
+
+			for (unsigned int v = 0; v < RayPerAxis; ++v)
+			{
+				for (unsigned int u = 0; u < RayPerAxis; ++u)
+				{
+					float uOffset = (u + 0.37f) / RayPerAxis * ChunkSize - ChunkSize * 0.5f;
+					float vOffset = (v + 0.61f) / RayPerAxis * ChunkSize - ChunkSize * 0.5f;
+
+					Nz::Vector3f origin = deformationCenter + normal * ChunkSize + uAxis * uOffset + vAxis * vOffset;
+
+					std::optional<float> legacyHit = RaycastMesh(legacyMesh, origin, -normal);
+					std::optional<float> hit = RaycastMesh(collisionMesh, origin, -normal);
+
+					rayCount++;
+					if (legacyHit.has_value() != hit.has_value() || (hit && std::abs(*hit - *legacyHit) > Tolerance))
+						mismatchCount++;
+				}
+			}
+		}
+
+		INFO(mismatchCount << " rays out of " << rayCount << " disagree");
+		CHECK(mismatchCount * 100 <= rayCount);
+	}
+
+	SECTION("Merged faces don't leave T-junctions next to deformed faces")
+	{
+		FillHollowCube();
+
+		TriangleMesh collisionMesh;
+		chunk.BuildCollisionMesh(collisionMesh.positions, collisionMesh.indices);
+		REQUIRE(!collisionMesh.indices.empty());
+
+		auto IsAxisAligned = [&](std::size_t triangleIndex)
+		{
+			const Nz::Vector3f& a = collisionMesh.positions[collisionMesh.indices[triangleIndex + 0]];
+			const Nz::Vector3f& b = collisionMesh.positions[collisionMesh.indices[triangleIndex + 1]];
+			const Nz::Vector3f& c = collisionMesh.positions[collisionMesh.indices[triangleIndex + 2]];
+
+			Nz::Vector3f normal = Nz::Vector3f::Normalize(Nz::Vector3f::CrossProduct(b - a, c - a)).GetAbs();
+			return std::max({ normal.x, normal.y, normal.z }) > 0.9999f;
+		};
+
+		// Vertices used by deformed triangles
+		std::vector<bool> deformedVertices(collisionMesh.positions.size(), false);
+		for (std::size_t i = 0; i < collisionMesh.indices.size(); i += 3)
+		{
+			if (IsAxisAligned(i))
+				continue;
+
+			for (std::size_t j = 0; j < 3; ++j)
+				deformedVertices[collisionMesh.indices[i + j]] = true;
+		}
+
+		// A deformed triangle vertex must never lie inside another triangle edge
+		unsigned int tJunctionCount = 0;
+		for (std::size_t i = 0; i < collisionMesh.indices.size(); i += 3)
+		{
+			for (std::size_t j = 0; j < 3; ++j)
+			{
+				const Nz::Vector3f& edgeStart = collisionMesh.positions[collisionMesh.indices[i + j]];
+				const Nz::Vector3f& edgeEnd = collisionMesh.positions[collisionMesh.indices[i + (j + 1) % 3]];
+				Nz::Vector3f edge = edgeEnd - edgeStart;
+				float edgeLength = edge.GetLength();
+
+				for (std::size_t vertexIndex = 0; vertexIndex < collisionMesh.positions.size(); ++vertexIndex)
+				{
+					if (!deformedVertices[vertexIndex])
+						continue;
+
+					Nz::Vector3f offset = collisionMesh.positions[vertexIndex] - edgeStart;
+					float projection = offset.DotProduct(edge) / edgeLength;
+					if (projection < 0.01f || projection > edgeLength - 0.01f)
+						continue;
+
+					if ((offset - edge * (projection / edgeLength)).GetLength() < 0.001f)
+						tJunctionCount++;
+				}
+			}
+		}
+
+		CHECK(tJunctionCount == 0);
+	}
+
+	SECTION("Non-colliding blocks are ignored")
+	{
+		BlockIndex forcefieldBlock = blockLibrary.GetBlockIndex("forcefield");
+
+		chunk.LockWrite();
+		chunk.Reset([&](BlockIndex* blocks)
+		{
+			std::fill_n(blocks, ChunkSize * ChunkSize * ChunkSize, forcefieldBlock);
+		});
+		chunk.UnlockWrite();
+
+		TriangleMesh collisionMesh;
+		chunk.BuildCollisionMesh(collisionMesh.positions, collisionMesh.indices);
+
+		CHECK(collisionMesh.positions.empty());
+		CHECK(collisionMesh.indices.empty());
+		CHECK(chunk.BuildCollider() == nullptr);
+	}
+}
@@ -0,0 +1,116 @@
+#include <CommonLib/EntityRegistry.hpp>
+#include <CommonLib/Components/ClassInstanceComponent.hpp>
+#include <CommonLib/Components/ScriptedEntityComponent.hpp>
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
+#include <CommonLib/Scripting/SharedEntityScriptingLibrary.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <string>
+
+using namespace tsom;
+
+TEST_CASE("Entity properties from scripts", "[Scripting]")
+{
+	sol::state state;
+	state.open_libraries(sol::lib::base, sol::lib::math);
+
+	ScriptCpuMonitor cpuMonitor(state.lua_state());
+
+	EntityRegistry entityRegistry;
+	SharedEntityScriptingLibrary entityLibrary(entityRegistry);
+	entityLibrary.Register(state);
+
+	state.script(R"(
+		local turret = EntityRegistry.ClassBuilder()
+		TurretActive = turret:AddProperty("active", { type = "bool", default = false })
+		TurretAmmo = turret:AddProperty("ammo", { type = "integer", default = 10 })
+		TurretLabel = turret:AddProperty("label", { type = "string", default = "turret" })
+		TurretRange = turret:AddProperty("range", { type = "float", default = 5.0 })
+
+		UpdateCount = 0
+		turret:OnPropertyUpdate("ammo", function (self, newValue)
+			UpdateCount = UpdateCount + 1
+			LastAmmo = newValue
+		end)
+
+		EntityRegistry.RegisterClass("turret", turret)
+
+		local door = EntityRegistry.ClassBuilder()
+		DoorOpen = door:AddProperty("open", { type = "bool", default = false })
+		EntityRegistry.RegisterClass("door", door)
+
+		-- Same property name and index as the turret one
+		local gate = EntityRegistry.ClassBuilder()
+		GateActive = gate:AddProperty("active", { type = "bool", default = false })
+		EntityRegistry.RegisterClass("gate", gate)
+	)");
+
+	entt::registry registry;
+
+	auto CreateEntity = [&](std::string_view className)
+	{
+		std::shared_ptr<const EntityClass> entityClass = entityRegistry.FindClass(className);
+		REQUIRE(entityClass);
+
+		entt::handle entity(registry, registry.create());
+		entity.emplace<ClassInstanceComponent>(entityClass);
+		entityClass->ActivateEntity(entity);
+
+		return entity;
+	};
+
+	entt::handle turret = CreateEntity("turret");
+	auto& turretInstance = turret.get<ClassInstanceComponent>();
+	state["Turret"] = turret.get<ScriptedEntityComponent>().entityTable;
+
+	SECTION("Values read through handles match the ones read by name")
+	{
+		CHECK(state.script("return Turret:GetProperty(TurretActive) == Turret:GetProperty('active')").get<bool>());
+		CHECK(state.script("return Turret:GetProperty(TurretAmmo)").get<Nz::Int64>() == 10);
+		CHECK(state.script("return Turret:GetProperty(TurretLabel)").get<std::string>() == "turret");
+		CHECK(state.script("return Turret:GetProperty(TurretRange)").get<float>() == 5.f);
+		CHECK(state.script("return math.type(Turret:GetProperty(TurretAmmo))").get<std::string>() == "integer");
+	}
+
+	SECTION("Updating properties through handles updates the class instance and triggers callbacks")
+	{
+		state.script(R"(
+			Turret:UpdateProperty(TurretActive, true)
+			Turret:UpdateProperty(TurretAmmo, 42)
+			Turret:UpdateProperty(TurretLabel, "sentry")
+			Turret:UpdateProperty(TurretRange, 7.5)
+		)");
+
+		CHECK(*turretInstance.GetProperty<EntityPropertyType::Bool>("active") == true);
+		CHECK(*turretInstance.GetProperty<EntityPropertyType::Integer>("ammo") == 42);
+		CHECK(*turretInstance.GetProperty<EntityPropertyType::String>("label") == "sentry");
+		CHECK(*turretInstance.GetProperty<EntityPropertyType::Float>("range") == 7.5f);
+
+		CHECK(state["UpdateCount"].get<int>() == 1);
+		CHECK(state["LastAmmo"].get<Nz::Int64>() == 42);
+	}
+
+	SECTION("Handles retrieved from an entity can be used like the class ones")
+	{
+		CHECK(state.script("return Turret:GetPropertyHandle('range'):GetName()").get<std::string>() == "range");
+		CHECK(state.script("local h = Turret:GetPropertyHandle('ammo') Turret:UpdateProperty(h, 3) return Turret:GetProperty(TurretAmmo)").get<Nz::Int64>() == 3);
+	}
+
+	SECTION("Using a handle on an entity of another class raises an error")
+	{
+		entt::handle door = CreateEntity("door");
+		state["Door"] = door.get<ScriptedEntityComponent>().entityTable;
+
+		CHECK_FALSE(state.safe_script("Door:UpdateProperty(TurretActive, true)", sol::script_pass_on_error).valid());
+		CHECK_FALSE(state.safe_script("return Door:GetProperty(TurretAmmo)", sol::script_pass_on_error).valid());
+		CHECK(state.safe_script("return Door:GetProperty(DoorOpen)", sol::script_pass_on_error).valid());
+
+		// Handles are bound to their class, not to the property name
+		entt::handle gate = CreateEntity("gate");
+		state["Gate"] = gate.get<ScriptedEntityComponent>().entityTable;
+
+		CHECK_FALSE(state.safe_script("Gate:UpdateProperty(TurretActive, true)", sol::script_pass_on_error).valid());
+		CHECK(state.safe_script("Gate:UpdateProperty(GateActive, true)", sol::script_pass_on_error).valid());
+		CHECK_FALSE(state.safe_script("Turret:UpdateProperty(GateActive, true)", sol::script_pass_on_error).valid());
+	}
+}
@@ -0,0 +1,235 @@
+#include <CommonLib/EntityClass.hpp>
+#include <CommonLib/EntityPropertyTracker.hpp>
+#include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <CommonLib/NetworkSession.hpp>
+#include <CommonLib/SessionHandler.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Components/ClassInstanceComponent.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <ServerLib/ServerEnvironment.hpp>
+#include <ServerLib/ServerInstance.hpp>
+#include <ServerLib/SessionVisibilityHandler.hpp>
+#include <Nazara/Core/Application.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/FilesystemAppComponent.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <Nazara/Physics3D/Physics3D.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	class TestEnvironment final : public ServerEnvironment
+	{
+		public:
+			TestEnvironment(ServerInstance& serverInstance) :
+			ServerEnvironment(serverInstance, ServerEnvironmentType::Ship)
+			{
+			}
+
+			entt::handle CreateEntity() override
+			{
+				return m_world->CreateEntity();
+			}
+
+			const GravityController* GetGravityController() const override
+			{
+				return nullptr;
+			}
+
+			void OnSave() override
+			{
+			}
+	};
+
+	constexpr SessionHandler::SendAttributeTable s_packetAttributes = SessionHandler::BuildAttributeTable({
+		{ PacketIndex<Packets::EntitiesCreation>,     { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EntitiesStateUpdate>,  { .channel = 1, .flags = Nz::ENetPacketFlag_Unreliable } },
+		{ PacketIndex<Packets::EntityPropertyUpdate>, { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+		{ PacketIndex<Packets::EnvironmentCreate>,    { .channel = 1, .flags = Nz::ENetPacketFlag::Reliable } },
+	});
+
+	// Packets are buffered by the session and never handed to the reactor
+	class TestSessionHandler final : public SessionHandler
+	{
+		public:
+			TestSessionHandler(NetworkSession* session) :
+			SessionHandler(session)
+			{
+				SetupHandlerTable(this);
+				SetupAttributeTable(s_packetAttributes);
+			}
+	};
+}
+
+TEST_CASE("Entity property batching", "[Network]")
+{
+	constexpr Nz::UInt32 AmmoIndex = 0;
+	constexpr Nz::UInt32 HeadingIndex = 1;
+	constexpr Nz::Time HeadingSendInterval = Nz::Time::Milliseconds(100);
+
+	Nz::Application<Nz::Network, Nz::Physics3D> app;
+	app.AddComponent<Nz::FilesystemAppComponent>();
+
+	ServerInstance serverInstance(app, ServerInstance::Config{});
+	TestEnvironment environment(serverInstance);
+
+	std::vector<EntityClass::Property> properties;
+	properties.push_back({ .name = "Ammo", .type = EntityPropertyType::Integer, .defaultValue = EntityPropertySingleValue<EntityPropertyType::Integer>(0), .isArray = false, .isNetworked = true });
+	properties.push_back({ .name = "Heading", .type = EntityPropertyType::Float, .defaultValue = EntityPropertySingleValue<EntityPropertyType::Float>(0.f), .isArray = false, .isNetworked = true, .sendInterval = HeadingSendInterval });
+
+	auto turretClass = std::make_shared<EntityClass>("turret", std::move(properties), EntityClass::Callbacks{}, std::vector<EntityClass::RemoteProcedureCall>{});
+
+	entt::handle entity = environment.CreateEntity();
+	auto& serverInstanceComponent = entity.emplace<ClassInstanceComponent>(turretClass);
+
+	ClassInstanceComponent clientInstance(turretClass);
+
+	NetworkReactor reactor(0, Nz::NetProtocol::IPv4, 0, 1);
+
+	// Same tracking as NetworkedEntitiesSystem, dirty properties are flushed to the visibility handler once per tick
+	EntityPropertyTracker tracker;
+
+	std::size_t updateCount = 0;
+	serverInstanceComponent.OnPropertyUpdate.Connect([&](ClassInstanceComponent* emitter, Nz::UInt32 propertyIndex, const EntityProperty& /*newValue*/)
+	{
+		updateCount++;
+		tracker.MarkDirty(entity.entity(), propertyIndex, emitter->GetClass()->GetProperty(propertyIndex).sendInterval);
+	});
+
+	auto SetupSession = [&](NetworkSession& session, SessionVisibilityHandler& visibility, Nz::UInt32 protocolVersion)
+	{
+		session.SetProtocolVersion(protocolVersion);
+		session.SetupHandler<TestSessionHandler>();
+		session.BeginPacketBuffering();
+
+		visibility.CreateEnvironment(environment, EnvironmentTransform(Nz::Vector3f::Zero(), Nz::Quaternionf::Identity()));
+		visibility.CreateEntity(entity, {
+			.environment = &environment,
+			.entityClass = turretClass,
+			.initialRotation = Nz::Quaternionf::Identity(),
+			.initialPosition = Nz::Vector3f::Zero(),
+			.entityProperties = { serverInstanceComponent.GetProperty(AmmoIndex), serverInstanceComponent.GetProperty(HeadingIndex) },
+			.isMoving = false
+		});
+		visibility.Dispatch(0);
+	};
+
+	Nz::UInt16 tickIndex = 0;
+	Nz::Time currentTime = Nz::Time::Zero();
+	std::size_t processedPackets = 0;
+	std::size_t headingSendCount = 0;
+
+	// Runs a server tick and applies the property updates which would reach the client, returns how many packets were sent
+	auto Tick = [&](NetworkSession& session, SessionVisibilityHandler& visibility)
+	{
+		tickIndex++;
+		currentTime += Constants::TickDuration;
+
+		tracker.Flush(currentTime, [&](entt::entity flushedEntity, const Nz::Bitset<Nz::UInt64>& flushedProperties)
+		{
+			CHECK(flushedEntity == entity.entity());
+			visibility.UpdateEntityProperties(entity, flushedProperties);
+		});
+		visibility.Dispatch(tickIndex);
+
+		std::size_t packetCount = 0;
+
+		const auto& bufferedPackets = session.GetBufferedPackets();
+		for (; processedPackets < bufferedPackets.size(); ++processedPackets)
+		{
+			const Nz::ByteArray& payload = bufferedPackets[processedPackets].payload;
+			REQUIRE(payload.GetSize() > 0);
+			if (payload[0] != PacketIndex<Packets::EntityPropertyUpdate>)
+				continue;
+
+			Nz::ByteStream byteStream(payload.GetConstBuffer() + 1, payload.GetSize() - 1);
+
+			Packets::EntityPropertyUpdate propertyUpdate;
+			PacketSerializer serializer(byteStream, false, session.GetProtocolVersion());
+			Packets::Serialize(serializer, propertyUpdate);
+
+			for (auto& property : propertyUpdate.properties)
+			{
+				if (property.propertyIndex == HeadingIndex)
+					headingSendCount++;
+
+				clientInstance.UpdateProperty(property.propertyIndex, std::move(property.propertyValue));
+			}
+
+			packetCount++;
+		}
+
+		return packetCount;
+	};
+
+	SECTION("A single packet per entity and tick is sent")
+	{
+		constexpr std::size_t TickCount = 60;
+		constexpr std::size_t AmmoUpdatePerTick = 4;
+
+		NetworkSession session(reactor, 0, Nz::IpAddress::LoopbackIpV4);
+		SessionVisibilityHandler visibility(&session);
+		SetupSession(session, visibility, Constants::ProtocolBatchedPropertyUpdateVersion);
+
+		std::size_t packetCount = 0;
+		for (std::size_t tick = 0; tick < TickCount; ++tick)
+		{
+			for (std::size_t i = 0; i < AmmoUpdatePerTick; ++i)
+				serverInstanceComponent.UpdateProperty<EntityPropertyType::Integer>(AmmoIndex, *serverInstanceComponent.GetProperty<EntityPropertyType::Integer>(AmmoIndex) + 1);
+
+			serverInstanceComponent.UpdateProperty<EntityPropertyType::Float>(HeadingIndex, float(tick) * 1.5f);
+
+			packetCount += Tick(session, visibility);
+		}
+
+		CHECK(updateCount == TickCount * (AmmoUpdatePerTick + 1));
+		CHECK(packetCount == TickCount);
+		CHECK(*clientInstance.GetProperty<EntityPropertyType::Integer>(AmmoIndex) == Nz::Int64(TickCount * AmmoUpdatePerTick));
+
+		// Rate-limited properties are sent at their own rate, with their latest value
+		std::size_t maxHeadingSendCount = std::size_t(Constants::TickDuration.AsMicroseconds() * TickCount / HeadingSendInterval.AsMicroseconds()) + 1;
+		CHECK(headingSendCount <= maxHeadingSendCount);
+		CHECK(tracker.HasPendingUpdates());
+
+		currentTime += HeadingSendInterval;
+		CHECK(Tick(session, visibility) == 1);
+
+		CHECK_FALSE(tracker.HasPendingUpdates());
+		CHECK(*clientInstance.GetProperty<EntityPropertyType::Float>(HeadingIndex) == *serverInstanceComponent.GetProperty<EntityPropertyType::Float>(HeadingIndex));
+	}
+
+	SECTION("Older clients receive one packet per property")
+	{
+		NetworkSession session(reactor, 0, Nz::IpAddress::LoopbackIpV4);
+		SessionVisibilityHandler visibility(&session);
+		SetupSession(session, visibility, BuildVersion(0, 5, 0));
+
+		currentTime += HeadingSendInterval;
+		serverInstanceComponent.UpdateProperty<EntityPropertyType::Integer>(AmmoIndex, 42);
+		serverInstanceComponent.UpdateProperty<EntityPropertyType::Float>(HeadingIndex, 90.f);
+
+		CHECK(Tick(session, visibility) == 2);
+		CHECK(*clientInstance.GetProperty<EntityPropertyType::Integer>(AmmoIndex) == 42);
+		CHECK(*clientInstance.GetProperty<EntityPropertyType::Float>(HeadingIndex) == 90.f);
+	}
+
+	SECTION("Forgotten entities don't send pending updates")
+	{
+		NetworkSession session(reactor, 0, Nz::IpAddress::LoopbackIpV4);
+		SessionVisibilityHandler visibility(&session);
+		SetupSession(session, visibility, Constants::ProtocolBatchedPropertyUpdateVersion);
+
+		serverInstanceComponent.UpdateProperty<EntityPropertyType::Integer>(AmmoIndex, 42);
+		CHECK(tracker.HasPendingUpdates());
+
+		tracker.Forget(entity.entity());
+		CHECK_FALSE(tracker.HasPendingUpdates());
+
+		CHECK(Tick(session, visibility) == 0);
+	}
+}
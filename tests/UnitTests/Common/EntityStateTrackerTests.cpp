@@ -0,0 +1,166 @@
+#include <CommonLib/EntityStateTracker.hpp>
+#include <CommonLib/Version.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	std::size_t ComputePacketSize(const Packets::EntitiesStateUpdate& packet)
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+		byteStream << Nz::UInt8(PacketIndex<Packets::EntitiesStateUpdate>);
+
+		PacketSerializer serializer(byteStream, true, BuildVersion(0, 6, 0));
+		Packets::Serialize(serializer, const_cast<Packets::EntitiesStateUpdate&>(packet));
+
+		byteStream.FlushBits();
+
+		return byteArray.GetSize();
+	}
+}
+
+TEST_CASE("Entity state tracking", "[Network]")
+{
+	SECTION("Resting bodies are only sent at the heartbeat rate")
+	{
+		constexpr std::size_t BodyCount = 64;
+		constexpr Nz::UInt16 FallTickCount = 60;
+		constexpr Nz::UInt16 RestTickCount = 600;
+
+		EntityStateTracker tracker;
+		const Nz::UInt16 heartbeatInterval = tracker.GetHeartbeatInterval();
+
+		std::vector<Packets::Helper::EntityState> bodies(BodyCount);
+		for (std::size_t i = 0; i < BodyCount; ++i)
+		{
+			bodies[i].position = Nz::Vector3f(0.f, 10.f + float(i), 0.f);
+			bodies[i].rotation = Nz::Quaternionf::Identity();
+
+			tracker.Reset(static_cast<Packets::Helper::EntityId>(i), 0, bodies[i]);
+		}
+
+		// Sends a state update like the server would, returns its size in bytes (0 if nothing was sent)
+		auto DispatchTick = [&](Nz::UInt16 tickIndex, bool isSleeping)
+		{
+			Packets::EntitiesStateUpdate stateUpdate;
+			stateUpdate.tickIndex = tickIndex;
+			stateUpdate.lastInputIndex = InputIndex(0);
+
+			for (std::size_t i = 0; i < BodyCount; ++i)
+			{
+				Packets::Helper::EntityId entityId = static_cast<Packets::Helper::EntityId>(i);
+				if (!tracker.ShouldSend(entityId, tickIndex, bodies[i], isSleeping))
+					continue;
+
+				auto& entityData = stateUpdate.entities.emplace_back();
+				entityData.entityId = entityId;
+				entityData.newStates = bodies[i];
+			}
+
+			return (!stateUpdate.entities.empty()) ? ComputePacketSize(stateUpdate) : 0;
+		};
+
+		std::size_t fallingBytes = 0;
+		Nz::UInt16 tickIndex = 1;
+		for (; tickIndex <= FallTickCount; ++tickIndex)
+		{
+			for (auto& body : bodies)
+				body.position.y -= 0.1f;
+
+			std::size_t packetSize = DispatchTick(tickIndex, false);
+			CHECK(packetSize > 0);
+			fallingBytes += packetSize;
+		}
+
+		std::size_t restingBytes = 0;
+		std::size_t restingPacketCount = 0;
+		for (; tickIndex <= FallTickCount + RestTickCount; ++tickIndex)
+		{
+			std::size_t packetSize = DispatchTick(tickIndex, true);
+			if (packetSize > 0)
+			{
+				restingBytes += packetSize;
+				restingPacketCount++;
+			}
+		}
+
+		// Resting states are sent as bodies fall asleep, and then once per heartbeat
+		CHECK(restingPacketCount == RestTickCount / heartbeatInterval);
+
+		// Average bytes per tick should drop by the heartbeat interval (with some margin)
+		CHECK(restingBytes > 0);
+		CHECK(restingBytes * FallTickCount * heartbeatInterval <= fallingBytes * RestTickCount * 11 / 10);
+	}
+
+	SECTION("Jitter below the epsilon isn't sent")
+	{
+		EntityStateTracker tracker;
+
+		Packets::Helper::EntityState state;
+		state.position = Nz::Vector3f(5.f, 0.f, 0.f);
+		state.rotation = Nz::Quaternionf::Identity();
+		tracker.Reset(0, 0, state);
+
+		Packets::Helper::EntityState jitteringState = state;
+		jitteringState.position.x += EntityStateTracker::PositionEpsilon * 0.5f;
+		CHECK_FALSE(tracker.ShouldSend(0, 1, jitteringState, false));
+
+		jitteringState.rotation = Nz::EulerAnglesf(0.f, 0.01f, 0.f).ToQuaternion();
+		CHECK_FALSE(tracker.ShouldSend(0, 2, jitteringState, false));
+	}
+
+	SECTION("Rotations and slow drifts are eventually sent")
+	{
+		EntityStateTracker tracker;
+
+		Packets::Helper::EntityState state;
+		state.position = Nz::Vector3f(5.f, 0.f, 0.f);
+		state.rotation = Nz::Quaternionf::Identity();
+		tracker.Reset(0, 0, state);
+
+		Packets::Helper::EntityState rotatedState = state;
+		rotatedState.rotation = Nz::EulerAnglesf(0.f, 1.f, 0.f).ToQuaternion();
+		CHECK(tracker.ShouldSend(0, 3, rotatedState, false));
+
+		// Changes are compared to the last sent state, small moves accumulate until they're sent
+		Packets::Helper::EntityState driftingState = rotatedState;
+		std::size_t sentCount = 0;
+		for (Nz::UInt16 tickIndex = 4; tickIndex < 14; ++tickIndex)
+		{
+			driftingState.position.x += EntityStateTracker::PositionEpsilon * 0.4f;
+			if (tracker.ShouldSend(0, tickIndex, driftingState, false))
+				sentCount++;
+		}
+
+		CHECK(sentCount >= 3);
+		CHECK(sentCount <= 4);
+	}
+
+	SECTION("Bodies falling asleep and waking up")
+	{
+		EntityStateTracker tracker(30);
+
+		Packets::Helper::EntityState state;
+		state.position = Nz::Vector3f::Zero();
+		state.rotation = Nz::Quaternionf::Identity();
+		tracker.Reset(0, 65530, state); //< tick index wraps around
+
+		CHECK(tracker.ShouldSend(0, 65531, state, true)); //< resting state is sent once
+		CHECK_FALSE(tracker.ShouldSend(0, 65532, state, true));
+		CHECK_FALSE(tracker.ShouldSend(0, 24, state, true));
+		CHECK(tracker.ShouldSend(0, 25, state, true)); //< heartbeat
+		CHECK_FALSE(tracker.ShouldSend(0, 26, state, false));
+
+		state.position.y += 1.f;
+		CHECK(tracker.ShouldSend(0, 27, state, false));
+
+		tracker.Invalidate(0);
+		CHECK(tracker.ShouldSend(0, 28, state, false));
+	}
+}
@@ -0,0 +1,79 @@
+#include <CommonLib/Utility/MetricsRegistry.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+using namespace tsom;
+
+TEST_CASE("Metrics registry", "[Profiling]")
+{
+	SECTION("Histogram values land in the first bucket whose bound is greater or equal")
+	{
+		MetricsRegistry::Histogram histogram({ 1.0, 2.0, 5.0 });
+		histogram.Observe(0.5);
+		histogram.Observe(1.0); //< bounds are inclusive
+		histogram.Observe(1.5);
+		histogram.Observe(5.0);
+		histogram.Observe(10.0);
+		histogram.Observe(std::numeric_limits<double>::infinity());
+
+		std::vector<Nz::UInt64> cumulativeCounts = histogram.GetCumulativeCounts();
+		REQUIRE(cumulativeCounts.size() == 4);
+		CHECK(cumulativeCounts[0] == 2);
+		CHECK(cumulativeCounts[1] == 3);
+		CHECK(cumulativeCounts[2] == 4);
+		CHECK(cumulativeCounts[3] == 6);
+		CHECK(histogram.GetCount() == 6);
+	}
+
+	SECTION("Bucket bounds are generated linearly or exponentially")
+	{
+		CHECK(MetricsRegistry::ExponentialBuckets(1.0, 2.0, 4) == std::vector<double>{ 1.0, 2.0, 4.0, 8.0 });
+		CHECK(MetricsRegistry::LinearBuckets(0.5, 0.5, 3) == std::vector<double>{ 0.5, 1.0, 1.5 });
+	}
+
+	SECTION("The same name and labels return the same metric")
+	{
+		MetricsRegistry registry;
+
+		MetricsRegistry::Counter& counter = registry.GetCounter("test_packets_total", "Packets", { { "direction", "in" } });
+		counter.Increment(3.0);
+
+		CHECK(&registry.GetCounter("test_packets_total", "Packets", { { "direction", "in" } }) == &counter);
+		CHECK(&registry.GetCounter("test_packets_total", "Packets", { { "direction", "out" } }) != &counter);
+		CHECK(registry.GetCounter("test_packets_total", "Packets", { { "direction", "in" } }).GetValue() == 3.0);
+
+		// Registering a name with another type fails
+		CHECK_THROWS_AS(registry.GetGauge("test_packets_total", "Packets"), std::runtime_error);
+	}
+
+	SECTION("Metrics are exported as sorted Prometheus text families")
+	{
+		MetricsRegistry registry;
+		registry.GetCounter("test_bytes_total", "Bytes \"sent\"\nby the server\\", { { "packet", "Chunk\"Reset\"" } }).Increment(42.0);
+		registry.GetGauge("test_players", "Connected players").Set(3.0);
+
+		MetricsRegistry::Histogram& histogram = registry.GetHistogram("test_duration_seconds", "Durations", { 0.5, 1.0 }, { { "type", "tick" } });
+		histogram.Observe(0.25);
+		histogram.Observe(0.75);
+		histogram.Observe(2.0);
+
+		std::string text = registry.ToPrometheusText();
+
+		CHECK(text ==
+			"# HELP test_bytes_total Bytes \"sent\"\\nby the server\\\\\n"
+			"# TYPE test_bytes_total counter\n"
+			"test_bytes_total{packet=\"Chunk\\\"Reset\\\"\"} 42\n"
+			"# HELP test_duration_seconds Durations\n"
+			"# TYPE test_duration_seconds histogram\n"
+			"test_duration_seconds_bucket{type=\"tick\",le=\"0.5\"} 1\n"
+			"test_duration_seconds_bucket{type=\"tick\",le=\"1\"} 2\n"
+			"test_duration_seconds_bucket{type=\"tick\",le=\"+Inf\"} 3\n"
+			"test_duration_seconds_sum{type=\"tick\"} 3\n"
+			"test_duration_seconds_count{type=\"tick\"} 3\n"
+			"# HELP test_players Connected players\n"
+			"# TYPE test_players gauge\n"
+			"test_players 3\n");
+	}
+}
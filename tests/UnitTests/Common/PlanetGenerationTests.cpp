@@ -0,0 +1,299 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <NazaraUtils/MathUtils.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <PerlinNoise.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	unsigned int GetBlockLocalIndex(const Nz::Vector3ui& indices)
+	{
+		return Planet::ChunkSize * (Planet::ChunkSize * indices.z + indices.y) + indices.x;
+	}
+
+	// Planet generator as it was before the surface noise was evaluated in batches (one siv::PerlinNoise call per column),
+	// kept verbatim as the golden reference for the generator output
+	std::vector<BlockIndex> GenerateReferenceChunk(const Planet& planet, const BlockLibrary& blockLibrary, const ChunkIndices& chunkIndices, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount)
+	{
+		constexpr std::size_t freeSpace = 30;
+
+		Nz::UInt32 chunkSeed = seed + static_cast<Nz::UInt32>(chunkIndices.x) + static_cast<Nz::UInt32>(chunkIndices.y) + static_cast<Nz::UInt32>(chunkIndices.z);
+
+		std::minstd_rand rand(chunkSeed);
+		std::bernoulli_distribution dis(0.9);
+
+		BlockIndex dirtBlockIndex = blockLibrary.GetBlockIndex("dirt");
+		BlockIndex grassBlockIndex = blockLibrary.GetBlockIndex("grass");
+		BlockIndex stoneBlockIndex = blockLibrary.GetBlockIndex("stone");
+		BlockIndex stoneMossyBlockIndex = blockLibrary.GetBlockIndex("stone_mossy");
+		BlockIndex snowBlockIndex = blockLibrary.GetBlockIndex("snow");
+
+		Nz::Vector3i maxHeight((Nz::Vector3i(chunkCount) + Nz::Vector3i(1)) / 2);
+		maxHeight *= int(Planet::ChunkSize);
+
+		Nz::EnumArray<Direction, siv::PerlinNoise> perlin;
+		for (auto&& [dir, noise] : perlin.iter_kv())
+			noise.reseed(seed + static_cast<unsigned int>(dir));
+
+		std::vector<BlockIndex> blockIndices(Planet::ChunkSize * Planet::ChunkSize * Planet::ChunkSize, InvalidBlockIndex);
+		{
+			// Fill all blocks based on their depth
+			BlockIndex* blockIndexPtr = blockIndices.data();
+			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			{
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+				{
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						Nz::Vector3i blockPos = planet.GetBlockIndices(chunkIndices, { x, y, z });
+						unsigned int depth = Nz::SafeCaster(std::min({
+							maxHeight.x - std::abs(blockPos.x),
+							maxHeight.y - std::abs(blockPos.z),
+							maxHeight.z - std::abs(blockPos.y)
+						}));
+
+						if (depth < freeSpace)
+						{
+							*blockIndexPtr++ = EmptyBlockIndex;
+							continue;
+						}
+
+						depth -= freeSpace;
+
+						BlockIndex blockIndex;
+						if (depth <= 6)
+							blockIndex = snowBlockIndex;
+						else if (depth <= 18)
+							blockIndex = dirtBlockIndex;
+						else
+							blockIndex = (dis(rand)) ? stoneBlockIndex : stoneMossyBlockIndex;
+
+						if (std::abs(blockPos.x) <= 2 && std::abs(blockPos.z) <= 2)
+							blockIndex = EmptyBlockIndex;
+
+						if (blockIndex != InvalidBlockIndex)
+							*blockIndexPtr++ = blockIndex;
+					}
+				}
+			}
+
+			constexpr double heightScale = 1.5f;
+			constexpr double scale = 0.02f;
+
+			// +X
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices(chunkIndices, { 0, x, y });
+					double height = perlin[Direction::Right].normalizedOctave2D_01(mapPos.y * scale, mapPos.z * scale, 4) * heightScale;
+
+					int terrainDepth = std::round(std::min<double>(height * (maxHeight.x / 2 - freeSpace) + freeSpace, maxHeight.x / 2));
+					int blockDepth = maxHeight.x - mapPos.x + 1;
+					if (blockDepth < terrainDepth)
+						continue;
+
+					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+					if (startHeight >= Planet::ChunkSize)
+						continue;
+
+					if (BlockIndex& blockType = blockIndices[GetBlockLocalIndex({ startHeight, x, y })]; blockType == dirtBlockIndex)
+						blockType = grassBlockIndex;
+
+					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+						blockIndices[GetBlockLocalIndex({ height, x, y })] = EmptyBlockIndex;
+				}
+			}
+
+			// -X
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices(chunkIndices, { Planet::ChunkSize - 1, x, y });
+					double height = perlin[Direction::Left].normalizedOctave2D_01(mapPos.y * scale, mapPos.z * scale, 4) * heightScale;
+
+					int terrainDepth = std::round(std::min<double>(height * (maxHeight.x / 2 - freeSpace) + freeSpace, maxHeight.x / 2));
+					int blockDepth = maxHeight.x + mapPos.x + 1;
+					if (blockDepth < terrainDepth)
+						continue;
+
+					unsigned int startHeight = Nz::SafeCast<unsigned int>(blockDepth - terrainDepth);
+					if (startHeight >= Planet::ChunkSize)
+						continue;
+
+					if (BlockIndex& blockType = blockIndices[GetBlockLocalIndex({ Planet::ChunkSize - startHeight - 1, x, y })]; blockType == dirtBlockIndex)
+						blockType = grassBlockIndex;
+
+					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+						blockIndices[GetBlockLocalIndex({ Planet::ChunkSize - height - 1, x, y })] = EmptyBlockIndex;
+				}
+			}
+
+			// +Y
+			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices(chunkIndices, { x, z, 0 });
+					double height = perlin[Direction::Up].normalizedOctave2D_01(mapPos.x * scale, mapPos.z * scale, 4) * heightScale;
+
+					int terrainDepth = std::round(std::min<double>(height * (maxHeight.y / 2 - freeSpace) + freeSpace, maxHeight.y / 2));
+					int blockDepth = maxHeight.y - mapPos.y + 1;
+					if (blockDepth < terrainDepth)
+						continue;
+
+					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+					if (startHeight >= Planet::ChunkSize)
+						continue;
+
+					if (BlockIndex& blockType = blockIndices[GetBlockLocalIndex({ x, z, startHeight })]; blockType == dirtBlockIndex)
+						blockType = grassBlockIndex;
+
+					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+						blockIndices[GetBlockLocalIndex({ x, z, height })] = EmptyBlockIndex;
+				}
+			}
+
+			// -Y
+			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices(chunkIndices, { x, z, Planet::ChunkSize - 1 });
+					double height = perlin[Direction::Down].normalizedOctave2D_01(mapPos.x * scale, mapPos.z * scale, 4) * heightScale;
+
+					int terrainDepth = std::round(std::min<double>(height * (maxHeight.y / 2 - freeSpace) + freeSpace, maxHeight.y / 2));
+					int blockDepth = maxHeight.y + mapPos.y + 1;
+					if (blockDepth < terrainDepth)
+						continue;
+
+					unsigned int startHeight = Nz::SafeCast<unsigned int>(blockDepth - terrainDepth);
+					if (startHeight >= Planet::ChunkSize)
+						continue;
+
+					if (BlockIndex& blockType = blockIndices[GetBlockLocalIndex({ x, z, Planet::ChunkSize - startHeight - 1 })]; blockType == dirtBlockIndex)
+						blockType = grassBlockIndex;
+
+					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+						blockIndices[GetBlockLocalIndex({ x, z, Planet::ChunkSize - height - 1 })] = EmptyBlockIndex;
+				}
+			}
+
+			// +Z
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices(chunkIndices, { x, 0, y });
+					double height = perlin[Direction::Back].normalizedOctave2D_01(mapPos.x * scale, mapPos.y * scale, 4) * heightScale;
+
+					int terrainDepth = std::round(std::min<double>(height * (maxHeight.z / 2 - freeSpace) + freeSpace, maxHeight.z / 2));
+					int blockDepth = maxHeight.z - mapPos.z + 1;
+					if (blockDepth < terrainDepth)
+						continue;
+
+					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+					if (startHeight >= Planet::ChunkSize)
+						continue;
+
+					if (BlockIndex& blockType = blockIndices[GetBlockLocalIndex({ x, startHeight, y })]; blockType == dirtBlockIndex)
+						blockType = grassBlockIndex;
+
+					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+						blockIndices[GetBlockLocalIndex({ x, height, y })] = EmptyBlockIndex;
+				}
+			}
+
+			// -Z
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				{
+					BlockIndices mapPos = planet.GetBlockIndices(chunkIndices, { x, Planet::ChunkSize - 1, y });
+					double height = perlin[Direction::Front].normalizedOctave2D_01(mapPos.x * scale, mapPos.y * scale, 4) * heightScale;
+
+					int terrainDepth = std::round(std::min<double>(height * (maxHeight.z / 2 - freeSpace) + freeSpace, maxHeight.z / 2));
+					int blockDepth = maxHeight.z + mapPos.z + 1;
+					if (blockDepth < terrainDepth)
+						continue;
+
+					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+					if (startHeight >= Planet::ChunkSize)
+						continue;
+
+					if (BlockIndex& blockType = blockIndices[GetBlockLocalIndex({ x, Planet::ChunkSize - startHeight - 1, y })]; blockType == dirtBlockIndex)
+						blockType = grassBlockIndex;
+
+					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+						blockIndices[GetBlockLocalIndex({ x, Planet::ChunkSize - height - 1, y })] = EmptyBlockIndex;
+				}
+			}
+		}
+
+		return blockIndices;
+	}
+
+	Nz::UInt64 HashBlocks(Nz::UInt64 hash, const BlockIndex* blocks, std::size_t blockCount)
+	{
+		// FNV-1a
+		for (std::size_t i = 0; i < blockCount; ++i)
+		{
+			hash ^= blocks[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+}
+
+TEST_CASE("Planet generation", "[Planet]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	const Nz::Vector3ui chunkCount(5);
+
+	BlockLibrary blockLibrary;
+	Nz::TaskScheduler taskScheduler;
+
+	Planet planet(1.f, 16.f, 9.81f);
+	planet.GenerateChunks(blockLibrary, taskScheduler, seed, chunkCount);
+	REQUIRE(planet.GetChunkCount() == chunkCount.x * chunkCount.y * chunkCount.z);
+
+	SECTION("Generated chunks match the reference generator block for block")
+	{
+		Nz::UInt64 referenceHash = 14695981039346656037ull;
+		Nz::UInt64 planetHash = 14695981039346656037ull;
+
+		std::size_t mismatchingChunkCount = 0;
+		for (int z = -int(chunkCount.z / 2); z <= int(chunkCount.z / 2); ++z)
+		{
+			for (int y = -int(chunkCount.y / 2); y <= int(chunkCount.y / 2); ++y)
+			{
+				for (int x = -int(chunkCount.x / 2); x <= int(chunkCount.x / 2); ++x)
+				{
+					const Chunk* chunk = planet.GetChunk({ x, y, z });
+					REQUIRE(chunk);
+					REQUIRE(chunk->GetBlockCount() == Planet::ChunkSize * Planet::ChunkSize * Planet::ChunkSize);
+
+					std::vector<BlockIndex> referenceBlocks = GenerateReferenceChunk(planet, blockLibrary, { x, y, z }, seed, chunkCount);
+					if (!std::equal(referenceBlocks.begin(), referenceBlocks.end(), chunk->GetContent()))
+						mismatchingChunkCount++;
+
+					referenceHash = HashBlocks(referenceHash, referenceBlocks.data(), referenceBlocks.size());
+					planetHash = HashBlocks(planetHash, chunk->GetContent(), chunk->GetBlockCount());
+				}
+			}
+		}
+
+		CHECK(mismatchingChunkCount == 0);
+		CHECK(planetHash == referenceHash);
+	}
+}
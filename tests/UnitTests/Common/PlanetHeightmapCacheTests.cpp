@@ -0,0 +1,100 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/PlanetHeightmapCache.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <utility>
+
+using namespace tsom;
+
+TEST_CASE("Planet heightmap cache", "[Planet]")
+{
+	SECTION("LRU eviction")
+	{
+		PlanetHeightmapCache cache(2);
+
+		unsigned int generationCount = 0;
+		auto GetTile = [&](int x)
+		{
+			PlanetHeightmapCache::TileKey key;
+			key.face = Direction::Up;
+			key.seed = 42;
+			key.origin = Nz::Vector2i(x, 0);
+			key.maxHeight = 64;
+
+			return cache.GetTile(key, [&](PlanetHeightmapCache::Tile& tile)
+			{
+				generationCount++;
+				tile.fill(x);
+			});
+		};
+
+		CHECK(GetTile(0)->front() == 0);
+		CHECK(GetTile(1)->front() == 1);
+		CHECK(generationCount == 2);
+
+		CHECK(GetTile(0)->front() == 0);
+		CHECK(generationCount == 2);
+
+		// Tile 1 is the least recently used one
+		auto tile2 = GetTile(2);
+		CHECK(generationCount == 3);
+		CHECK(cache.GetTileCount() == 2);
+
+		CHECK(GetTile(0)->front() == 0);
+		CHECK(generationCount == 3);
+
+		CHECK(GetTile(1)->front() == 1);
+		CHECK(generationCount == 4);
+
+		// Evicted tiles stay valid while being referenced
+		CHECK(tile2->back() == 2);
+
+		cache.UpdateCapacity(0);
+		CHECK(cache.GetTileCount() == 0);
+
+		CHECK(GetTile(0)->front() == 0);
+		CHECK(GetTile(0)->front() == 0);
+		CHECK(generationCount == 6);
+	}
+
+	SECTION("Cached and uncached generation give the same chunks")
+	{
+		constexpr Nz::UInt32 seed = 42;
+		const Nz::Vector3ui chunkCount(3);
+
+		BlockLibrary blockLibrary;
+		Nz::TaskScheduler taskScheduler;
+
+		Planet uncachedPlanet(1.f, 16.f, 9.81f);
+		uncachedPlanet.GetHeightmapCache().UpdateCapacity(0);
+		uncachedPlanet.GenerateChunks(blockLibrary, taskScheduler, seed, chunkCount);
+
+		// Also use a tiny cache to stress eviction while generating in parallel
+		for (std::size_t capacity : { Planet::DefaultHeightmapCacheCapacity, std::size_t(2) })
+		{
+			Planet cachedPlanet(1.f, 16.f, 9.81f);
+			cachedPlanet.GetHeightmapCache().UpdateCapacity(capacity);
+			cachedPlanet.GenerateChunks(blockLibrary, taskScheduler, seed, chunkCount);
+
+			REQUIRE(cachedPlanet.GetChunkCount() == uncachedPlanet.GetChunkCount());
+			CHECK(cachedPlanet.GetHeightmapCache().GetTileCount() <= capacity);
+
+			std::size_t mismatchCount = 0;
+			std::as_const(uncachedPlanet).ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& uncachedChunk)
+			{
+				const Chunk* cachedChunk = cachedPlanet.GetChunk(chunkIndices);
+				REQUIRE(cachedChunk);
+
+				for (unsigned int i = 0; i < uncachedChunk.GetBlockCount(); ++i)
+				{
+					if (cachedChunk->GetBlockContent(i) != uncachedChunk.GetBlockContent(i))
+						mismatchCount++;
+				}
+			});
+
+			CHECK(mismatchCount == 0);
+		}
+	}
+}
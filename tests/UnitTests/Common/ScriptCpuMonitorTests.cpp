@@ -0,0 +1,215 @@
+#include <CommonLib/Scripting/ScriptCpuMonitor.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace tsom;
+
+namespace
+{
+	std::string GetError(const sol::protected_function_result& result)
+	{
+		sol::error err = result;
+		return err.what();
+	}
+}
+
+TEST_CASE("Script CPU monitor", "[Scripting]")
+{
+	sol::state state;
+	state.open_libraries(sol::lib::base);
+
+	ScriptCpuMonitor cpuMonitor(state.lua_state());
+	CHECK(&ScriptCpuMonitor::Retrieve(state.lua_state()) == &cpuMonitor);
+
+	ScriptCpuStats& classStats = cpuMonitor.GetOrCreateClassStats("computer");
+	ScriptCpuStats entityStats;
+
+	sol::protected_function infiniteLoop = state.script("return function() while true do end end");
+
+	SECTION("An infinite loop exceeding the call time budget is aborted")
+	{
+		ScriptCpuMonitor::Budget budget;
+		budget.callTime = Nz::Time::Milliseconds(20);
+		cpuMonitor.UpdateBudget(budget);
+
+		Nz::Time startTime = Nz::GetElapsedNanoseconds();
+		auto result = cpuMonitor.Call(infiniteLoop, &classStats, &entityStats);
+		Nz::Time callTime = Nz::GetElapsedNanoseconds() - startTime;
+
+		REQUIRE_FALSE(result.valid());
+		CHECK(GetError(result).find("time budget") != std::string::npos);
+		CHECK(callTime >= budget.callTime);
+		CHECK(callTime < Nz::Time::Seconds(1));
+		CHECK_FALSE(cpuMonitor.IsCallInProgress());
+
+		CHECK(classStats.callCount == 1);
+		CHECK(classStats.abortCount == 1);
+		CHECK(entityStats.callCount == 1);
+		CHECK(entityStats.abortCount == 1);
+
+		// The monitor keeps working for the next calls
+		sol::protected_function sum = state.script("return function(a, b) return a + b end");
+		auto sumResult = cpuMonitor.Call(sum, &classStats, &entityStats, 1, 2);
+		REQUIRE(sumResult.valid());
+		CHECK(sumResult.get<int>() == 3);
+		CHECK(classStats.callCount == 2);
+		CHECK(classStats.abortCount == 1);
+	}
+
+	SECTION("An infinite loop catching the abort error is still aborted")
+	{
+		ScriptCpuMonitor::Budget budget;
+		budget.callTime = Nz::Time::Milliseconds(20);
+		cpuMonitor.UpdateBudget(budget);
+
+		sol::protected_function stubbornLoop = state.script(R"(
+			return function()
+				while true do
+					pcall(function() while true do end end)
+				end
+			end
+		)");
+
+		auto result = cpuMonitor.Call(stubbornLoop, &classStats, &entityStats);
+
+		REQUIRE_FALSE(result.valid());
+		CHECK(classStats.abortCount == 1);
+	}
+
+	SECTION("An infinite loop is aborted once it exceeds the instruction budget")
+	{
+		ScriptCpuMonitor::Budget budget;
+		budget.callInstructions = 100'000;
+		cpuMonitor.UpdateBudget(budget);
+
+		auto result = cpuMonitor.Call(infiniteLoop, &classStats, &entityStats);
+
+		REQUIRE_FALSE(result.valid());
+		CHECK(GetError(result).find("instruction budget") != std::string::npos);
+		CHECK(classStats.instructionCount >= budget.callInstructions);
+		CHECK(classStats.instructionCount < budget.callInstructions + ScriptCpuMonitor::HookInstructionInterval);
+	}
+
+	SECTION("Calls exceeding the tick time budget are aborted until the next tick")
+	{
+		ScriptCpuMonitor::Budget budget;
+		budget.tickTime = Nz::Time::Milliseconds(20);
+		cpuMonitor.UpdateBudget(budget);
+
+		auto firstResult = cpuMonitor.Call(infiniteLoop, &classStats, nullptr);
+		CHECK_FALSE(firstResult.valid());
+		CHECK(GetError(firstResult).find("tick time budget") != std::string::npos);
+		CHECK(cpuMonitor.GetTickTime() >= budget.tickTime);
+
+		// Following calls of the same tick are aborted right away
+		Nz::Time startTime = Nz::GetElapsedNanoseconds();
+		auto secondResult = cpuMonitor.Call(infiniteLoop, &classStats, nullptr);
+		Nz::Time callTime = Nz::GetElapsedNanoseconds() - startTime;
+
+		CHECK_FALSE(secondResult.valid());
+		CHECK(callTime < budget.tickTime);
+		CHECK(classStats.abortCount == 2);
+
+		// The budget is restored on the next tick
+		cpuMonitor.ResetTickTime();
+		CHECK(cpuMonitor.GetTickTime() == Nz::Time::Zero());
+		CHECK(cpuMonitor.GetLastTickTime() >= budget.tickTime);
+
+		sol::protected_function shortLoop = state.script("return function() for i = 1, 10000 do end end");
+		auto result = cpuMonitor.Call(shortLoop, &classStats, nullptr);
+		CHECK(result.valid());
+	}
+
+	SECTION("Statistics match the work done by calls without budget")
+	{
+		sol::protected_function loop = state.script("return function(n) for i = 1, n do end end");
+
+		ScriptCpuStats smallStats;
+		ScriptCpuStats bigStats;
+
+		Nz::Time startTime = Nz::GetElapsedNanoseconds();
+		REQUIRE(cpuMonitor.Call(loop, &smallStats, nullptr, 100'000).valid());
+		REQUIRE(cpuMonitor.Call(loop, &bigStats, nullptr, 1'000'000).valid());
+		Nz::Time wallTime = Nz::GetElapsedNanoseconds() - startTime;
+
+		CHECK(smallStats.callCount == 1);
+		CHECK(bigStats.callCount == 1);
+		CHECK(smallStats.abortCount == 0);
+		CHECK(bigStats.abortCount == 0);
+
+		// Instructions are counted with the hook granularity
+		CHECK(smallStats.instructionCount > 0);
+		CHECK(bigStats.instructionCount >= 8 * smallStats.instructionCount);
+		CHECK(bigStats.instructionCount <= 12 * smallStats.instructionCount);
+
+		CHECK(smallStats.totalTime > Nz::Time::Zero());
+		CHECK(bigStats.totalTime > smallStats.totalTime);
+		CHECK(smallStats.totalTime + bigStats.totalTime <= wallTime);
+		CHECK(smallStats.totalTime + bigStats.totalTime == cpuMonitor.GetTickTime());
+		CHECK(bigStats.maxCallTime == bigStats.totalTime);
+	}
+
+	SECTION("Nested calls are only accounted their own time and instructions")
+	{
+		ScriptCpuStats innerStats;
+
+		sol::protected_function inner = state.script("return function() for i = 1, 200000 do end end");
+		state["CallInner"] = [&]
+		{
+			cpuMonitor.Call(inner, &innerStats, nullptr);
+		};
+
+		sol::protected_function outer = state.script("return function() for i = 1, 100000 do end CallInner() end");
+		REQUIRE(cpuMonitor.Call(outer, &classStats, &entityStats).valid());
+
+		CHECK(classStats.callCount == 1);
+		CHECK(innerStats.callCount == 1);
+
+		CHECK(classStats.totalTime + innerStats.totalTime == cpuMonitor.GetTickTime());
+		CHECK(classStats.maxCallTime == cpuMonitor.GetTickTime());
+		CHECK(innerStats.instructionCount > classStats.instructionCount);
+	}
+
+	SECTION("A nested call running past the budget of its caller aborts both calls")
+	{
+		ScriptCpuMonitor::Budget budget;
+		budget.callTime = Nz::Time::Milliseconds(20);
+		cpuMonitor.UpdateBudget(budget);
+
+		ScriptCpuStats innerStats;
+		bool innerFailed = false;
+
+		state["CallInner"] = [&]
+		{
+			innerFailed = !cpuMonitor.Call(infiniteLoop, &innerStats, nullptr).valid();
+		};
+
+		sol::protected_function outer = state.script("return function() CallInner() while true do end end");
+
+		Nz::Time startTime = Nz::GetElapsedNanoseconds();
+		auto result = cpuMonitor.Call(outer, &classStats, &entityStats);
+		Nz::Time callTime = Nz::GetElapsedNanoseconds() - startTime;
+
+		CHECK(innerFailed);
+		CHECK_FALSE(result.valid());
+		CHECK(innerStats.abortCount == 1);
+		CHECK(classStats.abortCount == 1);
+		CHECK(callTime < Nz::Time::Seconds(1));
+	}
+
+	SECTION("Resetting statistics keeps class entries but zeroes them")
+	{
+		sol::protected_function failure = state.script("return function() error('failure') end");
+		REQUIRE_FALSE(cpuMonitor.Call(failure, &classStats, nullptr).valid());
+		CHECK(classStats.callCount == 1);
+		CHECK(classStats.abortCount == 0); //< regular errors aren't budget aborts
+
+		cpuMonitor.ResetStats();
+
+		REQUIRE(cpuMonitor.GetClassStats().contains("computer"));
+		CHECK(&cpuMonitor.GetOrCreateClassStats("computer") == &classStats);
+		CHECK(classStats.callCount == 0);
+		CHECK(classStats.totalTime == Nz::Time::Zero());
+	}
+}
@@ -0,0 +1,232 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/NetworkReactor.hpp>
+#include <CommonLib/NetworkSessionManager.hpp>
+#include <CommonLib/Planet.hpp>
+#include <CommonLib/SessionHandler.hpp>
+#include <CommonLib/SessionRecorder.hpp>
+#include <CommonLib/SessionReplay.hpp>
+#include <CommonLib/Protocol/Packets.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/ByteStream.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Core/Modules.hpp>
+#include <Nazara/Network/Network.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	// Minimal server-side handler applying block edits to a chunk
+	class BlockEditSessionHandler : public SessionHandler
+	{
+		public:
+			BlockEditSessionHandler(Chunk& chunk, NetworkSession* session) :
+			SessionHandler(session),
+			m_chunk(chunk)
+			{
+				SetupHandlerTable(this);
+			}
+
+			void HandlePacket(Packets::MineBlock&& mineBlock)
+			{
+				m_chunk.UpdateBlock({ mineBlock.voxelLoc.x, mineBlock.voxelLoc.y, mineBlock.voxelLoc.z }, EmptyBlockIndex);
+			}
+
+			void HandlePacket(Packets::PlaceBlock&& placeBlock)
+			{
+				m_chunk.UpdateBlock({ placeBlock.voxelLoc.x, placeBlock.voxelLoc.y, placeBlock.voxelLoc.z }, placeBlock.newContent);
+			}
+
+		private:
+			Chunk& m_chunk;
+	};
+
+	template<typename T>
+	Nz::ByteArray SerializePacket(const T& packet)
+	{
+		Nz::ByteArray byteArray;
+		Nz::ByteStream byteStream(&byteArray, Nz::OpenMode::Write);
+		byteStream << Nz::UInt8(PacketIndex<T>);
+
+		// Sessions don't negotiate a protocol version here
+		PacketSerializer serializer(byteStream, true, 0);
+		Packets::Serialize(serializer, const_cast<T&>(packet));
+
+		byteStream.FlushBits();
+
+		return byteArray;
+	}
+}
+
+TEST_CASE("Session recording and replay", "[Network]")
+{
+	constexpr Nz::UInt32 seed = 42;
+	constexpr std::size_t FrameCount = 20;
+	constexpr std::size_t PeerIndex = 2;
+	const Nz::Vector3ui chunkCount(3);
+
+	Nz::Modules<Nz::Network> nazara;
+
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+
+	auto CreateWorld = [&](Planet& planet) -> Chunk&
+	{
+		Chunk& chunk = planet.AddChunk(blockLibrary, { 0, 1, 0 });
+		planet.GenerateChunk(blockLibrary, chunk, seed, chunkCount);
+
+		return chunk;
+	};
+
+	std::filesystem::path recordingPath = std::filesystem::temp_directory_path() / "tsom_session_recording_tests.tsrec";
+
+	// Record a scripted session: a player connects, edits blocks over several frames and leaves
+	Planet recordedPlanet(1.f, 16.f, 9.81f);
+	Chunk& recordedChunk = CreateWorld(recordedPlanet);
+	std::vector<BlockIndex> initialContent(recordedChunk.GetContent(), recordedChunk.GetContent() + recordedChunk.GetBlockCount());
+	{
+		SessionRecorder::Header header;
+		header.saveDirectory = "saves/chunks";
+		header.seed = seed;
+
+		SessionRecorder recorder(recordingPath, header);
+
+		NetworkSessionManager sessionManager(0, Nz::NetProtocol::IPv4, 4);
+		sessionManager.SetDefaultHandler<BlockEditSessionHandler>(std::ref(recordedChunk));
+		sessionManager.SetRecorder(&recorder);
+
+		std::minstd_rand rand(seed);
+		std::uniform_int_distribution<unsigned int> coordDis(0, Planet::ChunkSize - 1);
+
+		for (std::size_t frameIndex = 0; frameIndex < FrameCount; ++frameIndex)
+		{
+			recorder.BeginFrame(Nz::Time::Milliseconds(33), Nz::UInt16(frameIndex));
+
+			if (frameIndex == 0)
+				sessionManager.HandleConnection(PeerIndex, Nz::IpAddress::LoopbackIpV4);
+			else if (frameIndex == FrameCount - 1)
+				sessionManager.HandleDisconnection(PeerIndex, false);
+			else
+			{
+				for (std::size_t i = 0; i < 10; ++i)
+				{
+					Packets::Helper::VoxelLocation voxelLoc;
+					voxelLoc.x = Nz::UInt8(coordDis(rand));
+					voxelLoc.y = Nz::UInt8(coordDis(rand));
+					voxelLoc.z = Nz::UInt8(coordDis(rand));
+
+					if (i % 2 == 0)
+					{
+						Packets::MineBlock mineBlock;
+						mineBlock.chunkId = 0;
+						mineBlock.voxelLoc = voxelLoc;
+
+						sessionManager.HandlePacket(PeerIndex, SerializePacket(mineBlock));
+					}
+					else
+					{
+						Packets::PlaceBlock placeBlock;
+						placeBlock.chunkId = 0;
+						placeBlock.voxelLoc = voxelLoc;
+						placeBlock.newContent = Nz::UInt8((i % 4 == 1) ? dirtBlock : stoneBlock);
+
+						sessionManager.HandlePacket(PeerIndex, SerializePacket(placeBlock));
+					}
+				}
+			}
+		}
+	}
+
+	REQUIRE(std::memcmp(recordedChunk.GetContent(), initialContent.data(), initialContent.size() * sizeof(BlockIndex)) != 0);
+
+	SECTION("Replaying a recording reproduces the same world state")
+	{
+		SessionReplay replay(recordingPath);
+		CHECK(replay.GetHeader().saveDirectory == "saves/chunks");
+		CHECK(replay.GetHeader().seed == seed);
+		REQUIRE(replay.GetFrameCount() == FrameCount);
+
+		for (std::size_t frameIndex = 0; frameIndex < replay.GetFrameCount(); ++frameIndex)
+		{
+			const SessionReplay::Frame& frame = replay.GetFrame(frameIndex);
+			CHECK(frame.elapsedTime == Nz::Time::Milliseconds(33));
+			CHECK(frame.tickIndex == frameIndex);
+			if (frameIndex > 0)
+				CHECK(frame.timestamp >= replay.GetFrame(frameIndex - 1).timestamp);
+		}
+
+		CHECK(replay.GetFrame(0).events.size() == 1);
+		CHECK(replay.GetFrame(0).events[0].type == SessionRecordType::Connection);
+		CHECK(replay.GetFrame(0).events[0].peerIndex == PeerIndex);
+		CHECK(replay.GetFrame(1).events.size() == 10);
+		CHECK(replay.GetFrame(FrameCount - 1).events[0].type == SessionRecordType::Disconnection);
+
+		Planet replayedPlanet(1.f, 16.f, 9.81f);
+		Chunk& replayedChunk = CreateWorld(replayedPlanet);
+
+		NetworkSessionManager sessionManager(0, Nz::NetProtocol::IPv4, 4);
+		sessionManager.SetDefaultHandler<BlockEditSessionHandler>(std::ref(replayedChunk));
+
+		for (std::size_t frameIndex = 0; frameIndex < replay.GetFrameCount(); ++frameIndex)
+			replay.InjectFrame(frameIndex, sessionManager);
+
+		REQUIRE(replayedChunk.GetBlockCount() == recordedChunk.GetBlockCount());
+		CHECK(std::memcmp(replayedChunk.GetContent(), recordedChunk.GetContent(), recordedChunk.GetBlockCount() * sizeof(BlockIndex)) == 0);
+	}
+
+	SECTION("Truncated recordings keep their complete frames")
+	{
+		std::optional<std::vector<Nz::UInt8>> content = Nz::File::ReadWhole(recordingPath);
+		REQUIRE(content);
+
+		// Drop the last frame (frame record and disconnection) and cut in the middle of the previous frame last packet (a PlaceBlock)
+		std::size_t lastFrameSize = SessionRecorder::FrameRecordSize + SessionRecorder::DisconnectionRecordSize;
+		std::size_t lastPacketSize = SessionRecorder::PacketRecordHeaderSize + SerializePacket(Packets::PlaceBlock{}).GetSize();
+		REQUIRE(content->size() > lastFrameSize + lastPacketSize);
+
+		std::size_t truncatedSize = content->size() - lastFrameSize - lastPacketSize / 2;
+		REQUIRE(Nz::File::WriteWhole(recordingPath, content->data(), truncatedSize));
+
+		SessionReplay replay(recordingPath);
+		CHECK(replay.GetFrameCount() == FrameCount - 1);
+		CHECK(replay.GetFrame(FrameCount - 2).events.size() == 9);
+	}
+
+	SECTION("Invalid files are rejected")
+	{
+		std::vector<Nz::UInt8> content(64, 0xAB);
+		REQUIRE(Nz::File::WriteWhole(recordingPath, content.data(), content.size()));
+
+		CHECK_THROWS_AS(SessionReplay(recordingPath), std::runtime_error);
+	}
+
+	SECTION("Replayed peers acknowledge packets")
+	{
+		NetworkReactor reactor(0, Nz::NetProtocol::IPv4, 0, 4);
+		reactor.EnableFakePeers();
+
+		std::atomic_bool acknowledged = false;
+		reactor.SendData(PeerIndex, 0, Nz::ENetPacketFlag::Reliable, SerializePacket(Packets::MineBlock{}), [&] { acknowledged = true; });
+
+		// Acknowledgements are triggered by the reactor thread
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!acknowledged && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		CHECK(acknowledged);
+	}
+
+	std::filesystem::remove(recordingPath);
+}
@@ -0,0 +1,129 @@
+#include <CommonLib/Utility/TickProfiler.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+
+using namespace tsom;
+
+TEST_CASE("Tick profiler", "[Profiling]")
+{
+	TickProfiler::Clear();
+
+	SECTION("Nothing is recorded while disabled")
+	{
+		TickProfiler::Enable(false);
+		{
+			TickProfiler::Zone zone("Disabled zone");
+		}
+
+		for (const auto& threadEvents : TickProfiler::CollectEvents())
+			CHECK(threadEvents.events.empty());
+	}
+
+	SECTION("Zones from multiple threads are exported as Chrome trace events")
+	{
+		TickProfiler::Enable(true);
+		{
+			TickProfiler::Zone tickZone("Tick");
+			{
+				TickProfiler::Zone systemZone("System");
+			}
+
+			std::thread workerThread([]
+			{
+				TickProfiler::SetThreadName("Worker");
+				TickProfiler::Zone workerZone("Worker zone");
+			});
+			workerThread.join();
+		}
+		TickProfiler::Enable(false);
+
+		nlohmann::json trace = nlohmann::json::parse(TickProfiler::ToChromeTrace());
+
+		REQUIRE(trace.is_object());
+		REQUIRE(trace.contains("traceEvents"));
+
+		const nlohmann::json& traceEvents = trace["traceEvents"];
+		REQUIRE(traceEvents.is_array());
+
+		const nlohmann::json* tickEvent = nullptr;
+		const nlohmann::json* systemEvent = nullptr;
+		const nlohmann::json* workerEvent = nullptr;
+		bool hasWorkerThreadName = false;
+
+		for (const nlohmann::json& event : traceEvents)
+		{
+			REQUIRE(event.contains("name"));
+			REQUIRE(event.contains("ph"));
+			REQUIRE(event.contains("pid"));
+			REQUIRE(event.contains("tid"));
+
+			std::string phase = event["ph"];
+			if (phase == "M")
+			{
+				CHECK(event["name"] == "thread_name");
+				REQUIRE(event["args"].contains("name"));
+				if (event["args"]["name"] == "Worker")
+					hasWorkerThreadName = true;
+
+				continue;
+			}
+
+			REQUIRE(phase == "X");
+			REQUIRE(event["ts"].is_number());
+			REQUIRE(event["dur"].is_number());
+			CHECK(event["dur"].get<double>() >= 0.0);
+
+			if (event["name"] == "Tick")
+				tickEvent = &event;
+			else if (event["name"] == "System")
+				systemEvent = &event;
+			else if (event["name"] == "Worker zone")
+				workerEvent = &event;
+		}
+
+		CHECK(hasWorkerThreadName);
+		REQUIRE(tickEvent);
+		REQUIRE(systemEvent);
+		REQUIRE(workerEvent);
+
+		// Nested zones are recorded on the same thread and are contained in their parent
+		CHECK((*systemEvent)["tid"] == (*tickEvent)["tid"]);
+		CHECK((*workerEvent)["tid"] != (*tickEvent)["tid"]);
+
+		double tickBegin = (*tickEvent)["ts"];
+		double tickEnd = tickBegin + (*tickEvent)["dur"].get<double>();
+		double systemBegin = (*systemEvent)["ts"];
+		double systemEnd = systemBegin + (*systemEvent)["dur"].get<double>();
+		CHECK(systemBegin >= tickBegin);
+		CHECK(systemEnd <= tickEnd);
+	}
+
+	SECTION("Full thread buffers keep the most recent events")
+	{
+		TickProfiler::Enable(true);
+		for (std::size_t i = 0; i < TickProfiler::ThreadEventCapacity + 10; ++i)
+		{
+			TickProfiler::Zone zone("Zone");
+		}
+		TickProfiler::Enable(false);
+
+		// Events are kept oldest first
+		std::size_t eventCount = 0;
+		for (const auto& threadEvents : TickProfiler::CollectEvents())
+		{
+			if (threadEvents.events.empty())
+				continue;
+
+			eventCount += threadEvents.events.size();
+			for (std::size_t i = 1; i < threadEvents.events.size(); ++i)
+				CHECK(threadEvents.events[i - 1].beginTime <= threadEvents.events[i].beginTime);
+		}
+
+		CHECK(eventCount == TickProfiler::ThreadEventCapacity);
+	}
+
+	TickProfiler::Enable(false);
+	TickProfiler::Clear();
+}
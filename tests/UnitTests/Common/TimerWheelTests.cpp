@@ -0,0 +1,180 @@
+#include <CommonLib/Utility/TimerWheel.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	struct TimerOwnerComponent
+	{
+		bool dummy;
+	};
+
+	struct TimerCleaner
+	{
+		void OnDestroy(entt::registry& /*registry*/, entt::entity entity)
+		{
+			timerWheel->CancelTimers(entity);
+		}
+
+		TimerWheel* timerWheel;
+	};
+}
+
+TEST_CASE("Timer wheel", "[Scripting]")
+{
+	TimerWheel timerWheel;
+
+	SECTION("Timers are triggered on their tick, in scheduling order")
+	{
+		std::vector<int> triggeredTimers;
+		timerWheel.AddTimer(300, [&] { triggeredTimers.push_back(3); });
+		timerWheel.AddTimer(5, [&] { triggeredTimers.push_back(1); });
+		timerWheel.AddTimer(70, [&] { triggeredTimers.push_back(2); });
+		timerWheel.AddTimer(5, [&] { triggeredTimers.push_back(10); });
+		timerWheel.AddTimer(300, [&] { triggeredTimers.push_back(30); });
+
+		CHECK(timerWheel.GetTimerCount() == 5);
+
+		for (int i = 0; i < 4; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggeredTimers.empty());
+
+		timerWheel.Advance();
+		CHECK(triggeredTimers == std::vector<int>{ 1, 10 });
+
+		for (int i = 5; i < 69; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggeredTimers.size() == 2);
+
+		timerWheel.Advance();
+		CHECK(triggeredTimers == std::vector<int>{ 1, 10, 2 });
+
+		for (int i = 70; i < 300; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggeredTimers == std::vector<int>{ 1, 10, 2, 3, 30 });
+		CHECK(timerWheel.GetTimerCount() == 0);
+	}
+
+	SECTION("Repeating timers are triggered at each interval until cancelled")
+	{
+		std::vector<Nz::UInt64> triggerTicks;
+		TimerWheel::TimerId timerId = timerWheel.AddRepeatingTimer(10, [&] { triggerTicks.push_back(timerWheel.GetCurrentTick()); });
+
+		for (int i = 0; i < 35; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggerTicks == std::vector<Nz::UInt64>{ 10, 20, 30 });
+		CHECK(timerWheel.IsTimerActive(timerId));
+
+		CHECK(timerWheel.CancelTimer(timerId));
+		CHECK_FALSE(timerWheel.IsTimerActive(timerId));
+		CHECK_FALSE(timerWheel.CancelTimer(timerId));
+
+		for (int i = 0; i < 100; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggerTicks.size() == 3);
+	}
+
+	SECTION("Timers cancelled from a callback are no longer triggered, even on the same tick")
+	{
+		std::size_t triggerCount = 0;
+		TimerWheel::TimerId repeatingTimer = TimerWheel::InvalidTimer;
+		repeatingTimer = timerWheel.AddRepeatingTimer(1, [&]
+		{
+			if (++triggerCount == 3)
+				timerWheel.CancelTimer(repeatingTimer);
+		});
+
+		bool secondTriggered = false;
+		TimerWheel::TimerId secondTimer = TimerWheel::InvalidTimer;
+		timerWheel.AddTimer(2, [&] { timerWheel.CancelTimer(secondTimer); });
+		secondTimer = timerWheel.AddTimer(2, [&] { secondTriggered = true; });
+
+		for (int i = 0; i < 10; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggerCount == 3);
+		CHECK_FALSE(secondTriggered);
+		CHECK(timerWheel.GetTimerCount() == 0);
+	}
+
+	SECTION("Destroying an owner cancels its timers")
+	{
+		entt::registry registry;
+		entt::entity first = registry.create();
+		entt::entity second = registry.create();
+		registry.emplace<TimerOwnerComponent>(first);
+		registry.emplace<TimerOwnerComponent>(second);
+
+		TimerCleaner cleaner{ &timerWheel };
+		registry.on_destroy<TimerOwnerComponent>().connect<&TimerCleaner::OnDestroy>(cleaner);
+
+		std::size_t firstTriggerCount = 0;
+		std::size_t secondTriggerCount = 0;
+		TimerWheel::TimerId firstTimer = timerWheel.AddTimer(10, [&] { firstTriggerCount++; }, first);
+		timerWheel.AddRepeatingTimer(3, [&] { firstTriggerCount++; }, first);
+		timerWheel.AddTimer(5000, [&] { firstTriggerCount++; }, first);
+		timerWheel.AddTimer(10, [&] { secondTriggerCount++; }, second);
+
+		CHECK(timerWheel.GetTimerOwner(firstTimer) == first);
+
+		registry.destroy(first);
+
+		CHECK(timerWheel.GetTimerCount() == 1);
+		CHECK_FALSE(timerWheel.IsTimerActive(firstTimer));
+		CHECK(timerWheel.GetTimerOwner(firstTimer) == entt::null);
+		CHECK(timerWheel.CancelTimers(first) == 0);
+
+		for (int i = 0; i < 6000; ++i)
+			timerWheel.Advance();
+
+		CHECK(firstTriggerCount == 0);
+		CHECK(secondTriggerCount == 1);
+	}
+
+	SECTION("Large numbers of timers are each triggered once, on their tick")
+	{
+		constexpr Nz::UInt64 TimerCount = 100'000;
+		constexpr Nz::UInt64 MaxDelay = 20'000;
+
+		std::size_t triggerCount = 0;
+		std::size_t lateTriggerCount = 0;
+		for (Nz::UInt64 i = 0; i < TimerCount; ++i)
+		{
+			Nz::UInt64 delay = 1 + (i * 7919) % MaxDelay;
+			Nz::UInt64 expectedTick = timerWheel.GetCurrentTick() + delay;
+			timerWheel.AddTimer(delay, [&, expectedTick]
+			{
+				triggerCount++;
+				if (timerWheel.GetCurrentTick() != expectedTick)
+					lateTriggerCount++;
+			});
+		}
+
+		// Beyond the range of the wheel, these have to be cascaded back from the top level
+		Nz::UInt64 farTick = 0;
+		constexpr Nz::UInt64 FarDelay = (Nz::UInt64(1) << 24) + 1000;
+		timerWheel.AddTimer(FarDelay, [&] { farTick = timerWheel.GetCurrentTick(); });
+
+		CHECK(timerWheel.GetTimerCount() == TimerCount + 1);
+
+		for (Nz::UInt64 i = 0; i < MaxDelay; ++i)
+			timerWheel.Advance();
+
+		CHECK(triggerCount == TimerCount);
+		CHECK(lateTriggerCount == 0);
+		CHECK(timerWheel.GetTimerCount() == 1);
+
+		while (timerWheel.GetTimerCount() > 0)
+			timerWheel.Advance();
+
+		CHECK(farTick == FarDelay);
+	}
+}
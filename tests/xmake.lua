@@ -3,5 +3,7 @@ option("tests", { description = "Build tests", default = true })
 if has_config("tests") then
 	set_group("Tests")
 
+	add_requires("catch2 >=3.x")
+
 	includes("*/xmake.lua")
 end
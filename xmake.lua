@@ -5,6 +5,7 @@ includes("xmake/rules/*.lua")
 option("commonlib_static", { default = false, defines = "TSOM_COMMONLIB_STATIC"})
 option("clientlib_static", { default = false, defines = "TSOM_CLIENTLIB_STATIC"})
 option("serverlib_static", { default = false, defines = "TSOM_SERVERLIB_STATIC"})
+option("zstd", { default = false, description = "Enables zstd compression codec (and zstd dictionary training)"})
 
 -- Simple rule to make targets inherit their version from CommonLib version (which is extracted from git in on_config callback)
 rule("inherit_version", function ()
@@ -31,6 +32,10 @@ add_requires(
 	"sol2"
 )
 
+if has_config("zstd") then
+	add_requires("zstd")
+end
+
 if is_plat("windows") then
 	add_requires("stackwalker 5b0df7a4db8896f6b6dc45d36e383c52577e3c6b")
 elseif is_plat("macosx") then
@@ -89,6 +94,11 @@ target("CommonLib", function ()
 	add_packages("concurrentqueue", "cppcodec", "semver", "fmt", "hopscotch-map", "nlohmann_json", "sol2", { public = true })
 	add_packages("frozen", "libsodium", "lz4", "perlinnoise")
 
+	if has_config("zstd") then
+		add_packages("zstd")
+		add_defines("TSOM_WITH_ZSTD")
+	end
+
 	if is_plat("windows") then
 		add_packages("stackwalker")
 	end
@@ -255,6 +265,7 @@ target("TSOMGame", function ()
 	add_files("src/Game/**.cpp")
 	add_installfiles("gameconfig.lua.default", { prefixdir = "bin" })
 	add_installfiles("(scripts/**.lua)", { prefixdir = "bin" })
+	add_installfiles("(data/**)", { prefixdir = "bin" })
 
 	if is_plat("windows", "mingw") then
 		add_files("src/Game/resources.rc")
@@ -293,6 +304,22 @@ target("TSOMServer", function ()
 	add_files("src/Server/**.cpp")
 	add_installfiles("serverconfig.lua.default", { prefixdir = "bin" })
 	add_installfiles("(scripts/**.lua)", { prefixdir = "bin" })
+	add_installfiles("(data/**)", { prefixdir = "bin" })
+
+	add_rpathdirs("@executable_path")
+end)
+
+target("TSOMBot", function ()
+	set_group("Executable")
+	set_basename("ThisBotOfMine")
+	add_deps("CommonLib", "Main")
+	add_rules("inherit_version")
+
+	add_defines("TSOM_BOT_BUILD")
+
+	add_headerfiles("src/Bot/**.hpp", "src/Bot/**.inl")
+	add_files("src/Bot/**.cpp")
+	add_installfiles("botconfig.lua.default", { prefixdir = "bin" })
 
 	add_rpathdirs("@executable_path")
 end)
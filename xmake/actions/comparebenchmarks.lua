@@ -0,0 +1,89 @@
+task("compare-benchmarks")
+
+set_menu({
+	-- Settings menu usage
+	usage = "xmake compare-benchmarks [options] baseline current",
+	description = "Compares two benchmark reports (as written by the Catch2 XML reporter)",
+	options =
+	{
+		{'t', "threshold", "kv", "5", "Relative change (in percent) above which a benchmark is reported as a regression or an improvement" },
+		{nil, "baseline", "v", nil, "Baseline report (e.g. benchmarks.xml from the previous commit)" },
+		{nil, "current", "v", nil, "Current report" }
+	}
+})
+
+on_run(function ()
+	import("core.base.option")
+
+	local function ParseReport(filepath)
+		local content = io.readfile(filepath)
+		if not content then
+			os.raise("failed to read " .. filepath)
+		end
+
+		local results = {}
+		local names = {}
+		for name, body in content:gmatch("<BenchmarkResults%s+name=\"([^\"]*)\"(.-)</BenchmarkResults>") do
+			local mean = body:match("<mean%s+value=\"([^\"]*)\"")
+			if mean then
+				if not results[name] then
+					table.insert(names, name)
+				end
+
+				results[name] = tonumber(mean)
+			end
+		end
+
+		return results, names
+	end
+
+	local function FormatDuration(ns)
+		if ns >= 1e9 then
+			return string.format("%.2f s", ns / 1e9)
+		elseif ns >= 1e6 then
+			return string.format("%.2f ms", ns / 1e6)
+		elseif ns >= 1e3 then
+			return string.format("%.2f us", ns / 1e3)
+		else
+			return string.format("%.2f ns", ns)
+		end
+	end
+
+	local baselinePath = option.get("baseline")
+	local currentPath = option.get("current")
+	if not baselinePath or not currentPath then
+		os.raise("missing benchmark report paths")
+	end
+
+	local threshold = tonumber(option.get("threshold"))
+	if not threshold then
+		os.raise("invalid threshold")
+	end
+
+	local baseline = ParseReport(baselinePath)
+	local current, names = ParseReport(currentPath)
+
+	local regressionCount = 0
+	for _, name in ipairs(names) do
+		local currentMean = current[name]
+		local baselineMean = baseline[name]
+		if baselineMean and baselineMean > 0 then
+			local change = (currentMean - baselineMean) / baselineMean * 100
+			local color = "${dim}"
+			if change > threshold then
+				color = "${red}"
+				regressionCount = regressionCount + 1
+			elseif change < -threshold then
+				color = "${green}"
+			end
+
+			cprint("%s%+7.1f%%${clear} %s -> %s  %s", color, change, FormatDuration(baselineMean), FormatDuration(currentMean), name)
+		else
+			cprint("${yellow}    new${clear} %s  %s", FormatDuration(currentMean), name)
+		end
+	end
+
+	if regressionCount > 0 then
+		os.raise("%d benchmark(s) regressed by more than %s%%", regressionCount, threshold)
+	end
+end)
@@ -0,0 +1,24 @@
+task("train-chunk-dictionary")
+
+set_menu({
+	-- Settings menu usage
+	usage = "xmake train-chunk-dictionary [options]",
+	description = "Builds the server and trains the chunk compression dictionary asset on generated planet chunks",
+	options =
+	{
+		{'o', "output", "kv", "data/chunks_v1.tsdict", "Dictionary asset path (must match Constants::ChunkCompressionDictionaryPath)" }
+	}
+})
+
+on_run(function ()
+	import("core.base.option")
+
+	local outputPath = path.absolute(option.get("output"))
+	os.mkdir(path.directory(outputPath))
+
+	-- The asset must come from Planet::TrainChunkDictionary, as clients and servers built from this tree advertise its id
+	os.execv(os.programfile(), { "build", "TSOMServer" })
+	os.execv(os.programfile(), { "run", "TSOMServer", "--train-chunk-dictionary", outputPath })
+
+	cprint("${green}chunk dictionary written to %s${clear}, commit it (and bump Constants::ChunkCompressionDictionaryId if a previous asset was released)", outputPath)
+end)